@@ -0,0 +1,67 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief GlobalAligner micro benchmarks
+///
+
+#include "Benchmarks.hh"
+#include "SyntheticData.hh"
+
+#include "alignment/GlobalAligner.hh"
+
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+void
+runAlignerBenchmarks(BenchmarkRunner& runner)
+{
+    const BenchmarkOptions& opt(runner.getOptions());
+    std::mt19937 rng(opt.seed);
+
+    // align haplotype-sized queries to a reference window padded on both sides, using the same scores as the
+    // active region haplotype aligner:
+    static const unsigned fixtureCount(64);
+    static const unsigned refPadSize(25);
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    std::vector<std::pair<std::string,std::string>> fixtures;
+    for (unsigned fixtureIndex(0); fixtureIndex<fixtureCount; ++fixtureIndex)
+    {
+        const std::string ref(getRepeatRichSequence(opt.readLength+2*refPadSize, rng));
+        std::string query(ref.substr(refPadSize, opt.readLength));
+        if (unitDist(rng) < opt.indelDensity) addRandomIndel(query, rng);
+        addBaseErrors(0.01, query, rng);
+        fixtures.emplace_back(query, ref);
+    }
+
+    const GlobalAligner<int> aligner(AlignmentScores<int>(1, -4, -5, -1, -100, -5, true, true));
+    AlignmentResult<int> result;
+    runner.runMicro("GlobalAligner.align", fixtureCount, [&]()
+    {
+        for (const auto& fixture : fixtures)
+        {
+            aligner.align(fixture.first.begin(), fixture.first.end(), fixture.second.begin(), fixture.second.end(),
+                          result);
+            runner.consume(static_cast<double>(result.score));
+        }
+    });
+}
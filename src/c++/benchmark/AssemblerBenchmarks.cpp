@@ -0,0 +1,71 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief IterativeAssembler micro benchmarks
+///
+
+#include "Benchmarks.hh"
+#include "SyntheticData.hh"
+
+#include "assembly/IterativeAssembler.hh"
+
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+void
+runAssemblerBenchmarks(BenchmarkRunner& runner)
+{
+    const BenchmarkOptions& opt(runner.getOptions());
+    std::mt19937 rng(opt.seed);
+
+    // each fixture is a heterozygous active region with a reference haplotype and an alternate haplotype carrying
+    // an indel and a nearby SNV:
+    static const unsigned fixtureCount(8);
+    std::vector<AssemblyReadInput> fixtures;
+    const unsigned regionSize(2*opt.readLength);
+    for (unsigned fixtureIndex(0); fixtureIndex<fixtureCount; ++fixtureIndex)
+    {
+        const std::string refHaplotype(getRepeatRichSequence(regionSize, rng));
+        std::string altHaplotype(refHaplotype);
+        addRandomIndel(altHaplotype, rng);
+        addBaseErrors(2./regionSize, altHaplotype, rng);
+        fixtures.push_back(sampleReads({refHaplotype, altHaplotype}, opt.depth, opt.readLength, 0.005, rng));
+    }
+
+    // match the assembly settings used for active regions:
+    IterativeAssemblerOptions assembleOpt;
+    assembleOpt.minWordLength = 20;
+    assembleOpt.maxWordLength = 76;
+    assembleOpt.minCoverage = 3;
+
+    runner.runMicro("IterativeAssembler.region", fixtureCount, [&]()
+    {
+        for (auto& reads : fixtures)
+        {
+            AssemblyReadOutput readInfo;
+            Assembly contigs;
+            runIterativeAssembler(assembleOpt, reads, readInfo, contigs);
+            runner.consume(static_cast<uint64_t>(contigs.size()));
+        }
+    });
+}
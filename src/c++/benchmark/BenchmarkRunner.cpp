@@ -0,0 +1,250 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Timing and allocation counting harness shared by all benchmarks
+///
+
+#include "BenchmarkRunner.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+
+namespace
+{
+std::atomic<uint64_t> allocationCount(0);
+std::atomic<uint64_t> allocationBytes(0);
+}
+
+
+// replace the global allocation functions so that every heap allocation made by the benchmarked code is counted:
+
+void*
+operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    void* ptr(std::malloc(size == 0 ? 1 : size));
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void*
+operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return ::operator new(size, tag);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+
+
+AllocationCounts
+getAllocationCounts()
+{
+    AllocationCounts counts;
+    counts.allocations = allocationCount.load(std::memory_order_relaxed);
+    counts.bytes = allocationBytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+
+
+static
+double
+getSecondsSince(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+BenchmarkRunner::
+BenchmarkRunner(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+    : _opt(opt),
+      _os(os)
+{}
+
+
+
+BenchmarkRunner::
+~BenchmarkRunner()
+{
+    // the checksum is printed only to keep benchmark results live:
+    _os << "\nchecksum: " << _checksum << "\n";
+}
+
+
+
+bool
+BenchmarkRunner::
+isSelected(const std::string& name) const
+{
+    return (_opt.filter.empty() || (name.find(_opt.filter) != std::string::npos));
+}
+
+
+
+void
+BenchmarkRunner::
+writeMicroHeader()
+{
+    if (_isMicroHeaderWritten) return;
+    _os << std::left << std::setw(40) << "benchmark" << std::right
+        << std::setw(12) << "ops"
+        << std::setw(14) << "ns/op"
+        << std::setw(14) << "allocs/op"
+        << std::setw(14) << "bytes/op" << "\n";
+    _isMicroHeaderWritten = true;
+}
+
+
+
+void
+BenchmarkRunner::
+writeStageHeader()
+{
+    if (_isStageHeaderWritten) return;
+    _os << "\n" << std::left << std::setw(40) << "stage" << std::right
+        << std::setw(12) << "seconds"
+        << std::setw(14) << "positions/s"
+        << std::setw(14) << "reads/s"
+        << std::setw(14) << "allocs/read" << "\n";
+    _isStageHeaderWritten = true;
+}
+
+
+
+void
+BenchmarkRunner::
+runMicro(
+    const std::string& name,
+    const uint64_t opsPerIteration,
+    const std::function<void()>& iteration)
+{
+    if (! isSelected(name)) return;
+
+    // warm up caches and any lazily initialized state outside of the measurement:
+    iteration();
+
+    const AllocationCounts startAllocations(getAllocationCounts());
+    const auto start(std::chrono::steady_clock::now());
+    uint64_t iterationCount(0);
+    double seconds(0);
+    do
+    {
+        iteration();
+        iterationCount++;
+        seconds = getSecondsSince(start);
+    }
+    while (seconds < _opt.minSeconds);
+    const AllocationCounts endAllocations(getAllocationCounts());
+
+    const double opCount(static_cast<double>(iterationCount*opsPerIteration));
+    writeMicroHeader();
+    _os << std::left << std::setw(40) << name << std::right
+        << std::setw(12) << (iterationCount*opsPerIteration)
+        << std::fixed << std::setprecision(1)
+        << std::setw(14) << (seconds*1e9/opCount)
+        << std::setprecision(3)
+        << std::setw(14) << ((endAllocations.allocations-startAllocations.allocations)/opCount)
+        << std::setprecision(1)
+        << std::setw(14) << ((endAllocations.bytes-startAllocations.bytes)/opCount) << "\n";
+    _os.unsetf(std::ios::floatfield);
+}
+
+
+
+void
+BenchmarkRunner::
+reportStage(
+    const std::string& name,
+    const uint64_t positionCount,
+    const uint64_t readCount,
+    const double seconds,
+    const AllocationCounts& allocations)
+{
+    writeStageHeader();
+    const double safeSeconds(std::max(seconds, 1e-9));
+    _os << std::left << std::setw(40) << name << std::right
+        << std::fixed << std::setprecision(3)
+        << std::setw(12) << seconds
+        << std::setprecision(0)
+        << std::setw(14) << (positionCount/safeSeconds)
+        << std::setw(14) << (readCount/safeSeconds)
+        << std::setprecision(1)
+        << std::setw(14) << (readCount == 0 ? 0. : static_cast<double>(allocations.allocations)/readCount) << "\n";
+    _os.unsetf(std::ios::floatfield);
+}
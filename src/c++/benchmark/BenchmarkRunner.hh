@@ -0,0 +1,159 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Timing and allocation counting harness shared by all benchmarks
+///
+
+#pragma once
+
+#include "boost/utility.hpp"
+
+#include <cstdint>
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+
+
+/// \brief Global heap allocation counters
+///
+/// These are updated by the replacement global operator new linked into the benchmark binary, and are only
+/// meaningful there.
+struct AllocationCounts
+{
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+/// \return Heap allocation counts since program start, summed over all threads
+AllocationCounts
+getAllocationCounts();
+
+
+
+/// \brief Settings shared by all benchmarks
+struct BenchmarkOptions
+{
+    /// Only run benchmarks with a name containing this string, run all if empty
+    std::string filter;
+
+    /// Minimum wall time spent on the timed iterations of each micro benchmark
+    double minSeconds = 0.5;
+
+    /// Synthetic fixture read depth
+    unsigned depth = 30;
+
+    /// Synthetic fixture read length
+    unsigned readLength = 100;
+
+    /// Fraction of synthetic reads and haplotypes carrying a small indel
+    double indelDensity = 0.05;
+
+    /// Random seed for all synthetic fixtures
+    unsigned seed = 1;
+
+    /// Directory containing the bundled demo data used by the end-to-end benchmarks
+    std::string demoDataDir;
+
+    /// Number of times each end-to-end benchmark stage is run
+    unsigned demoIterations = 3;
+
+    bool isSkipMicro = false;
+    bool isSkipDemo = false;
+};
+
+
+
+/// \brief Runs and reports micro benchmarks and end-to-end stage benchmarks
+///
+/// Each micro benchmark is a function running one 'iteration' of a fixed number of operations. The iteration is
+/// run once untimed to warm up caches and any lazily constructed state, then repeatedly until the minimum time is
+/// reached. Time and heap allocations are reported per operation.
+///
+struct BenchmarkRunner : private boost::noncopyable
+{
+    BenchmarkRunner(
+        const BenchmarkOptions& opt,
+        std::ostream& os);
+
+    ~BenchmarkRunner();
+
+    const BenchmarkOptions&
+    getOptions() const
+    {
+        return _opt;
+    }
+
+    /// \return True if the benchmark with this name passes the name filter
+    bool
+    isSelected(const std::string& name) const;
+
+    /// \brief Time a micro benchmark
+    ///
+    /// \param[in] name Benchmark name, used for reporting and filtering
+    /// \param[in] opsPerIteration Number of operations run in each call to \p iteration
+    /// \param[in] iteration Function running one iteration of the benchmark
+    void
+    runMicro(
+        const std::string& name,
+        const uint64_t opsPerIteration,
+        const std::function<void()>& iteration);
+
+    /// \brief Report one end-to-end pipeline stage
+    ///
+    /// \param[in] name Stage name, used for reporting
+    /// \param[in] positionCount Total reference positions processed over all runs of the stage
+    /// \param[in] readCount Total reads processed over all runs of the stage
+    /// \param[in] seconds Total wall time of all runs of the stage
+    /// \param[in] allocations Heap allocation counts of all runs of the stage
+    void
+    reportStage(
+        const std::string& name,
+        const uint64_t positionCount,
+        const uint64_t readCount,
+        const double seconds,
+        const AllocationCounts& allocations);
+
+    /// \brief Fold a benchmark result into a checksum so that the computation producing it can't be optimized away
+    void
+    consume(const double value)
+    {
+        _checksum += value;
+    }
+
+    void
+    consume(const uint64_t value)
+    {
+        _checksum += static_cast<double>(value);
+    }
+
+private:
+    void
+    writeMicroHeader();
+
+    void
+    writeStageHeader();
+
+    const BenchmarkOptions& _opt;
+    std::ostream& _os;
+    bool _isMicroHeaderWritten = false;
+    bool _isStageHeaderWritten = false;
+    double _checksum = 0;
+};
@@ -0,0 +1,51 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Entry points of all benchmark groups
+///
+
+#pragma once
+
+#include "BenchmarkRunner.hh"
+
+
+/// GlobalAligner haplotype to reference alignment
+void
+runAlignerBenchmarks(BenchmarkRunner& runner);
+
+/// IterativeAssembler active region assembly
+void
+runAssemblerBenchmarks(BenchmarkRunner& runner);
+
+/// RandomForestModel single and batch scoring
+void
+runRandomForestBenchmarks(BenchmarkRunner& runner);
+
+/// germline SNV and indel genotype likelihood kernels
+void
+runLikelihoodBenchmarks(BenchmarkRunner& runner);
+
+/// pos_basecall_buffer pileup insertion
+void
+runPileupBenchmarks(BenchmarkRunner& runner);
+
+/// end-to-end pipeline stages over the bundled demo data
+void
+runDemoDataBenchmarks(BenchmarkRunner& runner);
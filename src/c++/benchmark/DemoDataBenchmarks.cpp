@@ -0,0 +1,306 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief End-to-end pipeline stage benchmarks over the bundled demo data
+///
+
+#include "Benchmarks.hh"
+
+#include "applications/starling/starling.hh"
+#include "applications/strelka/strelka.hh"
+#include "blt_util/align_path.hh"
+#include "htsapi/align_path_bam_util.hh"
+#include "htsapi/samtools_fasta_util.hh"
+#include "starling_common/HtsMergeStreamer.hh"
+#include "starling_common/pos_basecall_buffer.hh"
+
+#include "boost/filesystem.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+
+
+namespace
+{
+
+const std::string demoChrom("demo20");
+const pos_t demoRegionBeginPos(1);
+const pos_t demoRegionEndPos(5000);
+
+const std::string&
+getDemoRegion()
+{
+    static const std::string region(
+        demoChrom + ":" + std::to_string(demoRegionBeginPos) + "-" + std::to_string(demoRegionEndPos));
+    return region;
+}
+
+const unsigned demoPositionCount(demoRegionEndPos-demoRegionBeginPos+1);
+
+
+
+/// file paths to all demo data inputs
+struct DemoDataPaths
+{
+    explicit
+    DemoDataPaths(const std::string& demoDataDir)
+    {
+        const boost::filesystem::path dir(demoDataDir);
+        referenceFilename = (dir / "demo20.fa").string();
+        normalBamFilename = (dir / "NA12892_demo20.bam").string();
+        tumorBamFilename = (dir / "NA12891_demo20.bam").string();
+    }
+
+    bool
+    isValid() const
+    {
+        for (const auto& filename : {referenceFilename, normalBamFilename, tumorBamFilename})
+        {
+            if (! boost::filesystem::exists(filename)) return false;
+        }
+        return true;
+    }
+
+    std::string referenceFilename;
+    std::string normalBamFilename;
+    std::string tumorBamFilename;
+};
+
+
+
+/// Temporary directory removed at the end of scope
+struct ScopedTempDirectory
+{
+    ScopedTempDirectory()
+        : path(boost::filesystem::temp_directory_path() /
+               boost::filesystem::unique_path("strelka_benchmarks_%%%%-%%%%-%%%%"))
+    {
+        boost::filesystem::create_directories(path);
+    }
+
+    ~ScopedTempDirectory()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(path, ec);
+    }
+
+    const boost::filesystem::path path;
+};
+
+
+
+/// \brief Run \p stage for each demo iteration and report the mean throughput of the stage
+///
+/// \param[in] stage Function running the stage once and returning the number of reads processed
+template <typename Stage>
+void
+runDemoStage(
+    BenchmarkRunner& runner,
+    const std::string& name,
+    Stage stage)
+{
+    if (! runner.isSelected(name)) return;
+
+    const unsigned iterations(std::max(1u, runner.getOptions().demoIterations));
+    uint64_t readCount(0);
+    const AllocationCounts startCounts(getAllocationCounts());
+    const auto startTime(std::chrono::steady_clock::now());
+    for (unsigned iteration(0); iteration<iterations; ++iteration)
+    {
+        readCount += stage();
+    }
+    const std::chrono::duration<double> elapsed(std::chrono::steady_clock::now() - startTime);
+    const AllocationCounts endCounts(getAllocationCounts());
+
+    AllocationCounts stageCounts;
+    stageCounts.allocations = (endCounts.allocations - startCounts.allocations) / iterations;
+    stageCounts.bytes = (endCounts.bytes - startCounts.bytes) / iterations;
+    runner.reportStage(name, demoPositionCount, readCount/iterations, elapsed.count()/iterations, stageCounts);
+}
+
+
+
+/// \brief Run a Program subclass with the given command-line arguments
+template <typename ProgramType>
+void
+runProgram(
+    const char* programName,
+    const std::vector<std::string>& args)
+{
+    std::vector<std::string> argStrings(1, programName);
+    argStrings.insert(argStrings.end(), args.begin(), args.end());
+
+    std::vector<char*> argv;
+    for (auto& arg : argStrings)
+    {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+    ProgramType().run(static_cast<int>(argStrings.size()), argv.data());
+}
+
+}
+
+
+
+/// \return Number of alignment records decoded
+static
+uint64_t
+runDecodeStage(const DemoDataPaths& paths)
+{
+    HtsMergeStreamer streamer(paths.referenceFilename);
+    streamer.registerBam(paths.normalBamFilename, 0);
+    streamer.registerBam(paths.tumorBamFilename, 1);
+    streamer.resetRegion(getDemoRegion());
+
+    uint64_t readCount(0);
+    while (streamer.next())
+    {
+        if (streamer.getCurrentType() != HTS_TYPE::BAM) continue;
+        readCount++;
+    }
+    return readCount;
+}
+
+
+
+/// \return Number of alignment records decoded and added to the pileup
+static
+uint64_t
+runPileupStage(
+    const DemoDataPaths& paths,
+    const reference_contig_segment& ref)
+{
+    HtsMergeStreamer streamer(paths.referenceFilename);
+    streamer.registerBam(paths.normalBamFilename, 0);
+    streamer.registerBam(paths.tumorBamFilename, 1);
+    streamer.resetRegion(getDemoRegion());
+
+    pos_basecall_buffer normalBuffer(ref);
+    pos_basecall_buffer tumorBuffer(ref);
+    ALIGNPATH::path_t apath;
+    uint64_t readCount(0);
+    while (streamer.next())
+    {
+        if (streamer.getCurrentType() != HTS_TYPE::BAM) continue;
+        const bam_record& read(streamer.getCurrentBam());
+        if (read.is_unmapped() || read.is_filter() || read.is_dup()) continue;
+
+        pos_basecall_buffer& buffer((streamer.getCurrentIndex() == 0) ? normalBuffer : tumorBuffer);
+        const pos_t readStartPos(read.pos()-1);
+        buffer.clear_to_pos(readStartPos-1);
+
+        const bam_seq readSeq(read.get_bam_read());
+        const uint8_t* qual(read.qual());
+        const unsigned readSize(read.read_size());
+        const uint8_t mapq(read.map_qual());
+        const bool isFwdStrand(read.is_fwd_strand());
+
+        bam_cigar_to_apath(read.raw_cigar(), read.n_cigar(), apath);
+        pos_t refPos(readStartPos);
+        unsigned readPos(0);
+        for (const auto& ps : apath)
+        {
+            if (is_segment_align_match(ps.type))
+            {
+                for (unsigned segmentPos(0); segmentPos<ps.length; ++segmentPos)
+                {
+                    const base_call bc(base_to_id(readSeq.get_char(readPos)), qual[readPos], isFwdStrand,
+                                       readPos, readSize, false, false, false);
+                    snp_pos_info& posdata(buffer.getPosRef(refPos));
+                    pos_basecall_buffer::insert_pos_basecall(posdata, true, bc);
+                    pos_basecall_buffer::insert_mapq_count(posdata, mapq);
+                    refPos++;
+                    readPos++;
+                }
+                continue;
+            }
+            if (is_segment_type_read_length(ps.type)) readPos += ps.length;
+            if (is_segment_type_ref_length(ps.type)) refPos += ps.length;
+        }
+        readCount++;
+    }
+    return readCount;
+}
+
+
+
+void
+runDemoDataBenchmarks(BenchmarkRunner& runner)
+{
+    const BenchmarkOptions& opt(runner.getOptions());
+    const DemoDataPaths paths(opt.demoDataDir);
+    if (! paths.isValid())
+    {
+        std::cerr << "WARNING: skipping end-to-end benchmarks, demo data not found in '" << opt.demoDataDir << "'\n";
+        return;
+    }
+
+    uint64_t demoReadCount(0);
+    runDemoStage(runner, "demo.decode", [&]()
+    {
+        demoReadCount = runDecodeStage(paths);
+        return demoReadCount;
+    });
+
+    reference_contig_segment ref;
+    get_standardized_region_seq(paths.referenceFilename, demoChrom, 0, demoRegionEndPos+1000, ref.seq());
+    runDemoStage(runner, "demo.pileup", [&]()
+    {
+        return runPileupStage(paths, ref);
+    });
+
+    // full caller runs report the decoded read count of the region, so that reads/s is comparable across stages:
+    if (demoReadCount == 0) demoReadCount = runDecodeStage(paths);
+
+    runDemoStage(runner, "demo.germline", [&]()
+    {
+        const ScopedTempDirectory tempDir;
+        runProgram<starling>("strelka_benchmarks_germline", {
+            "--ref", paths.referenceFilename,
+            "--align-file", paths.normalBamFilename,
+            "--region", getDemoRegion(),
+            "--max-indel-size", "50",
+            "--min-mapping-quality", "20",
+            "--gvcf-output-prefix", (tempDir.path / "").string(),
+            "--stats-file", (tempDir.path / "stats.xml").string()
+        });
+        return demoReadCount;
+    });
+
+    runDemoStage(runner, "demo.somatic", [&]()
+    {
+        const ScopedTempDirectory tempDir;
+        runProgram<strelka>("strelka_benchmarks_somatic", {
+            "--ref", paths.referenceFilename,
+            "--tumor-align-file", paths.tumorBamFilename,
+            "--normal-align-file", paths.normalBamFilename,
+            "--region", getDemoRegion(),
+            "--max-indel-size", "50",
+            "--somatic-snv-file", (tempDir.path / "somatic.snvs.vcf").string(),
+            "--somatic-indel-file", (tempDir.path / "somatic.indels.vcf").string(),
+            "--somatic-callable-regions-file", (tempDir.path / "callable.bed").string(),
+            "--stats-file", (tempDir.path / "stats.xml").string()
+        });
+        return demoReadCount;
+    });
+}
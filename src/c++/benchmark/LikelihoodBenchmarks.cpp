@@ -0,0 +1,214 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Germline and somatic genotype likelihood kernel micro benchmarks
+///
+
+#include "Benchmarks.hh"
+#include "SyntheticData.hh"
+
+#include "applications/strelka/position_somatic_snv_strand_grid_lhood_cached.hh"
+#include "applications/strelka/strelka_digt_states.hh"
+#include "blt_common/position_snp_call_pprob_digt.hh"
+#include "blt_util/depth_buffer.hh"
+#include "starling_common/AlleleGroupGenotype.hh"
+#include "starling_common/IndelBuffer.hh"
+#include "starling_common/OrthogonalVariantAlleleCandidateGroup.hh"
+#include "test/starling_base_options_test.hh"
+
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+/// fill a pileup with the given depth, where the site is heterozygous for an alternate base if isHet is set:
+static
+void
+getSyntheticPileup(
+    const unsigned depth,
+    const bool isHet,
+    std::mt19937& rng,
+    snp_pos_info& pi)
+{
+    static const uint8_t refBaseId(0);
+    static const uint8_t altBaseId(2);
+
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    pi.clear();
+    pi.set_ref_base(id_to_base(refBaseId));
+    for (unsigned callIndex(0); callIndex<depth; ++callIndex)
+    {
+        const uint8_t qscore(getRandomQuality(rng));
+        uint8_t baseId((isHet && (unitDist(rng) < 0.5)) ? altBaseId : refBaseId);
+        if (unitDist(rng) < qphred_to_error_prob(qscore))
+        {
+            baseId = (baseId + 1 + (rng() % 3)) % N_BASE;
+        }
+        const bool isFwdStrand(unitDist(rng) < 0.5);
+        pi.calls.emplace_back(baseId, qscore, isFwdStrand, 0, 0, false, false, false);
+    }
+}
+
+
+
+static
+void
+runSnvLikelihoodBenchmarks(BenchmarkRunner& runner)
+{
+    const BenchmarkOptions& opt(runner.getOptions());
+    std::mt19937 rng(opt.seed);
+
+    static const unsigned fixtureCount(64);
+    std::vector<snp_pos_info> pileups(fixtureCount);
+    for (unsigned fixtureIndex(0); fixtureIndex<fixtureCount; ++fixtureIndex)
+    {
+        getSyntheticPileup(opt.depth, (fixtureIndex % 2) == 0, rng, pileups[fixtureIndex]);
+    }
+
+    const blt_options bopt;
+    const pprob_digt_caller caller(bopt.bsnp_diploid_theta);
+    const std::vector<float> noDependentEprob;
+    static const bool isAlwaysTest(true);
+    runner.runMicro("snv.germlineDiploidPosterior", fixtureCount, [&]()
+    {
+        for (const auto& pi : pileups)
+        {
+            const extended_pos_info epi(pi, noDependentEprob);
+            diploid_genotype dgt;
+            caller.position_snp_call_pprob_digt(bopt, epi, dgt, isAlwaysTest);
+            runner.consume(dgt.genome.ref_pprob);
+        }
+    });
+
+    std::vector<BasecallHistogram> histograms;
+    for (const auto& pi : pileups)
+    {
+        histograms.emplace_back(pi.calls);
+    }
+    static const unsigned refGt(0);
+    blt_float_t lhood[DIGT_GRID::HET_RES*2];
+    runner.runMicro("snv.somaticHetGridLhood", fixtureCount, [&]()
+    {
+        for (const auto& histogram : histograms)
+        {
+            get_diploid_het_grid_lhood_cached(histogram, refGt, DIGT_GRID::HET_RES, lhood);
+            runner.consume(static_cast<double>(lhood[0]));
+        }
+    });
+}
+
+
+
+/// \brief Run the germline indel allele group genotype likelihood kernel over synthetic read path scores
+///
+/// \param[in] alleleCount Number of overlapping alternate indel alleles at each locus
+static
+void
+runIndelLikelihoodBenchmark(
+    BenchmarkRunner& runner,
+    const unsigned alleleCount)
+{
+    const std::string name(alleleCount > 1 ? "indel.germlineGenotypeLhood.multiAllelic" :
+                           "indel.germlineGenotypeLhood.biAllelic");
+    if (! runner.isSelected(name)) return;
+
+    const BenchmarkOptions& opt(runner.getOptions());
+    std::mt19937 rng(opt.seed);
+
+    static const unsigned fixtureCount(64);
+    static const unsigned locusSpacing(50);
+
+    const starling_base_options_test sopt;
+    const starling_base_deriv_options dopt(sopt);
+    const starling_sample_options sampleOpt(sopt);
+    reference_contig_segment ref;
+    ref.seq() = getRandomSequence((fixtureCount+1)*locusSpacing, rng);
+
+    static const unsigned sampleIndex(0);
+    IndelBuffer indelBuffer(sopt, dopt, ref);
+    depth_buffer depthBuffer;
+    depth_buffer depthBufferTier2;
+    indelBuffer.registerSample(depthBuffer, depthBufferTier2, false);
+    indelBuffer.finalizeSamples();
+
+    // each locus has a deletion and (optionally) an overlapping insertion, supported by reads drawn from the
+    // reference and every alternate allele:
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    std::vector<OrthogonalVariantAlleleCandidateGroup> alleleGroups(fixtureCount);
+    unsigned readId(0);
+    for (unsigned fixtureIndex(0); fixtureIndex<fixtureCount; ++fixtureIndex)
+    {
+        const pos_t pos((fixtureIndex+1)*locusSpacing);
+        std::vector<IndelKey> keys;
+        keys.emplace_back(pos, INDEL::INDEL, 2);
+        if (alleleCount > 1) keys.emplace_back(pos, INDEL::INDEL, 0, "AT");
+        for (const auto& key : keys)
+        {
+            IndelObservation obs;
+            obs.key = key;
+            obs.data.is_external_candidate = true;
+            indelBuffer.addIndelObservation(sampleIndex, obs);
+            alleleGroups[fixtureIndex].addVariantAllele(indelBuffer.getIndelIter(key));
+        }
+
+        for (unsigned depthIndex(0); depthIndex<opt.depth; ++depthIndex, ++readId)
+        {
+            const unsigned supportedAllele(rng() % (keys.size()+1));
+            const bool isFwdStrand(unitDist(rng) < 0.5);
+            for (unsigned keyIndex(0); keyIndex<keys.size(); ++keyIndex)
+            {
+                const float goodScore(-1.f - static_cast<float>(unitDist(rng)));
+                const float badScore(-20.f - static_cast<float>(10*unitDist(rng)));
+                const float refScore((supportedAllele == 0) ? goodScore : badScore);
+                const float indelScore((supportedAllele == (keyIndex+1)) ? goodScore : badScore);
+                ReadPathScores score(refScore, indelScore, opt.readLength, opt.readLength, true, isFwdStrand,
+                                     opt.readLength/2, opt.readLength/2);
+                IndelSampleData& indelSampleData(getIndelData(indelBuffer.getIndelIter(keys[keyIndex])).getSampleData(sampleIndex));
+                indelSampleData.read_path_lnp[readId] = score;
+            }
+        }
+    }
+
+    static const unsigned callerPloidy(2);
+    const OrthogonalVariantAlleleCandidateGroup emptyContrastGroup;
+    std::vector<double> genotypeLogLhood;
+    runner.runMicro(name, fixtureCount, [&]()
+    {
+        for (const auto& alleleGroup : alleleGroups)
+        {
+            LocusSupportingReadStats locusReadStats;
+            getVariantAlleleGroupGenotypeLhoodsForSample(sopt, dopt, sampleOpt, callerPloidy, sampleIndex,
+                                                         alleleGroup, emptyContrastGroup, genotypeLogLhood,
+                                                         locusReadStats);
+            runner.consume(genotypeLogLhood.front());
+        }
+    });
+}
+
+
+
+void
+runLikelihoodBenchmarks(BenchmarkRunner& runner)
+{
+    runSnvLikelihoodBenchmarks(runner);
+    runIndelLikelihoodBenchmark(runner, 1);
+    runIndelLikelihoodBenchmark(runner, 2);
+}
@@ -0,0 +1,85 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Pileup buffer insertion micro benchmark
+///
+
+#include "Benchmarks.hh"
+#include "SyntheticData.hh"
+
+#include "starling_common/pos_basecall_buffer.hh"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+
+
+void
+runPileupBenchmarks(BenchmarkRunner& runner)
+{
+    const BenchmarkOptions& opt(runner.getOptions());
+    std::mt19937 rng(opt.seed);
+
+    static const unsigned regionSize(10000);
+    reference_contig_segment ref;
+    ref.seq() = getRandomSequence(regionSize + opt.readLength, rng);
+
+    // reads are tiled along the region in position order, as they would arrive from a sorted alignment file:
+    const unsigned readCount(std::max(1u, (regionSize*opt.depth)/opt.readLength));
+    std::vector<pos_t> readStarts(readCount);
+    for (unsigned readIndex(0); readIndex<readCount; ++readIndex)
+    {
+        readStarts[readIndex] = (static_cast<uint64_t>(readIndex)*regionSize)/readCount;
+    }
+
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    std::vector<base_call> calls;
+    calls.reserve(readCount*opt.readLength);
+    for (unsigned readIndex(0); readIndex<readCount; ++readIndex)
+    {
+        const bool isFwdStrand(unitDist(rng) < 0.5);
+        for (unsigned readPos(0); readPos<opt.readLength; ++readPos)
+        {
+            const uint8_t baseId(base_to_id(ref.get_base(readStarts[readIndex]+readPos)));
+            calls.emplace_back(baseId, getRandomQuality(rng), isFwdStrand, readPos, opt.readLength, false, false,
+                               false);
+        }
+    }
+
+    static const uint8_t mapq(60);
+    runner.runMicro("pileup.insertBasecall", calls.size(), [&]()
+    {
+        pos_basecall_buffer buffer(ref);
+        for (unsigned readIndex(0); readIndex<readCount; ++readIndex)
+        {
+            const pos_t readStart(readStarts[readIndex]);
+            buffer.clear_to_pos(readStart-1);
+            const base_call* readCalls(calls.data() + readIndex*opt.readLength);
+            for (unsigned readPos(0); readPos<opt.readLength; ++readPos)
+            {
+                snp_pos_info& posdata(buffer.getPosRef(readStart+readPos));
+                pos_basecall_buffer::insert_pos_basecall(posdata, true, readCalls[readPos]);
+                pos_basecall_buffer::insert_mapq_count(posdata, mapq);
+            }
+        }
+        runner.consume(static_cast<uint64_t>(buffer.getAllocationStats().slabAllocations));
+    });
+}
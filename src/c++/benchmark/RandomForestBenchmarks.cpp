@@ -0,0 +1,133 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief RandomForestModel micro benchmarks
+///
+
+#include "Benchmarks.hh"
+
+#include "calibration/RandomForestModel.hh"
+#include "common/Exceptions.hh"
+
+#include <random>
+#include <sstream>
+#include <vector>
+
+
+
+/// append a random tree of up to the given depth to a json model stream
+static
+void
+writeRandomTree(
+    const unsigned featureCount,
+    const unsigned maxDepth,
+    std::mt19937& rng,
+    std::ostream& os)
+{
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    std::ostringstream treeOss, decisionOss, voteOss;
+
+    // build the tree breadth first, so that every child index is greater than its parent's:
+    std::vector<unsigned> nodeDepth = {0};
+    for (unsigned nodeIndex(0); nodeIndex<nodeDepth.size(); ++nodeIndex)
+    {
+        const char* sep((nodeIndex==0) ? "" : ",");
+        const bool isLeaf((nodeDepth[nodeIndex] == maxDepth) || ((nodeDepth[nodeIndex] > 2) && (unitDist(rng) < 0.2)));
+        if (isLeaf)
+        {
+            treeOss << sep << "\"" << nodeIndex << "\": [-1,-1]";
+            voteOss << (voteOss.tellp() == 0 ? "" : ",") << "\"" << nodeIndex << "\": ["
+                    << static_cast<int>(unitDist(rng)*100) << "," << (1+static_cast<int>(unitDist(rng)*100)) << "]";
+        }
+        else
+        {
+            const unsigned childIndex(nodeDepth.size());
+            nodeDepth.push_back(nodeDepth[nodeIndex]+1);
+            nodeDepth.push_back(nodeDepth[nodeIndex]+1);
+            treeOss << sep << "\"" << nodeIndex << "\": [" << childIndex << "," << (childIndex+1) << "]";
+            decisionOss << (decisionOss.tellp() == 0 ? "" : ",") << "\"" << nodeIndex << "\": ["
+                        << (rng() % featureCount) << "," << unitDist(rng) << "]";
+        }
+    }
+
+    os << "{\"tree\": {" << treeOss.str() << "}, \"decisions\": {" << decisionOss.str()
+       << "}, \"node_votes\": {" << voteOss.str() << "}}";
+}
+
+
+
+void
+runRandomForestBenchmarks(BenchmarkRunner& runner)
+{
+    const BenchmarkOptions& opt(runner.getOptions());
+    std::mt19937 rng(opt.seed);
+
+    // forest shape approximates the bundled somatic and germline scoring models:
+    static const unsigned featureCount(20);
+    static const unsigned treeCount(100);
+    static const unsigned maxTreeDepth(10);
+    static const unsigned batchSize(64);
+
+    std::ostringstream modelOss;
+    modelOss << "{\"Model\": [";
+    for (unsigned treeIndex(0); treeIndex<treeCount; ++treeIndex)
+    {
+        if (treeIndex > 0) modelOss << ",";
+        writeRandomTree(featureCount, maxTreeDepth, rng, modelOss);
+    }
+    modelOss << "]}";
+
+    rapidjson::Document document;
+    document.Parse(modelOss.str().c_str());
+    if (document.HasParseError())
+    {
+        using namespace illumina::common;
+        BOOST_THROW_EXCEPTION(GeneralException("Failed to parse synthetic random forest model"));
+    }
+    RandomForestModel model;
+    model.Deserialize(featureCount, document);
+
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    std::vector<VariantScoringModelBase::featureInput_t> featureArrays(batchSize);
+    VariantScoringModelBase::featureInputBatch_t featureBatch;
+    for (auto& features : featureArrays)
+    {
+        for (unsigned featureIndex(0); featureIndex<featureCount; ++featureIndex)
+        {
+            features.push_back(unitDist(rng));
+        }
+        featureBatch.push_back(&features);
+    }
+
+    runner.runMicro("RandomForestModel.getProb", batchSize, [&]()
+    {
+        for (const auto& features : featureArrays)
+        {
+            runner.consume(model.getProb(features));
+        }
+    });
+
+    std::vector<double> probs(batchSize);
+    runner.runMicro("RandomForestModel.getProbBatch", batchSize, [&]()
+    {
+        model.getProbBatch(featureBatch.data(), batchSize, probs.data());
+        runner.consume(probs.front());
+    });
+}
@@ -0,0 +1,149 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Benchmark suite for the variant calling hot paths
+///
+
+#include "StrelkaBenchmarks.hh"
+#include "Benchmarks.hh"
+#include "benchmarkConfig.h"
+
+#include "blt_util/log.hh"
+#include "common/ProgramUtil.hh"
+
+#include "boost/program_options.hpp"
+
+#include <iostream>
+
+
+
+static
+void
+usage(
+    std::ostream& os,
+    const illumina::Program& prog,
+    const boost::program_options::options_description& visible,
+    const char* msg = nullptr)
+{
+    usage(os, prog, visible, "Run micro benchmarks of the variant calling hot paths and end-to-end benchmarks of "
+          "each pipeline stage on the bundled demo data", "", msg);
+}
+
+
+
+static
+void
+parseBenchmarkOptions(
+    const illumina::Program& prog,
+    int argc,
+    char** argv,
+    BenchmarkOptions& opt)
+{
+    opt.demoDataDir = BENCHMARK_DEMO_DATA_PATH;
+
+    namespace po = boost::program_options;
+    po::options_description req("configuration");
+
+    req.add_options()
+    ("filter", po::value(&opt.filter),
+     "only run benchmarks with names containing this string")
+    ("min-seconds", po::value(&opt.minSeconds)->default_value(opt.minSeconds),
+     "minimum timed duration of each micro benchmark")
+    ("depth", po::value(&opt.depth)->default_value(opt.depth),
+     "read depth of synthetic fixtures")
+    ("read-length", po::value(&opt.readLength)->default_value(opt.readLength),
+     "read length of synthetic fixtures")
+    ("indel-density", po::value(&opt.indelDensity)->default_value(opt.indelDensity),
+     "fraction of synthetic reads and haplotypes containing an indel")
+    ("seed", po::value(&opt.seed)->default_value(opt.seed),
+     "random seed for synthetic fixtures")
+    ("demo-data-dir", po::value(&opt.demoDataDir)->default_value(opt.demoDataDir),
+     "directory containing the demo data used for end-to-end benchmarks")
+    ("demo-iterations", po::value(&opt.demoIterations)->default_value(opt.demoIterations),
+     "number of runs of each end-to-end benchmark stage")
+    ("skip-micro", po::bool_switch(&opt.isSkipMicro),
+     "skip micro benchmarks")
+    ("skip-demo", po::bool_switch(&opt.isSkipDemo),
+     "skip end-to-end benchmarks")
+    ;
+
+    po::options_description help("help");
+    help.add_options()
+    ("help,h","print this message");
+
+    po::options_description visible("options");
+    visible.add(req).add(help);
+
+    bool po_parse_fail(false);
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, visible,
+                                         po::command_line_style::unix_style ^ po::command_line_style::allow_short), vm);
+        po::notify(vm);
+    }
+    catch (const boost::program_options::error& e)
+    {
+        log_os << "\nERROR: Exception thrown by option parser: " << e.what() << "\n";
+        po_parse_fail=true;
+    }
+
+    if ((vm.count("help")) || po_parse_fail)
+    {
+        usage(log_os,prog,visible);
+    }
+
+    if (opt.minSeconds < 0.)
+    {
+        usage(log_os,prog,visible, "min-seconds must be non-negative");
+    }
+    if ((opt.depth == 0) || (opt.readLength == 0))
+    {
+        usage(log_os,prog,visible, "depth and read-length must be positive");
+    }
+    if ((opt.indelDensity < 0.) || (opt.indelDensity > 1.))
+    {
+        usage(log_os,prog,visible, "indel-density must be in the range [0,1]");
+    }
+}
+
+
+
+void
+StrelkaBenchmarks::
+runInternal(int argc, char* argv[]) const
+{
+    BenchmarkOptions opt;
+    parseBenchmarkOptions(*this, argc, argv, opt);
+
+    BenchmarkRunner runner(opt, std::cout);
+    if (! opt.isSkipMicro)
+    {
+        runAlignerBenchmarks(runner);
+        runAssemblerBenchmarks(runner);
+        runRandomForestBenchmarks(runner);
+        runLikelihoodBenchmarks(runner);
+        runPileupBenchmarks(runner);
+    }
+    if (! opt.isSkipDemo)
+    {
+        runDemoDataBenchmarks(runner);
+    }
+}
@@ -0,0 +1,161 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Synthetic sequence and read fixtures for the micro benchmarks
+///
+
+#include "SyntheticData.hh"
+
+#include <cassert>
+
+#include <algorithm>
+
+
+static const char baseSymbols[] = "ACGT";
+
+
+
+std::string
+getRandomSequence(
+    const unsigned length,
+    std::mt19937& rng)
+{
+    std::uniform_int_distribution<unsigned> baseDist(0,3);
+    std::string seq(length, 'N');
+    for (auto& base : seq)
+    {
+        base = baseSymbols[baseDist(rng)];
+    }
+    return seq;
+}
+
+
+
+std::string
+getRepeatRichSequence(
+    const unsigned length,
+    std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    std::uniform_int_distribution<unsigned> unitLengthDist(1,4);
+    std::uniform_int_distribution<unsigned> repeatCountDist(3,10);
+    std::uniform_int_distribution<unsigned> uniqueLengthDist(10,60);
+
+    std::string seq;
+    while (seq.size() < length)
+    {
+        if (unitDist(rng) < 0.3)
+        {
+            const std::string unit(getRandomSequence(unitLengthDist(rng), rng));
+            const unsigned repeatCount(repeatCountDist(rng));
+            for (unsigned repeatIndex(0); repeatIndex<repeatCount; ++repeatIndex) seq += unit;
+        }
+        else
+        {
+            seq += getRandomSequence(uniqueLengthDist(rng), rng);
+        }
+    }
+    seq.resize(length);
+    return seq;
+}
+
+
+
+void
+addRandomIndel(
+    std::string& seq,
+    std::mt19937& rng)
+{
+    static const unsigned edgeSize(10);
+    static const unsigned maxIndelSize(8);
+    assert(seq.size() > (2*edgeSize+maxIndelSize));
+
+    std::uniform_int_distribution<unsigned> posDist(edgeSize, seq.size()-(edgeSize+maxIndelSize));
+    std::uniform_int_distribution<unsigned> sizeDist(1, maxIndelSize);
+    const unsigned pos(posDist(rng));
+    const unsigned size(sizeDist(rng));
+    if (rng() % 2)
+    {
+        seq.insert(pos, getRandomSequence(size, rng));
+    }
+    else
+    {
+        seq.erase(pos, size);
+    }
+}
+
+
+
+void
+addBaseErrors(
+    const double errorRate,
+    std::string& seq,
+    std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    std::uniform_int_distribution<unsigned> shiftDist(1,3);
+    for (auto& base : seq)
+    {
+        if (unitDist(rng) >= errorRate) continue;
+        const char* const basePtr(std::find(baseSymbols, baseSymbols+4, base));
+        const unsigned baseIndex(basePtr - baseSymbols);
+        base = baseSymbols[(baseIndex + shiftDist(rng)) % 4];
+    }
+}
+
+
+
+std::vector<std::string>
+sampleReads(
+    const std::vector<std::string>& haplotypes,
+    const unsigned depth,
+    const unsigned readLength,
+    const double errorRate,
+    std::mt19937& rng)
+{
+    assert(! haplotypes.empty());
+    const unsigned readCount(std::max(1u, (depth*static_cast<unsigned>(haplotypes.front().size()))/readLength));
+
+    std::uniform_int_distribution<unsigned> haplotypeDist(0, haplotypes.size()-1);
+    std::vector<std::string> reads;
+    for (unsigned readIndex(0); readIndex<readCount; ++readIndex)
+    {
+        const std::string& haplotype(haplotypes[haplotypeDist(rng)]);
+        assert(haplotype.size() >= readLength);
+        std::uniform_int_distribution<unsigned> startDist(0, haplotype.size()-readLength);
+        std::string read(haplotype.substr(startDist(rng), readLength));
+        addBaseErrors(errorRate, read, rng);
+        reads.push_back(read);
+    }
+    return reads;
+}
+
+
+
+uint8_t
+getRandomQuality(std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    const double draw(unitDist(rng));
+    if (draw < 0.05) return 2;
+    if (draw < 0.15) return 20;
+    if (draw < 0.35) return 30;
+    return 37;
+}
@@ -0,0 +1,76 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Synthetic sequence and read fixtures for the micro benchmarks
+///
+
+#pragma once
+
+#include <cstdint>
+
+#include <random>
+#include <string>
+#include <vector>
+
+
+/// \return Random sequence of the given length over 'ACGT'
+std::string
+getRandomSequence(
+    const unsigned length,
+    std::mt19937& rng);
+
+/// \return Random sequence built from short tandem repeats and unique sequence, to give assembly and alignment
+///         fixtures a realistic share of ambiguous context
+std::string
+getRepeatRichSequence(
+    const unsigned length,
+    std::mt19937& rng);
+
+/// \brief Add a single 1-8 base insertion or deletion to \p seq at a random position away from either end
+void
+addRandomIndel(
+    std::string& seq,
+    std::mt19937& rng);
+
+/// \brief Substitute each base in \p seq with probability \p errorRate
+void
+addBaseErrors(
+    const double errorRate,
+    std::string& seq,
+    std::mt19937& rng);
+
+/// \brief Sample reads uniformly from a set of haplotypes
+///
+/// \param[in] haplotypes Haplotype sequences, each must be at least \p readLength long. Reads are sampled from
+///                       each haplotype with equal probability.
+/// \param[in] depth Approximate read depth at each position of the first haplotype
+/// \param[in] readLength Length of all reads
+/// \param[in] errorRate Per-base sequencing error rate
+std::vector<std::string>
+sampleReads(
+    const std::vector<std::string>& haplotypes,
+    const unsigned depth,
+    const unsigned readLength,
+    const double errorRate,
+    std::mt19937& rng);
+
+/// \return Random basecall quality in the range typical of current sequencers
+uint8_t
+getRandomQuality(std::mt19937& rng);
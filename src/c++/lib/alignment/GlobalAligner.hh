@@ -23,6 +23,8 @@
 
 #include "SingleRefAlignerShared.hh"
 
+#include <cstdint>
+
 
 /// \brief Implementation of global alignment with affine gap costs
 ///
@@ -34,12 +36,22 @@
 ///
 /// transition from insert to delete is free and allowed, but not reverse
 ///
+/// when built with SSE2 support, alignments are by default computed eight query positions at a time
+/// with 16-bit scores. The scalar implementation is used whenever the scores could exceed the 16-bit
+/// range, and remains the reference which the vector implementation reproduces exactly.
+///
+/// alignBanded() restricts the vector implementation to the diagonals reachable with a bounded indel size,
+/// and falls back to the full alignment whenever the banded result can not be shown to match it.
+///
 template <typename ScoreType>
 struct GlobalAligner : public SingleRefAlignerBase<ScoreType>
 {
+    /// \param isVectorAlign if false, always use the scalar implementation
     GlobalAligner(
-        const AlignmentScores<ScoreType>& scores) :
-        SingleRefAlignerBase<ScoreType>(scores)
+        const AlignmentScores<ScoreType>& scores,
+        const bool isVectorAlign = true) :
+        SingleRefAlignerBase<ScoreType>(scores),
+        _isVectorAlign(isVectorAlign)
     {}
 
     /// returns alignment path of query to reference
@@ -50,8 +62,63 @@ struct GlobalAligner : public SingleRefAlignerBase<ScoreType>
         const SymIter refBegin, const SymIter refEnd,
         AlignmentResult<ScoreType>& result) const;
 
+    /// returns the same alignment path as align(), computing only the cells within \p bandIndelSize
+    /// diagonals of the band spanned by the query/reference length difference
+    ///
+    /// the band only reduces the work done when query and reference lengths are close relative to their size,
+    /// and the full alignment is computed whenever an optimal path could leave the band
+    template <typename SymIter>
+    void
+    alignBanded(
+        const SymIter queryBegin, const SymIter queryEnd,
+        const SymIter refBegin, const SymIter refEnd,
+        const unsigned bandIndelSize,
+        AlignmentResult<ScoreType>& result) const;
+
 private:
 
+    /// scalar reference implementation of align()
+    template <typename SymIter>
+    void
+    alignScalar(
+        const SymIter queryBegin, const SymIter queryEnd,
+        const SymIter refBegin, const SymIter refEnd,
+        AlignmentResult<ScoreType>& result) const;
+
+    /// \return true if all alignment scores of the given query and reference sizes fit in 16 bits,
+    ///         and the scores are otherwise supported by alignVector()
+    bool
+    isVectorAlignSupported(
+        const size_t querySize,
+        const size_t refSize) const;
+
+    /// \return true if the alignment scores allow the optimality test of alignBanded()
+    bool
+    isBandedAlignSupported() const;
+
+#ifdef __SSE2__
+    /// \return true if alignVector() can be used for this symbol type, query and reference
+    template <typename SymIter>
+    bool
+    isVectorAlign(
+        const size_t querySize,
+        const size_t refSize) const;
+
+    /// SSE2 implementation of align(), producing the same result as alignScalar()
+    ///
+    /// \param isBanded if true, restrict the alignment to the band described in alignBanded()
+    ///
+    /// \return false if a banded alignment can not be shown to be optimal, in which case \p result is undefined
+    template <typename SymIter>
+    bool
+    alignVector(
+        const SymIter queryBegin, const SymIter queryEnd,
+        const SymIter refBegin, const SymIter refEnd,
+        const bool isBanded,
+        const unsigned bandIndelSize,
+        AlignmentResult<ScoreType>& result) const;
+#endif
+
     // insert and delete are for query wrt reference
     struct ScoreVal
     {
@@ -112,11 +179,108 @@ private:
         code_t ins : 2;
     };
 
+    /// back-trace pointers of all three states, packed as 2-bit state codes indexed by AlignState
+    struct PackedPtrVal
+    {
+        AlignState::index_t
+        getStatePtr(const AlignState::index_t i) const
+        {
+            return static_cast<AlignState::index_t>((code >> (2*i)) & 0x3);
+        }
+
+        uint8_t code;
+    };
+
+    /// back-trace matrix of the vector implementation
+    ///
+    /// pointers are stored reference-major, so that each reference position is written to a contiguous
+    /// block of query positions. Only the query range computed at each reference position is stored,
+    /// and each range is padded to allow full register writes past its end.
+    struct PackedPtrMatrix
+    {
+        void
+        clear()
+        {
+            _refOffset.clear();
+            _refRowBegin.clear();
+            _size = 0;
+        }
+
+        /// add storage for query positions [rowBegin,rowEnd) of the next reference position
+        void
+        addRefColumn(
+            const unsigned rowBegin,
+            const unsigned rowEnd)
+        {
+            assert(rowBegin <= rowEnd);
+            _refOffset.push_back(_size);
+            _refRowBegin.push_back(rowBegin);
+            _size += (rowEnd-rowBegin);
+        }
+
+        /// allocate storage after all reference positions have been added
+        void
+        allocate()
+        {
+            if (_data.size() < _size) _data.resize(_size);
+        }
+
+        const PackedPtrVal&
+        val(const unsigned queryIndex,
+            const unsigned refIndex) const
+        {
+            assert(queryIndex >= _refRowBegin[refIndex]);
+            return _data[_refOffset[refIndex] + (queryIndex-_refRowBegin[refIndex])];
+        }
+
+        /// \return pointer values at \p refIndex, indexed by query position minus getRowBegin(refIndex)
+        PackedPtrVal*
+        getRefColumn(const unsigned refIndex)
+        {
+            return _data.data() + _refOffset[refIndex];
+        }
+
+        unsigned
+        getRowBegin(const unsigned refIndex) const
+        {
+            return _refRowBegin[refIndex];
+        }
+
+    private:
+        std::vector<unsigned> _refOffset;
+        std::vector<unsigned> _refRowBegin;
+        unsigned _size = 0;
+        std::vector<PackedPtrVal> _data;
+    };
+
+    /// scores of all query positions for one reference position in the vector implementation
+    struct VectorScoreColumn
+    {
+        void
+        resize(const unsigned size)
+        {
+            match.resize(size);
+            del.resize(size);
+            ins.resize(size);
+        }
+
+        std::vector<int16_t> match;
+        std::vector<int16_t> del;
+        std::vector<int16_t> ins;
+    };
+
+    const bool _isVectorAlign;
+
     // add the matrices here to reduce allocations over many alignment calls:
     typedef std::vector<ScoreVal> ScoreVec;
     mutable ScoreVec _score1;
     mutable ScoreVec _score2;
     mutable basic_matrix<PtrVal> _ptrMat;
+
+    mutable VectorScoreColumn _vectorScore1;
+    mutable VectorScoreColumn _vectorScore2;
+    mutable std::vector<int16_t> _vectorQuery;
+    mutable PackedPtrMatrix _packedPtrMat;
 };
 
 
@@ -20,7 +20,13 @@
 /// derived from ELAND implementation by Tony Cox
 
 
+#include "alignment/VectorAlignerUtil.hh"
+
 #include <cassert>
+#include <cstdlib>
+
+#include <algorithm>
+#include <type_traits>
 
 #ifdef DEBUG_ALN
 #include "blt_util/log.hh"
@@ -37,6 +43,51 @@ align(
     const SymIter queryBegin, const SymIter queryEnd,
     const SymIter refBegin, const SymIter refEnd,
     AlignmentResult<ScoreType>& result) const
+{
+#ifdef __SSE2__
+    if (isVectorAlign<SymIter>(std::distance(queryBegin, queryEnd), std::distance(refBegin, refEnd)))
+    {
+        alignVector(queryBegin, queryEnd, refBegin, refEnd, false, 0, result);
+        return;
+    }
+#endif
+
+    alignScalar(queryBegin, queryEnd, refBegin, refEnd, result);
+}
+
+
+
+template <typename ScoreType>
+template <typename SymIter>
+void
+GlobalAligner<ScoreType>::
+alignBanded(
+    const SymIter queryBegin, const SymIter queryEnd,
+    const SymIter refBegin, const SymIter refEnd,
+    const unsigned bandIndelSize,
+    AlignmentResult<ScoreType>& result) const
+{
+#ifdef __SSE2__
+    if (isBandedAlignSupported() &&
+        isVectorAlign<SymIter>(std::distance(queryBegin, queryEnd), std::distance(refBegin, refEnd)))
+    {
+        if (alignVector(queryBegin, queryEnd, refBegin, refEnd, true, bandIndelSize, result)) return;
+    }
+#endif
+
+    align(queryBegin, queryEnd, refBegin, refEnd, result);
+}
+
+
+
+template <typename ScoreType>
+template <typename SymIter>
+void
+GlobalAligner<ScoreType>::
+alignScalar(
+    const SymIter queryBegin, const SymIter queryEnd,
+    const SymIter refBegin, const SymIter refEnd,
+    AlignmentResult<ScoreType>& result) const
 {
     result.clear();
 
@@ -226,3 +277,372 @@ align(
         btrace, result);
 }
 
+
+
+template <typename ScoreType>
+bool
+GlobalAligner<ScoreType>::
+isVectorAlignSupported(
+    const size_t querySize,
+    const size_t refSize) const
+{
+    const AlignmentScores<ScoreType>& scores(this->getScores());
+
+    // the insert state scan assumes gap extension never increases the score:
+    if (scores.extend > 0) return false;
+
+    // bound the magnitude of every score which can propagate through the matrix: each value starts from a
+    // boundary value, and each step along the path to a cell changes it by at most maxStep
+    //
+    // the leading soft-clip scores of the first reference position are excluded, see alignVector()
+    const int64_t open(std::abs(static_cast<int64_t>(scores.open)));
+    const int64_t extend(std::abs(static_cast<int64_t>(scores.extend)));
+    const int64_t maxPathLength(querySize+refSize+1);
+    const int64_t maxStep(std::max(std::abs(static_cast<int64_t>(scores.match)), std::abs(static_cast<int64_t>(scores.mismatch))) +
+                          open + extend + std::abs(static_cast<int64_t>(scores.insertDelete)));
+    const int64_t maxBoundaryValue(std::max(static_cast<int64_t>(10000), open+(extend*maxPathLength)));
+    if (open >= 10000) return false;
+
+    static const int64_t maxVectorScore(32000);
+    return ((maxBoundaryValue + (maxStep*(maxPathLength+1))) <= maxVectorScore);
+}
+
+
+
+template <typename ScoreType>
+bool
+GlobalAligner<ScoreType>::
+isBandedAlignSupported() const
+{
+    // the optimality test of a banded alignment requires that the match score is the only way to increase
+    // the score along a path, and that every change of diagonal has a cost:
+    const AlignmentScores<ScoreType>& scores(this->getScores());
+    if (not scores.isRequireEdgeDeletion) return false;
+    if ((scores.open > 0) || (scores.extend >= 0) || (scores.offEdge >= 0) || (scores.insertDelete > 0)) return false;
+    return (scores.mismatch <= std::max(scores.match, static_cast<ScoreType>(0)));
+}
+
+
+
+#ifdef __SSE2__
+template <typename ScoreType>
+template <typename SymIter>
+bool
+GlobalAligner<ScoreType>::
+isVectorAlign(
+    const size_t querySize,
+    const size_t refSize) const
+{
+    typedef typename std::iterator_traits<SymIter>::value_type sym_t;
+    static const bool isVectorType(std::is_integral<ScoreType>::value && std::is_signed<ScoreType>::value &&
+                                   std::is_integral<sym_t>::value && (sizeof(sym_t) == 1));
+
+    return (isVectorType && _isVectorAlign && isVectorAlignSupported(querySize, refSize));
+}
+
+
+
+template <typename ScoreType>
+template <typename SymIter>
+bool
+GlobalAligner<ScoreType>::
+alignVector(
+    const SymIter queryBegin, const SymIter queryEnd,
+    const SymIter refBegin, const SymIter refEnd,
+    const bool isBanded,
+    const unsigned bandIndelSize,
+    AlignmentResult<ScoreType>& result) const
+{
+    // This follows alignScalar() cell by cell. The match and delete states of each reference position only
+    // depend on the previous reference position, and are computed for eight query positions at a time. The
+    // insert state depends on the previous query position, and is solved within each register with a max-plus
+    // scan. All intermediate scores are known to fit in 16 bits, so the results are identical.
+    //
+    // In banded mode, only the query blocks overlapping the band are computed at each reference position.
+    // Scores just outside of the computed blocks are set to outOfBandVal, and the result is checked for
+    // optimality at the end.
+    //
+    typedef VectorAlignerUtil vau;
+    static const unsigned laneCount(VectorAlignerUtil::laneCount);
+
+    result.clear();
+
+    const AlignmentScores<ScoreType>& scores(this->getScores());
+
+    const size_t querySize(std::distance(queryBegin, queryEnd));
+    const size_t refSize(std::distance(refBegin, refEnd));
+
+    assert(0 != querySize);
+    assert(0 != refSize);
+
+    // storage is padded so that full registers can be read and written one past each query position:
+    const unsigned queryVectorSize(((querySize+laneCount-1)/laneCount)*laneCount);
+    const unsigned columnSize(queryVectorSize+laneCount);
+
+    // range of diagonals (query position minus reference position) included in the band:
+    const int sizeDiff(static_cast<int>(querySize) - static_cast<int>(refSize));
+    int minDiagonal(-static_cast<int>(refSize));
+    int maxDiagonal(querySize);
+    if (isBanded)
+    {
+        minDiagonal = std::max(minDiagonal, std::min(0, sizeDiff) - static_cast<int>(bandIndelSize));
+        maxDiagonal = std::min(maxDiagonal, std::max(0, sizeDiff) + static_cast<int>(bandIndelSize));
+    }
+
+    // query register blocks [blockBegin,blockEnd) covering the band at reference position refPos, where
+    // block i covers query positions [i*laneCount+1,(i+1)*laneCount]:
+    auto getBlockRange = [&](
+                             const unsigned refPos,
+                             unsigned& blockBegin,
+                             unsigned& blockEnd)
+    {
+        const int rowBegin(std::max(0, static_cast<int>(refPos) + minDiagonal));
+        const int rowEnd(std::min(static_cast<int>(querySize), static_cast<int>(refPos) + maxDiagonal));
+        blockBegin = ((rowBegin == 0) ? 0 : ((rowBegin-1)/laneCount));
+        blockEnd = ((rowEnd-1)/laneCount)+1;
+    };
+
+    // the first reference position stores pointers for its band only, all others for their full blocks:
+    const unsigned headRowEnd(std::min(static_cast<int>(querySize), maxDiagonal));
+    _packedPtrMat.clear();
+    _packedPtrMat.addRefColumn(0, headRowEnd+1);
+    for (unsigned refPos(1); refPos<=refSize; ++refPos)
+    {
+        unsigned blockBegin, blockEnd;
+        getBlockRange(refPos, blockBegin, blockEnd);
+        _packedPtrMat.addRefColumn(((blockBegin == 0) ? 0 : (blockBegin*laneCount+1)), (blockEnd*laneCount+1));
+    }
+    _packedPtrMat.allocate();
+
+    _vectorScore1.resize(columnSize);
+    _vectorScore2.resize(columnSize);
+
+    _vectorQuery.resize(columnSize);
+    std::copy(queryBegin, queryEnd, _vectorQuery.begin());
+
+    VectorScoreColumn* thisSV(&_vectorScore1);
+    VectorScoreColumn* prevSV(&_vectorScore2);
+
+    static const int16_t badVal(-10000);
+
+    // leading soft-clip scores at the first reference position are only compared against badVal in the
+    // match and delete states, so they can be clamped to any floor below badVal+open without changing
+    // the result:
+    static const int16_t softClipFloor(-20000);
+
+    // score of all states outside of the computed blocks in banded mode:
+    static const int16_t outOfBandVal(-30000);
+
+    if (isBanded)
+    {
+        for (VectorScoreColumn* sv : { thisSV, prevSV })
+        {
+            std::fill(sv->match.begin(), sv->match.end(), outOfBandVal);
+            std::fill(sv->del.begin(), sv->del.end(), outOfBandVal);
+            std::fill(sv->ins.begin(), sv->ins.end(), outOfBandVal);
+        }
+    }
+
+    const int16_t open(scores.open);
+    const int16_t extend(scores.extend);
+
+    auto packPtr = [](
+                       const AlignState::index_t matchPtr,
+                       const AlignState::index_t delPtr,
+                       const AlignState::index_t insPtr)
+    {
+        return static_cast<uint8_t>(matchPtr | (delPtr << 2) | (insPtr << 4));
+    };
+
+    // global alignment of query, see alignScalar() for boundary conditions
+    {
+        PackedPtrVal* headPtr(_packedPtrMat.getRefColumn(0));
+        const AlignState::index_t insPtr(scores.isAllowEdgeInsertion ? AlignState::INSERT : AlignState::MATCH);
+        for (unsigned queryIndex(0); queryIndex<=headRowEnd; queryIndex++)
+        {
+            headPtr[queryIndex].code = packPtr(AlignState::MATCH, AlignState::MATCH, insPtr);
+            const ScoreType softClipScore(queryIndex * scores.offEdge);
+            thisSV->match[queryIndex] = std::max(softClipScore, static_cast<ScoreType>(softClipFloor));
+            thisSV->del[queryIndex] = badVal;
+            thisSV->ins[queryIndex] = (scores.isAllowEdgeInsertion ? (scores.open + (queryIndex * scores.extend)) : badVal);
+        }
+    }
+
+    const __m128i matchVec(_mm_set1_epi16(scores.match));
+    const __m128i mismatchVec(_mm_set1_epi16(scores.mismatch));
+    const __m128i openVec(_mm_set1_epi16(open));
+    const __m128i extendVec(_mm_set1_epi16(extend));
+    const __m128i insertDeleteVec(_mm_set1_epi16(scores.insertDelete));
+    const __m128i badVec(_mm_set1_epi16(badVal));
+    const __m128i extendMultiples(_mm_setr_epi16(extend, 2*extend, 3*extend, 4*extend,
+                                                 5*extend, 6*extend, 7*extend, 8*extend));
+
+    BackTrace<ScoreType> btrace;
+
+    {
+        unsigned refIndex(0);
+        for (SymIter refIter(refBegin); refIter != refEnd; ++refIter, ++refIndex)
+        {
+            std::swap(thisSV,prevSV);
+
+            unsigned blockBegin, blockEnd;
+            getBlockRange(refIndex+1, blockBegin, blockEnd);
+            const unsigned blockQueryBegin(blockBegin*laneCount);
+            const unsigned blockQueryEnd(blockEnd*laneCount);
+
+            PackedPtrVal* columnPtr(_packedPtrMat.getRefColumn(refIndex+1));
+            const unsigned columnRowBegin(_packedPtrMat.getRowBegin(refIndex+1));
+
+            if (0 == blockBegin)
+            {
+                // control start from delete state with flag
+                if (not scores.isRequireEdgeDeletion)
+                {
+                    columnPtr[0].code = packPtr(AlignState::MATCH, AlignState::MATCH, AlignState::MATCH);
+                    thisSV->match[0] = 0;
+                    thisSV->del[0] = badVal;
+                }
+                else
+                {
+                    columnPtr[0].code = packPtr(AlignState::MATCH, AlignState::DELETE, AlignState::MATCH);
+                    thisSV->match[0] = badVal;
+                    thisSV->del[0] = scores.open + ((refIndex+1) * scores.extend);
+                }
+                thisSV->ins[0] = badVal;
+            }
+            else
+            {
+                // the query position below the first block is outside of the band, it is read by the insert
+                // state scan here and by the match state of the next reference position:
+                thisSV->match[blockQueryBegin] = outOfBandVal;
+                thisSV->del[blockQueryBegin] = outOfBandVal;
+                thisSV->ins[blockQueryBegin] = outOfBandVal;
+            }
+
+            const __m128i refVec(_mm_set1_epi16(static_cast<int16_t>(*refIter)));
+
+            // the highest query position completed so far for the match and insert states:
+            int16_t lastMatch(thisSV->match[blockQueryBegin]);
+            int16_t lastIns(thisSV->ins[blockQueryBegin]);
+
+            for (unsigned queryIndex(blockQueryBegin); queryIndex<blockQueryEnd; queryIndex += laneCount)
+            {
+                // update match
+                __m128i headMatch;
+                __m128i matchPtr;
+                {
+                    const __m128i svalMatch(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&prevSV->match[queryIndex])));
+                    const __m128i svalDel(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&prevSV->del[queryIndex])));
+                    const __m128i svalIns(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&prevSV->ins[queryIndex])));
+                    matchPtr = vau::max3(headMatch, svalMatch, svalDel, svalIns);
+
+                    const __m128i querySym(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&_vectorQuery[queryIndex])));
+                    const __m128i isMatch(_mm_cmpeq_epi16(querySym, refVec));
+                    headMatch = _mm_adds_epi16(headMatch, _mm_or_si128(_mm_and_si128(isMatch, matchVec),
+                                                                       _mm_andnot_si128(isMatch, mismatchVec)));
+                }
+
+                // update delete
+                __m128i headDel;
+                __m128i delPtr;
+                {
+                    const __m128i svalMatch(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&prevSV->match[queryIndex+1])));
+                    const __m128i svalDel(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&prevSV->del[queryIndex+1])));
+                    const __m128i svalIns(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&prevSV->ins[queryIndex+1])));
+                    delPtr = vau::max3(headDel,
+                                       _mm_adds_epi16(svalMatch, openVec),
+                                       svalDel,
+                                       _mm_adds_epi16(svalIns, insertDeleteVec));
+
+                    headDel = _mm_adds_epi16(headDel, extendVec);
+                    if (0==refIndex) headDel = badVec;
+                }
+
+                // update insert
+                __m128i headIns;
+                __m128i insPtr;
+                {
+                    const __m128i svalMatchOpen(_mm_adds_epi16(vau::shiftLanesUp(headMatch, lastMatch), openVec));
+                    __m128i insStart(_mm_adds_epi16(_mm_max_epi16(svalMatchOpen, badVec), extendVec));
+                    if (0==queryIndex) insStart = _mm_insert_epi16(insStart, badVal, 0);
+
+                    headIns = vau::maxPlusScan(insStart, extend, extendMultiples, lastIns);
+
+                    __m128i unused;
+                    insPtr = vau::max3(unused,
+                                       svalMatchOpen,
+                                       badVec,
+                                       vau::shiftLanesUp(headIns, lastIns));
+                }
+
+                lastMatch = vau::getHighLane(headMatch);
+                lastIns = vau::getHighLane(headIns);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&thisSV->match[queryIndex+1]), headMatch);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&thisSV->del[queryIndex+1]), headDel);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&thisSV->ins[queryIndex+1]), headIns);
+
+                const __m128i ptrCode(_mm_or_si128(_mm_or_si128(matchPtr, _mm_slli_epi16(delPtr, 2)),
+                                                   _mm_slli_epi16(insPtr, 4)));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(columnPtr+(queryIndex+1-columnRowBegin)),
+                                 _mm_packus_epi16(ptrCode, _mm_setzero_si128()));
+            }
+
+            // record potential backtrace start point, unless full reference sequence must be explained
+            if (not scores.isRequireEdgeDeletion)
+            {
+                updateBacktrace(static_cast<ScoreType>(thisSV->match[querySize]),refIndex+1,querySize,btrace);
+            }
+        }
+    }
+
+    // optionally require that full reference sequence is explained
+    if (scores.isRequireEdgeDeletion)
+    {
+        updateBacktrace(static_cast<ScoreType>(thisSV->match[querySize]),refSize,querySize,btrace, AlignState::MATCH);
+        updateBacktrace(static_cast<ScoreType>(thisSV->del[querySize]),refSize,querySize,btrace, AlignState::DELETE);
+    }
+
+    // optionally allow for trailing insertion
+    if (scores.isAllowEdgeInsertion)
+    {
+        updateBacktrace(static_cast<ScoreType>(thisSV->ins[querySize]),refSize,querySize,btrace, AlignState::INSERT);
+    }
+
+    // also allow for the case where query falls-off the end of the reference:
+    for (unsigned queryIndex(_packedPtrMat.getRowBegin(refSize)); queryIndex<querySize; queryIndex++)
+    {
+        const ScoreType thisMax(thisSV->match[queryIndex] + (querySize-queryIndex) * scores.offEdge);
+        updateBacktrace(thisMax,refSize,queryIndex,btrace);
+    }
+
+    if (isBanded)
+    {
+        // Only the match score can increase the score along a path, by at most maxMatchScore in total. Any path
+        // leaving the band shifts across at least (2*(bandIndelSize+1) + |sizeDiff|) diagonals, each costing at
+        // least minShiftCost. Any score derived from outOfBandVal, softClipFloor or badVal is at most
+        // badVal+maxMatchScore.
+        //
+        // If the banded optimum exceeds both bounds, all optimal paths of the full alignment lie in the band and
+        // every cell on them has the same score and back-trace pointer as in the full alignment, so the result
+        // is identical. Otherwise the caller must fall back to the full alignment.
+        //
+        const int64_t maxMatchScore(std::max(static_cast<int64_t>(scores.match), static_cast<int64_t>(0)) *
+                                    std::min(querySize, refSize));
+        const int64_t minShiftCost(std::min(-static_cast<int64_t>(scores.extend), -static_cast<int64_t>(scores.offEdge)));
+        const int64_t minShiftCount((2*(static_cast<int64_t>(bandIndelSize)+1)) + std::abs(sizeDiff));
+        const int64_t maxOutOfBandScore(maxMatchScore - (minShiftCost*minShiftCount));
+        const int64_t bestScore(btrace.max);
+        if ((maxOutOfBandScore >= bestScore) || ((badVal + (2*maxMatchScore)) >= bestScore)) return false;
+    }
+
+    this->backTraceAlignment(
+        queryBegin, queryEnd,
+        refBegin, refEnd,
+        querySize, refSize,
+        _packedPtrMat,
+        btrace, result);
+
+    return true;
+}
+#endif
@@ -0,0 +1,103 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief SSE2 helpers for aligners working on eight 16-bit scores per register
+///
+
+#pragma once
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+#include <cstdint>
+
+
+struct VectorAlignerUtil
+{
+    /// number of 16-bit scores held in one register
+    static const unsigned laneCount = 8;
+
+    /// lane-wise equivalent of AlignerBase::max3
+    ///
+    /// sets max to the maximum of the three values, and returns the index of the first maximum
+    /// value in each lane, matching the tie-breaking of the scalar version
+    static
+    __m128i
+    max3(
+        __m128i& max,
+        const __m128i v0,
+        const __m128i v1,
+        const __m128i v2)
+    {
+        const __m128i isV1(_mm_cmpgt_epi16(v1, v0));
+        max = _mm_max_epi16(v0, v1);
+        const __m128i isV2(_mm_cmpgt_epi16(v2, max));
+        max = _mm_max_epi16(max, v2);
+
+        const __m128i ptr1(_mm_and_si128(isV1, _mm_set1_epi16(1)));
+        return _mm_or_si128(_mm_andnot_si128(isV2, ptr1), _mm_and_si128(isV2, _mm_set1_epi16(2)));
+    }
+
+    /// shift all lanes up by one, so that lane i+1 receives lane i, and set lane 0 to \p lowVal
+    static
+    __m128i
+    shiftLanesUp(
+        const __m128i v,
+        const int16_t lowVal)
+    {
+        return _mm_insert_epi16(_mm_slli_si128(v, 2), lowVal, 0);
+    }
+
+    static
+    int16_t
+    getHighLane(const __m128i v)
+    {
+        return static_cast<int16_t>(_mm_extract_epi16(v, laneCount-1));
+    }
+
+    /// solve the recurrence out[i] = max(in[i], out[i-1] + step) across the lanes of \p in,
+    /// where out[-1] is \p carry
+    ///
+    /// \p stepMultiples must hold step*(i+1) in lane i. All additions saturate, so results
+    /// are exact as long as the true values fit in 16 bits.
+    static
+    __m128i
+    maxPlusScan(
+        const __m128i in,
+        const int16_t step,
+        const __m128i stepMultiples,
+        const int16_t carry)
+    {
+        // lane fill values used when shifting, so that shifted-in lanes never win the max:
+        static const int16_t minVal(-32768);
+        const __m128i fill1(_mm_setr_epi16(minVal, 0, 0, 0, 0, 0, 0, 0));
+        const __m128i fill2(_mm_setr_epi16(minVal, minVal, 0, 0, 0, 0, 0, 0));
+        const __m128i fill4(_mm_setr_epi16(minVal, minVal, minVal, minVal, 0, 0, 0, 0));
+
+        __m128i out(in);
+        out = _mm_max_epi16(out, _mm_adds_epi16(_mm_or_si128(_mm_slli_si128(out, 2), fill1), _mm_set1_epi16(step)));
+        out = _mm_max_epi16(out, _mm_adds_epi16(_mm_or_si128(_mm_slli_si128(out, 4), fill2), _mm_set1_epi16(2*step)));
+        out = _mm_max_epi16(out, _mm_adds_epi16(_mm_or_si128(_mm_slli_si128(out, 8), fill4), _mm_set1_epi16(4*step)));
+        return _mm_max_epi16(out, _mm_adds_epi16(_mm_set1_epi16(carry), stepMultiples));
+    }
+};
+
+#endif
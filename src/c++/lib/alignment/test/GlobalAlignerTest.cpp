@@ -23,6 +23,7 @@
 
 #include "blt_util/align_path.hh"
 
+#include <random>
 #include <string>
 
 
@@ -346,4 +347,137 @@ BOOST_AUTO_TEST_CASE( test_GlobalAlignerNoClipEdgeIndelInsertDelete )
 }
 
 
+// check that the vector implementation exactly reproduces the scalar reference implementation over
+// random sequences, scores and edge options
+//
+BOOST_AUTO_TEST_CASE( test_GlobalAlignerVectorMatchesScalar )
+{
+    std::mt19937 randomGenerator(18);
+    auto getRandom = [&](const int minVal, const int maxVal)
+    {
+        return std::uniform_int_distribution<int>(minVal, maxVal)(randomGenerator);
+    };
+
+    static const std::string alphabet("ACGT");
+    auto getRandomSeq = [&](const unsigned size)
+    {
+        std::string seq;
+        for (unsigned seqIndex(0); seqIndex<size; ++seqIndex)
+        {
+            seq.push_back(alphabet[getRandom(0,3)]);
+        }
+        return seq;
+    };
+
+    auto testRandomAlignment = [&](
+                                   const AlignmentScores<int>& scores,
+                                   const unsigned maxRefSize)
+    {
+        // build the query from a mutated copy of the reference, so that alignments contain indels:
+        const std::string ref(getRandomSeq(getRandom(1,maxRefSize)));
+        std::string query;
+        for (const char refSym : ref)
+        {
+            const int mutation(getRandom(0,9));
+            if (mutation == 0) continue;
+            query.push_back((mutation == 1) ? alphabet[getRandom(0,3)] : refSym);
+            if (mutation == 2) query += getRandomSeq(getRandom(1,4));
+        }
+        if (query.empty() or (getRandom(0,9) == 0)) query = getRandomSeq(getRandom(1,maxRefSize));
+
+        const GlobalAligner<int> scalarAligner(scores, false);
+        const GlobalAligner<int> vectorAligner(scores, true);
+
+        AlignmentResult<int> scalarResult;
+        AlignmentResult<int> vectorResult;
+        scalarAligner.align(query.cbegin(),query.cend(),ref.cbegin(),ref.cend(),scalarResult);
+        vectorAligner.align(query.cbegin(),query.cend(),ref.cbegin(),ref.cend(),vectorResult);
+
+        BOOST_REQUIRE_EQUAL(vectorResult.score, scalarResult.score);
+        BOOST_REQUIRE_EQUAL(vectorResult.align.beginPos, scalarResult.align.beginPos);
+        BOOST_REQUIRE_EQUAL(apath_to_cigar(vectorResult.align.apath), apath_to_cigar(scalarResult.align.apath));
+    };
+
+    for (unsigned testIndex(0); testIndex<2000; ++testIndex)
+    {
+        const AlignmentScores<int> scores(getRandom(0,3), getRandom(-6,0), getRandom(-8,0), getRandom(-3,0),
+                                          getRandom(-10,0), getRandom(-12,0), getRandom(0,1), getRandom(0,1));
+        testRandomAlignment(scores, 60);
+    }
+
+    // haplotype alignment scores, where leading soft-clip scores exceed the 16-bit range:
+    for (unsigned testIndex(0); testIndex<60; ++testIndex)
+    {
+        const AlignmentScores<int> haplotypeScores(1, -4, -5, -1, -100, -5, (testIndex%2), true);
+        testRandomAlignment(haplotypeScores, 400);
+    }
+}
+
+
+// banded alignment of random sequences must match the scalar alignment, including cases where the
+// band is too narrow and the full alignment is required
+BOOST_AUTO_TEST_CASE( test_GlobalAlignerBandedMatchesScalar )
+{
+    std::mt19937 randomGenerator(19);
+    auto getRandom = [&](const int minVal, const int maxVal)
+    {
+        return std::uniform_int_distribution<int>(minVal, maxVal)(randomGenerator);
+    };
+
+    static const std::string alphabet("ACGT");
+    auto getRandomSeq = [&](const unsigned size)
+    {
+        std::string seq;
+        for (unsigned seqIndex(0); seqIndex<size; ++seqIndex)
+        {
+            seq.push_back(alphabet[getRandom(0,3)]);
+        }
+        return seq;
+    };
+
+    auto testRandomAlignment = [&](
+                                   const AlignmentScores<int>& scores,
+                                   const unsigned maxRefSize,
+                                   const unsigned maxIndelSize)
+    {
+        const std::string ref(getRandomSeq(getRandom(1,maxRefSize)));
+        std::string query;
+        for (const char refSym : ref)
+        {
+            const int mutation(getRandom(0,39));
+            if (mutation == 0) continue;
+            query.push_back((mutation <= 3) ? alphabet[getRandom(0,3)] : refSym);
+            if (mutation == 4) query += getRandomSeq(getRandom(1,maxIndelSize));
+        }
+        if (query.empty()) query = getRandomSeq(getRandom(1,maxRefSize));
+
+        const GlobalAligner<int> scalarAligner(scores, false);
+        const GlobalAligner<int> vectorAligner(scores, true);
+
+        AlignmentResult<int> scalarResult;
+        AlignmentResult<int> bandedResult;
+        scalarAligner.align(query.cbegin(),query.cend(),ref.cbegin(),ref.cend(),scalarResult);
+        vectorAligner.alignBanded(query.cbegin(),query.cend(),ref.cbegin(),ref.cend(),getRandom(0,40),bandedResult);
+
+        BOOST_REQUIRE_EQUAL(bandedResult.score, scalarResult.score);
+        BOOST_REQUIRE_EQUAL(bandedResult.align.beginPos, scalarResult.align.beginPos);
+        BOOST_REQUIRE_EQUAL(apath_to_cigar(bandedResult.align.apath), apath_to_cigar(scalarResult.align.apath));
+    };
+
+    for (unsigned testIndex(0); testIndex<2000; ++testIndex)
+    {
+        const AlignmentScores<int> scores(getRandom(0,3), getRandom(-6,0), getRandom(-8,0), getRandom(-3,0),
+                                          getRandom(-10,0), getRandom(-12,0), getRandom(0,1), getRandom(0,3)!=0);
+        testRandomAlignment(scores, 80, 20);
+    }
+
+    for (unsigned testIndex(0); testIndex<200; ++testIndex)
+    {
+        const AlignmentScores<int> haplotypeScores(1, -4, -5, -1, -100, -5, (testIndex%2), true);
+        testRandomAlignment(haplotypeScores, 400, 40);
+    }
+}
+
+
+
 BOOST_AUTO_TEST_SUITE_END()
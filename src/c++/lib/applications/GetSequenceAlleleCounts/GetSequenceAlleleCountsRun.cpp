@@ -29,6 +29,7 @@
 #include "common/Exceptions.hh"
 #include "htsapi/align_path_bam_util.hh"
 #include "htsapi/bam_header_info.hh"
+#include "htsapi/HtsDecodeThreadPool.hh"
 #include "htsapi/vcf_record_util.hh"
 #include "starling_common/HtsMergeStreamerUtil.hh"
 #include "starling_common/ploidy_util.hh"
@@ -106,10 +107,14 @@ getSequenceAlleleCountsRun(
     const SequenceAlleleCountsDerivOptions dopt(opt);
     starling_read_counts readCounts;
     reference_contig_segment ref;
+    const ReferenceStore referenceStore(opt.referenceFilename, opt.isUsePackedReference);
 
     ////////////////////////////////////////
     // setup streamData:
     //
+    // the decode thread pool is shared by all input alignment streams, so it must be created before any of them:
+    const std::unique_ptr<HtsDecodeThreadPool> decodeThreadPool(
+        createHtsDecodeThreadPool(opt.alignFileOpt.decodeThreadCount));
     HtsMergeStreamer streamData(opt.referenceFilename);
 
     // additional data structures required in the region loop below, which are filled in as a side effect of
@@ -123,7 +128,9 @@ getSequenceAlleleCountsRun(
             oss << "WARNING: Multiple bam file inputs. Will be treated as single sample (with sampleName: " << opt.alignFileOpt.alignmentFilenames[0] << ")\n";
         }
         std::vector<unsigned> registrationIndices(opt.alignFileOpt.alignmentFilenames.size(), 0);
-        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilenames, registrationIndices, streamData);
+        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilenames, registrationIndices, streamData,
+                                        decodeThreadPool.get(), opt.alignFileOpt.readAheadRecordCount,
+                                        getInputAlignmentFilterSpec(opt));
 
         assert(! bamHeaders.empty());
         const bam_hdr_t& referenceHeader(bamHeaders.front());
@@ -164,7 +171,7 @@ getSequenceAlleleCountsRun(
     {
         posProcessor.resetRegion(regionInfo.regionChrom, regionInfo.regionRange);
         streamData.resetRegion(regionInfo.streamerRegion.c_str());
-        setRefSegment(opt, regionInfo.regionChrom, regionInfo.refRegionRange, ref);
+        setRefSegment(referenceStore, regionInfo.regionChrom, regionInfo.refRegionRange, ref);
 
         while (streamData.next())
         {
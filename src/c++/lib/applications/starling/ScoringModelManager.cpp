@@ -35,11 +35,13 @@
 ScoringModelManager::
 ScoringModelManager(
     const starling_options& opt,
-    const gvcf_deriv_options& gvcfDerivedOptions)
+    const starling_deriv_options& dopt)
     : _opt(opt.gvcf),
-      _dopt(gvcfDerivedOptions),
+      _dopt(dopt.gvcf),
       _isReportEVSFeatures(opt.isReportEVSFeatures),
-      _isRNA(opt.isRNA)
+      _isRNA(opt.isRNA),
+      _snvScoringModelPtr(dopt.snvScoringModel.get()),
+      _indelScoringModelPtr(dopt.indelScoringModel.get())
 {
     if (opt.isReportEVSFeatures)
     {
@@ -47,30 +49,6 @@ ScoringModelManager(
         const unsigned sampleCount(opt.alignFileOpt.alignmentFilenames.size());
         assert(1 == sampleCount);
     }
-
-    const SCORING_CALL_TYPE::index_t callType(opt.isRNA ? SCORING_CALL_TYPE::RNA : SCORING_CALL_TYPE::GERMLINE);
-
-    if (not opt.snv_scoring_model_filename.empty())
-    {
-        _snvScoringModelPtr.reset(
-            new VariantScoringModelServer(
-                _dopt.snvFeatureSet.getFeatureMap(),
-                opt.snv_scoring_model_filename,
-                callType,
-                SCORING_VARIANT_TYPE::SNV)
-        );
-    }
-
-    if (not opt.indel_scoring_model_filename.empty())
-    {
-        _indelScoringModelPtr.reset(
-            new VariantScoringModelServer(
-                _dopt.indelFeatureSet.getFeatureMap(),
-                opt.indel_scoring_model_filename,
-                callType,
-                SCORING_VARIANT_TYPE::INDEL)
-        );
-    }
 }
 
 
@@ -100,66 +78,114 @@ resetChrom(const std::string& chrom)
 
 void
 ScoringModelManager::
-classify_site(
-    GermlineDiploidSiteLocusInfo& locus) const
+setEmpiricalVariantScores(
+    const VariantScoringModelServer& scoringModel,
+    const VariantScoringModelBase::featureInput_t* const* featureBatch,
+    LocusSampleInfo* const* batchSamples,
+    const unsigned batchSize)
 {
-    const bool isVariantUsableInEVSModel(locus.isVariantLocus());
+    if (batchSize == 0) return;
 
-    const unsigned sampleCount(locus.getSampleCount());
-    if (isVariantUsableInEVSModel && _isReportEVSFeatures)
+    std::vector<double> scores(batchSize);
+    scoringModel.scoreVariants(featureBatch, batchSize, scores.data());
+
+    static const int maxEmpiricalVariantScore(60);
+    for (unsigned batchIndex(0); batchIndex < batchSize; ++batchIndex)
     {
-        assert(sampleCount == 1);
-        const unsigned sampleIndex(0);
-        const auto& sampleInfo(locus.getSample(sampleIndex));
-        if (sampleInfo.isVariant())
+        LocusSampleInfo& sampleInfo(*batchSamples[batchIndex]);
+        sampleInfo.empiricalVariantScore = std::min(error_prob_to_qphred(scores[batchIndex]),
+                                                    maxEmpiricalVariantScore);
+
+        if (sampleInfo.empiricalVariantScore < scoringModel.scoreFilterThreshold())
         {
-            // when reporting is turned on, we need to compute EVS features
-            // for any usable variant regardless of EVS model type:
-            const bool isUniformDepthExpected(_dopt.is_max_depth());
-            GermlineDiploidSiteLocusInfo::computeEmpiricalScoringFeatures(
-                locus, sampleIndex, _isRNA, isUniformDepthExpected, _isReportEVSFeatures,
-                _normChromDepth, locus.evsFeatures, locus.evsDevelopmentFeatures);
+            sampleInfo.filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
         }
     }
+}
+
 
-    if (isVariantUsableInEVSModel && isEVSSiteModel())
+
+void
+ScoringModelManager::
+classify_sites(
+    GermlineDiploidSiteLocusInfo* const* loci,
+    const unsigned locusCount) const
+{
+    // EVS features of each variant sample are collected in the loop over loci, so that all EVS values can be
+    // computed together in a single batch at the end:
+    VariantScoringModelBase::featureInputBatch_t featureBatch;
+    std::vector<LocusSampleInfo*> batchSamples;
+
+    for (unsigned locusIndex(0); locusIndex < locusCount; ++locusIndex)
     {
-        const unsigned allSampleLocusDepth(locus.getTotalReadDepth());
-        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
-        {
-            auto& sampleInfo(locus.getSample(sampleIndex));
-            if (not sampleInfo.isVariant())
-            {
-                // revert to hard-filters for this sample:
-                default_classify_site(sampleIndex, allSampleLocusDepth, locus);
-                continue;
-            }
+        GermlineDiploidSiteLocusInfo& locus(*loci[locusIndex]);
+        const bool isVariantUsableInEVSModel(locus.isVariantLocus());
 
-            static const bool isComputeDevelopmentFeatures(false);
-            const bool isUniformDepthExpected(_dopt.is_max_depth());
-            if (not _isReportEVSFeatures)
+        const unsigned sampleCount(locus.getSampleCount());
+        if (isVariantUsableInEVSModel && _isReportEVSFeatures)
+        {
+            assert(sampleCount == 1);
+            const unsigned sampleIndex(0);
+            const auto& sampleInfo(locus.getSample(sampleIndex));
+            if (sampleInfo.isVariant())
             {
-                locus.clearEVSFeatures();
+                // when reporting is turned on, we need to compute EVS features
+                // for any usable variant regardless of EVS model type:
+                const bool isUniformDepthExpected(_dopt.is_max_depth());
                 GermlineDiploidSiteLocusInfo::computeEmpiricalScoringFeatures(
-                    locus, sampleIndex, _isRNA, isUniformDepthExpected, isComputeDevelopmentFeatures,
+                    locus, sampleIndex, _isRNA, isUniformDepthExpected, _isReportEVSFeatures,
                     _normChromDepth, locus.evsFeatures, locus.evsDevelopmentFeatures);
             }
+        }
 
-            static const int maxEmpiricalVariantScore(60);
-            sampleInfo.empiricalVariantScore = std::min(
-                                                   error_prob_to_qphred(_snvScoringModelPtr->scoreVariant(locus.evsFeatures.getAll())),
-                                                   maxEmpiricalVariantScore);
-
-            if (sampleInfo.empiricalVariantScore < snvEVSThreshold())
+        if (isVariantUsableInEVSModel && isEVSSiteModel())
+        {
+            const unsigned allSampleLocusDepth(locus.getTotalReadDepth());
+            for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
             {
-                sampleInfo.filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+                auto& sampleInfo(locus.getSample(sampleIndex));
+                if (not sampleInfo.isVariant())
+                {
+                    // revert to hard-filters for this sample:
+                    default_classify_site(sampleIndex, allSampleLocusDepth, locus);
+                    continue;
+                }
+
+                static const bool isComputeDevelopmentFeatures(false);
+                const bool isUniformDepthExpected(_dopt.is_max_depth());
+                if (not _isReportEVSFeatures)
+                {
+                    locus.clearEVSFeatures();
+                    GermlineDiploidSiteLocusInfo::computeEmpiricalScoringFeatures(
+                        locus, sampleIndex, _isRNA, isUniformDepthExpected, isComputeDevelopmentFeatures,
+                        _normChromDepth, locus.evsFeatures, locus.evsDevelopmentFeatures);
+                }
+
+                // the batch refers to the locus feature array without copying it:
+                const VariantScoringModelBase::featureInput_t* featuresPtr(&locus.evsFeatures.getAll());
+                LocusSampleInfo* samplePtr(&sampleInfo);
+                if (sampleCount == 1)
+                {
+                    featureBatch.push_back(featuresPtr);
+                    batchSamples.push_back(samplePtr);
+                }
+                else
+                {
+                    // the locus feature array is overwritten by the next sample, so score this sample now:
+                    setEmpiricalVariantScores(*_snvScoringModelPtr, &featuresPtr, &samplePtr, 1);
+                }
             }
         }
+        else
+        {
+            // don't know what to do with this site, throw it to the old default filters
+            default_classify_site_locus(locus);
+        }
     }
-    else
+
+    if (isEVSSiteModel())
     {
-        // don't know what to do with this site, throw it to the old default filters
-        default_classify_site_locus(locus);
+        setEmpiricalVariantScores(*_snvScoringModelPtr, featureBatch.data(), batchSamples.data(), batchSamples.size());
     }
 }
 
@@ -167,66 +193,84 @@ classify_site(
 
 void
 ScoringModelManager::
-classify_indel(
-    GermlineDiploidIndelLocusInfo& locus) const
+classify_indels(
+    GermlineDiploidIndelLocusInfo* const* loci,
+    const unsigned locusCount) const
 {
-    // locus must have at least one variant and no breakpoints
-    const bool isVariantUsableInEVSModel(locus.isVariantLocus() and (not locus.isAnyBreakpointAlleles()));
+    VariantScoringModelBase::featureInputBatch_t featureBatch;
+    std::vector<LocusSampleInfo*> batchSamples;
 
-    const unsigned sampleCount(locus.getSampleCount());
-    if (isVariantUsableInEVSModel && _isReportEVSFeatures)
+    for (unsigned locusIndex(0); locusIndex < locusCount; ++locusIndex)
     {
-        assert(sampleCount == 1);
-        const unsigned sampleIndex(0);
-        const auto& sampleInfo(locus.getSample(sampleIndex));
-        if (sampleInfo.isVariant())
-        {
-            // when reporting is turned on, we need to compute EVS features
-            // for any usable variant regardless of EVS model type:
-            const bool isUniformDepthExpected(_dopt.is_max_depth());
-            GermlineDiploidIndelLocusInfo::computeEmpiricalScoringFeatures(
-                locus, sampleIndex, _isRNA, isUniformDepthExpected, _isReportEVSFeatures,
-                _normChromDepth, locus.evsFeatures, locus.evsDevelopmentFeatures);
-        }
-    }
+        GermlineDiploidIndelLocusInfo& locus(*loci[locusIndex]);
 
-    if (isVariantUsableInEVSModel && isEVSIndelModel())
-    {
-        const unsigned allSampleLocusDepth(locus.getTotalReadDepth());
-        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
-        {
-            auto& sampleInfo(locus.getSample(sampleIndex));
-            if (not sampleInfo.isVariant())
-            {
-                // revert to hard-filters for this sample:
-                default_classify_indel(sampleIndex, allSampleLocusDepth, locus);
-                continue;
-            }
+        // locus must have at least one variant and no breakpoints
+        const bool isVariantUsableInEVSModel(locus.isVariantLocus() and (not locus.isAnyBreakpointAlleles()));
 
-            static const bool isComputeDevelopmentFeatures(false);
-            const bool isUniformDepthExpected(_dopt.is_max_depth());
-            if (not _isReportEVSFeatures)
+        const unsigned sampleCount(locus.getSampleCount());
+        if (isVariantUsableInEVSModel && _isReportEVSFeatures)
+        {
+            assert(sampleCount == 1);
+            const unsigned sampleIndex(0);
+            const auto& sampleInfo(locus.getSample(sampleIndex));
+            if (sampleInfo.isVariant())
             {
-                locus.clearEVSFeatures();
+                // when reporting is turned on, we need to compute EVS features
+                // for any usable variant regardless of EVS model type:
+                const bool isUniformDepthExpected(_dopt.is_max_depth());
                 GermlineDiploidIndelLocusInfo::computeEmpiricalScoringFeatures(
-                    locus, sampleIndex, _isRNA, isUniformDepthExpected, isComputeDevelopmentFeatures,
+                    locus, sampleIndex, _isRNA, isUniformDepthExpected, _isReportEVSFeatures,
                     _normChromDepth, locus.evsFeatures, locus.evsDevelopmentFeatures);
             }
+        }
 
-            static const int maxEmpiricalVariantScore(60);
-            sampleInfo.empiricalVariantScore = std::min(
-                                                   error_prob_to_qphred(_indelScoringModelPtr->scoreVariant(locus.evsFeatures.getAll())),
-                                                   maxEmpiricalVariantScore);
-
-            if (sampleInfo.empiricalVariantScore < indelEVSThreshold())
+        if (isVariantUsableInEVSModel && isEVSIndelModel())
+        {
+            const unsigned allSampleLocusDepth(locus.getTotalReadDepth());
+            for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
             {
-                sampleInfo.filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+                auto& sampleInfo(locus.getSample(sampleIndex));
+                if (not sampleInfo.isVariant())
+                {
+                    // revert to hard-filters for this sample:
+                    default_classify_indel(sampleIndex, allSampleLocusDepth, locus);
+                    continue;
+                }
+
+                static const bool isComputeDevelopmentFeatures(false);
+                const bool isUniformDepthExpected(_dopt.is_max_depth());
+                if (not _isReportEVSFeatures)
+                {
+                    locus.clearEVSFeatures();
+                    GermlineDiploidIndelLocusInfo::computeEmpiricalScoringFeatures(
+                        locus, sampleIndex, _isRNA, isUniformDepthExpected, isComputeDevelopmentFeatures,
+                        _normChromDepth, locus.evsFeatures, locus.evsDevelopmentFeatures);
+                }
+
+                // the batch refers to the locus feature array without copying it:
+                const VariantScoringModelBase::featureInput_t* featuresPtr(&locus.evsFeatures.getAll());
+                LocusSampleInfo* samplePtr(&sampleInfo);
+                if (sampleCount == 1)
+                {
+                    featureBatch.push_back(featuresPtr);
+                    batchSamples.push_back(samplePtr);
+                }
+                else
+                {
+                    // the locus feature array is overwritten by the next sample, so score this sample now:
+                    setEmpiricalVariantScores(*_indelScoringModelPtr, &featuresPtr, &samplePtr, 1);
+                }
             }
         }
+        else
+        {
+            default_classify_indel_locus(locus);
+        }
     }
-    else
+
+    if (isEVSIndelModel())
     {
-        default_classify_indel_locus(locus);
+        setEmpiricalVariantScores(*_indelScoringModelPtr, featureBatch.data(), batchSamples.data(), batchSamples.size());
     }
 }
 
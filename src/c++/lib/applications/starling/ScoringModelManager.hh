@@ -41,9 +41,10 @@
 ///
 struct ScoringModelManager
 {
+    /// \param[in] dopt scoring models are shared from this object, so its lifetime must exceed this manager's
     ScoringModelManager(
         const starling_options& opt,
-        const gvcf_deriv_options& gvcfDerivedOptions);
+        const starling_deriv_options& dopt);
 
     /// the current chromosome must be specified before handling any classifications:
     void
@@ -51,11 +52,41 @@ struct ScoringModelManager
 
     void
     classify_site(
-        GermlineDiploidSiteLocusInfo& locus) const;
+        GermlineDiploidSiteLocusInfo& locus) const
+    {
+        GermlineDiploidSiteLocusInfo* locusPtr(&locus);
+        classify_sites(&locusPtr, 1);
+    }
 
     void
     classify_indel(
-        GermlineDiploidIndelLocusInfo& locus) const;
+        GermlineDiploidIndelLocusInfo& locus) const
+    {
+        GermlineDiploidIndelLocusInfo* locusPtr(&locus);
+        classify_indels(&locusPtr, 1);
+    }
+
+    /// \brief Apply site filters or EVS to a batch of loci
+    ///
+    /// Results are identical to calling classify_site() on each locus in order, except that the EVS model is
+    /// evaluated for the whole batch at once.
+    ///
+    /// \param[in] loci Pointers to locusCount loci
+    void
+    classify_sites(
+        GermlineDiploidSiteLocusInfo* const* loci,
+        const unsigned locusCount) const;
+
+    /// \brief Apply indel filters or EVS to a batch of loci
+    ///
+    /// Results are identical to calling classify_indel() on each locus in order, except that the EVS model is
+    /// evaluated for the whole batch at once.
+    ///
+    /// \param[in] loci Pointers to locusCount loci
+    void
+    classify_indels(
+        GermlineDiploidIndelLocusInfo* const* loci,
+        const unsigned locusCount) const;
 
     void
     applyDepthFilter(
@@ -126,6 +157,16 @@ private:
         return _indelScoringModelPtr->scoreFilterThreshold();
     }
 
+    /// score batchSize sample feature arrays in featureBatch with scoringModel, and set EVS and EVS filter of the
+    /// corresponding sample in batchSamples
+    static
+    void
+    setEmpiricalVariantScores(
+        const VariantScoringModelServer& scoringModel,
+        const VariantScoringModelBase::featureInput_t* const* featureBatch,
+        LocusSampleInfo* const* batchSamples,
+        const unsigned batchSize);
+
     // for setting the vcf header filters
     const gvcf_options& _opt;
     const gvcf_deriv_options& _dopt;
@@ -136,6 +177,6 @@ private:
     double _normChromDepth = 0.;
     double _maxChromDepth = 0.;
 
-    std::unique_ptr<VariantScoringModelServer> _snvScoringModelPtr;
-    std::unique_ptr<VariantScoringModelServer> _indelScoringModelPtr;
+    const VariantScoringModelServer* _snvScoringModelPtr;
+    const VariantScoringModelServer* _indelScoringModelPtr;
 };
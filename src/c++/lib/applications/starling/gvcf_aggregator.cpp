@@ -34,7 +34,7 @@ gvcf_aggregator(
     const RegionTracker& nocompressRegions,
     const RegionTracker& callRegions,
     const unsigned sampleCount)
-    : _scoringModels(opt, dopt.gvcf)
+    : _scoringModels(opt, dopt)
 {
     if (! opt.gvcf.is_gvcf_output())
         throw std::invalid_argument("gvcf_aggregator cannot be constructed with nothing to do.");
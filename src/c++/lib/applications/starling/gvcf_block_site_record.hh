@@ -38,7 +38,7 @@ struct gvcf_block_site_record : public GermlineSiteLocusInfo
     explicit
     gvcf_block_site_record(
         const gvcf_options& opt)
-        : base_t(1),
+        : base_t(GERMLINE_LOCUS_TYPE::SITE, 1),
           frac_tol(static_cast<double>(opt.block_percent_tol)/100.),
           abs_tol(opt.block_abs_tol)
     {
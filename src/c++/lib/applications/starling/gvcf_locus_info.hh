@@ -31,6 +31,7 @@
 #include "blt_util/align_path.hh"
 #include "blt_util/math_util.hh"
 #include "blt_util/PolymorphicObject.hh"
+#include "blt_util/RecyclingAllocator.hh"
 #include "htsapi/vcf_util.hh"
 #include "starling_common/starling_indel_call_pprob_digt.hh"
 #include "starling_common/LocusSupportingReadStats.hh"
@@ -102,6 +103,30 @@ get_label(const unsigned idx)
 
 
 
+/// Concrete type of a germline locus, used to dispatch on locus type without RTTI
+namespace GERMLINE_LOCUS_TYPE
+{
+
+enum index_t
+{
+    /// site record which is not from a specific calling model, such as a gVCF block record
+    SITE,
+    DIPLOID_SITE,
+    CONTINUOUS_SITE,
+    DIPLOID_INDEL,
+    CONTINUOUS_INDEL
+};
+
+inline
+bool
+isSite(const index_t locusType)
+{
+    return (locusType <= CONTINUOUS_SITE);
+}
+}
+
+
+
 struct GermlineFilterKeeper
 {
     bool
@@ -425,16 +450,40 @@ std::ostream& operator<<(std::ostream& os,const LocusSampleInfo& lsi);
 
 
 /// represents a locus in the sense of multiple alleles which interact in some way such that they would be represented in a single VCF record
+///
+/// Locus objects are created and destroyed for every reported position, so their storage is recycled through
+/// RecyclingAllocator.
 struct LocusInfo : public PolymorphicObject
 {
-    explicit
     LocusInfo(
+        const GERMLINE_LOCUS_TYPE::index_t locusType,
         const unsigned sampleCount,
         const pos_t initPos = 0)
         : pos(initPos),
-          _sampleInfo(sampleCount)
+          _sampleInfo(sampleCount),
+          _locusType(locusType)
     {}
 
+    static
+    void*
+    operator new(std::size_t size)
+    {
+        return RecyclingAllocator::allocate(size);
+    }
+
+    static
+    void
+    operator delete(void* ptr, std::size_t size)
+    {
+        RecyclingAllocator::deallocate(ptr, size);
+    }
+
+    GERMLINE_LOCUS_TYPE::index_t
+    getLocusType() const
+    {
+        return _locusType;
+    }
+
     unsigned
     getAltAlleleCount() const
     {
@@ -529,6 +578,7 @@ public:
 private:
     std::vector<LocusSampleInfo> _sampleInfo;
     unsigned _altAlleleCount = 0;
+    GERMLINE_LOCUS_TYPE::index_t _locusType;
 
 protected:
     /// to sanity check input, locus must be specified by adding all alleles, and then adding all sample information, this bool enforces the allele->sample ordering
@@ -571,15 +621,24 @@ struct GermlineIndelSampleInfo
 /// represents an indel call at the level of a full VCF record, containing possibly multiple alleles/SimpleGenotypes
 struct GermlineIndelLocusInfo : public LocusInfo
 {
-    explicit
     GermlineIndelLocusInfo(
+        const GERMLINE_LOCUS_TYPE::index_t locusType,
         const unsigned sampleCount)
-        : LocusInfo(sampleCount),
+        : LocusInfo(locusType, sampleCount),
           _indelSampleInfo(sampleCount), _commonPrefixLength(0), _doNotGenotype(false)
-    {}
+    {
+        assert(not GERMLINE_LOCUS_TYPE::isSite(locusType));
+    }
 
     virtual ~GermlineIndelLocusInfo() {}
 
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return (not GERMLINE_LOCUS_TYPE::isSite(locus.getLocusType()));
+    }
+
     const known_pos_range2&
     range() const
     {
@@ -734,11 +793,18 @@ struct GermlineDiploidIndelLocusInfo : public GermlineIndelLocusInfo
     GermlineDiploidIndelLocusInfo(
         const gvcf_deriv_options& gvcfDerivedOptions,
         const unsigned sampleCount)
-        : GermlineIndelLocusInfo(sampleCount)
+        : GermlineIndelLocusInfo(GERMLINE_LOCUS_TYPE::DIPLOID_INDEL, sampleCount)
         , evsFeatures(gvcfDerivedOptions.indelFeatureSet)
         , evsDevelopmentFeatures(gvcfDerivedOptions.indelDevelopmentFeatureSet)
     {}
 
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return (locus.getLocusType() == GERMLINE_LOCUS_TYPE::DIPLOID_INDEL);
+    }
+
     /// \param allSampleChromDepth expected depth summed over all samples
     static
     void
@@ -771,8 +837,15 @@ struct GermlineContinuousIndelLocusInfo : public GermlineIndelLocusInfo
     explicit
     GermlineContinuousIndelLocusInfo(
         const unsigned sampleCount)
-        : GermlineIndelLocusInfo(sampleCount)
+        : GermlineIndelLocusInfo(GERMLINE_LOCUS_TYPE::CONTINUOUS_INDEL, sampleCount)
     {}
+
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return (locus.getLocusType() == GERMLINE_LOCUS_TYPE::CONTINUOUS_INDEL);
+    }
 };
 
 
@@ -890,23 +963,34 @@ struct GermlineSiteLocusInfo : public LocusInfo
     typedef LocusInfo base_t;
 
     GermlineSiteLocusInfo(
+        const GERMLINE_LOCUS_TYPE::index_t locusType,
         const unsigned sampleCount,
         const pos_t initPos,
         const uint8_t initRefBaseIndex,
         const bool initIsForcedOutput = false)
-        : base_t(sampleCount, initPos),
+        : base_t(locusType, sampleCount, initPos),
           refBaseIndex(initRefBaseIndex),
           _siteSampleInfo(sampleCount)
     {
+        assert(GERMLINE_LOCUS_TYPE::isSite(locusType));
         isForcedOutput = initIsForcedOutput;
     }
 
-    explicit
     GermlineSiteLocusInfo(
+        const GERMLINE_LOCUS_TYPE::index_t locusType,
         const unsigned sampleCount)
-        : base_t(sampleCount),
+        : base_t(locusType, sampleCount),
           _siteSampleInfo(sampleCount)
-    {}
+    {
+        assert(GERMLINE_LOCUS_TYPE::isSite(locusType));
+    }
+
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return GERMLINE_LOCUS_TYPE::isSite(locus.getLocusType());
+    }
 
     bool
     isRefUnknown() const
@@ -1036,7 +1120,8 @@ struct GermlineDiploidSiteLocusInfo : public GermlineSiteLocusInfo
         const pos_t init_pos,
         const uint8_t initRefBaseIndex,
         const bool is_forced_output = false)
-        : GermlineSiteLocusInfo(sampleCount, init_pos, initRefBaseIndex, is_forced_output),
+        : GermlineSiteLocusInfo(GERMLINE_LOCUS_TYPE::DIPLOID_SITE, sampleCount, init_pos, initRefBaseIndex,
+                                is_forced_output),
           evsFeatures(gvcfDerivedOptions.snvFeatureSet),
           evsDevelopmentFeatures(gvcfDerivedOptions.snvDevelopmentFeatureSet)
     {}
@@ -1044,11 +1129,18 @@ struct GermlineDiploidSiteLocusInfo : public GermlineSiteLocusInfo
     GermlineDiploidSiteLocusInfo(
         const gvcf_deriv_options& gvcfDerivedOptions,
         const unsigned sampleCount)
-        : GermlineSiteLocusInfo(sampleCount),
+        : GermlineSiteLocusInfo(GERMLINE_LOCUS_TYPE::DIPLOID_SITE, sampleCount),
           evsFeatures(gvcfDerivedOptions.snvFeatureSet),
           evsDevelopmentFeatures(gvcfDerivedOptions.snvDevelopmentFeatureSet)
     {}
 
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return (locus.getLocusType() == GERMLINE_LOCUS_TYPE::DIPLOID_SITE);
+    }
+
     /// \param allSampleChromDepth expected depth summed over all samples
     static
     void
@@ -1108,10 +1200,17 @@ struct GermlineContinuousSiteLocusInfo : public GermlineSiteLocusInfo
         const pos_t init_pos,
         const uint8_t initRefBaseIndex,
         const bool is_forced_output = false)
-        : base_t(sampleCount, init_pos, initRefBaseIndex, is_forced_output),
+        : base_t(GERMLINE_LOCUS_TYPE::CONTINUOUS_SITE, sampleCount, init_pos, initRefBaseIndex, is_forced_output),
           _continuousSiteSampleInfo(sampleCount)
     {}
 
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return (locus.getLocusType() == GERMLINE_LOCUS_TYPE::CONTINUOUS_SITE);
+    }
+
     void
     clear()
     {
@@ -19,7 +19,6 @@
 
 #include "gvcf_writer.hh"
 
-#include "gvcf_header.hh"
 #include "VariantOverlapResolver.hh"
 #include "LocusReportInfoUtil.hh"
 #include "variant_prefilter_stage.hh"
@@ -28,6 +27,7 @@
 #include "blt_util/io_util.hh"
 #include "blt_util/log.hh"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -65,25 +65,9 @@ gvcf_writer(
     if (! opt.gvcf.is_gvcf_output())
         throw std::invalid_argument("gvcf_writer cannot be constructed with nothing to do.");
 
-    const unsigned sampleCount(_streams.getSampleCount());
-    const auto& sampleNames(_streams.getSampleNames());
-
-    if (! _opt.gvcf.is_skip_header)
-    {
-        // Create the header for the variants VCF
-        bool isGenomeVCF(false);
-        finishGermlineVCFheader(_opt, _dopt, _dopt.chrom_depth, sampleNames, isGenomeVCF, _streams.variantsVCFStream());
-
-        // Create the header for each sample's gVCF
-        isGenomeVCF = true;
-        for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
-        {
-            const std::string& sampleName(sampleNames[sampleIndex]);
-            finishGermlineVCFheader(_opt, _dopt, _dopt.chrom_depth, {sampleName}, isGenomeVCF,
-                                    _streams.gvcfSampleStream(sampleIndex));
-        }
-    }
+    // note that all VCF headers are written by the streams object
 
+    const unsigned sampleCount(_streams.getSampleCount());
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
     {
         _blockPerSample.emplace_back(_opt.gvcf);
@@ -142,7 +126,9 @@ skip_to_pos(
         {
             if (not _callRegions.isIntersectRegion(_headPos))
             {
-                _headPos++;
+                // jump directly to the next call region:
+                const auto nextCallRegionPos(_callRegions.getNextRegionPos(_headPos));
+                _headPos = (nextCallRegionPos ? std::min(*nextCallRegionPos, target_pos) : target_pos);
                 continue;
             }
         }
@@ -223,7 +209,7 @@ process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr)
         write_indel_record(*locusPtr);
         if (locusPtr->isVariantLocus())
         {
-            if (dynamic_cast<GermlineDiploidIndelLocusInfo*>(locusPtr.get()) != nullptr)
+            if (GermlineDiploidIndelLocusInfo::isInstance(*locusPtr))
             {
                 _lastVariantIndelWritten = std::move(locusPtr);
             }
@@ -261,10 +247,9 @@ gvcf_writer::
 add_site_internal(
     GermlineSiteLocusInfo& locus)
 {
-    GermlineDiploidSiteLocusInfo* diploidLocusPtr(dynamic_cast<GermlineDiploidSiteLocusInfo*>(&locus));
-    if (diploidLocusPtr != nullptr)
+    if (GermlineDiploidSiteLocusInfo::isInstance(locus))
     {
-        modifySiteForConsistencyWithUpstreamIndels(*diploidLocusPtr);
+        modifySiteForConsistencyWithUpstreamIndels(static_cast<GermlineDiploidSiteLocusInfo&>(locus));
     }
 
     _headPos=locus.pos+1;
@@ -505,10 +490,9 @@ write_site_record_instance(
         os << "MQ=" << std::lround(mapqTracker.getRMS());
     }
 
-    const GermlineDiploidSiteLocusInfo* diploidLocusPtr(dynamic_cast<const GermlineDiploidSiteLocusInfo*>(&locus));
-    if (diploidLocusPtr != nullptr)
+    if (GermlineDiploidSiteLocusInfo::isInstance(locus))
     {
-        const GermlineDiploidSiteLocusInfo& diploidLocus(*diploidLocusPtr);
+        const GermlineDiploidSiteLocusInfo& diploidLocus(static_cast<const GermlineDiploidSiteLocusInfo&>(locus));
 
         if (locus.isVariantLocus())
         {
@@ -654,9 +638,8 @@ write_site_record_instance(
         // special constraint on continuous allele reporting right now:
         assert(altAlleleCount == 1);
 
-        const GermlineContinuousSiteLocusInfo* contLocusPtr(dynamic_cast<const GermlineContinuousSiteLocusInfo*>(&locus));
-        assert(contLocusPtr != nullptr);
-        const GermlineContinuousSiteLocusInfo& contLocus(*contLocusPtr);
+        assert(GermlineContinuousSiteLocusInfo::isInstance(locus));
+        const GermlineContinuousSiteLocusInfo& contLocus(static_cast<const GermlineContinuousSiteLocusInfo&>(locus));
 
         os << '\t';
 
@@ -922,12 +905,11 @@ write_indel_record_instance(
     }
 
 
-    const GermlineDiploidIndelLocusInfo* diploidLocusPtr(dynamic_cast<const GermlineDiploidIndelLocusInfo*>(&locus));
-    if (diploidLocusPtr != nullptr)
+    if (GermlineDiploidIndelLocusInfo::isInstance(locus))
     {
-        if (!diploidLocusPtr->isNotGenotyped())
+        if (!locus.isNotGenotyped())
         {
-            const GermlineDiploidIndelLocusInfo& diploidLocus(*diploidLocusPtr);
+            const GermlineDiploidIndelLocusInfo& diploidLocus(static_cast<const GermlineDiploidIndelLocusInfo&>(locus));
 
             //FORMAT
             if (_opt.isReportEVSFeatures)
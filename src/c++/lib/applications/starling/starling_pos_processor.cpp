@@ -172,18 +172,15 @@ process_pos_snp(const pos_t pos)
             if (isZeroCoverage) return;
         }
 
-        // prep step 1) clean pileups in all samples:
-        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
-        {
-            _pileupCleaner.CleanPileupErrorProb(sample(sampleIndex).cleanedPileup);
-        }
-
         if (_opt.is_bsnp_diploid())
         {
+            // pileup cleaning is deferred to the diploid caller, so that it can be skipped at reference sites:
             process_pos_snp_digt(pos);
         }
         else
         {
+            // prep step 1) clean pileups in all samples:
+            cleanSnpPileups();
             process_pos_snp_continuous(pos);
         }
 
@@ -236,13 +233,17 @@ updateSiteSampleInfo(
         // calculate empirical scoring metrics
         if (opt.is_compute_germline_scoring_metrics())
         {
-            siteSampleInfo.ReadPosRankSum = pi.get_read_pos_ranksum();
+            // each rank-sum provides both the rank-sum feature and the mean non-reference value:
+            const fastRanksum readPosRankSum(pi.getReadPositionRankSum());
+            const fastRanksum baseQRankSum(pi.getBaseQualityRankSum());
+
+            siteSampleInfo.ReadPosRankSum = readPosRankSum.get_z_stat();
             siteSampleInfo.MQRankSum = pi.get_mq_ranksum();
-            siteSampleInfo.BaseQRankSum = pi.get_baseq_ranksum();
+            siteSampleInfo.BaseQRankSum = baseQRankSum.get_z_stat();
 
-            siteSampleInfo.meanDistanceFromReadEdge = pi.distanceFromReadEdge.mean();
-            siteSampleInfo.rawPos = pi.get_raw_pos();
-            siteSampleInfo.avgBaseQ = pi.get_raw_baseQ();
+            siteSampleInfo.meanDistanceFromReadEdge = pi.getMeanDistanceFromReadEdge();
+            siteSampleInfo.rawPos = readPosRankSum.getExpectedCategory2Value();
+            siteSampleInfo.avgBaseQ = baseQRankSum.getExpectedCategory2Value();
         }
     }
 
@@ -615,6 +616,53 @@ getSiteAltAlleles(
 
 
 
+void
+starling_pos_processor::
+cleanSnpPileups()
+{
+    const unsigned sampleCount(getSampleCount());
+    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+    {
+        _pileupCleaner.CleanPileupErrorProb(sample(sampleIndex).cleanedPileup);
+    }
+}
+
+
+
+bool
+starling_pos_processor::
+computeHomRefSiteGenotypes(
+    const std::vector<int>& callerPloidy,
+    std::vector<diploid_genotype>& allDgt) const
+{
+    // the shortcut reproduces the full computation only when it is run with is_always_test set:
+    if (not _opt.is_all_sites()) return false;
+
+    const unsigned sampleCount(getSampleCount());
+    double homRefLogProb(0);
+    double homRefLogProbErrorBound(0);
+    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+    {
+        const extended_pos_info& good_epi(sample(sampleIndex).cleanedPileup.getExtendedPosInfo());
+        diploid_genotype& dgt(allDgt[sampleIndex]);
+        dgt.ploidy=callerPloidy[sampleIndex];
+
+        double lnRefPprobErrorBound(0);
+        if (not _dopt.pdcaller().position_snp_call_pprob_digt_homref(_opt, good_epi, dgt, lnRefPprobErrorBound))
+        {
+            return false;
+        }
+        homRefLogProb += std::log(dgt.genome.ref_pprob);
+        homRefLogProbErrorBound += lnRefPprobErrorBound;
+    }
+
+    // ref_pprob is not exact, so also check that the site QUAL value can't change:
+    return (ln_error_prob_to_qphred(homRefLogProb-homRefLogProbErrorBound) ==
+            ln_error_prob_to_qphred(homRefLogProb+homRefLogProbErrorBound));
+}
+
+
+
 void
 starling_pos_processor::
 process_pos_snp_digt(
@@ -649,12 +697,18 @@ process_pos_snp_digt(
         callerPloidy.push_back((ploidy == 0) ? 2 : ploidy);
     }
 
-    // prep step 3) compute diploid genotype object using older "4-allele" model:
+    // prep step 3) compute diploid genotype object using older "4-allele" model, first trying the cheaper
+    //              computation for reference sites, and otherwise cleaning the pileups for the full model:
     std::vector<diploid_genotype> allDgt(sampleCount);
-    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+    if (not computeHomRefSiteGenotypes(callerPloidy, allDgt))
     {
-        computeSampleDiploidSiteGenotype(
-            _opt, _dopt, sample(sampleIndex), callerPloidy[sampleIndex], allDgt[sampleIndex]);
+        cleanSnpPileups();
+        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+        {
+            allDgt[sampleIndex].reset();
+            computeSampleDiploidSiteGenotype(
+                _opt, _dopt, sample(sampleIndex), callerPloidy[sampleIndex], allDgt[sampleIndex]);
+        }
     }
 
     // prep step 4) rank each allele in each sample, allowing up to ploidy alleles.
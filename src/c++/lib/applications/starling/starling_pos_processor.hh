@@ -77,9 +77,23 @@ private:
     void
     process_pos_snp(const pos_t pos);
 
+    /// clean the snp pileups of all samples at the current position
+    void
+    cleanSnpPileups();
+
     void
     process_pos_snp_digt(const pos_t pos);
 
+    /// attempt to genotype all samples at a site where all basecalls match the reference, without cleaning the
+    /// snp pileups
+    ///
+    /// \return true if the genotype of every sample, and the site QUAL value which is computed from them, are
+    ///         certified to match the full genotyping computation
+    bool
+    computeHomRefSiteGenotypes(
+        const std::vector<int>& callerPloidy,
+        std::vector<diploid_genotype>& allDgt) const;
+
     void
     process_pos_snp_continuous(const pos_t pos);
 
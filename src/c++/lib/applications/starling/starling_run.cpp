@@ -24,11 +24,14 @@
 #include "appstats/RunStatsManager.hh"
 #include "blt_util/id_map.hh"
 #include "blt_util/log.hh"
+#include "blt_util/WorkStealingTaskQueue.hh"
 #include "common/Exceptions.hh"
 #include "htsapi/bam_header_util.hh"
+#include "htsapi/HtsDecodeThreadPool.hh"
 #include "htsapi/vcf_record_util.hh"
 #include "starling_common/HtsMergeStreamerUtil.hh"
 #include "starling_common/ploidy_util.hh"
+#include "starling_common/RegionOutputMerger.hh"
 #include "starling_common/starling_pos_processor_util.hh"
 
 
@@ -103,11 +106,13 @@ static
 void
 callRegion(
     const starling_options& opt,
+    const ReferenceStore& referenceStore,
     const AnalysisRegionInfo& regionInfo,
     const starling_streams& fileStreams,
     const std::vector<unsigned>& sampleIndexToPloidyVcfSampleIndex,
     const unsigned ploidyVcfSampleCount,
     starling_read_counts& readCounts,
+    RunStatsManager& statsManager,
     reference_contig_segment& ref,
     HtsMergeStreamer& streamData,
     starling_pos_processor& posProcessor)
@@ -118,7 +123,7 @@ callRegion(
 
     posProcessor.resetRegion(regionInfo.regionChrom, regionInfo.regionRange);
     streamData.resetRegion(regionInfo.streamerRegion.c_str());
-    setRefSegment(opt, regionInfo.regionChrom, regionInfo.refRegionRange, ref);
+    setRefSegment(referenceStore, regionInfo.regionChrom, regionInfo.refRegionRange, ref);
 
     while (streamData.next())
     {
@@ -243,6 +248,63 @@ callRegion(
             assert(false && "Invalid input condition");
         }
     }
+
+    addInputAlignmentFilterCounts(streamData, readCounts, statsManager);
+}
+
+
+
+/// \brief Register all alignment, vcf and bed inputs with a merge streamer
+///
+/// \param[out] ploidyVcfStreamPtr set to the ploidy vcf stream if ploidy input is used, nullptr otherwise
+///
+/// \return Headers of all registered alignment files, in sample order
+static
+std::vector<std::reference_wrapper<const bam_hdr_t>>
+registerInputs(
+    const starling_options& opt,
+    HtsMergeStreamer& streamData,
+    HtsDecodeThreadPool* decodeThreadPoolPtr,
+    const vcf_streamer*& ploidyVcfStreamPtr)
+{
+    const unsigned sampleCount(opt.getSampleCount());
+
+    std::vector<unsigned> registrationIndices;
+    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+    {
+        registrationIndices.push_back(sampleIndex);
+    }
+    const auto bamHeaders(registerAlignments(opt.alignFileOpt.alignmentFilenames, registrationIndices, streamData,
+                                               decodeThreadPoolPtr, opt.alignFileOpt.readAheadRecordCount,
+                                               getInputAlignmentFilterSpec(opt)));
+
+    assert(not bamHeaders.empty());
+    const bam_hdr_t& referenceHeader(bamHeaders.front());
+
+    static const bool noRequireNormalized(false);
+    registerVcfList(opt.input_candidate_indel_vcf, INPUT_TYPE::CANDIDATE_INDELS, referenceHeader, streamData,
+                    noRequireNormalized);
+    registerVcfList(opt.force_output_vcf, INPUT_TYPE::FORCED_GT_VARIANTS, referenceHeader, streamData);
+
+    ploidyVcfStreamPtr = nullptr;
+    if (!opt.ploidy_region_vcf.empty())
+    {
+        const vcf_streamer& vcfStream(streamData.registerVcf(opt.ploidy_region_vcf.c_str(), INPUT_TYPE::PLOIDY_REGION));
+        vcfStream.validateBamHeaderChromSync(referenceHeader);
+        ploidyVcfStreamPtr = &vcfStream;
+    }
+
+    if (!opt.gvcf.nocompress_region_bedfile.empty())
+    {
+        streamData.registerBed(opt.gvcf.nocompress_region_bedfile.c_str(), INPUT_TYPE::NOCOMPRESS_REGION);
+    }
+
+    if (! opt.callRegionsBedFilename.empty())
+    {
+        streamData.registerBed(opt.callRegionsBedFilename.c_str(), INPUT_TYPE::CALL_REGION);
+    }
+
+    return bamHeaders;
 }
 
 
@@ -263,11 +325,17 @@ starling_run(
     starling_read_counts readCounts;
     reference_contig_segment ref;
 
+    // the reference store is shared by all call threads:
+    const ReferenceStore referenceStore(opt.referenceFilename, opt.isUsePackedReference);
+
     const unsigned sampleCount(opt.getSampleCount());
 
     ////////////////////////////////////////
     // setup streamData:
     //
+    // the decode thread pool is shared by all input alignment streams, so it must be created before any of them:
+    const std::unique_ptr<HtsDecodeThreadPool> decodeThreadPool(
+        createHtsDecodeThreadPool(opt.alignFileOpt.decodeThreadCount));
     HtsMergeStreamer streamData(opt.referenceFilename);
 
     // additional data structures required in the region loop below, which are filled in as a side effect of
@@ -278,20 +346,8 @@ starling_run(
     std::vector<unsigned> sampleIndexToPloidyVcfSampleIndex;
 
     {
-        std::vector<unsigned> registrationIndices;
-        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
-        {
-            registrationIndices.push_back(sampleIndex);
-        }
-        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilenames, registrationIndices, streamData);
-
-        assert(not bamHeaders.empty());
-        const bam_hdr_t& referenceHeader(bamHeaders.front());
-
-        static const bool noRequireNormalized(false);
-        registerVcfList(opt.input_candidate_indel_vcf, INPUT_TYPE::CANDIDATE_INDELS, referenceHeader, streamData,
-                        noRequireNormalized);
-        registerVcfList(opt.force_output_vcf, INPUT_TYPE::FORCED_GT_VARIANTS, referenceHeader, streamData);
+        const vcf_streamer* ploidyVcfStreamPtr(nullptr);
+        bamHeaders = registerInputs(opt, streamData, decodeThreadPool.get(), ploidyVcfStreamPtr);
 
         // initialize sampleNames from all bam headers (assuming 1 sample per bam for now)
         assert(bamHeaders.size() == sampleCount);
@@ -305,28 +361,14 @@ starling_run(
             sampleNames.push_back(sampleName);
         }
 
-        if (!opt.ploidy_region_vcf.empty())
-        {
-            const vcf_streamer& vcfStream(streamData.registerVcf(opt.ploidy_region_vcf.c_str(), INPUT_TYPE::PLOIDY_REGION));
-            vcfStream.validateBamHeaderChromSync(referenceHeader);
-
-            mapVcfSampleIndices(vcfStream, sampleNames, sampleIndexToPloidyVcfSampleIndex);
-            ploidyVcfSampleCount = vcfStream.getSampleCount();
-        }
-
-        if (!opt.gvcf.nocompress_region_bedfile.empty())
-        {
-            streamData.registerBed(opt.gvcf.nocompress_region_bedfile.c_str(), INPUT_TYPE::NOCOMPRESS_REGION);
-        }
-
-        if (! opt.callRegionsBedFilename.empty())
+        if (ploidyVcfStreamPtr != nullptr)
         {
-            streamData.registerBed(opt.callRegionsBedFilename.c_str(), INPUT_TYPE::CALL_REGION);
+            mapVcfSampleIndices(*ploidyVcfStreamPtr, sampleNames, sampleIndexToPloidyVcfSampleIndex);
+            ploidyVcfSampleCount = ploidyVcfStreamPtr->getSampleCount();
         }
     }
 
-    starling_streams fileStreams(opt, pinfo, bamHeaders, sampleNames);
-    starling_pos_processor posProcessor(opt, dopt, ref, fileStreams, statsManager);
+    starling_streams fileStreams(opt, dopt, pinfo, bamHeaders, sampleNames);
 
     const bam_hdr_t& referenceHeader(bamHeaders.front());
     const bam_header_info referenceHeaderInfo(referenceHeader);
@@ -341,27 +383,61 @@ starling_run(
     std::vector<AnalysisRegionInfo> regionInfoList;
     getStrelkaAnalysisRegions(opt, referenceAlignmentFilename, referenceHeaderInfo, supplementalRegionBorderSize, regionInfoList);
 
-    for (const auto& regionInfo : regionInfoList)
+    std::vector<AnalysisRegionInfo> workRegionInfoList;
+    getStrelkaWorkRegions(opt, referenceHeaderInfo, regionInfoList, supplementalRegionBorderSize, workRegionInfoList);
+
+    if (opt.callThreadCount <= 1)
     {
-        if (not opt.isUseCallRegions())
+        starling_pos_processor posProcessor(opt, dopt, ref, fileStreams, statsManager);
+
+        for (const auto& workRegionInfo : workRegionInfoList)
         {
-            callRegion(opt, regionInfo, fileStreams, sampleIndexToPloidyVcfSampleIndex, ploidyVcfSampleCount,
-                       readCounts, ref, streamData, posProcessor);
+            callRegion(opt, referenceStore, workRegionInfo, fileStreams, sampleIndexToPloidyVcfSampleIndex,
+                       ploidyVcfSampleCount, readCounts, statsManager, ref, streamData, posProcessor);
         }
-        else
+        posProcessor.reset();
+    }
+    else
+    {
+        // each worker thread has its own input streams, reference segment, position processor and output buffers,
+        // options and scoring models are shared from dopt:
+        const unsigned workRegionCount(workRegionInfoList.size());
+        WorkStealingTaskQueue workQueue(workRegionCount, std::min(opt.callThreadCount, std::max(workRegionCount,1u)));
+        RegionOutputMerger outputMerger(fileStreams.getRecordOutputStreams(), workRegionCount);
+
+        auto regionWorker = [&](const unsigned workerIndex)
         {
-            std::vector<known_pos_range2> subRegionRanges;
-            getSubRegionsFromBedTrack(opt.callRegionsBedFilename, regionInfo.regionChrom, regionInfo.regionRange, subRegionRanges);
+            // the first worker streams from the inputs already opened on the main thread, so that only one set of
+            // inputs is opened per worker:
+            HtsMergeStreamer* workerStreamDataPtr(&streamData);
+            std::unique_ptr<HtsMergeStreamer> newStreamDataPtr;
+            if (workerIndex > 0)
+            {
+                newStreamDataPtr.reset(new HtsMergeStreamer(opt.referenceFilename));
+                workerStreamDataPtr = newStreamDataPtr.get();
+                const vcf_streamer* ploidyVcfStreamPtr(nullptr);
+                registerInputs(opt, *workerStreamDataPtr, decodeThreadPool.get(), ploidyVcfStreamPtr);
+            }
+            HtsMergeStreamer& workerStreamData(*workerStreamDataPtr);
+
+            starling_streams workerStreams(opt, sampleNames);
+            starling_read_counts workerReadCounts;
+            reference_contig_segment workerRef;
+            starling_pos_processor workerPosProcessor(opt, dopt, workerRef, workerStreams, statsManager);
 
-            for (const auto& subRegionRange : subRegionRanges)
+            unsigned workRegionIndex(0);
+            while (workQueue.getNextTask(workerIndex, workRegionIndex))
             {
-                AnalysisRegionInfo subRegionInfo;
-                getStrelkaAnalysisRegionInfo(regionInfo.regionChrom, subRegionRange.begin_pos(), subRegionRange.end_pos(),
-                                             supplementalRegionBorderSize, subRegionInfo);
-                callRegion(opt, subRegionInfo, fileStreams, sampleIndexToPloidyVcfSampleIndex, ploidyVcfSampleCount,
-                           readCounts, ref, streamData, posProcessor);
+                callRegion(opt, referenceStore, workRegionInfoList[workRegionIndex], workerStreams,
+                           sampleIndexToPloidyVcfSampleIndex, ploidyVcfSampleCount, workerReadCounts,
+                           statsManager, workerRef, workerStreamData, workerPosProcessor);
+                workerPosProcessor.finishRegion();
+                outputMerger.addRegionOutput(workRegionIndex, workerStreams.getRecordOutputStreams());
             }
-        }
+        };
+
+        runWorkStealingWorkers(workQueue, regionWorker);
     }
-    posProcessor.reset();
+
+    fileStreams.closeOutputStreams();
 }
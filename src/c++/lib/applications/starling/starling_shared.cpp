@@ -0,0 +1,53 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+
+#include "starling_shared.hh"
+
+
+
+starling_deriv_options::
+starling_deriv_options(const starling_options& opt)
+    : base_t(opt),
+      gvcf(opt.gvcf, opt.isRNA)
+{
+    const SCORING_CALL_TYPE::index_t callType(opt.isRNA ? SCORING_CALL_TYPE::RNA : SCORING_CALL_TYPE::GERMLINE);
+
+    if (not opt.snv_scoring_model_filename.empty())
+    {
+        snvScoringModel.reset(
+            new VariantScoringModelServer(
+                gvcf.snvFeatureSet.getFeatureMap(),
+                opt.snv_scoring_model_filename,
+                callType,
+                SCORING_VARIANT_TYPE::SNV)
+        );
+    }
+
+    if (not opt.indel_scoring_model_filename.empty())
+    {
+        indelScoringModel.reset(
+            new VariantScoringModelServer(
+                gvcf.indelFeatureSet.getFeatureMap(),
+                opt.indel_scoring_model_filename,
+                callType,
+                SCORING_VARIANT_TYPE::INDEL)
+        );
+    }
+}
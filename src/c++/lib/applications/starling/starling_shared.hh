@@ -24,6 +24,7 @@
 #pragma once
 
 #include "gvcf_options.hh"
+#include "calibration/VariantScoringModelServer.hh"
 #include "starling_common/starling_base_shared.hh"
 
 
@@ -104,10 +105,12 @@ struct starling_deriv_options : public starling_base_deriv_options
     typedef starling_base_deriv_options base_t;
 
     explicit
-    starling_deriv_options(const starling_options& opt)
-        : base_t(opt),
-          gvcf(opt.gvcf, opt.isRNA)
-    {}
+    starling_deriv_options(const starling_options& opt);
 
     gvcf_deriv_options gvcf;
+
+    /// germline empirical variant scoring models are loaded here so that they can be shared read-only
+    /// across all position processors (ie. one for each region worker thread)
+    std::unique_ptr<VariantScoringModelServer> snvScoringModel;
+    std::unique_ptr<VariantScoringModelServer> indelScoringModel;
 };
@@ -18,36 +18,42 @@
 //
 
 #include "starling_streams.hh"
+#include "gvcf_header.hh"
 #include "htsapi/bam_header_util.hh"
 
 #include <cassert>
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 
 std::unique_ptr<std::ostream>
 starling_streams::
 initializeGermlineVCFStream(
     const starling_options& opt,
+    const starling_deriv_options& dopt,
     const prog_info& pinfo,
     const std::string& filename,
     const char* label,
-    const bam_hdr_t& header)
+    const bam_hdr_t& header,
+    const std::vector<std::string>& headerSampleNames,
+    const bool isGenomeVCF)
 {
-    std::ofstream* fosPtr(new std::ofstream);
-    open_ofstream(pinfo, filename, label, *fosPtr);
+    std::unique_ptr<std::ostream> osPtr(initialize_output_stream(opt, pinfo, filename, label, BGZF_INDEX_TYPE::VCF));
 
     if (not opt.gvcf.is_skip_header)
     {
-        std::ostream& os(*fosPtr);
+        std::ostream& os(*osPtr);
         const char* const cmdline(opt.cmdline.c_str());
 
         write_vcf_audit(opt,pinfo,cmdline,header,os);
 
         os << "##content=" << pinfo.name() << " germline small-variant calls\n";
+
+        finishGermlineVCFheader(opt, dopt.gvcf, dopt.gvcf.chrom_depth, headerSampleNames, isGenomeVCF, os);
     }
-    return std::unique_ptr<std::ostream>(fosPtr);
+    return osPtr;
 }
 
 
@@ -55,6 +61,7 @@ initializeGermlineVCFStream(
 starling_streams::
 starling_streams(
     const starling_options& opt,
+    const starling_deriv_options& dopt,
     const prog_info& pinfo,
     const std::vector<std::reference_wrapper<const bam_hdr_t>>& bamHeaders,
     const std::vector<std::string>& sampleNames)
@@ -67,7 +74,8 @@ starling_streams(
     if (opt.gvcf.is_gvcf_output())
     {
         const std::string gvcfVariantsPath(opt.gvcf.outputPrefix+"variants.vcf");
-        _variantsVCFStreamPtr = initializeGermlineVCFStream(opt, pinfo, gvcfVariantsPath, "variants", referenceHeader);
+        _variantsVCFStreamPtr = initializeGermlineVCFStream(opt, dopt, pinfo, gvcfVariantsPath, "variants",
+                                                            referenceHeader, sampleNames, false);
         const unsigned sampleCount(getSampleCount());
         for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
         {
@@ -75,7 +83,8 @@ starling_streams(
             sampleTag << "S" << (sampleIndex+1);
             const std::string gvcfSamplePath(opt.gvcf.outputPrefix+"genome." + sampleTag.str() + ".vcf");
             _gvcfSampleStreamPtr.push_back(
-                initializeGermlineVCFStream(opt, pinfo, gvcfSamplePath, sampleTag.str().c_str(), referenceHeader));
+                initializeGermlineVCFStream(opt, dopt, pinfo, gvcfSamplePath, sampleTag.str().c_str(),
+                                            referenceHeader, {sampleNames[sampleIndex]}, true));
         }
     }
 
@@ -90,3 +99,39 @@ starling_streams(
         }
     }
 }
+
+
+
+starling_streams::
+starling_streams(
+    const starling_options& opt,
+    const std::vector<std::string>& sampleNames)
+    : base_t(sampleNames.size()),
+      _sampleNames(sampleNames)
+{
+    if (opt.gvcf.is_gvcf_output())
+    {
+        _variantsVCFStreamPtr.reset(new std::ostringstream);
+        const unsigned sampleCount(getSampleCount());
+        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+        {
+            _gvcfSampleStreamPtr.emplace_back(new std::ostringstream);
+        }
+    }
+}
+
+
+
+std::vector<std::ostream*>
+starling_streams::
+getRecordOutputStreams() const
+{
+    std::vector<std::ostream*> recordStreams;
+    recordStreams.push_back(_variantsVCFStreamPtr.get());
+    const unsigned sampleCount(getSampleCount());
+    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+    {
+        recordStreams.push_back((sampleIndex < _gvcfSampleStreamPtr.size()) ? _gvcfSampleStreamPtr[sampleIndex].get() : nullptr);
+    }
+    return recordStreams;
+}
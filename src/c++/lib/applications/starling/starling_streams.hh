@@ -29,10 +29,19 @@ struct starling_streams : public starling_streams_base
 
     starling_streams(
         const starling_options& opt,
+        const starling_deriv_options& dopt,
         const prog_info& pinfo,
         const std::vector<std::reference_wrapper<const bam_hdr_t>>& bamHeaders,
         const std::vector<std::string>& sampleNames);
 
+    /// \brief Create in-memory record output streams for one region worker thread
+    ///
+    /// The enabled set of outputs matches the primary file streams, but no headers are written. Buffered
+    /// records are transferred to the primary file streams in region order by RegionOutputMerger.
+    starling_streams(
+        const starling_options& opt,
+        const std::vector<std::string>& sampleNames);
+
     std::ostream&
     gvcfSampleStream(const unsigned sampleIndex) const
     {
@@ -52,15 +61,32 @@ struct starling_streams : public starling_streams_base
         return _sampleNames;
     }
 
+    /// \brief Get all variant record output streams in a fixed order, with null entries for disabled outputs
+    std::vector<std::ostream*>
+    getRecordOutputStreams() const;
+
+    /// \brief Finish all variant record output files, throws if any compressed output could not be written
+    ///
+    /// This should be called once all records have been written, compressed output files are otherwise only
+    /// closed by their destructors, which can only log an error.
+    void
+    closeOutputStreams()
+    {
+        close_output_streams(getRecordOutputStreams());
+    }
+
 private:
     static
     std::unique_ptr<std::ostream>
     initializeGermlineVCFStream(
         const starling_options& opt,
+        const starling_deriv_options& dopt,
         const prog_info& pinfo,
         const std::string& filename,
         const char* label,
-        const bam_hdr_t& header);
+        const bam_hdr_t& header,
+        const std::vector<std::string>& headerSampleNames,
+        const bool isGenomeVCF);
 
     std::unique_ptr<std::ostream> _variantsVCFStreamPtr;
     std::vector<std::unique_ptr<std::ostream>> _gvcfSampleStreamPtr;
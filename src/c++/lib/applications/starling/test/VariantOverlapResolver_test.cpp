@@ -59,7 +59,7 @@ BOOST_AUTO_TEST_CASE( simple_indel_test )
 
     const starling_deriv_options dopt(opt);
 
-    ScoringModelManager cm(opt, dopt.gvcf);
+    ScoringModelManager cm(opt, dopt);
 
     std::shared_ptr<variant_pipe_stage_base> next(new DummyVariantSink);
     VariantOverlapResolver overlap(cm, next);
@@ -60,13 +60,13 @@ protected:
 
     virtual void flush_impl() {}
 
+    /// downcast to a locus type, using the locus type tag instead of RTTI
     template <class TDerived, class TBase>
     static std::unique_ptr<TDerived> downcast(std::unique_ptr<TBase> basePtr)
     {
-        TDerived* ptr(dynamic_cast<TDerived*>(basePtr.release()));
-        if (ptr != nullptr)
+        if (TDerived::isInstance(*basePtr))
         {
-            return std::unique_ptr<TDerived>(ptr);
+            return std::unique_ptr<TDerived>(static_cast<TDerived*>(basePtr.release()));
         }
         throw std::bad_cast();
     }
@@ -74,7 +74,7 @@ protected:
     template <class TDerived, class TBase>
     inline bool isInstanceOf(TBase& Instance)
     {
-        return (dynamic_cast<TDerived*>(&Instance) != nullptr);
+        return TDerived::isInstance(Instance);
     }
 
     std::shared_ptr<variant_pipe_stage_base> _sink;
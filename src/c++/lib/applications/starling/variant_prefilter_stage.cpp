@@ -56,16 +56,19 @@ process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr)
     _model.applyDepthFilter(*locusPtr);
 
     // apply filtration/EVS model:
-    if (dynamic_cast<GermlineContinuousSiteLocusInfo*>(locusPtr.get()) != nullptr)
+    if (GermlineContinuousSiteLocusInfo::isInstance(*locusPtr))
     {
         _model.default_classify_site_locus(*locusPtr);
     }
     else
     {
-        _model.classify_site(dynamic_cast<GermlineDiploidSiteLocusInfo&>(*locusPtr));
+        assert(GermlineDiploidSiteLocusInfo::isInstance(*locusPtr));
+        _batchSites.push_back(static_cast<GermlineDiploidSiteLocusInfo*>(locusPtr.get()));
     }
 
-    _sink->process(std::move(locusPtr));
+    _buffer.emplace_back();
+    _buffer.back().sitePtr = std::move(locusPtr);
+    if (_buffer.size() >= maxBufferSize) processBuffer();
 }
 
 
@@ -97,15 +100,54 @@ process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr)
         _model.applyDepthFilter(*locusPtr);
 
         // apply filtration/EVS model:
-        if (dynamic_cast<GermlineContinuousIndelLocusInfo*>(locusPtr.get()) != nullptr)
+        if (GermlineContinuousIndelLocusInfo::isInstance(*locusPtr))
         {
             _model.default_classify_indel_locus(*locusPtr);
         }
         else
         {
-            _model.classify_indel(dynamic_cast<GermlineDiploidIndelLocusInfo&>(*locusPtr));
+            assert(GermlineDiploidIndelLocusInfo::isInstance(*locusPtr));
+            _batchIndels.push_back(static_cast<GermlineDiploidIndelLocusInfo*>(locusPtr.get()));
         }
     }
 
-    _sink->process(std::move(locusPtr));
+    _buffer.emplace_back();
+    _buffer.back().indelPtr = std::move(locusPtr);
+    if (_buffer.size() >= maxBufferSize) processBuffer();
+}
+
+
+
+void
+variant_prefilter_stage::
+processBuffer()
+{
+    // classification of each locus is independent of all other loci, so batching by locus type does not change
+    // the result:
+    _model.classify_sites(_batchSites.data(), _batchSites.size());
+    _model.classify_indels(_batchIndels.data(), _batchIndels.size());
+    _batchSites.clear();
+    _batchIndels.clear();
+
+    for (BufferedLocus& bufferedLocus : _buffer)
+    {
+        if (bufferedLocus.sitePtr)
+        {
+            _sink->process(std::move(bufferedLocus.sitePtr));
+        }
+        else
+        {
+            _sink->process(std::move(bufferedLocus.indelPtr));
+        }
+    }
+    _buffer.clear();
+}
+
+
+
+void
+variant_prefilter_stage::
+flush_impl()
+{
+    processBuffer();
 }
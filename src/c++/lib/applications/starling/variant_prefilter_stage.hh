@@ -24,6 +24,8 @@
 
 #include "variant_pipe_stage_base.hh"
 
+#include <vector>
+
 struct RegionTracker;
 struct ScoringModelManager;
 
@@ -41,9 +43,32 @@ struct variant_prefilter_stage : public variant_pipe_stage_base
     void process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr) override;
 
 private:
+    void flush_impl() override;
+
     void
     applySharedLocusFilters(
         LocusInfo& locus) const;
 
+    /// run the EVS model on all buffered diploid loci in a single batch, and pass every buffered locus on to the
+    /// next stage in input order
+    void
+    processBuffer();
+
+    /// holds exactly one of a site or indel locus, so that the input order of mixed locus types is preserved
+    struct BufferedLocus
+    {
+        std::unique_ptr<GermlineSiteLocusInfo> sitePtr;
+        std::unique_ptr<GermlineIndelLocusInfo> indelPtr;
+    };
+
+    /// maximum number of loci held before the buffer is scored and passed on
+    static const unsigned maxBufferSize = 64;
+
     const ScoringModelManager& _model;
+
+    std::vector<BufferedLocus> _buffer;
+
+    /// diploid loci in _buffer which still require EVS/default classification
+    std::vector<GermlineDiploidSiteLocusInfo*> _batchSites;
+    std::vector<GermlineDiploidIndelLocusInfo*> _batchIndels;
 };
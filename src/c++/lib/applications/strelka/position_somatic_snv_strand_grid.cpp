@@ -61,22 +61,16 @@ somatic_snv_caller_strand_grid(const strelka_options& opt)
 static
 void
 get_diploid_strand_grid_lhood_spi(
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const unsigned ref_gt,
     blt_float_t* const lhood)
 {
-    // TODO: make this thread safe...
-    //
-    static het_ratio_cache<2> hrcache;
-
     // get likelihood of each genotype
     for (unsigned gt(0); gt<(DIGT_GRID::STRAND_STATE_SIZE); ++gt) lhood[gt] = 0.;
 
     for (unsigned i(0); i<DIGT_GRID::HET_RES; ++i)
     {
-        const blt_float_t het_ratio((i+1)*DIGT_GRID::RATIO_INCREMENT);
-        get_strand_ratio_lhood_spi(pi,ref_gt,het_ratio,i,hrcache,
-                                   lhood+i);
+        get_strand_ratio_lhood_spi(histogram,ref_gt,i,lhood+i);
     }
 }
 
@@ -280,16 +274,21 @@ position_somatic_snv_call(
         const extended_pos_info& nepi(is_include_tier2 ? *normal_epi_t2_ptr : normal_epi );
         const extended_pos_info& tepi(is_include_tier2 ? *tumor_epi_t2_ptr : tumor_epi );
 
-        get_diploid_gt_lhood_cached_simple(nepi.pi, sgt.ref_gt, normal_lhood);
-        get_diploid_gt_lhood_cached_simple(tepi.pi, sgt.ref_gt, tumor_lhood);
+        // reduce each pileup to a basecall histogram, so that all likelihood terms below are evaluated
+        // once per distinct (base,qscore,strand) rather than once per basecall:
+        const BasecallHistogram normalHistogram(nepi.pi.calls);
+        const BasecallHistogram tumorHistogram(tepi.pi.calls);
+
+        get_diploid_gt_lhood_cached_simple(normalHistogram, sgt.ref_gt, normal_lhood);
+        get_diploid_gt_lhood_cached_simple(tumorHistogram, sgt.ref_gt, tumor_lhood);
 
         // get likelihood of non-canonical frequencies (0.05, 0.1, ..., 0.45, 0.55, ..., 0.95)
-        get_diploid_het_grid_lhood_cached(nepi.pi, sgt.ref_gt, DIGT_GRID::HET_RES, normal_lhood+SOMATIC_DIGT::SIZE);
-        get_diploid_het_grid_lhood_cached(tepi.pi, sgt.ref_gt, DIGT_GRID::HET_RES, tumor_lhood+SOMATIC_DIGT::SIZE);
+        get_diploid_het_grid_lhood_cached(normalHistogram, sgt.ref_gt, DIGT_GRID::HET_RES, normal_lhood+SOMATIC_DIGT::SIZE);
+        get_diploid_het_grid_lhood_cached(tumorHistogram, sgt.ref_gt, DIGT_GRID::HET_RES, tumor_lhood+SOMATIC_DIGT::SIZE);
 
         // get likelihood of strand states (0.05, ..., 0.45)
-//        get_diploid_strand_grid_lhood_spi(nepi.pi,sgt.ref_gt,normal_lhood+DIGT_GRID::PRESTRAND_SIZE);
-        get_diploid_strand_grid_lhood_spi(tepi.pi,sgt.ref_gt,tumor_lhood+DIGT_GRID::PRESTRAND_SIZE);
+//        get_diploid_strand_grid_lhood_spi(normalHistogram,sgt.ref_gt,normal_lhood+DIGT_GRID::PRESTRAND_SIZE);
+        get_diploid_strand_grid_lhood_spi(tumorHistogram,sgt.ref_gt,tumor_lhood+DIGT_GRID::PRESTRAND_SIZE);
 
         // genomic site results:
         calculate_result_set_grid(isComputeNonSomatic,
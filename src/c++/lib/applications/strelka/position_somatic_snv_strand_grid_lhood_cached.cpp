@@ -23,11 +23,12 @@
 
 #include "position_somatic_snv_strand_grid_lhood_cached.hh"
 #include "strelka_digt_states.hh"
-#include "strelka_common/het_ratio_cache.hh"
+#include "strelka_common/het_ratio_table.hh"
 
 #include "blt_util/digt.hh"
 #include "blt_util/logSumUtil.hh"
 
+#include <cassert>
 #include <cmath>
 
 
@@ -37,48 +38,89 @@ static const blt_float_t one_half(1./2.);
 static const blt_float_t ln_one_half(std::log(one_half));
 
 
+/// fill lhood table values for expect values of 0.0, 0.5 & 1.0
+static
+void
+fillDiploidLhoodValues(
+    const unsigned qscore,
+    const blt_float_t /*het_ratio*/,
+    cache_val<3>& cv)
+{
+    const blt_float_t eprob(qphred_to_error_prob(qscore));
+    const blt_float_t ceprob(1-eprob);
+    const blt_float_t lne(qphred_to_ln_error_prob(qscore));
+    const blt_float_t lnce(qphred_to_ln_comp_error_prob(qscore));
+
+    cv.val[0] = lne+ln_one_third;
+    cv.val[1] = std::log((ceprob)+((eprob)*one_third))+ln_one_half;
+    cv.val[2] = lnce;
+}
+
+
+
+/// fill lhood table values for expect values of het_ratio and chet_ratio
+static
+void
+fillHetRatioLhoodValues(
+    const unsigned qscore,
+    const blt_float_t het_ratio,
+    cache_val<2>& cv)
+{
+    const blt_float_t chet_ratio(1.-het_ratio);
+    const blt_float_t eprob(qphred_to_error_prob(qscore));
+    const blt_float_t ceprob(1-eprob);
+
+    cv.val[0] = std::log((ceprob)*het_ratio+((eprob)*one_third)*chet_ratio);
+    cv.val[1] = std::log((ceprob)*chet_ratio+((eprob)*one_third)*het_ratio);
+}
+
+
+
+static
+std::vector<blt_float_t>
+getHetGridRatios()
+{
+    std::vector<blt_float_t> hetRatios;
+    for (unsigned hetIndex(0); hetIndex<DIGT_GRID::HET_RES; ++hetIndex)
+    {
+        hetRatios.push_back((hetIndex+1)*DIGT_GRID::RATIO_INCREMENT);
+    }
+    return hetRatios;
+}
+
+
+
+static const het_ratio_table<3> diploidLhoodTable({one_half}, fillDiploidLhoodValues);
+static const het_ratio_table<2> hetGridLhoodTable(getHetGridRatios(), fillHetRatioLhoodValues);
+
+
+
 void
 get_diploid_gt_lhood_cached_simple(
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const unsigned ref_gt,
     blt_float_t* const lhood)
 {
-    // ! not thread-safe !
-    static het_ratio_cache<3> hrcache;
-
     // get likelihood of each genotype
     for (unsigned gt(0); gt<SOMATIC_DIGT::SIZE; ++gt) lhood[gt] = 0.;
 
-    for (const base_call& bc : pi.calls)
+    const cache_val<3>* const diploidRow(diploidLhoodTable.getRatioRow(0));
+    for (const BasecallHistogram::Bin& bin : histogram)
     {
-        std::pair<bool,cache_val<3>*> ret(hrcache.get_val(bc.get_qscore(),0));
-        cache_val<3>& cv(*ret.second);
-        if (! ret.first)
-        {
-            const blt_float_t eprob(bc.error_prob());
-            const blt_float_t ceprob(1-eprob);
-            const blt_float_t lne(bc.ln_error_prob());
-            const blt_float_t lnce(bc.ln_comp_error_prob());
-
-            // precalculate the result for expect values of 0.0, 0.5 & 1.0
-            cv.val[0] = lne+ln_one_third;
-            cv.val[1] = std::log((ceprob)+((eprob)*one_third))+ln_one_half;
-            cv.val[2] = lnce;
-        }
+        const cache_val<3>& cv(diploidRow[bin.qscore]);
+        const blt_float_t count(bin.count);
 
-        const uint8_t obs_id(bc.base_id);
-
-        if (obs_id == ref_gt)
+        if (bin.baseId == ref_gt)
         {
-            lhood[SOMATIC_DIGT::REF] += cv.val[2];
-            lhood[SOMATIC_DIGT::HET] += cv.val[1];
-            lhood[SOMATIC_DIGT::HOM] += cv.val[0];
+            lhood[SOMATIC_DIGT::REF] += count*cv.val[2];
+            lhood[SOMATIC_DIGT::HET] += count*cv.val[1];
+            lhood[SOMATIC_DIGT::HOM] += count*cv.val[0];
         }
         else
         {
-            lhood[SOMATIC_DIGT::REF] += cv.val[0];
-            lhood[SOMATIC_DIGT::HET] += cv.val[1];
-            lhood[SOMATIC_DIGT::HOM] += cv.val[2];
+            lhood[SOMATIC_DIGT::REF] += count*cv.val[0];
+            lhood[SOMATIC_DIGT::HET] += count*cv.val[1];
+            lhood[SOMATIC_DIGT::HOM] += count*cv.val[2];
         }
     }
 }
@@ -86,69 +128,48 @@ get_diploid_gt_lhood_cached_simple(
 static
 void
 get_high_low_het_ratio_lhood_cached(
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const unsigned ref_gt,
-    const blt_float_t het_ratio,
-    const unsigned het_ratio_index,
-    het_ratio_cache<2>& hrcache,
+    const cache_val<2>* const ratioRow,
     blt_float_t* lhood_high,
     blt_float_t* lhood_low)
 {
-    const blt_float_t chet_ratio(1.-het_ratio);
-
-    const unsigned n_calls(pi.calls.size());
-
-    for (unsigned i(0); i<n_calls; ++i)
+    for (const BasecallHistogram::Bin& bin : histogram)
     {
-        const base_call& bc(pi.calls[i]);
-
-        std::pair<bool,cache_val<2>*> ret(hrcache.get_val(bc.get_qscore(),het_ratio_index));
-        cache_val<2>& cv(*ret.second);
-        if (! ret.first)
-        {
-            const blt_float_t eprob(bc.error_prob());
-            const blt_float_t ceprob(1-eprob);
-
-            // precalculate the result for expect values of het_ratio and chet_ratio
-            cv.val[0] = std::log((ceprob)*het_ratio+((eprob)*one_third)*chet_ratio);    // mismatch for lhood_low, match for lhood_high
-            cv.val[1] = std::log((ceprob)*chet_ratio+((eprob)*one_third)*het_ratio);    // match for lhood_low, mismatch for lhood_high
-        }
-
-        const uint8_t obs_id(bc.base_id);
+        // value [0] is the mismatch for lhood_low, match for lhood_high
+        // value [1] is the match for lhood_low, mismatch for lhood_high
+        const cache_val<2>& cv(ratioRow[bin.qscore]);
+        const blt_float_t count(bin.count);
 
-        if (obs_id == ref_gt)   // match
+        if (bin.baseId == ref_gt)   // match
         {
-            *lhood_high += cv.val[0];
-            *lhood_low += cv.val[1];
+            *lhood_high += count*cv.val[0];
+            *lhood_low += count*cv.val[1];
         }
         else                    // mismatch
         {
-            *lhood_high += cv.val[1];
-            *lhood_low += cv.val[0];
+            *lhood_high += count*cv.val[1];
+            *lhood_low += count*cv.val[0];
         }
     }
 }
 
 void
 get_diploid_het_grid_lhood_cached(
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const unsigned ref_gt,
     const unsigned hetResolution,
     blt_float_t* const lhood)
 {
-    // ! not thread-safe !
-    static het_ratio_cache<2> hrcache;
+    assert(hetResolution <= hetGridLhoodTable.getRatioCount());
 
     // get likelihood of each genotype
     const unsigned totalHetRatios(hetResolution*2);
     for (unsigned gt(0); gt<totalHetRatios; ++gt) lhood[gt] = 0.;
 
-//    blt_float_t* lhood_off=lhood-N_BASE;
-
     for (unsigned hetIndex(0); hetIndex<hetResolution; ++hetIndex)
     {
-        const blt_float_t het_ratio((hetIndex+1)*DIGT_GRID::RATIO_INCREMENT);
-        get_high_low_het_ratio_lhood_cached(pi,ref_gt, het_ratio,hetIndex,hrcache,
+        get_high_low_het_ratio_lhood_cached(histogram,ref_gt,hetGridLhoodTable.getRatioRow(hetIndex),
                                             lhood+(totalHetRatios-(hetIndex+1)),
                                             lhood+hetIndex);
     }
@@ -158,77 +179,57 @@ get_diploid_het_grid_lhood_cached(
 //
 // accelerated version with no hyrax q-val mods:
 //
-// the ratio key can be used as a proxy for the het ratio to look up cached results:
-//
 void
 get_strand_ratio_lhood_spi(
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const unsigned ref_gt,
-    const blt_float_t het_ratio,
     const unsigned het_ratio_index,
-    het_ratio_cache<2>& hrcache,
     blt_float_t* lhood)
 {
     // het_ratio is the expected allele frequency of noise on the
-    // noise-strand, or "on-strand" below. All possible ratio values
-    // (there should be very few), have an associated index value for
-    // caching.
+    // noise-strand, or "on-strand" below. Every possible ratio value
+    // is drawn from the het grid, and indexed by het_ratio_index.
     //
-    const blt_float_t chet_ratio(1.-het_ratio);
-
     // In this situation every basecall falls into 1 of 4 states:
     //
     // 0: off-strand non-reference allele (0)
-    // 1: on-strand non-reference allele (het_ratio)  (cached)
-    // 2: on-strand agrees with the reference (chet_ratio) (cached)
+    // 1: on-strand non-reference allele (het_ratio)  (precomputed)
+    // 2: on-strand agrees with the reference (chet_ratio) (precomputed)
     // 3: off-strand agree with the reference (1)
     //
-    // The off-strand states are not cached below because they're
+    // The off-strand states are not precomputed below because they're
     // simpler to compute
     //
+    const cache_val<2>* const ratioRow(hetGridLhoodTable.getRatioRow(het_ratio_index));
+
     blt_float_t lhood_fwd = 0; // "on-strand" is fwd
     blt_float_t lhood_rev = 0; // "on-strand" is rev
 
-    for (const base_call& bc : pi.calls)
+    for (const BasecallHistogram::Bin& bin : histogram)
     {
-        std::pair<bool,cache_val<2>*> ret(hrcache.get_val(bc.get_qscore(),het_ratio_index));
-        cache_val<2>& cv(*ret.second);
-
-        // compute results only if they aren't already cached:
-        //
-        if (! ret.first)
-        {
-            const blt_float_t eprob(bc.error_prob());
-            const blt_float_t ceprob(1.-eprob);
-            // cached value [0] refers to state 2 above: on-strand
-            // reference allele
-            cv.val[0]=(std::log((ceprob)*chet_ratio+((eprob)*one_third)*het_ratio));
-            // cached value [1] refers to state 1 above: on-strand
-            // non-reference allele
-            cv.val[1]=(std::log((ceprob)*het_ratio+((eprob)*one_third)*chet_ratio));
-        }
-
-        const uint8_t obs_id(bc.base_id);
+        // table value [1] refers to state 2 above: on-strand reference allele
+        // table value [0] refers to state 1 above: on-strand non-reference allele
+        const cache_val<2>& cv(ratioRow[bin.qscore]);
+        const blt_float_t count(bin.count);
 
-        if (obs_id==ref_gt)
+        if (bin.baseId==ref_gt)
         {
-            const blt_float_t val_off_strand(bc.ln_comp_error_prob());
-            const blt_float_t val_fwd(bc.is_fwd_strand ? cv.val[0] : val_off_strand);
-            const blt_float_t val_rev(bc.is_fwd_strand ? val_off_strand : cv.val[0]);
-            lhood_fwd += val_fwd;
-            lhood_rev += val_rev;
+            const blt_float_t val_off_strand(qphred_to_ln_comp_error_prob(bin.qscore));
+            const blt_float_t val_fwd(bin.isFwdStrand ? cv.val[1] : val_off_strand);
+            const blt_float_t val_rev(bin.isFwdStrand ? val_off_strand : cv.val[1]);
+            lhood_fwd += count*val_fwd;
+            lhood_rev += count*val_rev;
         }
         else
         {
-            const blt_float_t val_off_strand(bc.ln_error_prob()+ln_one_third);
-            const blt_float_t val_fwd(bc.is_fwd_strand ? cv.val[1] : val_off_strand);
-            const blt_float_t val_rev(bc.is_fwd_strand ? val_off_strand : cv.val[1]);
+            const blt_float_t val_off_strand(qphred_to_ln_error_prob(bin.qscore)+ln_one_third);
+            const blt_float_t val_fwd(bin.isFwdStrand ? cv.val[0] : val_off_strand);
+            const blt_float_t val_rev(bin.isFwdStrand ? val_off_strand : cv.val[0]);
 
-            lhood_fwd += val_fwd;
-            lhood_rev += val_rev;
+            lhood_fwd += count*val_fwd;
+            lhood_rev += count*val_rev;
         }
     }
 
     *lhood = getLogSum(lhood_fwd,lhood_rev)+ln_one_half;
 }
-
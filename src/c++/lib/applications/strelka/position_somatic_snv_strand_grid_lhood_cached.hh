@@ -23,28 +23,27 @@
 
 #pragma once
 
+#include "blt_common/BasecallHistogram.hh"
 #include "blt_common/blt_shared.hh"
-#include "blt_common/snp_pos_info.hh"
-#include "strelka_common/het_ratio_cache.hh"
+#include "strelka_common/het_ratio_table.hh"
 
 void
 get_diploid_gt_lhood_cached_simple(
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const unsigned ref_gt,
     blt_float_t* const lhood);
 
 void
 get_diploid_het_grid_lhood_cached(
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const unsigned ref_gt,
     const unsigned hetResolution,
     blt_float_t* const lhood);
 
+/// get the lhood of strand-specific noise at the het ratio of the given index in the DIGT_GRID het ratio grid
 void
 get_strand_ratio_lhood_spi(
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const unsigned ref_gt,
-    const blt_float_t het_ratio,
     const unsigned het_ratio_index,
-    het_ratio_cache<2>& hrcache,
     blt_float_t* lhood);
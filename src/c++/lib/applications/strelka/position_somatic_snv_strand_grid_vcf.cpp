@@ -205,7 +205,7 @@ get_scoring_features(
     const unsigned zeroMappingQualityObservations(mapqTracker.zeroCount);
     smod.features.set(SOMATIC_SNV_SCORING_FEATURES::ZeroMappingQualityFraction, safeFrac(zeroMappingQualityObservations,mappingQualityObservations));
 
-    const double tumorSampleReadPosRankSum = t1_cpi.rawPileup().readPositionRankSum.get_z_stat();
+    const double tumorSampleReadPosRankSum = t1_cpi.rawPileup().get_read_pos_ranksum();
     smod.features.set(SOMATIC_SNV_SCORING_FEATURES::TumorSampleReadPosRankSum, tumorSampleReadPosRankSum);
 
     smod.features.set(SOMATIC_SNV_SCORING_FEATURES::TumorSampleStrandBias,rs.strandBias);
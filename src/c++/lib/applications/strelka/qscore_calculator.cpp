@@ -28,6 +28,9 @@
 #include "strelka_digt_states.hh"
 #include "blt_common/snp_util.hh"
 #include "blt_util/math_util.hh"
+#include "blt_util/VectorMathUtil.hh"
+
+#include <algorithm>
 
 
 
@@ -59,10 +62,12 @@ calculate_result_set_grid(
     static const blt_float_t ln_one_half(std::log(1./2.));
     static const blt_float_t log_error_mod = -std::log(static_cast<double>(DIGT_GRID::PRESTRAND_SIZE-1));
 
-    double log_post_prob[SOMATIC_DIGT::SIZE][SOMATIC_STATE::SIZE];
-    double max_log_prob = neg_inf;
+    static const unsigned stateCount(SOMATIC_DIGT::SIZE*SOMATIC_STATE::SIZE);
 
-    rs.max_gt = 0;
+    // log(D|G) for each state is accumulated as max_log_sum + log(exp_sum), the log transform is applied to all
+    // states together below:
+    double state_max_log_sum[SOMATIC_DIGT::SIZE][SOMATIC_STATE::SIZE];
+    double state_log_exp_sum[SOMATIC_DIGT::SIZE][SOMATIC_STATE::SIZE];
 
     for (unsigned ngt(0); ngt<SOMATIC_DIGT::SIZE; ++ngt)
     {
@@ -141,13 +146,30 @@ calculate_result_set_grid(
                 }
             }
 
-            // Calculate log(exp(log_sum[0]-max_log_sum) + ...
+            // Calculate exp(log_sum[0]-max_log_sum) + ...
+            vectorExp(log_sum, index, max_log_sum);
             double sum = 0.0;
             for (int i(0); i<index; ++i)
             {
-                sum += std::exp(log_sum[i] - max_log_sum);
+                sum += log_sum[i];
             }
 
+            state_max_log_sum[ngt][tgt] = max_log_sum;
+            state_log_exp_sum[ngt][tgt] = sum;
+        }
+    }
+
+    vectorLog(&state_log_exp_sum[0][0], stateCount);
+
+    double log_post_prob[SOMATIC_DIGT::SIZE][SOMATIC_STATE::SIZE];
+    double max_log_prob = neg_inf;
+
+    rs.max_gt = 0;
+
+    for (unsigned ngt(0); ngt<SOMATIC_DIGT::SIZE; ++ngt)
+    {
+        for (unsigned tgt(0); tgt<SOMATIC_STATE::SIZE; ++tgt)
+        {
             // logP(Gn=ngt, Gt=tgt)
             double log_genotype_prior = germlineGenotypeLogPrior[ngt] + ((tgt == 0) ? lnmatch : lnmismatch);
 
@@ -155,7 +177,7 @@ calculate_result_set_grid(
             // log(D|G)
             // = log(exp(log_sum[0])+exp(log_sum[1])+...)
             // = max_log_sum + log(exp(log_sum[0]-max_log_sum) + ...
-            log_post_prob[ngt][tgt] = log_genotype_prior + max_log_sum + std::log(sum);
+            log_post_prob[ngt][tgt] = log_genotype_prior + state_max_log_sum[ngt][tgt] + state_log_exp_sum[ngt][tgt];
 
             if (log_post_prob[ngt][tgt] > max_log_prob)
             {
@@ -166,13 +188,25 @@ calculate_result_set_grid(
     }
 
     // Calculate posterior probabilities ( P(G)*P(D|G) )
+    double scaled_log_post_prob[SOMATIC_DIGT::SIZE][SOMATIC_STATE::SIZE];
+    for (unsigned ngt(0); ngt<SOMATIC_DIGT::SIZE; ++ngt)
+    {
+        for (unsigned tgt(0); tgt<SOMATIC_STATE::SIZE; ++tgt)
+        {
+            scaled_log_post_prob[ngt][tgt] = log_post_prob[ngt][tgt] - max_log_prob; // to prevent underflow
+        }
+    }
+
+    double prob[SOMATIC_DIGT::SIZE][SOMATIC_STATE::SIZE];
+    std::copy(&scaled_log_post_prob[0][0], &scaled_log_post_prob[0][0]+stateCount, &prob[0][0]);
+    vectorExp(&prob[0][0], stateCount);
+
     double sum_prob = 0.0;
     for (unsigned ngt(0); ngt<SOMATIC_DIGT::SIZE; ++ngt)
     {
         for (unsigned tgt(0); tgt<SOMATIC_STATE::SIZE; ++tgt)
         {
-            double prob = std::exp(log_post_prob[ngt][tgt] - max_log_prob); // to prevent underflow
-            sum_prob += prob;
+            sum_prob += prob[ngt][tgt];
         }
     }
 
@@ -181,12 +215,14 @@ calculate_result_set_grid(
     double nonsom_prob = 0.0;
 
     double post_prob[SOMATIC_DIGT::SIZE][SOMATIC_STATE::SIZE];
+    std::copy(&scaled_log_post_prob[0][0], &scaled_log_post_prob[0][0]+stateCount, &post_prob[0][0]);
+    vectorExp(&post_prob[0][0], stateCount, log_sum_prob);
+
     for (unsigned ngt(0); ngt<SOMATIC_DIGT::SIZE; ++ngt)
     {
         double som_prob_given_ngt(0);
         for (unsigned tgt(0); tgt<SOMATIC_STATE::SIZE; ++tgt)
         {
-            post_prob[ngt][tgt] = std::exp(log_post_prob[ngt][tgt] - max_log_prob - log_sum_prob);
             if (tgt == 0)   // Non-somatic
             {
                 nonsom_prob += post_prob[ngt][tgt];
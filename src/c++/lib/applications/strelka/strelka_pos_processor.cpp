@@ -91,6 +91,17 @@ reset()
 
 
 
+void
+strelka_pos_processor::
+finishRegion()
+{
+    base_t::finishRegion();
+
+    _scallProcessor.flush();
+}
+
+
+
 void
 strelka_pos_processor::
 resetRegion(
@@ -50,6 +50,9 @@ struct strelka_pos_processor : public starling_pos_processor_base
 
     void reset() override;
 
+    /// in addition to the base class behavior, this completes any pending callable region output
+    void finishRegion() override;
+
     void
     resetRegion(
         const std::string& chromName,
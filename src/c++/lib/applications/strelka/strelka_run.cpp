@@ -23,10 +23,13 @@
 
 #include "appstats/RunStatsManager.hh"
 #include "blt_util/log.hh"
+#include "blt_util/WorkStealingTaskQueue.hh"
 #include "common/Exceptions.hh"
 #include "htsapi/bam_header_info.hh"
+#include "htsapi/HtsDecodeThreadPool.hh"
 #include "htsapi/vcf_record_util.hh"
 #include "starling_common/HtsMergeStreamerUtil.hh"
+#include "starling_common/RegionOutputMerger.hh"
 #include "starling_common/starling_ref_seq.hh"
 #include "starling_common/starling_pos_processor_util.hh"
 
@@ -49,8 +52,10 @@ static
 void
 callRegion(
     const strelka_options& opt,
+    const ReferenceStore& referenceStore,
     const AnalysisRegionInfo& regionInfo,
     starling_read_counts& readCounts,
+    RunStatsManager& statsManager,
     reference_contig_segment& ref,
     HtsMergeStreamer& streamData,
     strelka_pos_processor& posProcessor)
@@ -59,7 +64,7 @@ callRegion(
 
     posProcessor.resetRegion(regionInfo.regionChrom, regionInfo.regionRange);
     streamData.resetRegion(regionInfo.streamerRegion.c_str());
-    setRefSegment(opt, regionInfo.regionChrom, regionInfo.refRegionRange, ref);
+    setRefSegment(referenceStore, regionInfo.regionChrom, regionInfo.refRegionRange, ref);
 
     while (streamData.next())
     {
@@ -155,6 +160,49 @@ callRegion(
             assert(false && "Invalid input condition");
         }
     }
+
+    addInputAlignmentFilterCounts(streamData, readCounts, statsManager);
+}
+
+
+
+/// \brief Register all alignment, vcf and bed inputs with a merge streamer
+///
+/// \return Headers of all registered alignment files
+static
+std::vector<std::reference_wrapper<const bam_hdr_t>>
+registerInputs(
+    const strelka_options& opt,
+    HtsMergeStreamer& streamData,
+    HtsDecodeThreadPool* decodeThreadPoolPtr)
+{
+    std::vector<unsigned> registrationIndices;
+    for (const bool isTumor : opt.alignFileOpt.isAlignmentTumor)
+    {
+        const unsigned rindex(isTumor ? STRELKA_SAMPLE_TYPE::TUMOR : STRELKA_SAMPLE_TYPE::NORMAL);
+        registrationIndices.push_back(rindex);
+    }
+
+    const auto bamHeaders(registerAlignments(opt.alignFileOpt.alignmentFilenames, registrationIndices, streamData,
+                                               decodeThreadPoolPtr, opt.alignFileOpt.readAheadRecordCount,
+                                               getInputAlignmentFilterSpec(opt)));
+
+    assert(not bamHeaders.empty());
+    const bam_hdr_t& referenceHeader(bamHeaders.front());
+
+    static const bool noRequireNormalized(false);
+    registerVcfList(opt.input_candidate_indel_vcf, INPUT_TYPE::CANDIDATE_INDELS, referenceHeader, streamData,
+                    noRequireNormalized);
+    registerVcfList(opt.force_output_vcf, INPUT_TYPE::FORCED_GT_VARIANTS, referenceHeader, streamData);
+
+    registerVcfList(opt.noise_vcf, INPUT_TYPE::NOISE_VARIANTS, referenceHeader, streamData);
+
+    if (! opt.callRegionsBedFilename.empty())
+    {
+        streamData.registerBed(opt.callRegionsBedFilename.c_str(), INPUT_TYPE::CALL_REGION);
+    }
+
+    return bamHeaders;
 }
 
 
@@ -176,45 +224,25 @@ strelka_run(
     starling_read_counts readCounts;
     reference_contig_segment ref;
 
+    // the reference store is shared by all call threads:
+    const ReferenceStore referenceStore(opt.referenceFilename, opt.isUsePackedReference);
+
     ////////////////////////////////////////
     // setup streamData:
     //
+    // the decode thread pool is shared by all input alignment streams, so it must be created before any of them:
+    const std::unique_ptr<HtsDecodeThreadPool> decodeThreadPool(
+        createHtsDecodeThreadPool(opt.alignFileOpt.decodeThreadCount));
     HtsMergeStreamer streamData(opt.referenceFilename);
 
     // additional data structures required in the region loop below, which are filled in as a side effect of
     // streamData initialization:
-    std::vector<std::reference_wrapper<const bam_hdr_t>> bamHeaders;
-    {
-        std::vector<unsigned> registrationIndices;
-        for (const bool isTumor : opt.alignFileOpt.isAlignmentTumor)
-        {
-            const unsigned rindex(isTumor ? STRELKA_SAMPLE_TYPE::TUMOR : STRELKA_SAMPLE_TYPE::NORMAL);
-            registrationIndices.push_back(rindex);
-        }
-
-        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilenames, registrationIndices, streamData);
-
-        assert(not bamHeaders.empty());
-        const bam_hdr_t& referenceHeader(bamHeaders.front());
-
-        static const bool noRequireNormalized(false);
-        registerVcfList(opt.input_candidate_indel_vcf, INPUT_TYPE::CANDIDATE_INDELS, referenceHeader, streamData,
-                        noRequireNormalized);
-        registerVcfList(opt.force_output_vcf, INPUT_TYPE::FORCED_GT_VARIANTS, referenceHeader, streamData);
-
-        registerVcfList(opt.noise_vcf, INPUT_TYPE::NOISE_VARIANTS, referenceHeader, streamData);
-
-        if (! opt.callRegionsBedFilename.empty())
-        {
-            streamData.registerBed(opt.callRegionsBedFilename.c_str(), INPUT_TYPE::CALL_REGION);
-        }
-    }
+    const std::vector<std::reference_wrapper<const bam_hdr_t>> bamHeaders(registerInputs(opt, streamData, decodeThreadPool.get()));
 
     const bam_hdr_t& referenceHeader(bamHeaders.front());
     const bam_header_info referenceHeaderInfo(referenceHeader);
 
     strelka_streams fileStreams(opt, dopt, pinfo, referenceHeader, ssi);
-    strelka_pos_processor posProcessor(opt, dopt, ref, fileStreams, statsManager);
 
     // parse and sanity check regions
     assert ((! opt.isHaplotypingEnabled) && "Region border size must be updated if haplotyping is enabled");
@@ -225,25 +253,58 @@ strelka_run(
     getStrelkaAnalysisRegions(opt, referenceAlignmentFilename, referenceHeaderInfo, supplementalRegionBorderSize,
                               regionInfoList);
 
-    for (const auto& regionInfo : regionInfoList)
+    std::vector<AnalysisRegionInfo> workRegionInfoList;
+    getStrelkaWorkRegions(opt, referenceHeaderInfo, regionInfoList, supplementalRegionBorderSize, workRegionInfoList);
+
+    if (opt.callThreadCount <= 1)
     {
-        if (not opt.isUseCallRegions())
+        strelka_pos_processor posProcessor(opt, dopt, ref, fileStreams, statsManager);
+
+        for (const auto& workRegionInfo : workRegionInfoList)
         {
-            callRegion(opt, regionInfo, readCounts, ref, streamData, posProcessor);
+            callRegion(opt, referenceStore, workRegionInfo, readCounts, statsManager, ref, streamData, posProcessor);
         }
-        else
+        posProcessor.reset();
+    }
+    else
+    {
+        // each worker thread has its own input streams, reference segment, position processor and output buffers,
+        // options and scoring models are shared from dopt:
+        const unsigned workRegionCount(workRegionInfoList.size());
+        WorkStealingTaskQueue workQueue(workRegionCount, std::min(opt.callThreadCount, std::max(workRegionCount,1u)));
+        RegionOutputMerger outputMerger(fileStreams.getRecordOutputStreams(), workRegionCount);
+
+        auto regionWorker = [&](const unsigned workerIndex)
         {
-            std::vector<known_pos_range2> subRegionRanges;
-            getSubRegionsFromBedTrack(opt.callRegionsBedFilename, regionInfo.regionChrom, regionInfo.regionRange, subRegionRanges);
+            // the first worker streams from the inputs already opened on the main thread, so that only one set of
+            // inputs is opened per worker:
+            HtsMergeStreamer* workerStreamDataPtr(&streamData);
+            std::unique_ptr<HtsMergeStreamer> newStreamDataPtr;
+            if (workerIndex > 0)
+            {
+                newStreamDataPtr.reset(new HtsMergeStreamer(opt.referenceFilename));
+                workerStreamDataPtr = newStreamDataPtr.get();
+                registerInputs(opt, *workerStreamDataPtr, decodeThreadPool.get());
+            }
+            HtsMergeStreamer& workerStreamData(*workerStreamDataPtr);
+
+            strelka_streams workerStreams(opt, ssi);
+            starling_read_counts workerReadCounts;
+            reference_contig_segment workerRef;
+            strelka_pos_processor workerPosProcessor(opt, dopt, workerRef, workerStreams, statsManager);
 
-            for (const auto& subRegionRange : subRegionRanges)
+            unsigned workRegionIndex(0);
+            while (workQueue.getNextTask(workerIndex, workRegionIndex))
             {
-                AnalysisRegionInfo subRegionInfo;
-                getStrelkaAnalysisRegionInfo(regionInfo.regionChrom, subRegionRange.begin_pos(), subRegionRange.end_pos(),
-                                             supplementalRegionBorderSize, subRegionInfo);
-                callRegion(opt, subRegionInfo, readCounts, ref, streamData, posProcessor);
+                callRegion(opt, referenceStore, workRegionInfoList[workRegionIndex], workerReadCounts,
+                           statsManager, workerRef, workerStreamData, workerPosProcessor);
+                workerPosProcessor.finishRegion();
+                outputMerger.addRegionOutput(workRegionIndex, workerStreams.getRecordOutputStreams());
             }
-        }
+        };
+
+        runWorkStealingWorkers(workQueue, regionWorker);
     }
-    posProcessor.reset();
+
+    fileStreams.closeOutputStreams();
 }
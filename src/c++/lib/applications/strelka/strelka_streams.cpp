@@ -84,7 +84,7 @@ write_shared_vcf_header_info(
 static
 void
 writeLowEVSFilter(
-    std::ofstream& fos,
+    std::ostream& fos,
     const strelka_options& opt,
     const char* label)
 {
@@ -124,10 +124,9 @@ strelka_streams(
     {
         const char* const cmdline(opt.cmdline.c_str());
 
-        std::ofstream* fosptr(new std::ofstream);
-        _somatic_snv_osptr.reset(fosptr);
-        std::ofstream& fos(*fosptr);
-        open_ofstream(pinfo,opt.somatic_snv_filename,"somatic-snv",fos);
+        _somatic_snv_osptr = initialize_output_stream(opt, pinfo, opt.somatic_snv_filename, "somatic-snv",
+                                                      BGZF_INDEX_TYPE::VCF);
+        std::ostream& fos(*_somatic_snv_osptr);
 
         if (! opt.sfilter.is_skip_header)
         {
@@ -235,11 +234,9 @@ strelka_streams(
     {
         const char* const cmdline(opt.cmdline.c_str());
 
-        std::ofstream* fosptr(new std::ofstream);
-        _somatic_indel_osptr.reset(fosptr);
-        std::ofstream& fos(*fosptr);
-
-        open_ofstream(pinfo,opt.somatic_indel_filename,"somatic-indel",fos);
+        _somatic_indel_osptr = initialize_output_stream(opt, pinfo, opt.somatic_indel_filename, "somatic-indel",
+                                                        BGZF_INDEX_TYPE::VCF);
+        std::ostream& fos(*_somatic_indel_osptr);
 
         if (! opt.sfilter.is_skip_header)
         {
@@ -353,14 +350,12 @@ strelka_streams(
 
     if (opt.is_somatic_callable())
     {
-        std::ofstream* fosptr(new std::ofstream);
-        _somatic_callable_osptr.reset(fosptr);
-        std::ofstream& fos(*fosptr);
-
-        open_ofstream(pinfo,opt.somatic_callable_filename,"somatic-callable-regions",fos);
+        _somatic_callable_osptr = initialize_output_stream(opt, pinfo, opt.somatic_callable_filename,
+                                                           "somatic-callable-regions", BGZF_INDEX_TYPE::BED);
 
         // post samtools 1.0 tabix doesn't handle header information anymore, so take this out entirely:
 #if 0
+        std::ostream& fos(*_somatic_callable_osptr);
         if (! opt.sfilter.is_skip_header)
         {
             fos << "track name=\"StrelkaCallableSites\"\t"
@@ -369,3 +364,27 @@ strelka_streams(
 #endif
     }
 }
+
+
+
+strelka_streams::
+strelka_streams(
+    const strelka_options& opt,
+    const StrelkaSampleSetSummary& ssi)
+    : base_t(ssi.size())
+{
+    if (opt.is_somatic_snv())
+    {
+        _somatic_snv_osptr.reset(new std::ostringstream);
+    }
+
+    if (opt.is_somatic_indel())
+    {
+        _somatic_indel_osptr.reset(new std::ostringstream);
+    }
+
+    if (opt.is_somatic_callable())
+    {
+        _somatic_callable_osptr.reset(new std::ostringstream);
+    }
+}
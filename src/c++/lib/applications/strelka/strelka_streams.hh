@@ -40,6 +40,14 @@ struct strelka_streams : public starling_streams_base
         const bam_hdr_t& bam_header,
         const StrelkaSampleSetSummary& ssi);
 
+    /// \brief Create in-memory record output streams for one region worker thread
+    ///
+    /// The enabled set of outputs matches the primary file streams, but no headers are written. Buffered
+    /// records are transferred to the primary file streams in region order by RegionOutputMerger.
+    strelka_streams(
+        const strelka_options& opt,
+        const StrelkaSampleSetSummary& ssi);
+
     std::ostream*
     somatic_snv_osptr() const
     {
@@ -58,6 +66,23 @@ struct strelka_streams : public starling_streams_base
         return _somatic_callable_osptr.get();
     }
 
+    /// \brief Get all record output streams in a fixed order, with null entries for disabled outputs
+    std::vector<std::ostream*>
+    getRecordOutputStreams() const
+    {
+        return { somatic_snv_osptr(), somatic_indel_osptr(), somatic_callable_osptr() };
+    }
+
+    /// \brief Finish all record output files, throws if any compressed output could not be written
+    ///
+    /// This should be called once all records have been written, compressed output files are otherwise only
+    /// closed by their destructors, which can only log an error.
+    void
+    closeOutputStreams()
+    {
+        close_output_streams(getRecordOutputStreams());
+    }
+
 private:
     std::unique_ptr<std::ostream> _somatic_snv_osptr;
     std::unique_ptr<std::ostream> _somatic_indel_osptr;
@@ -0,0 +1,188 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "position_somatic_snv_strand_grid_lhood_cached.hh"
+#include "strelka_digt_states.hh"
+
+#include "blt_util/logSumUtil.hh"
+#include "blt_util/time_util.hh"
+
+#include <cmath>
+
+
+BOOST_AUTO_TEST_SUITE( position_somatic_snv_strand_grid_lhood_cached_test )
+
+
+/// create a pileup cycling through all basecall qscores, bases and strands
+static
+void
+getTestPileup(
+    const unsigned depth,
+    snp_pos_info& pi)
+{
+    pi.clear();
+    pi.set_ref_base('A');
+    for (unsigned callIndex(0); callIndex<depth; ++callIndex)
+    {
+        const uint8_t baseId(callIndex % N_BASE);
+        const uint8_t qscore(2 + (callIndex % 62));
+        const bool isFwdStrand((callIndex % 3) != 0);
+        pi.calls.emplace_back(baseId, qscore, isFwdStrand, 0, 0, false, false, false);
+    }
+}
+
+
+/// reference het ratio lhood for one basecall, computed without any precomputed table
+static
+double
+getRefHetRatioLhood(
+    const base_call& bc,
+    const bool isMatch,
+    const double het_ratio)
+{
+    const double expect(isMatch ? (1.-het_ratio) : het_ratio);
+    return std::log((1.-bc.error_prob())*expect + (bc.error_prob()/3.)*(1.-expect));
+}
+
+
+static const double tol(0.001);
+
+
+BOOST_AUTO_TEST_CASE( test_diploid_gt_lhood_cached_simple )
+{
+    snp_pos_info pi;
+    getTestPileup(200, pi);
+    static const unsigned ref_gt(0);
+
+    blt_float_t lhood[SOMATIC_DIGT::SIZE];
+    get_diploid_gt_lhood_cached_simple(BasecallHistogram(pi.calls), ref_gt, lhood);
+
+    double expectRef(0), expectHet(0), expectHom(0);
+    for (const base_call& bc : pi.calls)
+    {
+        const double lnMatch(bc.ln_comp_error_prob());
+        const double lnMismatch(bc.ln_error_prob()+std::log(1./3.));
+        const double lnHalf(std::log((1.-bc.error_prob())+(bc.error_prob()/3.))+std::log(0.5));
+        const bool isMatch(bc.base_id == ref_gt);
+        expectRef += (isMatch ? lnMatch : lnMismatch);
+        expectHet += lnHalf;
+        expectHom += (isMatch ? lnMismatch : lnMatch);
+    }
+
+    BOOST_REQUIRE_CLOSE(lhood[SOMATIC_DIGT::REF], expectRef, tol);
+    BOOST_REQUIRE_CLOSE(lhood[SOMATIC_DIGT::HET], expectHet, tol);
+    BOOST_REQUIRE_CLOSE(lhood[SOMATIC_DIGT::HOM], expectHom, tol);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_diploid_het_grid_lhood_cached )
+{
+    snp_pos_info pi;
+    getTestPileup(200, pi);
+    static const unsigned ref_gt(1);
+    static const unsigned hetResolution(DIGT_GRID::HET_RES);
+
+    blt_float_t lhood[hetResolution*2];
+    get_diploid_het_grid_lhood_cached(BasecallHistogram(pi.calls), ref_gt, hetResolution, lhood);
+
+    for (unsigned hetIndex(0); hetIndex<hetResolution; ++hetIndex)
+    {
+        const double het_ratio((hetIndex+1)*DIGT_GRID::RATIO_INCREMENT);
+        double expectHigh(0), expectLow(0);
+        for (const base_call& bc : pi.calls)
+        {
+            const bool isMatch(bc.base_id == ref_gt);
+            expectHigh += getRefHetRatioLhood(bc, isMatch, 1.-het_ratio);
+            expectLow += getRefHetRatioLhood(bc, isMatch, het_ratio);
+        }
+        BOOST_REQUIRE_CLOSE(lhood[hetResolution*2-(hetIndex+1)], expectHigh, tol);
+        BOOST_REQUIRE_CLOSE(lhood[hetIndex], expectLow, tol);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_strand_ratio_lhood_spi )
+{
+    snp_pos_info pi;
+    getTestPileup(200, pi);
+    static const unsigned ref_gt(2);
+
+    const BasecallHistogram histogram(pi.calls);
+    for (unsigned hetIndex(0); hetIndex<DIGT_GRID::HET_RES; ++hetIndex)
+    {
+        blt_float_t lhood(0);
+        get_strand_ratio_lhood_spi(histogram, ref_gt, hetIndex, &lhood);
+
+        const double het_ratio((hetIndex+1)*DIGT_GRID::RATIO_INCREMENT);
+        double expectFwd(0), expectRev(0);
+        for (const base_call& bc : pi.calls)
+        {
+            const bool isMatch(bc.base_id == ref_gt);
+            const double onStrand(getRefHetRatioLhood(bc, isMatch, het_ratio));
+            const double offStrand(isMatch ? bc.ln_comp_error_prob() : (bc.ln_error_prob()+std::log(1./3.)));
+            expectFwd += (bc.is_fwd_strand ? onStrand : offStrand);
+            expectRev += (bc.is_fwd_strand ? offStrand : onStrand);
+        }
+        const double expect(getLogSum(expectFwd, expectRev)+std::log(0.5));
+        BOOST_REQUIRE_CLOSE(lhood, expect, tol);
+    }
+}
+
+
+/// micro-benchmark of the per-site cost of the precomputed lhood kernels, including basecall histogram construction
+///
+/// timing is reported at the 'message' log level, run with '--log_level=message' to view results
+///
+BOOST_AUTO_TEST_CASE( benchmark_snv_lhood_kernels )
+{
+    static const unsigned depth(1000);
+    static const unsigned siteCount(200);
+
+    snp_pos_info pi;
+    getTestPileup(depth, pi);
+
+    blt_float_t lhood[DIGT_GRID::HET_RES*2];
+    double checksum(0);
+
+    TimeTracker timer;
+    timer.resume();
+    for (unsigned siteIndex(0); siteIndex<siteCount; ++siteIndex)
+    {
+        const BasecallHistogram histogram(pi.calls);
+        get_diploid_gt_lhood_cached_simple(histogram, 0, lhood);
+        checksum += lhood[0];
+        get_diploid_het_grid_lhood_cached(histogram, 0, DIGT_GRID::HET_RES, lhood);
+        checksum += lhood[0];
+        for (unsigned hetIndex(0); hetIndex<DIGT_GRID::HET_RES; ++hetIndex)
+        {
+            get_strand_ratio_lhood_spi(histogram, 0, hetIndex, lhood);
+            checksum += lhood[0];
+        }
+    }
+    timer.stop();
+
+    const double nsPerSite((timer.getWallSeconds()*1e9)/siteCount);
+    BOOST_TEST_MESSAGE("SNV lhood kernels, depth " << depth << ": " << nsPerSite << " ns/site");
+    BOOST_REQUIRE(std::isfinite(checksum));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,7 @@
 #include "blt_util/log.hh"
 #include "common/Exceptions.hh"
 #include "htsapi/bam_header_info.hh"
+#include "htsapi/HtsDecodeThreadPool.hh"
 #include "htsapi/vcf_record_util.hh"
 #include "starling_common/HtsMergeStreamerUtil.hh"
 #include "starling_common/starling_ref_seq.hh"
@@ -55,10 +56,14 @@ snoise_run(
     const starling_base_deriv_options dopt(opt);
     starling_read_counts readCounts;
     reference_contig_segment ref;
+    const ReferenceStore referenceStore(opt.referenceFilename, opt.isUsePackedReference);
 
     ////////////////////////////////////////
     // setup streamData:
     //
+    // the decode thread pool is shared by all input alignment streams, so it must be created before any of them:
+    const std::unique_ptr<HtsDecodeThreadPool> decodeThreadPool(
+        createHtsDecodeThreadPool(opt.alignFileOpt.decodeThreadCount));
     HtsMergeStreamer streamData(opt.referenceFilename);
 
     // additional data structures required in the region loop below, which are filled in as a side effect of
@@ -66,7 +71,9 @@ snoise_run(
     std::vector<std::reference_wrapper<const bam_hdr_t>> bamHeaders;
     {
         std::vector<unsigned> registrationIndices(opt.alignFileOpt.alignmentFilenames.size(), 0);
-        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilenames, registrationIndices, streamData);
+        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilenames, registrationIndices, streamData,
+                                        decodeThreadPool.get(), opt.alignFileOpt.readAheadRecordCount,
+                                        getInputAlignmentFilterSpec(opt));
 
         assert(not bamHeaders.empty());
         const bam_hdr_t& referenceHeader(bamHeaders.front());
@@ -94,7 +101,7 @@ snoise_run(
     {
         posProcessor.resetRegion(rinfo.regionChrom, rinfo.regionRange);
         streamData.resetRegion(rinfo.streamerRegion.c_str());
-        setRefSegment(opt, rinfo.regionChrom, rinfo.refRegionRange, ref);
+        setRefSegment(referenceStore, rinfo.regionChrom, rinfo.refRegionRange, ref);
 
         while (streamData.next())
         {
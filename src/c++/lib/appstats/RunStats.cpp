@@ -41,6 +41,19 @@ report(std::ostream& os) const
     os << "\n";
     os << "CallRegionCandidateIndels\t" << candidateIndels << "\n";
     os << "CallRegionNonCandidateIndels\t" << nonCandidateIndels << "\n";
+    os << "\n";
+    os << "PileupSlabAllocations\t" << pileupSlabAllocations << "\n";
+    os << "PileupSlabBytes\t" << pileupSlabBytes << "\n";
+    os << "PileupArrayAllocations\t" << pileupArrayAllocations << "\n";
+    os << "\n";
+    os << "DownsampledReads\t" << downsampledReads << "\n";
+    os << "\n";
+    os << "FilteredQCFailReads\t" << filteredQcFailReads << "\n";
+    os << "FilteredDuplicateReads\t" << filteredDuplicateReads << "\n";
+    os << "FilteredUnmappedReads\t" << filteredUnmappedReads << "\n";
+    os << "FilteredSecondaryReads\t" << filteredSecondaryReads << "\n";
+    os << "FilteredSupplementaryReads\t" << filteredSupplementaryReads << "\n";
+    os << "FilteredLowMAPQReads\t" << filteredLowMapqReads << "\n";
 }
 
 
@@ -45,6 +45,16 @@ struct RunStatsData
         lifeTime.merge(rhs.lifeTime);
         candidateIndels += rhs.candidateIndels;
         nonCandidateIndels += rhs.nonCandidateIndels;
+        pileupSlabAllocations += rhs.pileupSlabAllocations;
+        pileupSlabBytes += rhs.pileupSlabBytes;
+        pileupArrayAllocations += rhs.pileupArrayAllocations;
+        downsampledReads += rhs.downsampledReads;
+        filteredQcFailReads += rhs.filteredQcFailReads;
+        filteredDuplicateReads += rhs.filteredDuplicateReads;
+        filteredUnmappedReads += rhs.filteredUnmappedReads;
+        filteredSecondaryReads += rhs.filteredSecondaryReads;
+        filteredSupplementaryReads += rhs.filteredSupplementaryReads;
+        filteredLowMapqReads += rhs.filteredLowMapqReads;
     }
 
     void
@@ -56,6 +66,16 @@ struct RunStatsData
         ar& BOOST_SERIALIZATION_NVP(lifeTime);
         ar& BOOST_SERIALIZATION_NVP(candidateIndels);
         ar& BOOST_SERIALIZATION_NVP(nonCandidateIndels);
+        ar& BOOST_SERIALIZATION_NVP(pileupSlabAllocations);
+        ar& BOOST_SERIALIZATION_NVP(pileupSlabBytes);
+        ar& BOOST_SERIALIZATION_NVP(pileupArrayAllocations);
+        ar& BOOST_SERIALIZATION_NVP(downsampledReads);
+        ar& BOOST_SERIALIZATION_NVP(filteredQcFailReads);
+        ar& BOOST_SERIALIZATION_NVP(filteredDuplicateReads);
+        ar& BOOST_SERIALIZATION_NVP(filteredUnmappedReads);
+        ar& BOOST_SERIALIZATION_NVP(filteredSecondaryReads);
+        ar& BOOST_SERIALIZATION_NVP(filteredSupplementaryReads);
+        ar& BOOST_SERIALIZATION_NVP(filteredLowMapqReads);
     }
 
     /// Total wall-time of each (single-thread) process, summed together
@@ -66,6 +86,29 @@ struct RunStatsData
 
     /// Total indels failing to reach candidate status in the report range and (if defined) call regions
     unsigned long nonCandidateIndels = 0;
+
+    /// Total heap allocations of pileup storage slabs, summed over all samples
+    unsigned long pileupSlabAllocations = 0;
+
+    /// Total size in bytes of all pileup storage slabs allocated from the heap
+    unsigned long pileupSlabBytes = 0;
+
+    /// Total per-position pileup arrays carved from storage slabs, including array regrowth
+    unsigned long pileupArrayAllocations = 0;
+
+    /// Total reads dropped by the limit on reads per start position, summed over all samples
+    unsigned long downsampledReads = 0;
+
+    /// Total input alignment records removed by each record filter before reaching the caller, summed over all
+    /// input alignment files. A record matching more than one filter is only counted under the first of these
+    /// in the order listed here. Records streamed by more than one region, such as those in the border shared by
+    /// two adjacent regions, are counted once for each region.
+    unsigned long filteredQcFailReads = 0;
+    unsigned long filteredDuplicateReads = 0;
+    unsigned long filteredUnmappedReads = 0;
+    unsigned long filteredSecondaryReads = 0;
+    unsigned long filteredSupplementaryReads = 0;
+    unsigned long filteredLowMapqReads = 0;
 };
 
 BOOST_CLASS_IMPLEMENTATION(RunStatsData, boost::serialization::object_serializable)
@@ -20,17 +20,22 @@
 #pragma once
 
 #include "RunStats.hh"
+#include "blt_util/SlabArena.hh"
 #include "blt_util/time_util.hh"
+#include "htsapi/BamRecordFilter.hh"
 
 #include "boost/utility.hpp"
 
 #include <iosfwd>
+#include <mutex>
 #include <string>
 
 
 /// \brief Handles all messy real world interaction for the stats module, while the stats module itself just
 ///        accumulates data
 ///
+/// Stats updates are thread-safe, so that a single manager can be shared by all region worker threads.
+///
 struct RunStatsManager : private boost::noncopyable
 {
     explicit
@@ -42,6 +47,7 @@ struct RunStatsManager : private boost::noncopyable
     void
     addCallRegionIndel(const bool isCandidate)
     {
+        std::lock_guard<std::mutex> guard(_statsLock);
         if (isCandidate)
         {
             runStats.runStatsData.candidateIndels++;
@@ -52,9 +58,45 @@ struct RunStatsManager : private boost::noncopyable
         }
     }
 
+    /// add pileup storage allocation counts from one sample's basecall buffer
+    void
+    addPileupAllocationStats(const SlabArenaStats& stats)
+    {
+        std::lock_guard<std::mutex> guard(_statsLock);
+        runStats.runStatsData.pileupSlabAllocations += stats.slabAllocations;
+        runStats.runStatsData.pileupSlabBytes += stats.slabBytes;
+        runStats.runStatsData.pileupArrayAllocations += stats.blockAllocations;
+    }
+
+    /// add reads dropped by the limit on reads per start position from one sample
+    void
+    addDownsampledReads(const unsigned long readCount)
+    {
+        std::lock_guard<std::mutex> guard(_statsLock);
+        runStats.runStatsData.downsampledReads += readCount;
+    }
+
+    /// add input alignment records removed by the bam_streamer record filters
+    void
+    addBamRecordFilterCounts(const BamRecordFilterCounts& filterCounts)
+    {
+        using namespace BAM_RECORD_FILTER;
+
+        std::lock_guard<std::mutex> guard(_statsLock);
+        RunStatsData& data(runStats.runStatsData);
+        data.filteredQcFailReads += filterCounts.count[QC_FAIL];
+        data.filteredDuplicateReads += filterCounts.count[DUPLICATE];
+        data.filteredUnmappedReads += filterCounts.count[UNMAPPED];
+        data.filteredSecondaryReads += filterCounts.count[SECONDARY];
+        data.filteredSupplementaryReads += filterCounts.count[SUPPLEMENTARY];
+        data.filteredLowMapqReads += filterCounts.count[LOW_MAPQ];
+    }
+
 private:
     std::ostream* _osPtr;
 
+    std::mutex _statsLock;
+
     /// this object tracks its own lifetime from ctor-to-dtor here, this is used to approximate
     /// program lifetime when RunStatsManager is appropriately scoped
     TimeTracker lifeTime;
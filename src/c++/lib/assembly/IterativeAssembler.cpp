@@ -24,6 +24,7 @@
 
 
 #include "assembly/IterativeAssembler.hh"
+#include "assembly/PackedKmerIndex.hh"
 #include "blt_util/set_util.hh"
 
 #include "boost/foreach.hpp"
@@ -31,7 +32,7 @@
 #include <cassert>
 
 #include <algorithm>
-#include <unordered_map>
+#include <iterator>
 #include <vector>
 
 
@@ -55,25 +56,11 @@ void print_unsignSet(const std::set<unsigned>& unsignSet)
     }
     log_os << "]\n";
 }
-
-static
-void print_stringSet(const std::set<std::string>& strSet)
-{
-    log_os << "[";
-    for (const std::string& str : strSet)
-    {
-        log_os << str << ",";
-    }
-    log_os << "]\n";
-}
 #endif
 
 
-// maps kmers to positions in read
-typedef std::unordered_map<std::string,unsigned> str_uint_map_t;
-// maps kmers to supporting reads
-typedef std::unordered_map<std::string,std::set<unsigned> > str_set_uint_map_t;
-typedef std::unordered_map<std::string, std::pair<unsigned,unsigned> > str_pair_uint_map_t;
+typedef PackedKmerIndex::word_t kmer_word_t;
+typedef PackedKmerIndex::read_list_t kmer_read_list_t;
 
 
 
@@ -93,70 +80,52 @@ addBase(
 
 
 
-/// Returns a suffix (isEnd is true) or prefix (otherwise) of the input contig with the specified length.
+/// Write the k-mer formed by extending @p kmer with symbol @p symbolCode at the end (isEnd is true)
+/// or start (otherwise) to @p result, dropping one symbol from the opposite side.
+///
+/// \return the id of the extended k-mer, or invalidId if it does not occur in the reads
 static
-std::string
-getEnd(
-    const std::string& contig,
-    const unsigned length,
-    const bool isEnd)
+unsigned
+getExtendedKmerId(
+    const PackedKmerIndex& kmerIndex,
+    const kmer_word_t* kmer,
+    const unsigned symbolCode,
+    const bool isEnd,
+    kmer_word_t* result)
 {
-
-    const unsigned csize(contig.size());
-    assert(length <= csize);
-
-    if (isEnd) return contig.substr((csize-length),length);
-    else       return contig.substr(0,length);
+    if (isEnd) kmerIndex.getSuccessor(kmer, symbolCode, result);
+    else       kmerIndex.getPredecessor(kmer, symbolCode, result);
+    return kmerIndex.getKmerId(result);
 }
 
 
-#if 0
-/// adapt Ole's function to represent word hash as a graph:
+
+/// Write the k-mer formed by replacing the last (isEnd is true) or first (otherwise) symbol
+/// of @p kmer with @p symbolCode to @p result.
 ///
-void
-wordHashToDot(
-    const str_uint_map_t& wordCount,
-    std::ostream& os)
+/// \return the id of the new k-mer, or invalidId if it does not occur in the reads
+static
+unsigned
+getReplacedKmerId(
+    const PackedKmerIndex& kmerIndex,
+    const kmer_word_t* kmer,
+    const unsigned symbolCode,
+    const bool isEnd,
+    kmer_word_t* result)
 {
-    static const unsigned MIN_KMER_FREQ(1);
-
-    // kmer nodes with coverage higher than this get a different color
-    //static const int lowCovGraphVisThreshold(3);
-    static const unsigned lowCovGraphVisThreshold(MIN_KMER_FREQ);
-    static const std::string lowCovNodeColor("red");
-    static const std::string highCovNodeColor("green");
-
-    os << "graph {\n";
-    os << "node [ style = filled ];\n";
-    str_uint_map_t aliasH;
-    unsigned n(0);
-    for (const str_uint_map_t::value_type& val : wordCount)
+    // shift the replaced symbol out, then shift the new symbol back in from the same side:
+    if (isEnd)
     {
-        const std::string& word(val.first);
-        const unsigned cov(val.second);
-        aliasH[word] = n++;
-        const std::string& color(cov>lowCovGraphVisThreshold ? highCovNodeColor : lowCovNodeColor);
-        os << word << "[label=\"cov" << cov << "\" color=" << color << "]\n";
+        kmerIndex.getPredecessor(kmer, 0, result);
+        kmerIndex.getSuccessor(result, symbolCode, result);
     }
-
-    // need to add edges here
-    static const bool isEnd(true);
-    for (const str_uint_map_t::value_type& val : wordCount)
+    else
     {
-        const std::string& word(val.first);
-        const std::string tmp(getEnd(word,word.size()-1,isEnd));
-        for (const char symbol : alphabet)
-        {
-            const std::string newKey(addBase(tmp,symbol,isEnd));
-            if (wordCount.find(newKey) != wordCount.end())
-            {
-                os << aliasH[word] << " -- " << aliasH[newKey] << ";\n";
-            }
-        }
+        kmerIndex.getSuccessor(kmer, 0, result);
+        kmerIndex.getPredecessor(result, symbolCode, result);
     }
-    os << "}\n";
+    return kmerIndex.getKmerId(result);
 }
-#endif
 
 
 
@@ -170,56 +139,55 @@ wordHashToDot(
 static
 bool
 walk(const IterativeAssemblerOptions& opt,
-     const std::string& seed,
-     const unsigned wordLength,
-     const str_uint_map_t& wordCount,
-     const str_set_uint_map_t& wordReads,
-     const std::set<std::string>& repeatWords,
-     std::set<std::string>& unusedWords,
+     const unsigned seedId,
+     const PackedKmerIndex& kmerIndex,
+     const std::vector<bool>& isRepeatKmer,
+     std::vector<bool>& isUsedKmer,
      AssembledContig& contig)
 {
-    const str_uint_map_t::const_iterator wordCountEnd(wordCount.cend());
-    const str_set_uint_map_t::const_iterator wordReadsEnd(wordReads.cend());
+    const unsigned wordLength(kmerIndex.getKmerLength());
+    std::vector<kmer_word_t> newKmer(kmerIndex.getWordsPerKmer());
 
 #ifdef DEBUG_WALK
-    log_os << "\nSeed: " << seed << "\n";
+    log_os << "\nSeed: " << kmerIndex.getKmerString(seedId) << "\n";
 #endif
     // we start with the seed
-    str_set_uint_map_t::const_iterator wordReadsIter(wordReads.find(seed));
-    assert(wordReadsIter != wordReadsEnd);
-    contig.supportReads = wordReadsIter->second;
-    contig.seq = seed;
-    unusedWords.erase(seed);
+    const kmer_read_list_t& seedReads(kmerIndex.getSupportReads(seedId));
+    contig.supportReads.insert(seedReads.begin(), seedReads.end());
+    contig.seq = kmerIndex.getKmerString(seedId);
+    isUsedKmer[seedId] = true;
 
-    if (repeatWords.find(seed) != repeatWords.end())
+    if (isRepeatKmer[seedId])
     {
 #ifdef DEBUG_WALK
-        log_os << "The seed is a repeat word " << seed << ". Stop walk.\n";
+        log_os << "The seed is a repeat word " << contig.seq << ". Stop walk.\n";
 #endif
         contig.conservativeRange.set_begin_pos(0);
         contig.conservativeRange.set_end_pos(wordLength);
         return true;
     }
 
-    const std::string tmpTrunk = getEnd(seed, wordLength-1, false);
+    const kmer_word_t* seed(kmerIndex.getKmer(seedId));
+    const unsigned seedLastCode(kmerIndex.getLastSymbolCode(seed));
     // collecting rejecting reads for the seed from the unselected branches
     for (const char symbol : opt.alphabet)
     {
+        const unsigned symbolCode(kmerIndex.getSymbolCode(symbol));
+
         // the seed itself
-        if (symbol == seed[wordLength-1]) continue;
+        if (symbolCode == seedLastCode) continue;
 
         // add rejecting reads from an unselected word/branch
-        const std::string newKey(addBase(tmpTrunk, symbol, true));
+        const unsigned newKmerId(getReplacedKmerId(kmerIndex, seed, symbolCode, true, newKmer.data()));
 #ifdef DEBUG_WALK
-        log_os << "Extending the seed trunk: base " << symbol << " " << newKey << "\n";
+        log_os << "Extending the seed trunk: base " << symbol << "\n";
 #endif
 
-        wordReadsIter= wordReads.find(newKey);
-        if (wordReadsIter == wordReadsEnd) continue;
-        const std::set<unsigned>& unselectedReads(wordReadsIter->second);
+        if (newKmerId == PackedKmerIndex::invalidId) continue;
+        const kmer_read_list_t& unselectedReads(kmerIndex.getSupportReads(newKmerId));
 #ifdef DEBUG_WALK
         log_os << "Supporting reads for the non-seed word : ";
-        print_unsignSet(unselectedReads);
+        print_unsignSet(std::set<unsigned>(unselectedReads.begin(), unselectedReads.end()));
 #endif
 
         contig.rejectReads.insert(unselectedReads.begin(), unselectedReads.end());
@@ -231,19 +199,27 @@ walk(const IterativeAssemblerOptions& opt,
 
     bool isRepeatFound(false);
 
+    // read id lists reused across extension steps:
+    std::vector<unsigned> contigWordReads;
+    std::vector<unsigned> maxContigWordReads;
+    std::vector<unsigned> supportReads2Remove;
+    std::vector<unsigned> rejectReads2Add;
+
     // 0 => walk to the right, 1 => walk to the left
     for (unsigned mode(0); mode<2; ++mode)
     {
         const bool isEnd(mode==0);
         unsigned conservativeEndOffset(0);
 
+        // the k-mer at the contig end in the current walk direction
+        unsigned endKmerId(seedId);
+
         while (true)
         {
-            const std::string previousWord = getEnd(contig.seq, wordLength, isEnd);
-            const std::string trunk(getEnd(contig.seq, wordLength-1, isEnd));
+            const kmer_word_t* previousWord(kmerIndex.getKmer(endKmerId));
 #ifdef DEBUG_WALK
             log_os << "# current contig : " << contig.seq << " size : " << contig.seq.size() << "\n"
-                   << " getEnd : " << trunk << "\n";
+                   << " getEnd : " << kmerIndex.getKmerString(endKmerId) << "\n";
             log_os << "contig rejecting reads : ";
             print_unsignSet(contig.rejectReads);
             log_os << "contig supporting reads : ";
@@ -253,37 +229,33 @@ walk(const IterativeAssemblerOptions& opt,
             unsigned maxBaseCount(0);
             unsigned maxContigWordReadCount(0);
             char maxBase(opt.alphabet[0]);
-            std::string maxWord;
-            std::set<unsigned> maxWordReads;
-            std::set<unsigned> maxContigWordReads;
-            std::set<unsigned> previousWordReads;
-            std::set<unsigned> supportReads2Remove;
-            std::set<unsigned> rejectReads2Add;
+            unsigned maxWordId(PackedKmerIndex::invalidId);
+            const kmer_read_list_t* maxWordReadsPtr(nullptr);
+            maxContigWordReads.clear();
+            supportReads2Remove.clear();
+            rejectReads2Add.clear();
 
             for (const char symbol : opt.alphabet)
             {
-                const std::string newKey(addBase(trunk, symbol, isEnd));
+                const unsigned newKmerId(getExtendedKmerId(kmerIndex, previousWord, kmerIndex.getSymbolCode(symbol),
+                                                           isEnd, newKmer.data()));
 #ifdef DEBUG_WALK
-                log_os << "Extending end : base " << symbol << " " << newKey << "\n";
+                log_os << "Extending end : base " << symbol << "\n";
 #endif
-                const str_uint_map_t::const_iterator wordCountIter(wordCount.find(newKey));
-                if (wordCountIter == wordCountEnd) continue;
-                const unsigned currWordCount(wordCountIter->second);
-
-                wordReadsIter= wordReads.find(newKey);
-                if (wordReadsIter == wordReadsEnd) continue;
-                const std::set<unsigned>& currWordReads(wordReadsIter->second);
+                if (newKmerId == PackedKmerIndex::invalidId) continue;
+                const unsigned currWordCount(kmerIndex.getCount(newKmerId));
+                const kmer_read_list_t& currWordReads(kmerIndex.getSupportReads(newKmerId));
 
                 // get the shared supporting reads between the contig and the current word
-                std::set<unsigned> contigWordReads;
+                contigWordReads.clear();
                 std::set_intersection(contig.supportReads.begin(), contig.supportReads.end(),
                                       currWordReads.begin(), currWordReads.end(),
-                                      std::inserter(contigWordReads, contigWordReads.begin()));
+                                      std::back_inserter(contigWordReads));
 #ifdef DEBUG_WALK
                 log_os << "Word supporting reads : ";
-                print_unsignSet(currWordReads);
+                print_unsignSet(std::set<unsigned>(currWordReads.begin(), currWordReads.end()));
                 log_os << "Contig-word shared reads : ";
-                print_unsignSet(contigWordReads);
+                print_unsignSet(std::set<unsigned>(contigWordReads.begin(), contigWordReads.end()));
 #endif
 
                 if (contigWordReads.empty()) continue;
@@ -293,25 +265,24 @@ walk(const IterativeAssemblerOptions& opt,
                 {
                     // the old shared reads support an unselected allele
                     // remove them from the contig's supporting reads
-                    if (!maxContigWordReads.empty())
-                        supportReads2Remove.insert(maxContigWordReads.begin(), maxContigWordReads.end());
+                    supportReads2Remove.insert(supportReads2Remove.end(), maxContigWordReads.begin(), maxContigWordReads.end());
                     // the old supporting reads is for an unselected allele
                     // they become rejecting reads for the currently selected allele
-                    if (!maxWordReads.empty())
-                        rejectReads2Add.insert(maxWordReads.begin(), maxWordReads.end());
+                    if (maxWordReadsPtr != nullptr)
+                        rejectReads2Add.insert(rejectReads2Add.end(), maxWordReadsPtr->begin(), maxWordReadsPtr->end());
                     // new supporting reads for the currently selected allele
-                    maxWordReads = currWordReads;
+                    maxWordReadsPtr = &currWordReads;
 
                     maxContigWordReadCount = contigWordReadCount;
-                    maxContigWordReads = contigWordReads;
+                    maxContigWordReads.swap(contigWordReads);
                     maxBaseCount = currWordCount;
                     maxBase = symbol;
-                    maxWord = newKey;
+                    maxWordId = newKmerId;
                 }
                 else
                 {
-                    supportReads2Remove.insert(contigWordReads.begin(), contigWordReads.end());
-                    rejectReads2Add.insert(currWordReads.begin(), currWordReads.end());
+                    supportReads2Remove.insert(supportReads2Remove.end(), contigWordReads.begin(), contigWordReads.end());
+                    rejectReads2Add.insert(rejectReads2Add.end(), currWordReads.begin(), currWordReads.end());
                 }
             }
 
@@ -319,7 +290,7 @@ walk(const IterativeAssemblerOptions& opt,
             log_os << "Winner is : " << maxBase << " with " << maxBaseCount << " occurrences." << "\n";
 #endif
 
-            if (maxBaseCount < opt.minCoverage)
+            if ((maxBaseCount < opt.minCoverage) || (maxWordId == PackedKmerIndex::invalidId))
             {
 
 #ifdef DEBUG_WALK
@@ -348,52 +319,44 @@ walk(const IterativeAssemblerOptions& opt,
             // TODO: can add threshold for the count or percentage of shared reads
             {
                 // walk backwards for one step at a branching point
-                if (maxWordReads != previousWordReads)
+                const unsigned tmpSymbolCode(isEnd ? kmerIndex.getFirstSymbolCode(previousWord)
+                                             : kmerIndex.getLastSymbolCode(previousWord));
+                for (const char symbol : opt.alphabet)
                 {
-                    const char tmpSymbol = (isEnd? previousWord[0] : previousWord[wordLength-1]);
-                    for (const char symbol : opt.alphabet)
-                    {
-                        // the selected branch: skip the backward word itself
-                        if (symbol == tmpSymbol) continue;
-
-                        // add rejecting reads from an unselected branch
-                        const std::string newKey(addBase(trunk, symbol, !isEnd));
-#ifdef DEBUG_WALK
-                        log_os << "Extending end backwards: base " << symbol << " " << newKey << "\n";
-#endif
-                        // the selected branch: skip the word just extended
-                        if (newKey == maxWord) continue;
+                    const unsigned symbolCode(kmerIndex.getSymbolCode(symbol));
 
-                        wordReadsIter= wordReads.find(newKey);
-                        if (wordReadsIter == wordReadsEnd) continue;
+                    // the selected branch: skip the backward word itself
+                    if (symbolCode == tmpSymbolCode) continue;
 
-                        const std::set<unsigned>& backWordReads(wordReadsIter->second);
+                    // add rejecting reads from an unselected branch
+                    const unsigned newKmerId(getReplacedKmerId(kmerIndex, previousWord, symbolCode, !isEnd,
+                                                               newKmer.data()));
 #ifdef DEBUG_WALK
-                        log_os << "Supporting reads for the backwards word : ";
-                        print_unsignSet(backWordReads);
+                    log_os << "Extending end backwards: base " << symbol << "\n";
 #endif
-                        rejectReads2Add.insert(backWordReads.begin(), backWordReads.end());
+                    if (newKmerId == PackedKmerIndex::invalidId) continue;
+
+                    // the selected branch: skip the word just extended
+                    if (newKmerId == maxWordId) continue;
+
+                    const kmer_read_list_t& backWordReads(kmerIndex.getSupportReads(newKmerId));
 #ifdef DEBUG_WALK
-                        log_os << "rejectReads2Add upated : ";
-                        print_unsignSet(rejectReads2Add);
+                    log_os << "Supporting reads for the backwards word : ";
+                    print_unsignSet(std::set<unsigned>(backWordReads.begin(), backWordReads.end()));
 #endif
-                    }
+                    rejectReads2Add.insert(rejectReads2Add.end(), backWordReads.begin(), backWordReads.end());
                 }
-                previousWordReads = maxWordReads;
 
 #ifdef DEBUG_WALK
                 log_os << "Adding rejecting reads " << "\n"
                        << " Old : ";
                 print_unsignSet(contig.rejectReads);
                 log_os << " To be added : ";
-                print_unsignSet(rejectReads2Add);
+                print_unsignSet(std::set<unsigned>(rejectReads2Add.begin(), rejectReads2Add.end()));
 #endif
                 // update rejecting reads
                 // add reads that support the unselected allele
-                for (const unsigned rd : rejectReads2Add)
-                {
-                    contig.rejectReads.insert(rd);
-                }
+                contig.rejectReads.insert(rejectReads2Add.begin(), rejectReads2Add.end());
 #ifdef DEBUG_WALK
                 log_os << " New : ";
                 print_unsignSet(contig.rejectReads);
@@ -404,11 +367,11 @@ walk(const IterativeAssemblerOptions& opt,
                        << " Old : ";
                 print_unsignSet(contig.supportReads);
                 log_os << " To be added : ";
-                print_unsignSet(maxWordReads);
+                print_unsignSet(std::set<unsigned>(maxWordReadsPtr->begin(), maxWordReadsPtr->end()));
 #endif
                 // update supporting reads
                 // add reads that support the selected allel
-                for (const unsigned rd : maxWordReads)
+                for (const unsigned rd : *maxWordReadsPtr)
                 {
                     if (contig.rejectReads.find(rd) == contig.rejectReads.end())
                         contig.supportReads.insert(rd);
@@ -420,7 +383,7 @@ walk(const IterativeAssemblerOptions& opt,
 
 #ifdef DEBUG_WALK
                 log_os << " To be removed : ";
-                print_unsignSet(supportReads2Remove);
+                print_unsignSet(std::set<unsigned>(supportReads2Remove.begin(), supportReads2Remove.end()));
 #endif
                 // remove reads that do NOT support the selected allel anymore
                 for (const unsigned rd : supportReads2Remove)
@@ -434,16 +397,17 @@ walk(const IterativeAssemblerOptions& opt,
             }
 
             // remove the last word from the unused list, so it cannot be used as the seed in finding the next contig
-            unusedWords.erase(maxWord);
+            isUsedKmer[maxWordId] = true;
             // stop walk in the current mode after seeing one repeat word
-            if (repeatWords.find(maxWord) != repeatWords.end())
+            if (isRepeatKmer[maxWordId])
             {
 #ifdef DEBUG_WALK
-                log_os << "Seen a repeat word " << maxWord << ". Stop walk in the current mode " << mode << "\n";
+                log_os << "Seen a repeat word " << kmerIndex.getKmerString(maxWordId) << ". Stop walk in the current mode " << mode << "\n";
 #endif
                 isRepeatFound = true;
                 break;
             }
+            endKmerId = maxWordId;
         }
 
         // set conservative coverage range for the contig
@@ -464,7 +428,7 @@ walk(const IterativeAssemblerOptions& opt,
 
 
 
-/// Construct k-mer maps
+/// Construct k-mer index
 /// k-mer ==> number of reads containing the k-mer
 /// k-mer ==> a list of read IDs containg the k-mer
 static
@@ -472,36 +436,14 @@ void
 getKmerCounts(
     const IterativeAssemblerOptions& opt,
     const AssemblyReadInput& reads,
-    AssemblyReadOutput& readInfo,
-    const unsigned wordLength,
-    str_uint_map_t& wordCount,
-    str_set_uint_map_t& wordSupportReads)
+    const AssemblyReadOutput& readInfo,
+    PackedKmerIndex& kmerIndex)
 {
     const unsigned readCount(reads.size());
 
     for (unsigned readIndex(0); readIndex<readCount; ++readIndex)
     {
-        // stores the index of a kmer in a read sequence
-        const std::string& seq(reads[readIndex]);
-        const unsigned readLen(seq.size());
-
-        // this read is unusable for assembly:
-        if (readLen < wordLength) continue;
-
-        // track all words from the read, including repetitive words
-        std::set<std::string> readWords;
-        for (unsigned j(0); j<=(readLen-wordLength); ++j)
-        {
-            const std::string word(seq.substr(j,wordLength));
-
-            // filter words with "N" (either directly from input alignment
-            // or marked due to low basecall quality:
-            if (word.find('N') != std::string::npos) continue;
-
-            readWords.insert(word);
-        }
-
-        AssemblyReadInfo& rinfo(readInfo[readIndex]);
+        const AssemblyReadInfo& rinfo(readInfo[readIndex]);
         unsigned wordCountAdd = 1;
         // pseudo reads must have passed coverage check with smaller kmers
         // Assigning minCoverage (instead of 1) to a pseudo read allows the pseudo read to rescue the regions
@@ -509,127 +451,127 @@ getKmerCounts(
         if (rinfo.isPseudo)
             wordCountAdd = opt.minCoverage;
 
-        // total occurrences from this read
-        for (const std::string& word : readWords)
-        {
-            wordCount[word] += wordCountAdd;
-            // record the supporting read
-            wordSupportReads[word].insert(readIndex);
-        }
+        // words with "N" (either directly from input alignment or marked due to low basecall quality)
+        // are filtered by the index, and each word is counted once per read
+        kmerIndex.addRead(reads[readIndex], readIndex, wordCountAdd);
     }
 }
 
 
+
 /// Identify repetitive k-mers
 /// i.e. k-mers that form a circular subgraph
 ///
+/// Circles are found as the strongly connected components of the k-mer graph, using Tarjan's
+/// algorithm on an explicit search path so that the search depth is not limited by the call stack.
+///
 static
-unsigned
-searchRepeats(
+void
+getRepeatKmers(
     const IterativeAssemblerOptions& opt,
-    const unsigned index,
-    const std::string& word,
-    str_pair_uint_map_t& wordIndices,
-    std::vector<std::string>& wordStack,
-    std::set<std::string>& repeatWords)
+    const PackedKmerIndex& kmerIndex,
+    std::vector<bool>& isRepeatKmer)
 {
-    // set the depth index for the current word to the smallest unused index
-    wordIndices[word] = std::pair<unsigned,unsigned>(index, index);
-    unsigned nextIndex = index + 1;
-    wordStack.push_back(word);
+    const unsigned kmerCount(kmerIndex.size());
+    isRepeatKmer.assign(kmerCount, false);
 
-    const std::string tmp(getEnd(word, word.size()-1, true));
-    for (const char symbol : opt.alphabet)
-    {
-        // candidate successor of the current word
-        const std::string nextWord(addBase(tmp, symbol, true));
-
-        // homopolymer
-        if (word == nextWord)
-        {
-            repeatWords.insert(word);
-            continue;
-        }
+    // depth index and lowlink of each word, a zero depth index marks words which have not been visited
+    std::vector<unsigned> wordIndices(kmerCount, 0);
+    std::vector<unsigned> wordLowLinks(kmerCount, 0);
+    std::vector<bool> isWordInStack(kmerCount, false);
+    std::vector<unsigned> wordStack;
 
-        // the successor word does not exist in the reads
-        if (wordIndices.count(nextWord) == 0) continue;
+    // each search path entry holds a word and the alphabet index of its next candidate successor
+    std::vector<std::pair<unsigned,unsigned>> searchPath;
+    std::vector<kmer_word_t> nextWord(kmerIndex.getWordsPerKmer());
 
-        const unsigned nextWordIdx = wordIndices[nextWord].first;
-        if (nextWordIdx == 0)
-        {
-            // the successor word has not been visited
-            // recurse on it
-            nextIndex = searchRepeats(opt, nextIndex, nextWord, wordIndices, wordStack, repeatWords);
-            // update the current word's lowlink
-            const unsigned wordLowLink = wordIndices[word].second;
-            const unsigned nextWordLowLink = wordIndices[nextWord].second;
-            wordIndices[word].second = std::min(wordLowLink, nextWordLowLink);
-        }
-        else
-        {
-            const bool isContained(std::find(wordStack.begin(), wordStack.end(), nextWord) != wordStack.end());
-            if (isContained)
-            {
-                // the successor word is in stack and therefore in the current circle of words
-                // only update the current word's lowlink
-                const unsigned wordLowLink = wordIndices[word].second;
-                wordIndices[word].second = std::min(wordLowLink, nextWordIdx);
-            }
-        }
-    }
+    unsigned index = 1;
+    auto visitWord = [&](const unsigned wordId)
+    {
+        // set the depth index for the word to the smallest unused index
+        wordIndices[wordId] = index;
+        wordLowLinks[wordId] = index;
+        index++;
+        wordStack.push_back(wordId);
+        isWordInStack[wordId] = true;
+        searchPath.emplace_back(wordId, 0);
+    };
 
-    // if the current word is a root node,
-    if (wordIndices[word].second == index)
+    for (unsigned rootId(0); rootId<kmerCount; ++rootId)
     {
-        // exclude singletons
-        bool isSingleton(wordStack.back() == word);
-        if (isSingleton)
-        {
-            wordStack.pop_back();
-        }
-        // record identified repeat words (i.e. words in the current circle)
-        else
+        if (wordIndices[rootId] != 0) continue;
+
+        visitWord(rootId);
+        while (not searchPath.empty())
         {
-            while (true)
+            const unsigned wordId(searchPath.back().first);
+            const unsigned symbolIndex(searchPath.back().second);
+            if (symbolIndex < opt.alphabet.size())
             {
-                const std::string repeatWd = wordStack.back();
-                repeatWords.insert(repeatWd);
-                wordStack.pop_back();
+                searchPath.back().second++;
+
+                // candidate successor of the current word
+                kmerIndex.getSuccessor(kmerIndex.getKmer(wordId), kmerIndex.getSymbolCode(opt.alphabet[symbolIndex]),
+                                       nextWord.data());
+                const unsigned nextWordId(kmerIndex.getKmerId(nextWord.data()));
 
-                if (repeatWd == word) break;
+                // the successor word does not exist in the reads
+                if (nextWordId == PackedKmerIndex::invalidId) continue;
+
+                // homopolymer
+                if (nextWordId == wordId)
+                {
+                    isRepeatKmer[wordId] = true;
+                    continue;
+                }
+
+                if (wordIndices[nextWordId] == 0)
+                {
+                    // the successor word has not been visited
+                    // descend into it
+                    visitWord(nextWordId);
+                }
+                else if (isWordInStack[nextWordId])
+                {
+                    // the successor word is in stack and therefore in the current circle of words
+                    // only update the current word's lowlink
+                    wordLowLinks[wordId] = std::min(wordLowLinks[wordId], wordIndices[nextWordId]);
+                }
+                continue;
             }
-        }
-    }
 
-    return nextIndex;
-}
+            // all successors are done. if the current word is a root node,
+            if (wordLowLinks[wordId] == wordIndices[wordId])
+            {
+                // exclude singletons
+                const bool isSingleton(wordStack.back() == wordId);
+                while (true)
+                {
+                    const unsigned repeatWordId(wordStack.back());
+                    wordStack.pop_back();
+                    isWordInStack[repeatWordId] = false;
 
+                    // record identified repeat words (i.e. words in the current circle)
+                    if (not isSingleton) isRepeatKmer[repeatWordId] = true;
 
-static
-void
-getRepeatKmers(
-    const IterativeAssemblerOptions& opt,
-    const str_uint_map_t& wordCount,
-    std::set<std::string>& repeatWords)
-{
-    str_pair_uint_map_t wordIndices;
-    for (const str_uint_map_t::value_type& wdct : wordCount)
-    {
-        wordIndices[wdct.first] = std::pair<unsigned,unsigned>(0, 0);
-    }
+                    if (repeatWordId == wordId) break;
+                }
+            }
 
-    unsigned index = 1;
-    std::vector<std::string> wordStack;
-    for (const str_pair_uint_map_t::value_type& wdidx : wordIndices)
-    {
-        const std::string word = wdidx.first;
-        const unsigned wordIdx = wdidx.second.first;
-        if (wordIdx == 0)
-            index = searchRepeats(opt, index, word, wordIndices, wordStack, repeatWords);
+            searchPath.pop_back();
+
+            // update the parent word's lowlink
+            if (not searchPath.empty())
+            {
+                const unsigned parentWordId(searchPath.back().first);
+                wordLowLinks[parentWordId] = std::min(wordLowLinks[parentWordId], wordLowLinks[wordId]);
+            }
+        }
     }
 }
 
 
+
 static
 bool
 buildContigs(
@@ -647,50 +589,67 @@ buildContigs(
     contigs.clear();
     bool isAssemblySuccess(true);
 
-    // counts the number of occurrences for each kmer in all reads
-    str_uint_map_t wordCount;
-    // records the supporting reads for each kmer
-    str_set_uint_map_t wordSupportReads;
-    // get counts and supporting reads for each kmer
-    getKmerCounts(opt, reads, readInfo, wordLength, wordCount, wordSupportReads);
+    // counts the number of occurrences and records the supporting reads for each kmer
+    PackedKmerIndex kmerIndex(opt.alphabet, wordLength);
+    getKmerCounts(opt, reads, readInfo, kmerIndex);
+    const unsigned kmerCount(kmerIndex.size());
 
     // identify repeat kmers (i.e. circles from the de bruijn graph)
-    std::set<std::string> repeatWords;
-    getRepeatKmers(opt, wordCount, repeatWords);
+    std::vector<bool> isRepeatKmer;
+    getRepeatKmers(opt, kmerIndex, isRepeatKmer);
 #ifdef DEBUG_ASBL
-    log_os << logtag << "Identified " << repeatWords.size() << " repeat words.\n";
-    print_stringSet(repeatWords);
+    log_os << logtag << "Identified " << std::count(isRepeatKmer.begin(), isRepeatKmer.end(), true) << " repeat words.\n";
+    log_os << "[";
+    for (unsigned kmerId(0); kmerId<kmerCount; ++kmerId)
+    {
+        if (isRepeatKmer[kmerId]) log_os << kmerIndex.getKmerString(kmerId) << ",";
+    }
+    log_os << "]\n";
 #endif
 
     // track kmers can be used as seeds for searching for the next contig
-    std::set<std::string> unusedWords;
-    for (const str_uint_map_t::value_type& wdct : wordCount)
+    // seeds are kept in lexical order so that ties in the seed count are broken by the word sequence
+    std::vector<unsigned> unusedWords;
+    for (unsigned kmerId(0); kmerId<kmerCount; ++kmerId)
     {
         // filter out kmers with too few coverage
-        if (wdct.second >= opt.minCoverage)
-            unusedWords.insert(wdct.first);
+        if (kmerIndex.getCount(kmerId) >= opt.minCoverage)
+            unusedWords.push_back(kmerId);
     }
+    std::sort(unusedWords.begin(), unusedWords.end(),
+              [&](const unsigned a, const unsigned b)
+    {
+        return kmerIndex.isKmerLess(a,b);
+    });
+    std::vector<bool> isUsedKmer(kmerCount, false);
 
     // TODO: for the seek of speed, consider limiting the number of contigs generated
-    while (!unusedWords.empty())
+    while (true)
     {
-        std::string maxWord;
+        unusedWords.erase(std::remove_if(unusedWords.begin(), unusedWords.end(),
+                                         [&](const unsigned kmerId)
+        {
+            return isUsedKmer[kmerId];
+        }),
+        unusedWords.end());
+        if (unusedWords.empty()) break;
+
+        unsigned maxWordId(unusedWords.front());
         unsigned maxWordCount(0);
         // get the kmers corresponding the highest count
-        for (const std::string& word : unusedWords)
+        for (const unsigned kmerId : unusedWords)
         {
-            assert (wordCount.count(word) > 0);
-            const unsigned currWordCount = wordCount.at(word);
+            const unsigned currWordCount = kmerIndex.getCount(kmerId);
             if (currWordCount > maxWordCount)
             {
-                maxWord = word;
+                maxWordId = kmerId;
                 maxWordCount = currWordCount;
             }
         }
 
         // solve for a best contig in the graph by a heuristic greedy maxflow-ish criteria
         AssembledContig contig;
-        bool isRepeatFound = walk(opt, maxWord, wordLength, wordCount, wordSupportReads, repeatWords, unusedWords, contig);
+        bool isRepeatFound = walk(opt, maxWordId, kmerIndex, isRepeatKmer, isUsedKmer, contig);
         if (isRepeatFound) isAssemblySuccess = false;
 
 #ifdef DEBUG_ASBL
@@ -705,14 +664,11 @@ buildContigs(
         contigs.push_back(contig);
     }
 
-    // done with this now
-    wordCount.clear();
-    wordSupportReads.clear();
-
     return isAssemblySuccess;
 }
 
 
+
 static
 void
 selectContigs(
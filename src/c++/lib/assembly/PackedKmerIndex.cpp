@@ -0,0 +1,291 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Packed k-mer index used by the iterative assembler
+///
+
+#include "assembly/PackedKmerIndex.hh"
+
+#include "common/Exceptions.hh"
+
+#include <cassert>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+
+
+const unsigned PackedKmerIndex::invalidId(std::numeric_limits<unsigned>::max());
+
+
+
+PackedKmerIndex::
+PackedKmerIndex(
+    const std::string& alphabet,
+    const unsigned kmerLength)
+    : _kmerLength(kmerLength),
+      _wordsPerKmer((kmerLength+31)/32),
+      _tableSlots(64,0),
+      _rollingKmer(_wordsPerKmer,0)
+{
+    using namespace illumina::common;
+
+    std::string sortedAlphabet(alphabet);
+    std::sort(sortedAlphabet.begin(), sortedAlphabet.end());
+    const bool isUniqueAlphabet(std::adjacent_find(sortedAlphabet.begin(), sortedAlphabet.end()) == sortedAlphabet.end());
+    if ((sortedAlphabet.size() < 2) or (sortedAlphabet.size() > 4) or (not isUniqueAlphabet))
+    {
+        std::ostringstream oss;
+        oss << "Packed k-mer alphabet must contain 2 to 4 distinct symbols, found '" << alphabet << "'";
+        BOOST_THROW_EXCEPTION(GeneralException(oss.str()));
+    }
+
+    if (kmerLength == 0)
+    {
+        BOOST_THROW_EXCEPTION(GeneralException("Packed k-mer length must be at least 1"));
+    }
+
+    _topWordBitCount = (2*kmerLength) - (64*(_wordsPerKmer-1));
+    _topWordMask = ((_topWordBitCount == 64) ? ~word_t(0) : ((word_t(1) << _topWordBitCount) - 1));
+
+    std::fill(std::begin(_symbolCode), std::end(_symbolCode), -1);
+    std::fill(std::begin(_codeSymbol), std::end(_codeSymbol), 'N');
+    for (unsigned code(0); code<sortedAlphabet.size(); ++code)
+    {
+        _symbolCode[static_cast<unsigned char>(sortedAlphabet[code])] = code;
+        _codeSymbol[code] = sortedAlphabet[code];
+    }
+}
+
+
+
+void
+PackedKmerIndex::
+addRead(
+    const std::string& seq,
+    const unsigned readIndex,
+    const unsigned countIncrement)
+{
+    const unsigned readLength(seq.size());
+    if (readLength < _kmerLength) return;
+
+    word_t* rollingKmer(_rollingKmer.data());
+
+    // number of consecutive in-alphabet symbols ending at the current read position, capped at the k-mer length:
+    unsigned validLength(0);
+    for (unsigned readPos(0); readPos<readLength; ++readPos)
+    {
+        const int symbolCode(getSymbolCode(seq[readPos]));
+        if (symbolCode < 0)
+        {
+            validLength = 0;
+            continue;
+        }
+
+        getSuccessor(rollingKmer, symbolCode, rollingKmer);
+        if (validLength < _kmerLength) validLength++;
+        if (validLength < _kmerLength) continue;
+
+        const unsigned kmerId(insertKmer(rollingKmer));
+        read_list_t& kmerReads(_kmerReads[kmerId]);
+
+        // each read contributes to a k-mer only once:
+        if ((not kmerReads.empty()) and (kmerReads.back() == readIndex)) continue;
+
+        assert(kmerReads.empty() or (kmerReads.back() < readIndex));
+        kmerReads.push_back(readIndex);
+        _kmerCounts[kmerId] += countIncrement;
+    }
+}
+
+
+
+unsigned
+PackedKmerIndex::
+getKmerId(const word_t* kmer) const
+{
+    const unsigned slotMask(_tableSlots.size()-1);
+    for (unsigned slotIndex(getKmerHash(kmer) & slotMask); true; slotIndex = ((slotIndex+1) & slotMask))
+    {
+        const unsigned slot(_tableSlots[slotIndex]);
+        if (slot == 0) return invalidId;
+        if (isKmerEqual(kmer, getKmer(slot-1))) return (slot-1);
+    }
+}
+
+
+
+unsigned
+PackedKmerIndex::
+getKmerId(const std::string& kmerString) const
+{
+    if (kmerString.size() != _kmerLength) return invalidId;
+
+    std::vector<word_t> kmer(_wordsPerKmer,0);
+    for (const char symbol : kmerString)
+    {
+        const int symbolCode(getSymbolCode(symbol));
+        if (symbolCode < 0) return invalidId;
+        getSuccessor(kmer.data(), symbolCode, kmer.data());
+    }
+    return getKmerId(kmer.data());
+}
+
+
+
+std::string
+PackedKmerIndex::
+getKmerString(const unsigned kmerId) const
+{
+    const word_t* kmer(getKmer(kmerId));
+    std::string kmerString(_kmerLength,'N');
+    for (unsigned kmerPos(0); kmerPos<_kmerLength; ++kmerPos)
+    {
+        // bit offset of the symbol counted from the least significant end of the packed k-mer:
+        const unsigned bitOffset(2*(_kmerLength-kmerPos-1));
+        const word_t word(kmer[_wordsPerKmer-1-(bitOffset/64)]);
+        kmerString[kmerPos] = _codeSymbol[(word >> (bitOffset%64)) & 0x3u];
+    }
+    return kmerString;
+}
+
+
+
+bool
+PackedKmerIndex::
+isKmerLess(
+    const unsigned kmerId1,
+    const unsigned kmerId2) const
+{
+    const word_t* kmer1(getKmer(kmerId1));
+    const word_t* kmer2(getKmer(kmerId2));
+    return std::lexicographical_compare(kmer1, kmer1+_wordsPerKmer, kmer2, kmer2+_wordsPerKmer);
+}
+
+
+
+void
+PackedKmerIndex::
+getSuccessor(
+    const word_t* kmer,
+    const unsigned symbolCode,
+    word_t* result) const
+{
+    // words are updated from most to least significant so that kmer and result may alias:
+    const unsigned lastWordIndex(_wordsPerKmer-1);
+    for (unsigned wordIndex(0); wordIndex<lastWordIndex; ++wordIndex)
+    {
+        result[wordIndex] = (kmer[wordIndex] << 2) | (kmer[wordIndex+1] >> 62);
+    }
+    result[lastWordIndex] = (kmer[lastWordIndex] << 2) | symbolCode;
+    result[0] &= _topWordMask;
+}
+
+
+
+void
+PackedKmerIndex::
+getPredecessor(
+    const word_t* kmer,
+    const unsigned symbolCode,
+    word_t* result) const
+{
+    // words are updated from least to most significant so that kmer and result may alias:
+    for (unsigned wordIndex(_wordsPerKmer-1); wordIndex>0; --wordIndex)
+    {
+        result[wordIndex] = (kmer[wordIndex] >> 2) | (kmer[wordIndex-1] << 62);
+    }
+    result[0] = (kmer[0] >> 2) | (word_t(symbolCode) << (_topWordBitCount-2));
+}
+
+
+
+uint64_t
+PackedKmerIndex::
+getKmerHash(const word_t* kmer) const
+{
+    uint64_t hash(_kmerLength);
+    for (unsigned wordIndex(0); wordIndex<_wordsPerKmer; ++wordIndex)
+    {
+        // splitmix64 finalizer applied to each accumulated word:
+        hash ^= kmer[wordIndex] + 0x9e3779b97f4a7c15ULL;
+        hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+        hash ^= (hash >> 31);
+    }
+    return hash;
+}
+
+
+
+bool
+PackedKmerIndex::
+isKmerEqual(
+    const word_t* kmer1,
+    const word_t* kmer2) const
+{
+    return std::equal(kmer1, kmer1+_wordsPerKmer, kmer2);
+}
+
+
+
+unsigned
+PackedKmerIndex::
+insertKmer(const word_t* kmer)
+{
+    // keep the table at most half full:
+    if (2*(size()+1) > _tableSlots.size()) growTable();
+
+    const unsigned slotMask(_tableSlots.size()-1);
+    unsigned slotIndex(getKmerHash(kmer) & slotMask);
+    for (; _tableSlots[slotIndex] != 0; slotIndex = ((slotIndex+1) & slotMask))
+    {
+        const unsigned kmerId(_tableSlots[slotIndex]-1);
+        if (isKmerEqual(kmer, getKmer(kmerId))) return kmerId;
+    }
+
+    const unsigned kmerId(size());
+    _tableSlots[slotIndex] = kmerId+1;
+    _kmerWords.insert(_kmerWords.end(), kmer, kmer+_wordsPerKmer);
+    _kmerCounts.push_back(0);
+    _kmerReads.emplace_back();
+    return kmerId;
+}
+
+
+
+void
+PackedKmerIndex::
+growTable()
+{
+    _tableSlots.assign(_tableSlots.size()*2, 0);
+    const unsigned slotMask(_tableSlots.size()-1);
+    const unsigned kmerCount(size());
+    for (unsigned kmerId(0); kmerId<kmerCount; ++kmerId)
+    {
+        unsigned slotIndex(getKmerHash(getKmer(kmerId)) & slotMask);
+        while (_tableSlots[slotIndex] != 0)
+        {
+            slotIndex = ((slotIndex+1) & slotMask);
+        }
+        _tableSlots[slotIndex] = kmerId+1;
+    }
+}
@@ -0,0 +1,204 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Packed k-mer index used by the iterative assembler
+///
+
+#pragma once
+
+#include "boost/container/small_vector.hpp"
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+
+/// \brief Counts the k-mers of an assembly read set and records their supporting reads
+///
+/// Each k-mer is packed two bits per symbol into ceil(k/32) 64-bit words, with the first
+/// symbol in the most significant position. Symbol codes follow the sorted order of the
+/// alphabet, so comparing packed words reproduces the lexical order of the k-mer strings.
+///
+/// Distinct k-mers are assigned dense ids in order of first observation. Ids are located
+/// through an open-addressing hash table with linear probing, and all per-k-mer data is
+/// stored in arrays indexed by id.
+///
+class PackedKmerIndex
+{
+public:
+    typedef uint64_t word_t;
+    typedef boost::container::small_vector<unsigned,4> read_list_t;
+
+    /// returned by id lookups when the k-mer is not in the index
+    static const unsigned invalidId;
+
+    /// \param alphabet The assembly symbol set, must contain between 2 and 4 distinct symbols
+    /// \param kmerLength Length of the indexed k-mers, must be at least 1
+    PackedKmerIndex(
+        const std::string& alphabet,
+        const unsigned kmerLength);
+
+    unsigned
+    getKmerLength() const
+    {
+        return _kmerLength;
+    }
+
+    /// \return Number of 64-bit words used to store one packed k-mer
+    unsigned
+    getWordsPerKmer() const
+    {
+        return _wordsPerKmer;
+    }
+
+    /// \return Number of distinct k-mers in the index
+    unsigned
+    size() const
+    {
+        return _kmerCounts.size();
+    }
+
+    /// \return 2-bit code of \p symbol, or -1 if the symbol is not in the alphabet
+    int
+    getSymbolCode(const char symbol) const
+    {
+        return _symbolCode[static_cast<unsigned char>(symbol)];
+    }
+
+    /// Add all k-mers of a read sequence to the index
+    ///
+    /// Each distinct k-mer of the read adds \p countIncrement to the k-mer count and \p readIndex to
+    /// the k-mer's supporting reads once, however many times it occurs in the read. K-mers overlapping
+    /// any symbol outside of the alphabet (such as 'N') are skipped.
+    ///
+    /// \p readIndex must not decrease between calls, so that supporting read lists stay sorted.
+    void
+    addRead(
+        const std::string& seq,
+        const unsigned readIndex,
+        const unsigned countIncrement = 1);
+
+    /// \return Id of the packed k-mer, or invalidId if it is not in the index
+    unsigned
+    getKmerId(const word_t* kmer) const;
+
+    /// \return Id of the k-mer string, or invalidId if it is not in the index or cannot be packed
+    unsigned
+    getKmerId(const std::string& kmerString) const;
+
+    /// \return Pointer to the getWordsPerKmer() words of the packed k-mer \p kmerId
+    const word_t*
+    getKmer(const unsigned kmerId) const
+    {
+        return _kmerWords.data() + (kmerId * _wordsPerKmer);
+    }
+
+    std::string
+    getKmerString(const unsigned kmerId) const;
+
+    /// \return Sum of count increments from all reads containing k-mer \p kmerId
+    unsigned
+    getCount(const unsigned kmerId) const
+    {
+        return _kmerCounts[kmerId];
+    }
+
+    /// \return Sorted list of reads containing k-mer \p kmerId
+    const read_list_t&
+    getSupportReads(const unsigned kmerId) const
+    {
+        return _kmerReads[kmerId];
+    }
+
+    /// \return True if k-mer \p kmerId1 sorts lexically before k-mer \p kmerId2
+    bool
+    isKmerLess(
+        const unsigned kmerId1,
+        const unsigned kmerId2) const;
+
+    /// Write the k-mer formed by dropping the first symbol of \p kmer and appending \p symbolCode to \p result
+    void
+    getSuccessor(
+        const word_t* kmer,
+        const unsigned symbolCode,
+        word_t* result) const;
+
+    /// Write the k-mer formed by dropping the last symbol of \p kmer and prepending \p symbolCode to \p result
+    void
+    getPredecessor(
+        const word_t* kmer,
+        const unsigned symbolCode,
+        word_t* result) const;
+
+    unsigned
+    getFirstSymbolCode(const word_t* kmer) const
+    {
+        return (kmer[0] >> (_topWordBitCount-2)) & 0x3u;
+    }
+
+    unsigned
+    getLastSymbolCode(const word_t* kmer) const
+    {
+        return kmer[_wordsPerKmer-1] & 0x3u;
+    }
+
+private:
+    uint64_t
+    getKmerHash(const word_t* kmer) const;
+
+    /// \return True if the packed k-mers \p kmer1 and \p kmer2 are equal
+    bool
+    isKmerEqual(
+        const word_t* kmer1,
+        const word_t* kmer2) const;
+
+    /// \return Id of the packed k-mer, adding it to the index if not already present
+    unsigned
+    insertKmer(const word_t* kmer);
+
+    /// Double the hash table capacity and re-insert all k-mer ids
+    void
+    growTable();
+
+    unsigned _kmerLength;
+    unsigned _wordsPerKmer;
+
+    /// number of bits used in the most significant word of each packed k-mer
+    unsigned _topWordBitCount;
+    word_t _topWordMask;
+
+    /// maps each char to its 2-bit code, or -1 for symbols outside of the alphabet
+    int _symbolCode[256];
+
+    /// maps each 2-bit code back to its symbol
+    char _codeSymbol[4];
+
+    /// open-addressing slots, each holding (k-mer id + 1) or zero if empty
+    std::vector<unsigned> _tableSlots;
+
+    /// packed k-mer words, getWordsPerKmer() words per k-mer id
+    std::vector<word_t> _kmerWords;
+    std::vector<unsigned> _kmerCounts;
+    std::vector<read_list_t> _kmerReads;
+
+    /// scratch k-mer used for rolling extraction in addRead
+    std::vector<word_t> _rollingKmer;
+};
@@ -32,34 +32,38 @@ BOOST_AUTO_TEST_SUITE( test_IterativeAssembler )
 BOOST_AUTO_TEST_CASE( test_CircleDetector )
 {
     IterativeAssemblerOptions assembleOpt;
-    str_uint_map_t wordCount;
-    std::set<std::string> repeatWords;
+    PackedKmerIndex kmerIndex(assembleOpt.alphabet, 5);
+    std::vector<bool> isRepeatKmer;
 
-    wordCount["TACCA"] = 3;
-    wordCount["CCACC"] = 3;
-    wordCount["CACCA"] = 3;
-    wordCount["ACCAC"] = 3;
-    wordCount["CCACA"] = 3;
-    wordCount["CACAC"] = 3;
-    wordCount["ACACA"] = 3;
-    wordCount["AAAAA"] = 2;
+    const std::vector<std::string> words = { "TACCA", "CCACC", "CACCA", "ACCAC", "CCACA", "CACAC", "ACACA", "AAAAA" };
+    for (unsigned wordIndex(0); wordIndex<words.size(); ++wordIndex)
+    {
+        kmerIndex.addRead(words[wordIndex], wordIndex);
+    }
 
-    getRepeatKmers(assembleOpt, wordCount, repeatWords);
+    getRepeatKmers(assembleOpt, kmerIndex, isRepeatKmer);
+
+    auto isRepeat = [&](const std::string& word)
+    {
+        const unsigned kmerId(kmerIndex.getKmerId(word));
+        BOOST_REQUIRE(kmerId != PackedKmerIndex::invalidId);
+        return isRepeatKmer[kmerId];
+    };
 
     // the first circle
-    BOOST_REQUIRE_EQUAL(repeatWords.count("ACCAC"), 1u);
-    BOOST_REQUIRE_EQUAL(repeatWords.count("CACCA"), 1u);
-    BOOST_REQUIRE_EQUAL(repeatWords.count("CCACC"), 1u);
+    BOOST_REQUIRE(isRepeat("ACCAC"));
+    BOOST_REQUIRE(isRepeat("CACCA"));
+    BOOST_REQUIRE(isRepeat("CCACC"));
 
-    BOOST_REQUIRE_EQUAL(repeatWords.count("TACCA"), 0u);
-    BOOST_REQUIRE_EQUAL(repeatWords.count("CCACA"), 0u);
+    BOOST_REQUIRE(! isRepeat("TACCA"));
+    BOOST_REQUIRE(! isRepeat("CCACA"));
 
     // the second circle
-    BOOST_REQUIRE_EQUAL(repeatWords.count("CACAC"), 1u);
-    BOOST_REQUIRE_EQUAL(repeatWords.count("ACACA"), 1u);
+    BOOST_REQUIRE(isRepeat("CACAC"));
+    BOOST_REQUIRE(isRepeat("ACACA"));
 
     // homopolymer: self-circle
-    BOOST_REQUIRE_EQUAL(repeatWords.count("AAAAA"), 1u);
+    BOOST_REQUIRE(isRepeat("AAAAA"));
 }
 
 
@@ -0,0 +1,124 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "PackedKmerIndex.hh"
+
+#include <random>
+
+
+BOOST_AUTO_TEST_SUITE( test_PackedKmerIndex )
+
+
+BOOST_AUTO_TEST_CASE( test_PackedKmerIndexCounts )
+{
+    PackedKmerIndex kmerIndex("ACGT", 4);
+
+    kmerIndex.addRead("ACGTACGT", 0);
+    kmerIndex.addRead("CGTANACGT", 1, 3);
+    kmerIndex.addRead("ACG", 2);
+
+    BOOST_REQUIRE_EQUAL(kmerIndex.size(), 4u);
+
+    // repeated words are counted once per read:
+    const unsigned acgtId(kmerIndex.getKmerId("ACGT"));
+    BOOST_REQUIRE(acgtId != PackedKmerIndex::invalidId);
+    BOOST_REQUIRE_EQUAL(kmerIndex.getCount(acgtId), 4u);
+    BOOST_REQUIRE_EQUAL(kmerIndex.getSupportReads(acgtId).size(), 2u);
+    BOOST_REQUIRE_EQUAL(kmerIndex.getSupportReads(acgtId)[0], 0u);
+    BOOST_REQUIRE_EQUAL(kmerIndex.getSupportReads(acgtId)[1], 1u);
+
+    const unsigned tacgId(kmerIndex.getKmerId("TACG"));
+    BOOST_REQUIRE(tacgId != PackedKmerIndex::invalidId);
+    BOOST_REQUIRE_EQUAL(kmerIndex.getCount(tacgId), 1u);
+
+    // words overlapping 'N' are skipped:
+    BOOST_REQUIRE_EQUAL(kmerIndex.getKmerId("GTAN"), PackedKmerIndex::invalidId);
+    BOOST_REQUIRE_EQUAL(kmerIndex.getKmerId("GTAA"), PackedKmerIndex::invalidId);
+    BOOST_REQUIRE_EQUAL(kmerIndex.getKmerId("ACG"), PackedKmerIndex::invalidId);
+
+    BOOST_REQUIRE_EQUAL(kmerIndex.getKmerString(acgtId), "ACGT");
+}
+
+
+BOOST_AUTO_TEST_CASE( test_PackedKmerIndexBadAlphabet )
+{
+    BOOST_REQUIRE_THROW(PackedKmerIndex("ACGTN", 4), std::exception);
+    BOOST_REQUIRE_THROW(PackedKmerIndex("AAC", 4), std::exception);
+    BOOST_REQUIRE_THROW(PackedKmerIndex("ACGT", 0), std::exception);
+}
+
+
+/// Check packed k-mer neighbors and ordering against their string equivalents, over a range of k-mer lengths
+/// spanning one to three packed words
+BOOST_AUTO_TEST_CASE( test_PackedKmerIndexMultiWord )
+{
+    static const std::string alphabet("ACGT");
+    std::mt19937 randomGenerator(17);
+    std::uniform_int_distribution<unsigned> symbolDistribution(0,3);
+
+    std::string seq;
+    for (unsigned seqIndex(0); seqIndex<2000; ++seqIndex)
+    {
+        seq.push_back(alphabet[symbolDistribution(randomGenerator)]);
+    }
+
+    for (const unsigned kmerLength : { 5u, 31u, 32u, 33u, 64u, 65u, 76u })
+    {
+        PackedKmerIndex kmerIndex(alphabet, kmerLength);
+        kmerIndex.addRead(seq, 0);
+        BOOST_REQUIRE_EQUAL(kmerIndex.getWordsPerKmer(), (kmerLength+31)/32);
+
+        std::vector<PackedKmerIndex::word_t> neighborKmer(kmerIndex.getWordsPerKmer());
+        const unsigned kmerCount(kmerIndex.size());
+        for (unsigned kmerId(0); kmerId<kmerCount; ++kmerId)
+        {
+            const std::string kmerString(kmerIndex.getKmerString(kmerId));
+            BOOST_REQUIRE_EQUAL(kmerIndex.getKmerId(kmerString), kmerId);
+
+            const PackedKmerIndex::word_t* kmer(kmerIndex.getKmer(kmerId));
+            BOOST_REQUIRE_EQUAL(kmerIndex.getFirstSymbolCode(kmer), kmerIndex.getSymbolCode(kmerString.front()));
+            BOOST_REQUIRE_EQUAL(kmerIndex.getLastSymbolCode(kmer), kmerIndex.getSymbolCode(kmerString.back()));
+
+            for (const char symbol : alphabet)
+            {
+                // neighbor k-mers must be found exactly when their string form occurs in the sequence:
+                kmerIndex.getSuccessor(kmer, kmerIndex.getSymbolCode(symbol), neighborKmer.data());
+                const std::string successorString(kmerString.substr(1) + symbol);
+                const bool isSuccessorFound(seq.find(successorString) != std::string::npos);
+                BOOST_REQUIRE_EQUAL(kmerIndex.getKmerId(neighborKmer.data()) != PackedKmerIndex::invalidId, isSuccessorFound);
+
+                kmerIndex.getPredecessor(kmer, kmerIndex.getSymbolCode(symbol), neighborKmer.data());
+                const std::string predecessorString(symbol + kmerString.substr(0,kmerLength-1));
+                const bool isPredecessorFound(seq.find(predecessorString) != std::string::npos);
+                BOOST_REQUIRE_EQUAL(kmerIndex.getKmerId(neighborKmer.data()) != PackedKmerIndex::invalidId, isPredecessorFound);
+            }
+
+            if (kmerId > 0)
+            {
+                const std::string previousString(kmerIndex.getKmerString(kmerId-1));
+                BOOST_REQUIRE_EQUAL(kmerIndex.isKmerLess(kmerId-1, kmerId), (previousString < kmerString));
+                BOOST_REQUIRE_EQUAL(kmerIndex.isKmerLess(kmerId, kmerId-1), (kmerString < previousString));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Compact sufficient statistics of a basecall pileup for SNV genotype likelihoods
+///
+
+#pragma once
+
+#include "blt_common/snp_pos_info.hh"
+
+#include <cassert>
+#include <cstdint>
+
+#include <array>
+
+
+/// \brief Count of basecalls at one position for each distinct (base, qscore, strand) combination
+///
+/// The SNV genotype likelihood kernels only depend on the base, qscore and strand of each basecall, so at high depth
+/// the pileup can be reduced to a small number of bins, and each likelihood term can be evaluated once per bin and
+/// multiplied by the bin count. No information used by the kernels is lost, so the qscore is not binned any further.
+///
+/// Bins are reported in order of first observation. The object is sized for all possible keys and does not allocate.
+///
+struct BasecallHistogram
+{
+    struct Bin
+    {
+        uint8_t baseId;
+        uint8_t qscore;
+        bool isFwdStrand;
+        unsigned count;
+    };
+
+    typedef const Bin* const_iterator;
+
+    BasecallHistogram()
+    {
+        _binIndex.fill(0);
+    }
+
+    template <typename CallContainer>
+    explicit
+    BasecallHistogram(
+        const CallContainer& calls)
+        : BasecallHistogram()
+    {
+        addCalls(calls);
+    }
+
+    void
+    clear()
+    {
+        for (unsigned binIndex(0); binIndex < _binCount; ++binIndex)
+        {
+            const Bin& bin(_bins[binIndex]);
+            _binIndex[getKey(bin.baseId, bin.qscore, bin.isFwdStrand)] = 0;
+        }
+        _binCount = 0;
+        _totalCount = 0;
+    }
+
+    void
+    addCall(
+        const base_call& bc)
+    {
+        const uint8_t baseId(bc.base_id);
+        const uint8_t qscore(bc.get_qscore());
+        const bool isFwdStrand(bc.is_fwd_strand);
+        const unsigned key(getKey(baseId, qscore, isFwdStrand));
+        if (_binIndex[key] == 0)
+        {
+            Bin& bin(_bins[_binCount++]);
+            bin.baseId = baseId;
+            bin.qscore = qscore;
+            bin.isFwdStrand = isFwdStrand;
+            bin.count = 0;
+            _binIndex[key] = _binCount;
+        }
+        _bins[_binIndex[key]-1].count++;
+        _totalCount++;
+    }
+
+    template <typename CallContainer>
+    void
+    addCalls(
+        const CallContainer& calls)
+    {
+        for (const base_call& bc : calls)
+        {
+            addCall(bc);
+        }
+    }
+
+    const_iterator
+    begin() const
+    {
+        return _bins.data();
+    }
+
+    const_iterator
+    end() const
+    {
+        return _bins.data() + _binCount;
+    }
+
+    /// \return Number of non-empty bins
+    unsigned
+    size() const
+    {
+        return _binCount;
+    }
+
+    /// \return Total count of basecalls over all bins
+    unsigned
+    getTotalCount() const
+    {
+        return _totalCount;
+    }
+
+private:
+
+    enum constants
+    {
+        QSCORE_SIZE = 64,
+        KEY_SIZE = BASE_ID::SIZE * QSCORE_SIZE * 2
+    };
+
+    static
+    unsigned
+    getKey(
+        const uint8_t baseId,
+        const uint8_t qscore,
+        const bool isFwdStrand)
+    {
+        assert(baseId < BASE_ID::SIZE);
+        assert(qscore < QSCORE_SIZE);
+        return ((baseId * QSCORE_SIZE + qscore) * 2) + (isFwdStrand ? 1 : 0);
+    }
+
+    /// for each key, 1 + the index of its bin, or zero if the key has not been observed
+    std::array<uint16_t, KEY_SIZE> _binIndex;
+    std::array<Bin, KEY_SIZE> _bins;
+    unsigned _binCount = 0;
+    unsigned _totalCount = 0;
+};
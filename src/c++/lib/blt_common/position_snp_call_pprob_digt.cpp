@@ -34,6 +34,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <limits>
 
 
 
@@ -259,13 +260,56 @@ pprob_digt_caller(
 
 
 
+/// call func(obs_id, is_fwd_strand, eprob, ceprob, lnce, count) for each basecall observation in the pileup
+///
+/// if histogramPtr is non-null, each basecall histogram bin is reported once with its basecall count, otherwise
+/// each basecall is reported individually with a count of one, using the dependent error probabilities from epi
+///
+/// if isDependentErrorProbBound is true, the dependent error probabilities are replaced by their upper bound of 1,
+/// so that they do not need to be computed in epi
+///
+template <typename ObsFunc>
+static
+void
+forEachBasecallObservation(
+    const extended_pos_info& epi,
+    const BasecallHistogram* histogramPtr,
+    const bool isDependentErrorProbBound,
+    ObsFunc obsFunc)
+{
+    if (histogramPtr != nullptr)
+    {
+        for (const BasecallHistogram::Bin& bin : *histogramPtr)
+        {
+            const blt_float_t eprob(qphred_to_error_prob(bin.qscore));
+            obsFunc(bin.baseId, bin.isFwdStrand, eprob, 1.-qphred_to_error_prob(bin.qscore),
+                    qphred_to_ln_comp_error_prob(bin.qscore), bin.count);
+        }
+    }
+    else
+    {
+        const snp_pos_info& pi(epi.pi);
+        const unsigned n_calls(pi.calls.size());
+        for (unsigned i(0); i<n_calls; ++i)
+        {
+            const base_call& bc(pi.calls[i]);
+            const blt_float_t eprob(isDependentErrorProbBound ? 1 : epi.de[i]);
+            obsFunc(bc.base_id, bc.is_fwd_strand, eprob, 1.-bc.error_prob(), bc.ln_comp_error_prob(), 1u);
+        }
+    }
+}
+
+
+
 static
 void
 increment_het_ratio_lhood(const extended_pos_info& epi,
+                          const BasecallHistogram* histogramPtr,
                           const blt_float_t het_ratio,
                           blt_float_t* all_het_lhood,
                           const bool is_strand_specific,
-                          const bool is_ss_fwd)
+                          const bool is_ss_fwd,
+                          const bool isDependentErrorProbBound)
 {
     const blt_float_t chet_ratio(1-het_ratio);
 
@@ -288,31 +332,33 @@ increment_het_ratio_lhood(const extended_pos_info& epi,
     const snp_pos_info& pi(epi.pi);
     const unsigned ref_gt(base_to_id(pi.get_ref_base()));
 
-    const unsigned n_calls(pi.calls.size());
-
     blt_float_t val_high[3];
 
-    for (unsigned i(0); i<n_calls; ++i)
+    auto incrementObs = [&](
+                            const uint8_t obs_id,
+                            const bool is_fwd_strand,
+                            const blt_float_t eprob,
+                            const blt_float_t ceprob,
+                            const blt_float_t /*lnce*/,
+                            const unsigned count)
     {
-        const blt_float_t eprob(epi.de[i]);
-        const blt_float_t ceprob(1.-pi.calls[i].error_prob());
-
         // precalculate the result for expect values of 0.0, het_ratio, chet_ratio, 1.0
         val_high[0] = std::log(eprob)+log_one_third;
         val_high[1] = std::log((ceprob)*het_ratio+((1.-ceprob)*one_third)*chet_ratio);
         val_high[2] = std::log((ceprob)*chet_ratio+((1.-ceprob)*one_third)*het_ratio);
 
-        const bool is_force_ref(is_strand_specific && (is_ss_fwd!=pi.calls[i].is_fwd_strand));
+        const bool is_force_ref(is_strand_specific && (is_ss_fwd!=is_fwd_strand));
 
-        const uint8_t obs_id(pi.calls[i].base_id);
         for (unsigned gt(N_BASE); gt<DIGT::SIZE; ++gt)
         {
             static const uint8_t low_remap[] = {0,2,1};
             const unsigned key(DIGT::expect2_bias(obs_id,(is_force_ref ? ref_gt : gt)));
-            lhood_high[gt] += val_high[key];
-            lhood_low[gt] += val_high[low_remap[key]];
+            lhood_high[gt] += count*val_high[key];
+            lhood_low[gt] += count*val_high[low_remap[key]];
         }
-    }
+    };
+
+    forEachBasecallObservation(epi, histogramPtr, isDependentErrorProbBound, incrementObs);
 
     for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
     {
@@ -327,11 +373,13 @@ void
 pprob_digt_caller::
 get_diploid_gt_lhood(const blt_options& opt,
                      const extended_pos_info& epi,
+                     const BasecallHistogram* histogramPtr,
                      const bool useHetVariantFrequencyExtension,
                      const blt_float_t hetVariantFrequencyExtension,
                      blt_float_t* const lhood,
                      const bool is_strand_specific,
-                     const bool is_ss_fwd)
+                     const bool is_ss_fwd,
+                     const bool isDependentErrorProbBound)
 {
     // get likelihood of each genotype
     for (unsigned gt(0); gt<DIGT::SIZE; ++gt) lhood[gt] = 0.;
@@ -339,28 +387,29 @@ get_diploid_gt_lhood(const blt_options& opt,
     const snp_pos_info& pi(epi.pi);
     const unsigned ref_gt(base_to_id(pi.get_ref_base()));
 
-    const unsigned n_calls(pi.calls.size());
-    for (unsigned i(0); i<n_calls; ++i)
+    auto incrementObs = [&](
+                            const uint8_t obs_id,
+                            const bool is_fwd_strand,
+                            const blt_float_t eprob,
+                            const blt_float_t ceprob,
+                            const blt_float_t lnce,
+                            const unsigned count)
     {
-        const base_call& bc(pi.calls[i]);
-        const blt_float_t eprob(epi.de[i]);
-        const blt_float_t ceprob(1.-bc.error_prob());
-        const blt_float_t lnce(bc.ln_comp_error_prob());
-
         // precalculate the result for expect values of 0.0, 0.5 & 1.0
         blt_float_t val[3];
         val[0] = std::log(eprob)+log_one_third;
         val[1] = std::log((ceprob)+((1.-ceprob)*one_third))+log_one_half;
         val[2] = lnce;
 
-        const bool is_force_ref(is_strand_specific && (is_ss_fwd!=bc.is_fwd_strand));
+        const bool is_force_ref(is_strand_specific && (is_ss_fwd!=is_fwd_strand));
 
-        const uint8_t obs_id(bc.base_id);
         for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
         {
-            lhood[gt] += val[DIGT::expect2(obs_id,(is_force_ref ? ref_gt : gt))];
+            lhood[gt] += count*val[DIGT::expect2(obs_id,(is_force_ref ? ref_gt : gt))];
         }
-    }
+    };
+
+    forEachBasecallObservation(epi, histogramPtr, isDependentErrorProbBound, incrementObs);
 
     if (useHetVariantFrequencyExtension)
     {
@@ -370,7 +419,7 @@ get_diploid_gt_lhood(const blt_options& opt,
         for (unsigned i(0); i<n_bias_steps; ++i)
         {
             const blt_float_t het_ratio(0.5+(i+1)*ratio_increment);
-            increment_het_ratio_lhood(epi,het_ratio,lhood,is_strand_specific,is_ss_fwd);
+            increment_het_ratio_lhood(epi,histogramPtr,het_ratio,lhood,is_strand_specific,is_ss_fwd,isDependentErrorProbBound);
         }
 
         const unsigned n_het_subgt(1+2*n_bias_steps);
@@ -434,6 +483,113 @@ calculate_result_set(const blt_float_t* lhood,
 
 
 
+/// calculate_result_set for a site where lhood is exact for all genotypes containing the reference allele, and is
+/// an upper bound for all other genotypes
+///
+/// the bounded genotypes are left out of the posterior, and their total probability relative to the reference
+/// genotype is bounded instead. rs is certified if the bound can't change the most likely genotype or the rounded
+/// qualities of the result set computed from the exact likelihoods.
+///
+/// \param[out] lnRefPprobErrorBound bound on the absolute error of log(rs.ref_pprob)
+///
+/// \return true if rs is certified
+static
+bool
+calculate_homref_result_set(
+    const blt_float_t* lhood,
+    const blt_float_t* lnprior,
+    const unsigned ref_gt,
+    result_set& rs,
+    double& lnRefPprobErrorBound)
+{
+    // pprob of the genotypes containing the reference, in genotype order:
+    std::array<double,DIGT::SIZE> pprob;
+    std::array<unsigned,DIGT::SIZE> pprobGt;
+    unsigned pprobSize(0);
+
+    const double refPprob(lhood[ref_gt] + lnprior[ref_gt]);
+    double omittedPprob(0);
+    for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
+    {
+        const double gtPprob(lhood[gt] + lnprior[gt]);
+        if (DIGT::expect2(ref_gt,gt) == 0)
+        {
+            if (! (gtPprob < refPprob)) return false;
+            omittedPprob += std::exp(gtPprob-refPprob);
+        }
+        else
+        {
+            pprob[pprobSize] = gtPprob;
+            pprobGt[pprobSize] = gt;
+            pprobSize++;
+        }
+    }
+
+    // allow for rounding error in the likelihood bounds, and in the normalization of the exact posterior:
+    omittedPprob *= 2;
+    static const double normRoundingError(1e-12);
+
+    unsigned maxIndex(0);
+    normalizeLogDistro(pprob.begin(), pprob.begin()+pprobSize, maxIndex);
+    rs.max_gt = pprobGt[maxIndex];
+    if (rs.max_gt != ref_gt) return false;
+
+    // each value is scaled by a factor in [minScale,maxScale] in the exact posterior:
+    const double minScale((1-normRoundingError)/(1+omittedPprob));
+    const double maxScale(1+normRoundingError);
+
+    rs.ref_pprob=pprob[maxIndex];
+    rs.snp_qphred=error_prob_to_qphred(rs.ref_pprob);
+    if (error_prob_to_qphred(rs.ref_pprob*minScale) != error_prob_to_qphred(rs.ref_pprob*maxScale)) return false;
+
+    const double compPprob(prob_comp(pprob.begin(),pprob.begin()+pprobSize,maxIndex));
+    rs.max_gt_qphred=error_prob_to_qphred(compPprob);
+    if (error_prob_to_qphred(compPprob*minScale) != error_prob_to_qphred((compPprob+omittedPprob)*maxScale)) return false;
+
+    lnRefPprobErrorBound = std::log1p(omittedPprob) + 2*normRoundingError;
+    return true;
+}
+
+
+
+/// \return basecall histogram of the pileup, if it can be used in place of the individual basecalls
+static
+const BasecallHistogram*
+getBasecallHistogram(
+    const blt_options& opt,
+    const snp_pos_info& pi,
+    BasecallHistogram& histogram)
+{
+    // when basecall error probabilities are a function of qscore only, the pileup can be reduced to a basecall
+    // histogram so that each likelihood term is evaluated once per distinct (base, qscore, strand) observation
+    if (opt.is_dependent_eprob()) return nullptr;
+    histogram.addCalls(pi.calls);
+    return &histogram;
+}
+
+
+
+static
+void
+setPhredLoghood(
+    const blt_float_t* lhood,
+    diploid_genotype& dgt)
+{
+    unsigned gtcount(DIGT::SIZE);
+    if (dgt.is_haploid()) gtcount=N_BASE;
+    unsigned maxIndex(0);
+    for (unsigned gt(1); gt<gtcount; ++gt)
+    {
+        if (lhood[gt] > lhood[maxIndex]) maxIndex = gt;
+    }
+    for (unsigned gt(0); gt<gtcount; ++gt)
+    {
+        dgt.phredLoghood[gt] = ln_error_prob_to_qphred(lhood[gt]-lhood[maxIndex]);
+    }
+}
+
+
+
 ///
 /// \param is_always_test - continue the full computation even for a site which is
 ///                          obviously non-variant
@@ -491,24 +647,14 @@ position_snp_call_pprob_digt(
     // don't spend time on the het bias model for haploid sites:
     const bool useHetVariantFrequencyExtension((! dgt.is_haploid()) && opt.isHetVariantFrequencyExtensionDefined());
 
+    BasecallHistogram histogram;
+    const BasecallHistogram* histogramPtr(getBasecallHistogram(opt, pi, histogram));
+
     // get likelihood of each genotype
     blt_float_t lhood[DIGT::SIZE];
-    get_diploid_gt_lhood(opt,epi,useHetVariantFrequencyExtension,opt.hetVariantFrequencyExtension,lhood);
+    get_diploid_gt_lhood(opt,epi,histogramPtr,useHetVariantFrequencyExtension,opt.hetVariantFrequencyExtension,lhood);
 
-    // set phredLoghood:
-    {
-        unsigned gtcount(DIGT::SIZE);
-        if (dgt.is_haploid()) gtcount=N_BASE;
-        unsigned maxIndex(0);
-        for (unsigned gt(1); gt<gtcount; ++gt)
-        {
-            if (lhood[gt] > lhood[maxIndex]) maxIndex = gt;
-        }
-        for (unsigned gt(0); gt<gtcount; ++gt)
-        {
-            dgt.phredLoghood[gt] = ln_error_prob_to_qphred(lhood[gt]-lhood[maxIndex]);
-        }
-    }
+    setPhredLoghood(lhood,dgt);
 
 
     // get genomic site results:
@@ -522,9 +668,9 @@ position_snp_call_pprob_digt(
     if (is_compute_sb && dgt.is_snp())
     {
         blt_float_t lhood_fwd[DIGT::SIZE];
-        get_diploid_gt_lhood(opt,epi,useHetVariantFrequencyExtension,opt.hetVariantFrequencyExtension,lhood_fwd,true,true);
+        get_diploid_gt_lhood(opt,epi,histogramPtr,useHetVariantFrequencyExtension,opt.hetVariantFrequencyExtension,lhood_fwd,true,true);
         blt_float_t lhood_rev[DIGT::SIZE];
-        get_diploid_gt_lhood(opt,epi,useHetVariantFrequencyExtension,opt.hetVariantFrequencyExtension,lhood_rev,true,false);
+        get_diploid_gt_lhood(opt,epi,histogramPtr,useHetVariantFrequencyExtension,opt.hetVariantFrequencyExtension,lhood_rev,true,false);
 
         // If max_gt is equal to reference, then go ahead and use it
         // for consistency, even though this makes the SB value
@@ -540,6 +686,61 @@ position_snp_call_pprob_digt(
 
 
 
+bool
+pprob_digt_caller::
+position_snp_call_pprob_digt_homref(
+    const blt_options& opt,
+    const extended_pos_info& epi,
+    diploid_genotype& dgt,
+    double& lnRefPprobErrorBound) const
+{
+    const snp_pos_info& pi(epi.pi);
+
+    if (pi.get_ref_base()=='N') return false;
+
+    dgt.ref_gt=base_to_id(pi.get_ref_base());
+
+    // the likelihoods of genotypes containing the reference are only independent of the dependent error
+    // probabilities when all basecalls are reference:
+    for (const base_call& bc : pi.calls)
+    {
+        if (bc.base_id != dgt.ref_gt) return false;
+    }
+
+    const bool useHetVariantFrequencyExtension((! dgt.is_haploid()) && opt.isHetVariantFrequencyExtensionDefined());
+
+    BasecallHistogram histogram;
+    const BasecallHistogram* histogramPtr(getBasecallHistogram(opt, pi, histogram));
+
+    // get exact likelihood of each genotype containing the reference, and an upper bound for all others:
+    blt_float_t lhood[DIGT::SIZE];
+    get_diploid_gt_lhood(opt,epi,histogramPtr,useHetVariantFrequencyExtension,opt.hetVariantFrequencyExtension,lhood,
+                         false,false,true);
+
+    setPhredLoghood(lhood,dgt);
+
+    if (! calculate_homref_result_set(lhood,lnprior_genomic(dgt.ref_gt,dgt.is_haploid()),dgt.ref_gt,dgt.genome,
+                                      lnRefPprobErrorBound))
+    {
+        return false;
+    }
+
+    double polyLnRefPprobErrorBound(0);
+    if (! calculate_homref_result_set(lhood,lnprior_polymorphic(dgt.ref_gt,dgt.is_haploid()),dgt.ref_gt,dgt.poly,
+                                      polyLnRefPprobErrorBound))
+    {
+        return false;
+    }
+
+    // strand-bias requires the full likelihood computation:
+    if (dgt.is_snp()) return false;
+    dgt.strand_bias = 0;
+
+    return true;
+}
+
+
+
 std::ostream& operator<<(std::ostream& os,const diploid_genotype& dgt)
 {
     const result_set& ge(dgt.genome);
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "blt_common/BasecallHistogram.hh"
 #include "blt_common/blt_shared.hh"
 #include "blt_common/snp_pos_info.hh"
 
@@ -142,6 +143,28 @@ struct pprob_digt_caller : private boost::noncopyable
         diploid_genotype& dgt,
         const bool is_always_test = false) const;
 
+    /// \brief attempt a cheaper form of position_snp_call_pprob_digt for a site where all basecalls match the
+    /// reference
+    ///
+    /// The likelihoods of genotypes which contain the reference allele are computed exactly, without the dependent
+    /// error probabilities, which do not need to be set in epi. The likelihoods of all other genotypes are bounded
+    /// by setting the dependent error probabilities to 1. The site is certified if the bounded genotypes can't change
+    /// the most likely genotype or any rounded quality value, in which case dgt matches the result of
+    /// position_snp_call_pprob_digt with is_always_test set, except that:
+    /// - ref_pprob is only known within the error bound below
+    /// - phredLoghood is computed from the bounded likelihoods, so it is only valid for reference genotypes
+    ///
+    /// \param[out] lnRefPprobErrorBound bound on the absolute error of log(dgt.genome.ref_pprob)
+    ///
+    /// \return true if the site is certified as homozygous reference, otherwise dgt is undefined and
+    ///         position_snp_call_pprob_digt is required
+    bool
+    position_snp_call_pprob_digt_homref(
+        const blt_options& opt,
+        const extended_pos_info& epi,
+        diploid_genotype& dgt,
+        double& lnRefPprobErrorBound) const;
+
 
     const blt_float_t*
     lnprior_genomic(
@@ -161,14 +184,20 @@ struct pprob_digt_caller : private boost::noncopyable
 
     static
     void
+    /// \param[in] histogramPtr If non-null, a basecall histogram of epi's pileup which is used in place of the
+    ///                         individual basecalls. This is only valid when error probabilities are not dependent.
+    /// \param[in] isDependentErrorProbBound If true, the dependent error probabilities of epi are replaced by their
+    ///                         upper bound of 1.
     get_diploid_gt_lhood(
         const blt_options& opt,
         const extended_pos_info& epi,
+        const BasecallHistogram* histogramPtr,
         const bool useHetVariantFrequencyExtension,
         const blt_float_t hetVariantFrequencyExtension,
         blt_float_t* const lhood,
         const bool is_strand_specific = false,
-        const bool is_ss_fwd = false);
+        const bool is_ss_fwd = false,
+        const bool isDependentErrorProbBound = false);
 
     static
     void
@@ -23,6 +23,7 @@
 
 #include "blt_common/snp_pos_info.hh"
 #include "blt_util/io_util.hh"
+#include "blt_util/MeanTracker.hh"
 
 #include <iomanip>
 #include <iostream>
@@ -35,6 +36,8 @@ static_assert(sizeof(base_call)==2, "Unexpected base_call object size");
 
 const unsigned base_call::qscore_max = ((1 << base_call::qscore_bits) - 1);
 
+const unsigned snp_pos_info::maxDistanceFromReadEdge = 20;
+
 
 std::ostream&
 operator<<(std::ostream& os,
@@ -72,45 +75,76 @@ operator<<(std::ostream& os,
 
 
 
+/// \return rank-sum of the value returned by obsValue(obs) for all scoring observations
+template <typename ObsValueFunc>
+static
+fastRanksum
+getScoringRankSum(
+    const SlabArray<snp_pos_info::ScoringObservation,pos_t>& scoringObservations,
+    const bool isIncludeSubmapped,
+    ObsValueFunc obsValue)
+{
+    fastRanksum ranksum;
+    for (const auto& obs : scoringObservations)
+    {
+        if (obs.isSubmapped && (! isIncludeSubmapped)) continue;
+        ranksum.add_observation(obs.isReference, obsValue(obs));
+    }
+    return ranksum;
+}
+
+
+
 double
 snp_pos_info::
 get_read_pos_ranksum() const
 {
-    //	cout << read_pos_ranksum << endl;
-    return readPositionRankSum.get_z_stat();
-
+    return getReadPositionRankSum().get_z_stat();
 }
 
 double
 snp_pos_info::
 get_mq_ranksum() const
 {
-    return mq_ranksum.get_z_stat();
+    return getScoringRankSum(scoringObservations, true,
+                             [](const ScoringObservation& obs) { return obs.mapq; }).get_z_stat();
 }
 
 double
 snp_pos_info::
 get_baseq_ranksum() const
 {
-//	cout << baseq_ranksum << endl;
-    return baseq_ranksum.get_z_stat();
+    return getBaseQualityRankSum().get_z_stat();
 }
 
-double
+fastRanksum
+snp_pos_info::
+getReadPositionRankSum() const
+{
+    return getScoringRankSum(scoringObservations, false,
+                             [](const ScoringObservation& obs) { return obs.readPos; });
+}
+
+fastRanksum
 snp_pos_info::
-get_raw_pos() const
+getBaseQualityRankSum() const
 {
-//  cout << baseq_ranksum << endl;
-    return readPositionRankSum.getExpectedCategory2Value();
+    return getScoringRankSum(scoringObservations, false,
+                             [](const ScoringObservation& obs) { return obs.qscore; });
 }
 
 
 double
 snp_pos_info::
-get_raw_baseQ() const
+getMeanDistanceFromReadEdge() const
 {
-//  cout << baseq_ranksum << endl;
-    return baseq_ranksum.getExpectedCategory2Value();
+    MeanTracker distanceFromReadEdge;
+    for (const auto& obs : scoringObservations)
+    {
+        if (obs.isSubmapped || obs.isReference) continue;
+        distanceFromReadEdge.addObservation(obs.distanceFromReadEdge);
+    }
+    return distanceFromReadEdge.mean();
 }
 
 
@@ -25,10 +25,11 @@
 
 #include "blt_common/hapscore.hh"
 #include "blt_common/MapqTracker.hh"
+#include "blt_util/blt_types.hh"
 #include "blt_util/fastRanksum.hh"
-#include "blt_util/MeanTracker.hh"
 #include "blt_util/qscore.hh"
 #include "blt_util/seq_util.hh"
+#include "blt_util/SlabArena.hh"
 
 #include <cstdint>
 
@@ -124,6 +125,9 @@ public:
 
 std::ostream& operator<<(std::ostream& os,const base_call& bc);
 
+/// basecall pileup array, this can optionally be backed by a position-keyed arena (see pos_basecall_buffer)
+typedef SlabArray<base_call,pos_t> basecall_array_t;
+
 
 /// \brief Captures basecall information for a single position 'pileup'
 struct snp_pos_info
@@ -145,10 +149,7 @@ struct snp_pos_info
         submappedReadCount=0;
         mapqTracker.clear();
         hap_set.clear();
-        mq_ranksum.clear();
-        baseq_ranksum.clear();
-        readPositionRankSum.clear();
-        distanceFromReadEdge.clear();
+        scoringObservations.clear();
         altAlleleReadPositionInfo.clear();
 
         spanningIndelPloidyModification = 0;
@@ -230,12 +231,21 @@ struct snp_pos_info
     double
     get_baseq_ranksum() const;
 
-    double
-    get_raw_baseQ() const;
+    /// \return rank-sum of read position for reference and non-reference observations
+    ///
+    /// This provides both the read-position rank-sum and the raw (mean non-reference) read position.
+    fastRanksum
+    getReadPositionRankSum() const;
 
-    /// \return the raw pos sum
+    /// \return rank-sum of basecall quality for reference and non-reference observations
+    ///
+    /// This provides both the basecall quality rank-sum and the raw (mean non-reference) basecall quality.
+    fastRanksum
+    getBaseQualityRankSum() const;
+
+    /// \return mean distance of the non-reference observations from the edge of the read
     double
-    get_raw_pos() const;
+    getMeanDistanceFromReadEdge() const;
 
     void
     print_known_counts(std::ostream& os,
@@ -250,8 +260,8 @@ private:
     char _ref_base; // always fwd-strand base
 public:
     bool is_n_ref_warn;
-    std::vector<base_call> calls;
-    std::vector<base_call> tier2_calls; // call not passing stringent quality criteria
+    basecall_array_t calls;
+    basecall_array_t tier2_calls; // call not passing stringent quality criteria
 
     /// number of spanning deletion reads crossing the site
     unsigned spanningDeletionReadCount;
@@ -266,15 +276,30 @@ public:
 
     mutable hap_set_t hap_set;
 
-    //for calculating various rank-sum statistics
-    fastRanksum mq_ranksum;
-    fastRanksum baseq_ranksum;
-    fastRanksum readPositionRankSum;
-
-    /// Track summary stats for the distance of the variant locus from the edge of the read.
+    /// Read observation data for the rank-sum and read position scoring features.
     ///
-    /// This is used to support an RNA-Seq EVS feature.
-    MeanTracker distanceFromReadEdge;
+    /// These features are only reported at a small fraction of positions, so each observation is stored during
+    /// pileup and the features are computed from these on demand.
+    struct ScoringObservation
+    {
+        /// read position in the orientation used for the read position rank-sum
+        uint32_t readPos;
+
+        /// zero-indexed distance from the edge of the full read, limited to maxDistanceFromReadEdge
+        uint8_t distanceFromReadEdge;
+
+        uint8_t mapq;
+        uint8_t qscore;
+        bool isReference;
+
+        /// submapped observations only contribute to the mapQ rank-sum
+        bool isSubmapped;
+    };
+
+    /// limiting the edge distance may help the mean edge distance better generalize over different read lengths
+    static const unsigned maxDistanceFromReadEdge;
+
+    SlabArray<ScoringObservation,pos_t> scoringObservations;
 
     /// Utility to store read position and total read length.
     struct ReadPositionInfo
@@ -286,7 +311,7 @@ public:
     /// Read position of all non-reference allele observations.
     ///
     /// This is used to compute an allele position bias features in the somatic model.
-    std::vector<ReadPositionInfo> altAlleleReadPositionInfo;
+    SlabArray<ReadPositionInfo,pos_t> altAlleleReadPositionInfo;
 
     int spanningIndelPloidyModification = 0;
 };
@@ -0,0 +1,101 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "BasecallHistogram.hh"
+
+
+BOOST_AUTO_TEST_SUITE( BasecallHistogram_test )
+
+
+static
+base_call
+getCall(
+    const uint8_t baseId,
+    const uint8_t qscore,
+    const bool isFwdStrand)
+{
+    return base_call(baseId, qscore, isFwdStrand, 0, 0, false, false, false);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_BasecallHistogram_counts )
+{
+    std::vector<base_call> calls;
+    calls.push_back(getCall(BASE_ID::C, 30, true));
+    calls.push_back(getCall(BASE_ID::A, 30, true));
+    calls.push_back(getCall(BASE_ID::C, 30, true));
+    calls.push_back(getCall(BASE_ID::C, 30, false));
+    calls.push_back(getCall(BASE_ID::C, 20, true));
+    calls.push_back(getCall(BASE_ID::A, 30, true));
+    calls.push_back(getCall(BASE_ID::C, 30, true));
+
+    const BasecallHistogram histogram(calls);
+
+    BOOST_REQUIRE_EQUAL(histogram.getTotalCount(), calls.size());
+    BOOST_REQUIRE_EQUAL(histogram.size(), 4u);
+
+    // bins are reported in order of first observation:
+    const BasecallHistogram::Bin* bin(histogram.begin());
+    BOOST_REQUIRE_EQUAL(bin[0].baseId, BASE_ID::C);
+    BOOST_REQUIRE_EQUAL(bin[0].qscore, 30);
+    BOOST_REQUIRE(bin[0].isFwdStrand);
+    BOOST_REQUIRE_EQUAL(bin[0].count, 3u);
+
+    BOOST_REQUIRE_EQUAL(bin[1].baseId, BASE_ID::A);
+    BOOST_REQUIRE_EQUAL(bin[1].count, 2u);
+
+    BOOST_REQUIRE_EQUAL(bin[2].baseId, BASE_ID::C);
+    BOOST_REQUIRE(! bin[2].isFwdStrand);
+    BOOST_REQUIRE_EQUAL(bin[2].count, 1u);
+
+    BOOST_REQUIRE_EQUAL(bin[3].qscore, 20);
+    BOOST_REQUIRE_EQUAL(bin[3].count, 1u);
+
+    unsigned binTotal(0);
+    for (const BasecallHistogram::Bin& histBin : histogram)
+    {
+        binTotal += histBin.count;
+    }
+    BOOST_REQUIRE_EQUAL(binTotal, calls.size());
+}
+
+
+BOOST_AUTO_TEST_CASE( test_BasecallHistogram_clear )
+{
+    BasecallHistogram histogram;
+    histogram.addCall(getCall(BASE_ID::G, 40, false));
+    histogram.addCall(getCall(BASE_ID::T, 63, true));
+    BOOST_REQUIRE_EQUAL(histogram.size(), 2u);
+
+    histogram.clear();
+    BOOST_REQUIRE_EQUAL(histogram.size(), 0u);
+    BOOST_REQUIRE_EQUAL(histogram.getTotalCount(), 0u);
+    BOOST_REQUIRE(histogram.begin() == histogram.end());
+
+    // a previously observed key must start a new bin after clear:
+    histogram.addCall(getCall(BASE_ID::T, 63, true));
+    BOOST_REQUIRE_EQUAL(histogram.size(), 1u);
+    BOOST_REQUIRE_EQUAL(histogram.begin()->baseId, BASE_ID::T);
+    BOOST_REQUIRE_EQUAL(histogram.begin()->count, 1u);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,190 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "position_snp_call_pprob_digt.hh"
+#include "adjust_joint_eprob.hh"
+
+#include <cmath>
+
+
+BOOST_AUTO_TEST_SUITE( position_snp_call_pprob_digt_test )
+
+
+namespace
+{
+
+struct DiploidTestOptions : public blt_options
+{
+    DiploidTestOptions()
+    {
+        bsnp_ssd_no_mismatch = 0.35;
+        bsnp_ssd_one_mismatch = 0.6;
+    }
+
+    bool
+    is_bsnp_diploid() const override
+    {
+        return true;
+    }
+};
+
+}
+
+
+static
+void
+addCalls(
+    const uint8_t baseId,
+    const unsigned count,
+    snp_pos_info& pi)
+{
+    static const uint8_t qscores[] = {37, 23, 37, 12, 37, 2, 37};
+    static const unsigned qscoreCount(sizeof(qscores)/sizeof(qscores[0]));
+    for (unsigned callIndex(0); callIndex<count; ++callIndex)
+    {
+        const uint8_t qscore(qscores[(pi.calls.size()) % qscoreCount]);
+        pi.calls.push_back(base_call(baseId, qscore, ((callIndex%2)==0), 0, 0, false, false, false));
+    }
+}
+
+
+
+static
+void
+checkResultSet(
+    const diploid_genotype::result_set& expect,
+    const diploid_genotype::result_set& result)
+{
+    BOOST_REQUIRE_EQUAL(expect.max_gt, result.max_gt);
+    BOOST_REQUIRE_EQUAL(expect.max_gt_qphred, result.max_gt_qphred);
+    BOOST_REQUIRE_EQUAL(expect.snp_qphred, result.snp_qphred);
+}
+
+
+
+/// test that each certified homref result matches the full computation
+static
+void
+checkHomRefCertification(
+    const blt_options& opt,
+    const int ploidy,
+    const snp_pos_info& pi,
+    const bool isCertifiedExpected)
+{
+    const pprob_digt_caller caller(opt.bsnp_diploid_theta);
+
+    dependent_prob_cache dpc;
+    std::vector<float> dependentErrorProb;
+    adjust_joint_eprob(opt, dpc, pi, dependentErrorProb);
+    const extended_pos_info epi(pi, dependentErrorProb);
+
+    diploid_genotype expectDgt;
+    expectDgt.ploidy = ploidy;
+    caller.position_snp_call_pprob_digt(opt, epi, expectDgt, true);
+
+    const std::vector<float> emptyErrorProb;
+    const extended_pos_info homRefEpi(pi, emptyErrorProb);
+
+    diploid_genotype dgt;
+    dgt.ploidy = ploidy;
+    double lnRefPprobErrorBound(0);
+    const bool isCertified(caller.position_snp_call_pprob_digt_homref(opt, homRefEpi, dgt, lnRefPprobErrorBound));
+    BOOST_REQUIRE_EQUAL(isCertified, isCertifiedExpected);
+    if (! isCertified) return;
+
+    BOOST_REQUIRE_EQUAL(expectDgt.ref_gt, dgt.ref_gt);
+    checkResultSet(expectDgt.genome, dgt.genome);
+    checkResultSet(expectDgt.poly, dgt.poly);
+    BOOST_REQUIRE_EQUAL(expectDgt.strand_bias, dgt.strand_bias);
+    BOOST_REQUIRE_LE(std::abs(std::log(expectDgt.genome.ref_pprob)-std::log(dgt.genome.ref_pprob)),
+                     lnRefPprobErrorBound);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_homref_shortcut_depth )
+{
+    const DiploidTestOptions opt;
+
+    snp_pos_info pi;
+    pi.set_ref_base('C');
+    addCalls(BASE_ID::C, 60, pi);
+    checkHomRefCertification(opt, 2, pi, true);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_homref_shortcut_low_depth )
+{
+    // check that the full computation is requested when the bounded genotypes could matter:
+    const DiploidTestOptions opt;
+
+    snp_pos_info pi;
+    pi.set_ref_base('C');
+    addCalls(BASE_ID::C, 1, pi);
+    checkHomRefCertification(opt, 2, pi, false);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_homref_shortcut_alt_evidence )
+{
+    const DiploidTestOptions opt;
+
+    snp_pos_info pi;
+    pi.set_ref_base('C');
+    addCalls(BASE_ID::C, 40, pi);
+    addCalls(BASE_ID::T, 1, pi);
+    checkHomRefCertification(opt, 2, pi, false);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_homref_shortcut_all_depths )
+{
+    // at any depth, a certified result must match the full computation:
+    DiploidTestOptions opt;
+
+    for (const int ploidy : {1, 2})
+    {
+        for (const double hetVariantFrequencyExtension : {0., 0.2})
+        {
+            opt.hetVariantFrequencyExtension = hetVariantFrequencyExtension;
+            for (unsigned depth(0); depth<80; ++depth)
+            {
+                snp_pos_info pi;
+                pi.set_ref_base('G');
+                addCalls(BASE_ID::G, depth, pi);
+
+                const pprob_digt_caller caller(opt.bsnp_diploid_theta);
+                const std::vector<float> emptyErrorProb;
+                diploid_genotype dgt;
+                dgt.ploidy = ploidy;
+                double lnRefPprobErrorBound(0);
+                const bool isCertified(caller.position_snp_call_pprob_digt_homref(
+                                           opt, extended_pos_info(pi, emptyErrorProb), dgt, lnRefPprobErrorBound));
+                checkHomRefCertification(opt, ploidy, pi, isCertified);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -165,6 +165,48 @@ struct RangeMap
         return _data[getKeyIndex(k)];
     }
 
+    /// find the lowest key present in the map which is greater than or equal to k
+    ///
+    /// \param[out] nextKey set to the key found, unchanged if no key is found
+    /// \return false if no such key is present
+    bool
+    getNextPresentKey(
+        const KeyType& k,
+        KeyType& nextKey) const
+    {
+        if (_isEmpty || (k > _maxKey)) return false;
+
+        const unsigned startOffset((k < _minKey) ? 0 : (k-_minKey));
+        const unsigned startIndex(getKeyIndexOffset(startOffset));
+        const unsigned dataSize(_data.size());
+
+        // occupancy is searched in storage order, which may wrap around the end of the data vector:
+        unsigned offset(0);
+        size_t index(findNextOccupied(startIndex));
+        if (startIndex >= _minKeyIndex)
+        {
+            if (index != boost::dynamic_bitset<>::npos)
+            {
+                offset = index - _minKeyIndex;
+            }
+            else
+            {
+                index = _occup.find_first();
+                if ((index == boost::dynamic_bitset<>::npos) || (index >= _minKeyIndex)) return false;
+                offset = (dataSize - _minKeyIndex) + index;
+            }
+        }
+        else
+        {
+            if ((index == boost::dynamic_bitset<>::npos) || (index >= _minKeyIndex)) return false;
+            offset = (dataSize - _minKeyIndex) + index;
+        }
+
+        if (offset > static_cast<unsigned>(_maxKey-_minKey)) return false;
+        nextKey = _minKey + offset;
+        return true;
+    }
+
     void
     erase(
         const KeyType& k)
@@ -231,19 +273,26 @@ private:
     resetMinKey()
     {
         // we have to shift minKey up to the next valid value:
-        const unsigned keySize(_maxKey-_minKey);
-        for (unsigned offset(1); offset<=keySize; ++offset)
+        KeyType nextKey;
+        if (getNextPresentKey(_minKey, nextKey))
         {
-            const unsigned testIndex(getKeyIndexOffset(offset));
-            if (! _occup.test(testIndex)) continue;
-            _minKeyIndex = testIndex;
-            _minKey += offset;
+            _minKeyIndex = getKeyIndex(nextKey);
+            _minKey = nextKey;
             return;
         }
 
         _isEmpty=true;
     }
 
+    /// \return index of the first occupied storage position at or after index, or npos if there is none
+    size_t
+    findNextOccupied(
+        const unsigned index) const
+    {
+        if (_occup.test(index)) return index;
+        return _occup.find_next(index);
+    }
+
     /// assumes offset has already been validated!
     unsigned
     getKeyIndexOffset(
@@ -0,0 +1,148 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+
+#include "RecyclingAllocator.hh"
+
+#include <new>
+
+
+
+namespace
+{
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+
+struct SizeClass
+{
+    std::size_t size;
+    FreeBlock* head;
+    unsigned freeCount;
+};
+
+
+struct ThreadFreeLists
+{
+    ~ThreadFreeLists()
+    {
+        for (unsigned sizeClassIndex(0); sizeClassIndex < sizeClassCount; ++sizeClassIndex)
+        {
+            FreeBlock* block(sizeClasses[sizeClassIndex].head);
+            while (block != nullptr)
+            {
+                FreeBlock* next(block->next);
+                ::operator delete(block);
+                block = next;
+            }
+        }
+        isThreadFreeListsDestroyed = true;
+    }
+
+    /// \return Size class for size, or nullptr if size is not recycled
+    SizeClass*
+    getSizeClass(const std::size_t size)
+    {
+        for (unsigned sizeClassIndex(0); sizeClassIndex < sizeClassCount; ++sizeClassIndex)
+        {
+            if (sizeClasses[sizeClassIndex].size == size) return (sizeClasses + sizeClassIndex);
+        }
+        if (sizeClassCount >= RecyclingAllocator::maxSizeClassCount) return nullptr;
+
+        SizeClass& sizeClass(sizeClasses[sizeClassCount++]);
+        sizeClass.size = size;
+        sizeClass.head = nullptr;
+        sizeClass.freeCount = 0;
+        return &sizeClass;
+    }
+
+    /// set once the free lists of this thread have been torn down, after which any remaining blocks bypass recycling
+    static thread_local bool isThreadFreeListsDestroyed;
+
+    SizeClass sizeClasses[RecyclingAllocator::maxSizeClassCount];
+    unsigned sizeClassCount = 0;
+    RecyclingAllocatorStats stats;
+};
+
+thread_local bool ThreadFreeLists::isThreadFreeListsDestroyed(false);
+
+thread_local ThreadFreeLists threadFreeLists;
+
+}
+
+
+
+void*
+RecyclingAllocator::
+allocate(const std::size_t size)
+{
+    if ((size >= sizeof(FreeBlock)) && (! ThreadFreeLists::isThreadFreeListsDestroyed))
+    {
+        SizeClass* sizeClassPtr(threadFreeLists.getSizeClass(size));
+        if ((sizeClassPtr != nullptr) && (sizeClassPtr->head != nullptr))
+        {
+            FreeBlock* block(sizeClassPtr->head);
+            sizeClassPtr->head = block->next;
+            sizeClassPtr->freeCount--;
+            threadFreeLists.stats.recycledAllocations++;
+            return block;
+        }
+        threadFreeLists.stats.heapAllocations++;
+    }
+    return ::operator new(size);
+}
+
+
+
+void
+RecyclingAllocator::
+deallocate(
+    void* ptr,
+    const std::size_t size)
+{
+    if (ptr == nullptr) return;
+
+    if ((size >= sizeof(FreeBlock)) && (! ThreadFreeLists::isThreadFreeListsDestroyed))
+    {
+        SizeClass* sizeClassPtr(threadFreeLists.getSizeClass(size));
+        if ((sizeClassPtr != nullptr) && (sizeClassPtr->freeCount < maxFreeBlockCount))
+        {
+            FreeBlock* block(static_cast<FreeBlock*>(ptr));
+            block->next = sizeClassPtr->head;
+            sizeClassPtr->head = block;
+            sizeClassPtr->freeCount++;
+            return;
+        }
+    }
+    ::operator delete(ptr);
+}
+
+
+
+RecyclingAllocatorStats
+RecyclingAllocator::
+getThreadStats()
+{
+    if (ThreadFreeLists::isThreadFreeListsDestroyed) return RecyclingAllocatorStats();
+    return threadFreeLists.stats;
+}
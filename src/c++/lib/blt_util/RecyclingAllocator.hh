@@ -0,0 +1,73 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Thread-local storage recycling for objects which are created and destroyed at high frequency
+///
+
+#pragma once
+
+#include <cstddef>
+
+
+/// \brief Allocation counters for RecyclingAllocator, accumulated over all allocations made from one thread
+struct RecyclingAllocatorStats
+{
+    /// Number of blocks allocated from the heap
+    unsigned long heapAllocations = 0;
+
+    /// Number of blocks served from the free list of previously deallocated blocks
+    unsigned long recycledAllocations = 0;
+};
+
+
+
+/// \brief Storage allocator which recycles deallocated blocks through a free list for each block size
+///
+/// This is intended to back the class-specific operator new/delete of a polymorphic type hierarchy, in which case
+/// all derived types share the allocator and the sized operator delete receives the size of the most-derived type.
+/// Each thread holds its own free lists so no locking is required. A block may be deallocated on a different thread
+/// than the one which allocated it, in which case it joins the free list of the deallocating thread.
+///
+/// Only a small number of distinct block sizes are recycled, and the number of free blocks retained for each size is
+/// limited. Requests outside of these limits fall back to the global operator new/delete.
+///
+struct RecyclingAllocator
+{
+    /// Maximum number of distinct block sizes recycled per thread
+    static const unsigned maxSizeClassCount = 8;
+
+    /// Maximum number of free blocks retained per thread for each block size
+    static const unsigned maxFreeBlockCount = 4096;
+
+    static
+    void*
+    allocate(const std::size_t size);
+
+    static
+    void
+    deallocate(
+        void* ptr,
+        const std::size_t size);
+
+    /// \return Allocation counters for the calling thread
+    static
+    RecyclingAllocatorStats
+    getThreadStats();
+};
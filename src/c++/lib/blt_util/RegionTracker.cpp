@@ -23,6 +23,8 @@
 
 #include "blt_util/RegionTracker.hh"
 
+#include <algorithm>
+
 
 
 bool
@@ -61,6 +63,19 @@ isSubsetOfRegionImpl(
 
 
 
+boost::optional<pos_t>
+RegionTracker::
+getNextRegionPos(
+    const pos_t pos) const
+{
+    // find first region where region.endPos > pos
+    const auto posIter(_regions.upper_bound(known_pos_range2(pos,pos)));
+    if (posIter == _regions.end()) return boost::none;
+    return std::max(posIter->begin_pos(), pos);
+}
+
+
+
 void
 RegionTracker::
 addRegion(
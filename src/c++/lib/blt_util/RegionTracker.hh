@@ -90,6 +90,11 @@ struct RegionTracker
         return isSubsetOfRegionImpl(range.begin_pos(),range.end_pos());
     }
 
+    /// \return the first position at or after \p pos which is in a tracked region, if any
+    boost::optional<pos_t>
+    getNextRegionPos(
+        const pos_t pos) const;
+
     /// add region
     ///
     /// any overlaps and adjacencies with existing regions in the tracker will be collapsed
@@ -0,0 +1,399 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Slab-backed storage for many small arrays with a shared, ordered lifetime
+///
+
+#pragma once
+
+#include "boost/utility.hpp"
+
+#include <cassert>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+/// \brief Allocation counters for SlabArena
+struct SlabArenaStats
+{
+    void
+    merge(const SlabArenaStats& rhs)
+    {
+        slabAllocations += rhs.slabAllocations;
+        slabBytes += rhs.slabBytes;
+        blockAllocations += rhs.blockAllocations;
+    }
+
+    /// Number of slabs allocated from the heap
+    unsigned long slabAllocations = 0;
+
+    /// Total size of all slabs allocated from the heap
+    unsigned long slabBytes = 0;
+
+    /// Number of array blocks carved from slabs
+    unsigned long blockAllocations = 0;
+};
+
+
+
+/// \brief Bump allocator handing out contiguous blocks of T from a pool of large slabs
+///
+/// Each block is allocated with a release key (in practice, the reference position of the pileup array it stores).
+/// Blocks are never freed individually. Instead, releaseTo(key) returns every slab holding only blocks with keys less
+/// than or equal to key to a free pool in a single step. Free slabs are reused for subsequent allocations, so once the
+/// arena reaches the working size of its window no further heap allocation occurs.
+///
+/// No constructors or destructors are run on arena storage, so T should be a trivially copyable type.
+///
+template <typename T, typename KeyType>
+struct SlabArena : private boost::noncopyable
+{
+    static const unsigned defaultSlabSize = 16384;
+
+    /// \param slabSize Number of T elements in each slab. Requests for larger blocks get a dedicated slab.
+    explicit
+    SlabArena(const unsigned slabSize = defaultSlabSize)
+        : _slabSize(slabSize)
+    {
+        assert(_slabSize > 0);
+    }
+
+    /// \return Uninitialized storage for size elements of T, which remains valid until a releaseTo() call with a
+    ///         key greater than or equal to key, or clear()
+    T*
+    allocate(
+        const unsigned size,
+        const KeyType& key)
+    {
+        assert(size > 0);
+        if (_activeSlabs.empty() || ((_activeSlabs.back()->capacity - _activeSlabs.back()->used) < size))
+        {
+            _activeSlabs.push_back(getFreeSlab(size));
+        }
+
+        Slab& slab(*_activeSlabs.back());
+        if ((slab.used == 0) || (slab.maxKey < key)) slab.maxKey = key;
+        T* block(slab.data + slab.used);
+        slab.used += size;
+        _stats.blockAllocations++;
+        return block;
+    }
+
+    /// release all slabs containing only blocks allocated with keys less than or equal to key
+    void
+    releaseTo(const KeyType& key)
+    {
+        unsigned keepCount(0);
+        const unsigned slabCount(_activeSlabs.size());
+        for (unsigned slabIndex(0); slabIndex < slabCount; ++slabIndex)
+        {
+            std::unique_ptr<Slab>& slabPtr(_activeSlabs[slabIndex]);
+            if (slabPtr->maxKey <= key)
+            {
+                slabPtr->used = 0;
+                _freeSlabs.push_back(std::move(slabPtr));
+            }
+            else
+            {
+                if (keepCount != slabIndex) _activeSlabs[keepCount] = std::move(slabPtr);
+                keepCount++;
+            }
+        }
+        _activeSlabs.resize(keepCount);
+    }
+
+    /// release all slabs
+    void
+    clear()
+    {
+        for (std::unique_ptr<Slab>& slabPtr : _activeSlabs)
+        {
+            slabPtr->used = 0;
+            _freeSlabs.push_back(std::move(slabPtr));
+        }
+        _activeSlabs.clear();
+    }
+
+    const SlabArenaStats&
+    getStats() const
+    {
+        return _stats;
+    }
+
+private:
+    struct Slab : private boost::noncopyable
+    {
+        explicit
+        Slab(const unsigned initCapacity)
+            : data(std::allocator<T>().allocate(initCapacity)),
+              capacity(initCapacity)
+        {}
+
+        ~Slab()
+        {
+            std::allocator<T>().deallocate(data, capacity);
+        }
+
+        T* data;
+        const unsigned capacity;
+        unsigned used = 0;
+        KeyType maxKey = KeyType();
+    };
+
+    /// get a free slab with capacity for at least size elements
+    std::unique_ptr<Slab>
+    getFreeSlab(const unsigned size)
+    {
+        const unsigned freeCount(_freeSlabs.size());
+        for (unsigned freeIndex(0); freeIndex < freeCount; ++freeIndex)
+        {
+            if (_freeSlabs[freeIndex]->capacity < size) continue;
+            std::unique_ptr<Slab> slabPtr(std::move(_freeSlabs[freeIndex]));
+            _freeSlabs[freeIndex] = std::move(_freeSlabs.back());
+            _freeSlabs.pop_back();
+            return slabPtr;
+        }
+
+        const unsigned capacity(std::max(size, _slabSize));
+        _stats.slabAllocations++;
+        _stats.slabBytes += capacity*sizeof(T);
+        return std::unique_ptr<Slab>(new Slab(capacity));
+    }
+
+    const unsigned _slabSize;
+
+    /// slabs which may contain live blocks, the last slab is the current allocation target
+    std::vector<std::unique_ptr<Slab>> _activeSlabs;
+    std::vector<std::unique_ptr<Slab>> _freeSlabs;
+    SlabArenaStats _stats;
+};
+
+
+
+/// \brief Minimal vector-like array which can optionally be carved out of a SlabArena
+///
+/// By default the array owns heap storage and behaves like a std::vector. After setArena() is called on an empty
+/// array, all further storage is taken from the arena under the given release key, until the next clear() detaches
+/// the array from the arena again. Arena storage must not be accessed after the arena releases the key, so owners
+/// are expected to clear() any array bound to a released key before reusing it.
+///
+/// Copies of an arena-bound array always own heap storage.
+///
+template <typename T, typename KeyType>
+struct SlabArray
+{
+    typedef SlabArena<T,KeyType> arena_t;
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    SlabArray() = default;
+
+    SlabArray(const SlabArray& rhs)
+        : _heap(rhs.begin(), rhs.end())
+    {
+        syncHeap();
+    }
+
+    SlabArray(SlabArray&& rhs) noexcept
+    {
+        moveFrom(rhs);
+    }
+
+    SlabArray&
+    operator=(const SlabArray& rhs)
+    {
+        if (this == &rhs) return *this;
+        detachArena();
+        _heap.assign(rhs.begin(), rhs.end());
+        syncHeap();
+        return *this;
+    }
+
+    SlabArray&
+    operator=(SlabArray&& rhs) noexcept
+    {
+        if (this == &rhs) return *this;
+        moveFrom(rhs);
+        return *this;
+    }
+
+    /// bind an empty array to arena storage for the given release key
+    void
+    setArena(
+        arena_t* arenaPtr,
+        const KeyType& key)
+    {
+        assert(empty());
+        _arenaPtr = arenaPtr;
+        _arenaKey = key;
+        _data = nullptr;
+        _capacity = 0;
+    }
+
+    bool
+    empty() const
+    {
+        return (_size == 0);
+    }
+
+    unsigned
+    size() const
+    {
+        return _size;
+    }
+
+    T&
+    operator[](const unsigned index)
+    {
+        assert(index < _size);
+        return _data[index];
+    }
+
+    const T&
+    operator[](const unsigned index) const
+    {
+        assert(index < _size);
+        return _data[index];
+    }
+
+    iterator
+    begin()
+    {
+        return _data;
+    }
+
+    iterator
+    end()
+    {
+        return _data + _size;
+    }
+
+    const_iterator
+    begin() const
+    {
+        return _data;
+    }
+
+    const_iterator
+    end() const
+    {
+        return _data + _size;
+    }
+
+    const T&
+    back() const
+    {
+        assert(! empty());
+        return _data[_size-1];
+    }
+
+    /// empty the array and detach it from any arena, heap capacity is retained
+    void
+    clear()
+    {
+        detachArena();
+        _heap.clear();
+        syncHeap();
+    }
+
+    void
+    push_back(const T& val)
+    {
+        if (_arenaPtr == nullptr)
+        {
+            _heap.push_back(val);
+            syncHeap();
+            return;
+        }
+
+        if (_size == _capacity) growArena();
+        new (_data + _size) T(val);
+        _size++;
+    }
+
+    template <typename... Args>
+    void
+    emplace_back(Args&& ... args)
+    {
+        push_back(T(std::forward<Args>(args)...));
+    }
+
+private:
+    void
+    syncHeap()
+    {
+        _data = _heap.data();
+        _size = _heap.size();
+        _capacity = 0;
+    }
+
+    void
+    detachArena()
+    {
+        _arenaPtr = nullptr;
+    }
+
+    /// move the array to a new arena block with double capacity, the old block is left for bulk release
+    void
+    growArena()
+    {
+        static const unsigned minArenaCapacity(8);
+        const unsigned newCapacity(std::max(minArenaCapacity, _capacity*2));
+        T* newData(_arenaPtr->allocate(newCapacity, _arenaKey));
+        if (_size > 0) std::uninitialized_copy(_data, _data + _size, newData);
+        _data = newData;
+        _capacity = newCapacity;
+    }
+
+    void
+    moveFrom(SlabArray& rhs)
+    {
+        _arenaPtr = rhs._arenaPtr;
+        _arenaKey = rhs._arenaKey;
+        _heap = std::move(rhs._heap);
+        if (_arenaPtr == nullptr)
+        {
+            syncHeap();
+        }
+        else
+        {
+            _data = rhs._data;
+            _size = rhs._size;
+            _capacity = rhs._capacity;
+        }
+        rhs.clear();
+    }
+
+    T* _data = nullptr;
+    unsigned _size = 0;
+
+    /// capacity of the current arena block, unused for heap storage
+    unsigned _capacity = 0;
+
+    arena_t* _arenaPtr = nullptr;
+    KeyType _arenaKey = KeyType();
+
+    std::vector<T> _heap;
+};
@@ -0,0 +1,203 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Bounded single-producer single-consumer ring buffer of recycled slots
+///
+
+#pragma once
+
+#include "boost/utility.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+
+/// \brief Bounded ring buffer connecting one producer thread to one consumer thread
+///
+/// Slot objects are created once and recycled for the lifetime of the ring: the producer fills the next free slot
+/// in place and publishes it with commitWrite(), the consumer reads (or swaps out) the oldest published slot in
+/// place and hands it back with commitRead(). Neither side takes a lock while the ring is neither full nor empty.
+///
+/// A side which finds the ring full (producer) or empty (consumer) spins briefly and then sleeps until the other
+/// side commits a slot. The producer signals the end of its output with closeWrite(), and the consumer can stop
+/// the producer at any time with cancel().
+///
+template <typename T>
+struct SpscRingBuffer : private boost::noncopyable
+{
+    /// \param[in] capacity Number of slots, must be at least 1
+    /// \param[in] initSlot Initial value of every slot
+    explicit
+    SpscRingBuffer(
+        const unsigned capacity,
+        const T& initSlot = T())
+        : _slots(capacity, initSlot)
+    {
+        assert(capacity > 0);
+    }
+
+    unsigned
+    capacity() const
+    {
+        return _slots.size();
+    }
+
+    /// \brief Access all slots, for setup and teardown only, when neither side is active
+    std::vector<T>&
+    getSlots()
+    {
+        return _slots;
+    }
+
+    /// \brief Producer: wait for the next free slot
+    ///
+    /// \return Next free slot, or nullptr if the ring has been cancelled
+    T*
+    waitWriteSlot()
+    {
+        for (unsigned spinCount(0); true; ++spinCount)
+        {
+            if (_isCancelled.load(std::memory_order_acquire)) return nullptr;
+            const uint64_t writeCount(_writeCount.load(std::memory_order_relaxed));
+            if ((writeCount - _readCount.load(std::memory_order_acquire)) < _slots.size())
+            {
+                return &_slots[writeCount % _slots.size()];
+            }
+            if (spinCount < maxSpinCount) continue;
+
+            std::unique_lock<std::mutex> lock(_waitMutex);
+            _isWriterWaiting.store(true);
+            if ((! _isCancelled.load()) && ((_writeCount.load() - _readCount.load()) >= _slots.size()))
+            {
+                _writerCondition.wait(lock);
+            }
+            _isWriterWaiting.store(false);
+        }
+    }
+
+    /// \brief Producer: publish the slot returned by the last call to waitWriteSlot()
+    void
+    commitWrite()
+    {
+        _writeCount.store(_writeCount.load(std::memory_order_relaxed) + 1);
+        wake(_isReaderWaiting, _readerCondition);
+    }
+
+    /// \brief Producer: signal that no further slots will be written
+    void
+    closeWrite()
+    {
+        _isWriteClosed.store(true);
+        wake(_isReaderWaiting, _readerCondition);
+    }
+
+    /// \brief Consumer: wait for the oldest published slot
+    ///
+    /// \return Oldest published slot, or nullptr if all published slots have been read and the producer has called
+    ///         closeWrite()
+    T*
+    waitReadSlot()
+    {
+        for (unsigned spinCount(0); true; ++spinCount)
+        {
+            // the close flag must be read before the write count, so that no slot published before close is missed:
+            const bool isWriteClosed(_isWriteClosed.load(std::memory_order_acquire));
+            const uint64_t readCount(_readCount.load(std::memory_order_relaxed));
+            if (_writeCount.load(std::memory_order_acquire) != readCount)
+            {
+                return &_slots[readCount % _slots.size()];
+            }
+            if (isWriteClosed) return nullptr;
+            if (spinCount < maxSpinCount) continue;
+
+            std::unique_lock<std::mutex> lock(_waitMutex);
+            _isReaderWaiting.store(true);
+            if ((! _isWriteClosed.load()) && (_writeCount.load() == _readCount.load()))
+            {
+                _readerCondition.wait(lock);
+            }
+            _isReaderWaiting.store(false);
+        }
+    }
+
+    /// \brief Consumer: hand the slot returned by the last call to waitReadSlot() back to the producer
+    void
+    commitRead()
+    {
+        _readCount.store(_readCount.load(std::memory_order_relaxed) + 1);
+        wake(_isWriterWaiting, _writerCondition);
+    }
+
+    /// \brief Consumer: stop the producer, any current or future call to waitWriteSlot() returns nullptr
+    void
+    cancel()
+    {
+        _isCancelled.store(true);
+        std::lock_guard<std::mutex> lock(_waitMutex);
+        _writerCondition.notify_all();
+        _readerCondition.notify_all();
+    }
+
+    /// \brief Empty the ring and clear the closed and cancelled states, when neither side is active
+    void
+    reset()
+    {
+        _writeCount.store(0);
+        _readCount.store(0);
+        _isWriteClosed.store(false);
+        _isCancelled.store(false);
+    }
+
+private:
+    /// \brief Wake the other side if it is, or may be about to start, waiting
+    ///
+    /// The sequentially consistent count update made by the caller and the load of the waiting flag here pair with
+    /// the flag store and count load made by the waiting side under the mutex, so at least one side sees the
+    /// other's update and a wakeup can't be lost.
+    void
+    wake(
+        const std::atomic<bool>& isWaiting,
+        std::condition_variable& condition)
+    {
+        if (! isWaiting.load()) return;
+        std::lock_guard<std::mutex> lock(_waitMutex);
+        condition.notify_one();
+    }
+
+    static const unsigned maxSpinCount = 64;
+
+    std::vector<T> _slots;
+
+    std::atomic<uint64_t> _writeCount{0};
+    std::atomic<uint64_t> _readCount{0};
+    std::atomic<bool> _isWriteClosed{false};
+    std::atomic<bool> _isCancelled{false};
+
+    std::mutex _waitMutex;
+    std::atomic<bool> _isWriterWaiting{false};
+    std::atomic<bool> _isReaderWaiting{false};
+    std::condition_variable _writerCondition;
+    std::condition_variable _readerCondition;
+};
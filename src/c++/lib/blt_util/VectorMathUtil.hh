@@ -0,0 +1,423 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief SIMD exp and log over arrays of float and double values
+///
+/// The SSE2 kernels use the Cephes range reductions and polynomial/rational approximations. Over sampled
+/// inputs their relative error with respect to the C++ standard library is below:
+///
+///   exp, double: 3.5e-16 (results above the subnormal range)
+///   exp, float:  1.5e-7 (results above the subnormal range)
+///   log, double: 2.5e-16
+///   log, float:  1.5e-7
+///
+/// and the test suite checks these bounds. exp returns 0 for inputs below the smallest subnormal result
+/// and inf above the largest finite result. log returns -inf for 0, NaN for negative inputs, and handles
+/// subnormal inputs. NaN is propagated by both.
+///
+/// Without SSE2, all functions defer to std::exp and std::log.
+///
+
+#pragma once
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <cmath>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+
+#ifdef __SSE2__
+/// exp and log kernels on full SSE2 registers
+struct VectorMathKernel
+{
+    static
+    __m128d
+    exp(__m128d x)
+    {
+        const __m128d maxInput(_mm_set1_pd(709.782712893383973096));
+        const __m128d minInput(_mm_set1_pd(-745.2));
+
+        const __m128d isTooLarge(_mm_cmpgt_pd(x, maxInput));
+        const __m128d isTooSmall(_mm_cmplt_pd(x, minInput));
+
+        // argument order keeps NaN input:
+        x = _mm_min_pd(maxInput, _mm_max_pd(minInput, x));
+
+        // x = n*ln(2) + r, with ln(2) split in two parts so that n*C1 is exact:
+        const __m128i n(_mm_cvtpd_epi32(_mm_mul_pd(x, _mm_set1_pd(1.4426950408889634073599))));
+        const __m128d fn(_mm_cvtepi32_pd(n));
+        __m128d r(_mm_sub_pd(x, _mm_mul_pd(fn, _mm_set1_pd(6.93145751953125E-1))));
+        r = _mm_sub_pd(r, _mm_mul_pd(fn, _mm_set1_pd(1.42860682030941723212E-6)));
+
+        // exp(r) = 1 + 2r P(r^2) / (Q(r^2) - r P(r^2))
+        const __m128d rr(_mm_mul_pd(r, r));
+        __m128d p(_mm_set1_pd(1.26177193074810590878E-4));
+        p = _mm_add_pd(_mm_mul_pd(p, rr), _mm_set1_pd(3.02994407707441961300E-2));
+        p = _mm_add_pd(_mm_mul_pd(p, rr), _mm_set1_pd(9.99999999999999999910E-1));
+        p = _mm_mul_pd(p, r);
+        __m128d q(_mm_set1_pd(3.00198505138664455042E-6));
+        q = _mm_add_pd(_mm_mul_pd(q, rr), _mm_set1_pd(2.52448340349684104192E-3));
+        q = _mm_add_pd(_mm_mul_pd(q, rr), _mm_set1_pd(2.27265548208155028766E-1));
+        q = _mm_add_pd(_mm_mul_pd(q, rr), _mm_set1_pd(2.00000000000000000009E0));
+        __m128d y(_mm_div_pd(p, _mm_sub_pd(q, p)));
+        y = _mm_add_pd(_mm_set1_pd(1.), _mm_add_pd(y, y));
+
+        // scale by 2^n in two steps, so that each factor is a normal double:
+        const __m128i n1(_mm_srai_epi32(n, 1));
+        y = _mm_mul_pd(y, pow2pd(n1));
+        y = _mm_mul_pd(y, pow2pd(_mm_sub_epi32(n, n1)));
+
+        const __m128d inf(_mm_set1_pd(std::numeric_limits<double>::infinity()));
+        y = _mm_andnot_pd(_mm_or_pd(isTooLarge, isTooSmall), y);
+        return _mm_or_pd(y, _mm_and_pd(isTooLarge, inf));
+    }
+
+    static
+    __m128
+    exp(__m128 x)
+    {
+        const __m128 maxInput(_mm_set1_ps(88.7228391f));
+        const __m128 minInput(_mm_set1_ps(-103.98f));
+
+        const __m128 isTooLarge(_mm_cmpgt_ps(x, maxInput));
+        const __m128 isTooSmall(_mm_cmplt_ps(x, minInput));
+
+        x = _mm_min_ps(maxInput, _mm_max_ps(minInput, x));
+
+        const __m128i n(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f))));
+        const __m128 fn(_mm_cvtepi32_ps(n));
+        __m128 r(_mm_sub_ps(x, _mm_mul_ps(fn, _mm_set1_ps(0.693359375f))));
+        r = _mm_sub_ps(r, _mm_mul_ps(fn, _mm_set1_ps(-2.12194440e-4f)));
+
+        __m128 p(_mm_set1_ps(1.9875691500E-4f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.3981999507E-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(8.3334519073E-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(4.1665795894E-2f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.6666665459E-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(5.0000001201E-1f));
+        __m128 y(_mm_mul_ps(p, _mm_mul_ps(r, r)));
+        y = _mm_add_ps(_mm_add_ps(y, r), _mm_set1_ps(1.f));
+
+        const __m128i n1(_mm_srai_epi32(n, 1));
+        y = _mm_mul_ps(y, pow2ps(n1));
+        y = _mm_mul_ps(y, pow2ps(_mm_sub_epi32(n, n1)));
+
+        const __m128 inf(_mm_set1_ps(std::numeric_limits<float>::infinity()));
+        y = _mm_andnot_ps(_mm_or_ps(isTooLarge, isTooSmall), y);
+        return _mm_or_ps(y, _mm_and_ps(isTooLarge, inf));
+    }
+
+    static
+    __m128d
+    log(const __m128d x)
+    {
+        // scale subnormal input into the normal range:
+        const __m128d isSubnormal(_mm_cmplt_pd(x, _mm_set1_pd(std::numeric_limits<double>::min())));
+        const __m128d scaledX(_mm_mul_pd(x, _mm_or_pd(_mm_and_pd(isSubnormal, _mm_set1_pd(18014398509481984.)),
+                                                      _mm_andnot_pd(isSubnormal, _mm_set1_pd(1.)))));
+
+        // x = m*2^e, with m on [0.5,1):
+        const __m128i bits(_mm_castpd_si128(scaledX));
+        const __m128i expBits(_mm_shuffle_epi32(_mm_srli_epi64(bits, 52), _MM_SHUFFLE(3,3,2,0)));
+        __m128d e(_mm_sub_pd(_mm_cvtepi32_pd(expBits), _mm_set1_pd(1022.)));
+        e = _mm_sub_pd(e, _mm_and_pd(isSubnormal, _mm_set1_pd(54.)));
+        const __m128d m(_mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+                                                      _mm_set1_epi64x(0x3FE0000000000000LL))));
+
+        // shift m to [sqrt(0.5),sqrt(2)) and compute log(1+z) for z=m-1:
+        const __m128d isLow(_mm_cmplt_pd(m, _mm_set1_pd(0.70710678118654752440)));
+        e = _mm_sub_pd(e, _mm_and_pd(isLow, _mm_set1_pd(1.)));
+        const __m128d z(_mm_add_pd(_mm_sub_pd(m, _mm_set1_pd(1.)), _mm_and_pd(isLow, m)));
+
+        // log(1+z) = z - z^2/2 + z^3 P(z)/Q(z)
+        const __m128d zz(_mm_mul_pd(z, z));
+        __m128d p(_mm_set1_pd(1.01875663804580931796E-4));
+        p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(4.97494994976747001425E-1));
+        p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(4.70579119878881725854E0));
+        p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(1.44989225341610930846E1));
+        p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(1.79368678507819816313E1));
+        p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(7.70838733755885391666E0));
+        __m128d q(_mm_add_pd(z, _mm_set1_pd(1.12873587189167450590E1)));
+        q = _mm_add_pd(_mm_mul_pd(q, z), _mm_set1_pd(4.52279145837532221105E1));
+        q = _mm_add_pd(_mm_mul_pd(q, z), _mm_set1_pd(8.29875266912776603211E1));
+        q = _mm_add_pd(_mm_mul_pd(q, z), _mm_set1_pd(7.11544750618563894466E1));
+        q = _mm_add_pd(_mm_mul_pd(q, z), _mm_set1_pd(2.31251620126765340583E1));
+        __m128d y(_mm_mul_pd(z, _mm_div_pd(_mm_mul_pd(zz, p), q)));
+        y = _mm_sub_pd(y, _mm_mul_pd(e, _mm_set1_pd(2.121944400546905827679E-4)));
+        y = _mm_sub_pd(y, _mm_mul_pd(zz, _mm_set1_pd(0.5)));
+        y = _mm_add_pd(_mm_add_pd(z, y), _mm_mul_pd(e, _mm_set1_pd(0.693359375)));
+
+        return handleLogSpecialValues(x, y);
+    }
+
+    static
+    __m128
+    log(const __m128 x)
+    {
+        const __m128 isSubnormal(_mm_cmplt_ps(x, _mm_set1_ps(std::numeric_limits<float>::min())));
+        const __m128 scaledX(_mm_mul_ps(x, _mm_or_ps(_mm_and_ps(isSubnormal, _mm_set1_ps(33554432.f)),
+                                                     _mm_andnot_ps(isSubnormal, _mm_set1_ps(1.f)))));
+
+        const __m128i bits(_mm_castps_si128(scaledX));
+        __m128 e(_mm_sub_ps(_mm_cvtepi32_ps(_mm_srli_epi32(bits, 23)), _mm_set1_ps(126.f)));
+        e = _mm_sub_ps(e, _mm_and_ps(isSubnormal, _mm_set1_ps(25.f)));
+        const __m128 m(_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)),
+                                                     _mm_set1_epi32(0x3F000000))));
+
+        const __m128 isLow(_mm_cmplt_ps(m, _mm_set1_ps(0.707106781186547524f)));
+        e = _mm_sub_ps(e, _mm_and_ps(isLow, _mm_set1_ps(1.f)));
+        const __m128 z(_mm_add_ps(_mm_sub_ps(m, _mm_set1_ps(1.f)), _mm_and_ps(isLow, m)));
+
+        const __m128 zz(_mm_mul_ps(z, z));
+        __m128 p(_mm_set1_ps(7.0376836292E-2f));
+        p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(-1.1514610310E-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.1676998740E-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(-1.2420140846E-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.4249322787E-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(-1.6668057665E-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(2.0000714765E-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(-2.4999993993E-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(3.3333331174E-1f));
+        __m128 y(_mm_mul_ps(_mm_mul_ps(p, z), zz));
+        y = _mm_sub_ps(y, _mm_mul_ps(e, _mm_set1_ps(2.12194440e-4f)));
+        y = _mm_sub_ps(y, _mm_mul_ps(zz, _mm_set1_ps(0.5f)));
+        y = _mm_add_ps(_mm_add_ps(z, y), _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+
+        return handleLogSpecialValues(x, y);
+    }
+
+private:
+    /// \return 2^n for each of the two low lanes of \p n, for n on [-1022,1023]
+    static
+    __m128d
+    pow2pd(const __m128i n)
+    {
+        const __m128i biased(_mm_add_epi32(n, _mm_set1_epi32(1023)));
+        return _mm_castsi128_pd(_mm_slli_epi64(_mm_unpacklo_epi32(biased, _mm_setzero_si128()), 52));
+    }
+
+    /// \return 2^n for each lane of \p n, for n on [-126,127]
+    static
+    __m128
+    pow2ps(const __m128i n)
+    {
+        return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    }
+
+    /// replace log kernel results for input values outside of the positive normal and subnormal range
+    static
+    __m128d
+    handleLogSpecialValues(
+        const __m128d x,
+        __m128d y)
+    {
+        const __m128d zero(_mm_setzero_pd());
+        const __m128d inf(_mm_set1_pd(std::numeric_limits<double>::infinity()));
+        const __m128d isZero(_mm_cmpeq_pd(x, zero));
+        const __m128d isInvalid(_mm_or_pd(_mm_cmplt_pd(x, zero), _mm_cmpunord_pd(x, x)));
+        const __m128d isInf(_mm_cmpeq_pd(x, inf));
+
+        y = _mm_andnot_pd(_mm_or_pd(_mm_or_pd(isZero, isInvalid), isInf), y);
+        y = _mm_or_pd(y, _mm_and_pd(isZero, _mm_set1_pd(-std::numeric_limits<double>::infinity())));
+        y = _mm_or_pd(y, _mm_and_pd(isInvalid, _mm_set1_pd(std::numeric_limits<double>::quiet_NaN())));
+        return _mm_or_pd(y, _mm_and_pd(isInf, inf));
+    }
+
+    static
+    __m128
+    handleLogSpecialValues(
+        const __m128 x,
+        __m128 y)
+    {
+        const __m128 zero(_mm_setzero_ps());
+        const __m128 inf(_mm_set1_ps(std::numeric_limits<float>::infinity()));
+        const __m128 isZero(_mm_cmpeq_ps(x, zero));
+        const __m128 isInvalid(_mm_or_ps(_mm_cmplt_ps(x, zero), _mm_cmpunord_ps(x, x)));
+        const __m128 isInf(_mm_cmpeq_ps(x, inf));
+
+        y = _mm_andnot_ps(_mm_or_ps(_mm_or_ps(isZero, isInvalid), isInf), y);
+        y = _mm_or_ps(y, _mm_and_ps(isZero, _mm_set1_ps(-std::numeric_limits<float>::infinity())));
+        y = _mm_or_ps(y, _mm_and_ps(isInvalid, _mm_set1_ps(std::numeric_limits<float>::quiet_NaN())));
+        return _mm_or_ps(y, _mm_and_ps(isInf, inf));
+    }
+};
+
+
+
+/// register load/store operations for each floating point type
+template <typename FloatType>
+struct VectorMathRegister;
+
+template <>
+struct VectorMathRegister<double>
+{
+    typedef __m128d reg_t;
+    static const unsigned laneCount = 2;
+
+    static reg_t load(const double* p)
+    {
+        return _mm_loadu_pd(p);
+    }
+    static void store(double* p, const reg_t v)
+    {
+        _mm_storeu_pd(p, v);
+    }
+    static reg_t sub(const reg_t a, const double b)
+    {
+        return _mm_sub_pd(a, _mm_set1_pd(b));
+    }
+};
+
+template <>
+struct VectorMathRegister<float>
+{
+    typedef __m128 reg_t;
+    static const unsigned laneCount = 4;
+
+    static reg_t load(const float* p)
+    {
+        return _mm_loadu_ps(p);
+    }
+    static void store(float* p, const reg_t v)
+    {
+        _mm_storeu_ps(p, v);
+    }
+    static reg_t sub(const reg_t a, const float b)
+    {
+        return _mm_sub_ps(a, _mm_set1_ps(b));
+    }
+};
+#endif
+
+
+
+/// Replace each value x in [data,data+size) with exp(x-offset)
+///
+/// Each result depends only on its input value, independent of its position in the array.
+///
+template <typename FloatType>
+void
+vectorExp(
+    FloatType* data,
+    const unsigned size,
+    const FloatType offset = 0)
+{
+    static_assert(std::is_floating_point<FloatType>::value, "Requires floating point type.");
+
+#ifdef __SSE2__
+    typedef VectorMathRegister<FloatType> vreg;
+    static const unsigned laneCount(vreg::laneCount);
+
+    unsigned index(0);
+    for (; (index+laneCount)<=size; index += laneCount)
+    {
+        vreg::store(data+index, VectorMathKernel::exp(vreg::sub(vreg::load(data+index), offset)));
+    }
+
+    // the remaining values are padded to a full register, so that they are computed by the same kernel:
+    if (index<size)
+    {
+        FloatType buffer[laneCount] = {};
+        std::copy(data+index, data+size, buffer);
+        vreg::store(buffer, VectorMathKernel::exp(vreg::sub(vreg::load(buffer), offset)));
+        std::copy(buffer, buffer+(size-index), data+index);
+    }
+#else
+    for (unsigned index(0); index<size; ++index)
+    {
+        data[index] = std::exp(data[index]-offset);
+    }
+#endif
+}
+
+
+
+/// Replace each value x in [data,data+size) with log(x)
+///
+template <typename FloatType>
+void
+vectorLog(
+    FloatType* data,
+    const unsigned size)
+{
+    static_assert(std::is_floating_point<FloatType>::value, "Requires floating point type.");
+
+#ifdef __SSE2__
+    typedef VectorMathRegister<FloatType> vreg;
+    static const unsigned laneCount(vreg::laneCount);
+
+    unsigned index(0);
+    for (; (index+laneCount)<=size; index += laneCount)
+    {
+        vreg::store(data+index, VectorMathKernel::log(vreg::load(data+index)));
+    }
+
+    if (index<size)
+    {
+        // pad with 1 so that unused lanes are well defined:
+        FloatType buffer[laneCount];
+        std::fill(buffer, buffer+laneCount, static_cast<FloatType>(1));
+        std::copy(data+index, data+size, buffer);
+        vreg::store(buffer, VectorMathKernel::log(vreg::load(buffer)));
+        std::copy(buffer, buffer+(size-index), data+index);
+    }
+#else
+    for (unsigned index(0); index<size; ++index)
+    {
+        data[index] = std::log(data[index]);
+    }
+#endif
+}
+
+
+
+/// Replace each value x in [begin,end) with exp(x-offset), for any forward iterator over floating point values
+///
+template <typename IterType>
+void
+vectorExpRange(
+    IterType begin,
+    const IterType end,
+    const typename std::iterator_traits<IterType>::value_type offset)
+{
+    typedef typename std::iterator_traits<IterType>::value_type value_type;
+
+    // values are transformed in blocks through a local buffer:
+    static const unsigned bufferSize(32);
+    value_type buffer[bufferSize];
+
+    while (begin != end)
+    {
+        IterType blockBegin(begin);
+        unsigned size(0);
+        for (; (begin != end) && (size<bufferSize); ++begin, ++size)
+        {
+            buffer[size] = *begin;
+        }
+        vectorExp(buffer, size, offset);
+        std::copy(buffer, buffer+size, blockBegin);
+    }
+}
@@ -0,0 +1,154 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+
+#include "WorkStealingTaskQueue.hh"
+
+#include <cassert>
+
+#include <exception>
+#include <thread>
+
+
+
+WorkStealingTaskQueue::
+WorkStealingTaskQueue(
+    const unsigned taskCount,
+    const unsigned workerCount)
+    : _taskCount(taskCount),
+      _isCancelled(false)
+{
+    assert(workerCount > 0);
+
+    for (unsigned workerIndex(0); workerIndex < workerCount; ++workerIndex)
+    {
+        std::unique_ptr<TaskBlock> block(new TaskBlock);
+        block->next = workerIndex;
+        _blocks.push_back(std::move(block));
+    }
+}
+
+
+
+bool
+WorkStealingTaskQueue::
+getNextTask(
+    const unsigned workerIndex,
+    unsigned& taskIndex)
+{
+    assert(workerIndex < getWorkerCount());
+
+    if (_isCancelled) return false;
+
+    {
+        TaskBlock& block(*_blocks[workerIndex]);
+        std::lock_guard<std::mutex> guard(block.lock);
+        if (block.next < _taskCount)
+        {
+            taskIndex = block.next;
+            block.next += getWorkerCount();
+            return true;
+        }
+    }
+
+    return stealTask(workerIndex, taskIndex);
+}
+
+
+
+bool
+WorkStealingTaskQueue::
+stealTask(
+    const unsigned workerIndex,
+    unsigned& taskIndex)
+{
+    const unsigned workerCount(getWorkerCount());
+
+    while (not _isCancelled)
+    {
+        // find the victim with the lowest pending task index -- this can change before the victim is locked,
+        // so this is only used as a heuristic:
+        unsigned victimIndex(workerCount);
+        unsigned victimNext(_taskCount);
+        for (unsigned otherIndex(0); otherIndex < workerCount; ++otherIndex)
+        {
+            if (otherIndex == workerIndex) continue;
+            TaskBlock& block(*_blocks[otherIndex]);
+            std::lock_guard<std::mutex> guard(block.lock);
+            if (block.next < victimNext)
+            {
+                victimIndex = otherIndex;
+                victimNext = block.next;
+            }
+        }
+
+        if (victimIndex == workerCount) return false;
+
+        TaskBlock& victim(*_blocks[victimIndex]);
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (victim.next < _taskCount)
+        {
+            taskIndex = victim.next;
+            victim.next += workerCount;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+void
+runWorkStealingWorkers(
+    WorkStealingTaskQueue& taskQueue,
+    const std::function<void(const unsigned workerIndex)>& workerFunc)
+{
+    const unsigned workerCount(taskQueue.getWorkerCount());
+
+    std::mutex exceptionLock;
+    std::exception_ptr firstException;
+
+    auto workerWrapper = [&](const unsigned workerIndex)
+    {
+        try
+        {
+            workerFunc(workerIndex);
+        }
+        catch (...)
+        {
+            taskQueue.cancel();
+            std::lock_guard<std::mutex> guard(exceptionLock);
+            if (not firstException) firstException = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned workerIndex(0); workerIndex < workerCount; ++workerIndex)
+    {
+        workers.emplace_back(workerWrapper, workerIndex);
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    if (firstException) std::rethrow_exception(firstException);
+}
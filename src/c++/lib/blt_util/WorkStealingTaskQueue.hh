@@ -0,0 +1,104 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Simple work-stealing scheduler for a fixed list of tasks
+///
+
+#pragma once
+
+#include "boost/utility.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+/// \brief Distributes a fixed set of task indices [0,taskCount) over a set of workers
+///
+/// Task indices are initially dealt out round-robin, so that worker w owns tasks {w, w+N, w+2N, ...}
+/// for N workers, and each worker handles its own tasks in ascending order. A worker which has exhausted
+/// its own tasks steals the lowest pending task index remaining among all other workers.
+///
+/// Together these rules keep the set of tasks in progress close to the lowest incomplete task index,
+/// which bounds the amount of output a consumer must buffer to write task results in task order.
+///
+/// All methods are thread-safe.
+///
+struct WorkStealingTaskQueue : private boost::noncopyable
+{
+    WorkStealingTaskQueue(
+        const unsigned taskCount,
+        const unsigned workerCount);
+
+    unsigned
+    getWorkerCount() const
+    {
+        return _blocks.size();
+    }
+
+    /// \brief Get the next task for the given worker
+    ///
+    /// \param[out] taskIndex index of the next task, only valid if the function returns true
+    /// \return False when no tasks remain or the queue has been cancelled
+    bool
+    getNextTask(
+        const unsigned workerIndex,
+        unsigned& taskIndex);
+
+    /// \brief Prevent any further tasks from being handed out
+    void
+    cancel()
+    {
+        _isCancelled = true;
+    }
+
+private:
+
+    /// \brief The pending task indices {next, next+stride, ...} less than taskCount owned by one worker
+    struct TaskBlock
+    {
+        std::mutex lock;
+        unsigned next = 0;
+    };
+
+    /// \return True if a task was stolen from another worker
+    bool
+    stealTask(
+        const unsigned workerIndex,
+        unsigned& taskIndex);
+
+    const unsigned _taskCount;
+    std::atomic<bool> _isCancelled;
+    std::vector<std::unique_ptr<TaskBlock>> _blocks;
+};
+
+
+/// \brief Run workerFunc(workerIndex) on one thread for each worker of the task queue
+///
+/// Each worker function is expected to pull tasks from the queue until it is exhausted. If any worker throws,
+/// the queue is cancelled so that the remaining workers stop after their current task, and the first exception
+/// is rethrown on the calling thread after all workers have joined.
+///
+void
+runWorkStealingWorkers(
+    WorkStealingTaskQueue& taskQueue,
+    const std::function<void(const unsigned workerIndex)>& workerFunc);
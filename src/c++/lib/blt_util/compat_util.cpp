@@ -19,7 +19,6 @@
 
 #include "compat_util.hh"
 
-#include <cerrno>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
@@ -36,13 +35,9 @@
 bool
 compat_realpath(std::string& path)
 {
-    errno=0;
+    // errno is only meaningful when realpath fails, it may be left set after a successful call:
     const char* newpath(realpath(path.c_str(),nullptr));
-    if ((nullptr==newpath) || (errno!=0))
-    {
-        if (nullptr!=newpath) free((void*)newpath);
-        return false;
-    }
+    if (nullptr==newpath) return false;
     path = newpath;
     free((void*)newpath);
     return true;
@@ -24,6 +24,7 @@
 #pragma once
 
 #include "blt_util/math_util.hh"
+#include "blt_util/VectorMathUtil.hh"
 
 #include "boost/concept_check.hpp"
 
@@ -96,11 +97,26 @@ getLogSumSequence(
         if (*iter > *largest) largest = iter;
     }
 
+    // exp terms are computed in blocks with the vector kernel, and summed in sequence order:
+    static const unsigned bufferSize(32);
+    value_type buffer[bufferSize];
+
     value_type smallSum(0);
-    for (; beginIter != endIter; ++beginIter)
+    while (beginIter != endIter)
     {
-        if (beginIter == largest) continue;
-        smallSum += std::exp(*beginIter - *largest);
+        IterType blockBegin(beginIter);
+        unsigned size(0);
+        for (; (beginIter != endIter) && (size<bufferSize); ++beginIter, ++size)
+        {
+            buffer[size] = *beginIter;
+        }
+        vectorExp(buffer, size, *largest);
+
+        for (unsigned bufferIndex(0); bufferIndex<size; ++bufferIndex, ++blockBegin)
+        {
+            if (blockBegin == largest) continue;
+            smallSum += buffer[bufferIndex];
+        }
     }
 
     return *largest + log1p_switch(smallSum);
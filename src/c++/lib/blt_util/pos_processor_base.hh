@@ -43,6 +43,16 @@ struct pos_processor_base
         process_pos(stage_no,pos);
     }
 
+    /// \return true if process_pos() is currently skipped at all stages and positions
+    ///
+    /// The skip state can only be cleared by adding new data to the processor, so the stage manager may advance
+    /// over any number of positions without calling check_process_pos() while this is true.
+    bool
+    isSkipProcessPos() const
+    {
+        return _is_skip_process_pos;
+    }
+
     /// Execute position dependent logic associated with a particular stage
     /// in a positional processing pipeline.
     ///
@@ -23,10 +23,13 @@
 
 #pragma once
 
+#include "blt_util/VectorMathUtil.hh"
+
 #include <cassert>
 #include <cmath>
 
 #include <iterator>
+#include <limits>
 #include <type_traits>
 
 
@@ -221,10 +224,11 @@ normalizeLogDistro(
         }
     }
 
+    vectorExpRange(pbegin, pend, max);  // To alleviate underflow problem
+
     FloatType sum(0.);
     for (It p(pbegin); p!=pend; ++p)
     {
-        *p = std::exp(*p-max);  // To alleviate underflow problem
         sum += *p;
     }
 
@@ -284,27 +288,28 @@ opt_normalize_ln_distro(
     static const FloatType norm_thresh(20);
     static const FloatType opt_thresh(5);
 
-    FloatType sum(0.);
+    // skipped values are set to -inf, so that they become zero in the exp transform below:
+    static const FloatType neginf(-std::numeric_limits<FloatType>::infinity());
+
     pred=(pred_begin);
     for (It p(pbegin); p!=pend; ++p,++pred)
     {
-        FloatType mdiff(max-*p);
+        const FloatType mdiff(max-*p);
         const bool is_mdiff_skip(mdiff>norm_thresh);
-        if (is_mdiff_skip)
+        if (! is_mdiff_skip) continue;
+
+        const FloatType optdiff(opt_max-*p);
+        if ((! *pred) || (optdiff>opt_thresh))
         {
-            if (! *pred)
-            {
-                *p=0;
-                continue;
-            }
-            FloatType optdiff(opt_max-*p);
-            if (optdiff>opt_thresh)
-            {
-                *p=0;
-                continue;
-            }
+            *p=neginf;
         }
-        *p = std::exp(-mdiff);
+    }
+
+    vectorExpRange(pbegin, pend, max);
+
+    FloatType sum(0.);
+    for (It p(pbegin); p!=pend; ++p)
+    {
         sum += *p;
     }
 
@@ -168,22 +168,25 @@ reset()
         if (_report_range.is_end_pos)
         {
             pos_t final_pos(_report_range.end_pos);
-            for (pos_t i(_max_pos+1); i<final_pos; ++i)
+            if (final_pos > (_max_pos+1))
             {
-                process_pos(i);
+                process_pos(final_pos-1);
             }
         }
     }
     else if (_report_range.is_begin_pos && _report_range.is_end_pos)
     {
-        // never read any data in this case, so we just write out
-        // the approriate range of zeros for consistency:
+        // never read any data in this case, so run every stage over the full report range for consistency. Starting
+        // the head at the beginning of the range means that the stages advance through each position in order, and may
+        // still fast-forward through positions the processor skips:
         //
         _min_pos=_report_range.begin_pos;
         const pos_t end(_report_range.end_pos);
-        for (pos_t i(_report_range.begin_pos); i<end; ++i)
+        if (end > _report_range.begin_pos)
         {
-            process_pos(i);
+            _head_pos=_report_range.begin_pos;
+            _is_head_pos=true;
+            process_pos(end-1);
         }
     }
     finish_process_pos();
@@ -309,6 +312,9 @@ process_pos(const pos_t pos)
     {
         for (pos_t p(_head_pos); p<=pos; ++p)
         {
+            // fast-forward over positions with no data to process in any stage, such as uncovered stretches:
+            if (_ppb.isSkipProcessPos()) break;
+
             for (unsigned s(0); s<_stage_size; ++s)
             {
                 const pos_t stage_pos(p-static_cast<pos_t>(_stage_pos_ptr->operator[](s).first));
@@ -142,5 +142,49 @@ BOOST_AUTO_TEST_CASE( test_rangeMap_dataSizeBoundary )
     BOOST_REQUIRE_EQUAL(rm.getConstRef(8), 1);
 }
 
+BOOST_AUTO_TEST_CASE( test_rangeMap_getNextPresentKey )
+{
+    RangeMap<int,int> rm(8);
+
+    int nextKey(-1);
+    BOOST_REQUIRE(! rm.getNextPresentKey(0, nextKey));
+
+    // force the occupied range to wrap around the end of the storage vector:
+    rm.getRef(10) = 1;
+    rm.getRef(6) = 2;
+    rm.getRef(12) = 3;
+
+    BOOST_REQUIRE(rm.getNextPresentKey(0, nextKey));
+    BOOST_REQUIRE_EQUAL(nextKey, 6);
+    BOOST_REQUIRE(rm.getNextPresentKey(7, nextKey));
+    BOOST_REQUIRE_EQUAL(nextKey, 10);
+    BOOST_REQUIRE(rm.getNextPresentKey(11, nextKey));
+    BOOST_REQUIRE_EQUAL(nextKey, 12);
+    BOOST_REQUIRE(! rm.getNextPresentKey(13, nextKey));
+    BOOST_REQUIRE_EQUAL(nextKey, 12);
+
+    rm.erase(10);
+    BOOST_REQUIRE(rm.getNextPresentKey(7, nextKey));
+    BOOST_REQUIRE_EQUAL(nextKey, 12);
+
+    // check every start key against a simple scan after the buffer grows:
+    rm.getRef(40) = 4;
+    for (int startKey(0); startKey<50; ++startKey)
+    {
+        int expectKey(-1);
+        for (int key(startKey); key<50; ++key)
+        {
+            if (rm.isKeyPresent(key))
+            {
+                expectKey = key;
+                break;
+            }
+        }
+        const bool isFound(rm.getNextPresentKey(startKey, nextKey));
+        BOOST_REQUIRE_EQUAL(isFound, (expectKey >= 0));
+        if (isFound) BOOST_REQUIRE_EQUAL(nextKey, expectKey);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
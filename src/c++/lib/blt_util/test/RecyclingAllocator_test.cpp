@@ -0,0 +1,115 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/RecyclingAllocator.hh"
+
+#include <memory>
+#include <thread>
+
+
+BOOST_AUTO_TEST_SUITE( test_RecyclingAllocator )
+
+
+namespace
+{
+
+struct PooledBase
+{
+    virtual ~PooledBase() {}
+
+    static
+    void*
+    operator new(std::size_t size)
+    {
+        return RecyclingAllocator::allocate(size);
+    }
+
+    static
+    void
+    operator delete(void* ptr, std::size_t size)
+    {
+        RecyclingAllocator::deallocate(ptr, size);
+    }
+
+    int val = 0;
+};
+
+
+struct PooledDerived : public PooledBase
+{
+    double data[16];
+};
+
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_RecyclingAllocator_reuse )
+{
+    const RecyclingAllocatorStats startStats(RecyclingAllocator::getThreadStats());
+
+    void* block1(RecyclingAllocator::allocate(48));
+    RecyclingAllocator::deallocate(block1, 48);
+    void* block2(RecyclingAllocator::allocate(48));
+    BOOST_REQUIRE_EQUAL(block1, block2);
+
+    // a different size must not reuse the free block:
+    RecyclingAllocator::deallocate(block2, 48);
+    void* block3(RecyclingAllocator::allocate(64));
+    BOOST_REQUIRE(block3 != block2);
+    RecyclingAllocator::deallocate(block3, 64);
+
+    const RecyclingAllocatorStats stats(RecyclingAllocator::getThreadStats());
+    BOOST_REQUIRE_EQUAL(stats.recycledAllocations - startStats.recycledAllocations, 1u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_RecyclingAllocator_polymorphic )
+{
+    // deleting through the base pointer must return the block to the free list of the derived size:
+    PooledBase* derivedPtr(new PooledDerived);
+    delete derivedPtr;
+
+    std::unique_ptr<PooledDerived> derived2Ptr(new PooledDerived);
+    BOOST_REQUIRE_EQUAL(static_cast<PooledBase*>(derived2Ptr.get()), derivedPtr);
+
+    std::unique_ptr<PooledBase> basePtr(new PooledBase);
+    BOOST_REQUIRE(basePtr.get() != derivedPtr);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_RecyclingAllocator_crossThread )
+{
+    // a block allocated on one thread may be deallocated on another:
+    void* block(RecyclingAllocator::allocate(96));
+    std::thread deallocThread([block]()
+    {
+        RecyclingAllocator::deallocate(block, 96);
+        void* block2(RecyclingAllocator::allocate(96));
+        RecyclingAllocator::deallocate(block2, 96);
+    });
+    deallocThread.join();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
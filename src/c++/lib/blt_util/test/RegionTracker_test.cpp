@@ -160,6 +160,23 @@ BOOST_AUTO_TEST_CASE( test_RegionTrackerSubset )
 
 
 
+BOOST_AUTO_TEST_CASE( test_RegionTrackerNextRegionPos )
+{
+    RegionTracker rt;
+    BOOST_REQUIRE(! rt.getNextRegionPos(0));
+
+    rt.addRegion(known_pos_range2(5,10));
+    rt.addRegion(known_pos_range2(14,15));
+
+    BOOST_REQUIRE_EQUAL(*rt.getNextRegionPos(0),5);
+    BOOST_REQUIRE_EQUAL(*rt.getNextRegionPos(5),5);
+    BOOST_REQUIRE_EQUAL(*rt.getNextRegionPos(9),9);
+    BOOST_REQUIRE_EQUAL(*rt.getNextRegionPos(10),14);
+    BOOST_REQUIRE_EQUAL(*rt.getNextRegionPos(14),14);
+    BOOST_REQUIRE(! rt.getNextRegionPos(15));
+}
+
+
 BOOST_AUTO_TEST_CASE( test_RegionPayloadTracker )
 {
     // Simplest test
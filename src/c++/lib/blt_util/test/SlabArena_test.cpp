@@ -0,0 +1,113 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/SlabArena.hh"
+
+
+BOOST_AUTO_TEST_SUITE( test_SlabArena )
+
+
+BOOST_AUTO_TEST_CASE( test_SlabArena_release )
+{
+    SlabArena<int,int> arena(16);
+
+    int* block1(arena.allocate(10,1));
+    int* block2(arena.allocate(10,2));
+    BOOST_REQUIRE(block1 != block2);
+    BOOST_REQUIRE_EQUAL(arena.getStats().slabAllocations, 2u);
+    BOOST_REQUIRE_EQUAL(arena.getStats().blockAllocations, 2u);
+
+    // the second slab still holds key 2, so only the first slab is released:
+    arena.releaseTo(1);
+    arena.allocate(10,3);
+    BOOST_REQUIRE_EQUAL(arena.getStats().slabAllocations, 2u);
+
+    // oversized requests get a dedicated slab:
+    arena.allocate(100,4);
+    BOOST_REQUIRE_EQUAL(arena.getStats().slabAllocations, 3u);
+    BOOST_REQUIRE_EQUAL(arena.getStats().slabBytes, 132u*sizeof(int));
+
+    // once all slabs are released no further heap allocation is needed:
+    arena.releaseTo(4);
+    arena.allocate(100,5);
+    arena.allocate(16,6);
+    arena.allocate(16,7);
+    BOOST_REQUIRE_EQUAL(arena.getStats().slabAllocations, 3u);
+
+    arena.clear();
+    arena.allocate(16,1);
+    BOOST_REQUIRE_EQUAL(arena.getStats().slabAllocations, 3u);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_SlabArray_heap )
+{
+    SlabArray<int,int> array;
+    BOOST_REQUIRE(array.empty());
+    for (int i(0); i<100; ++i) array.push_back(i);
+    BOOST_REQUIRE_EQUAL(array.size(), 100u);
+    BOOST_REQUIRE_EQUAL(array[50], 50);
+    BOOST_REQUIRE_EQUAL(array.back(), 99);
+
+    array.clear();
+    BOOST_REQUIRE(array.empty());
+    BOOST_REQUIRE(array.begin() == array.end());
+}
+
+
+BOOST_AUTO_TEST_CASE( test_SlabArray_arena )
+{
+    SlabArena<int,int> arena(16);
+
+    SlabArray<int,int> array;
+    array.setArena(&arena, 10);
+    for (int i(0); i<40; ++i) array.push_back(i);
+    BOOST_REQUIRE_EQUAL(array.size(), 40u);
+
+    int sum(0);
+    for (const int val : array) sum += val;
+    BOOST_REQUIRE_EQUAL(sum, 780);
+
+    // block regrowth should be served from the arena:
+    BOOST_REQUIRE_EQUAL(arena.getStats().blockAllocations, 4u);
+
+    // copies own heap storage and are unaffected by arena release:
+    const SlabArray<int,int> arrayCopy(array);
+
+    // moves retain the arena storage:
+    SlabArray<int,int> arrayMove(std::move(array));
+    BOOST_REQUIRE(array.empty());
+    BOOST_REQUIRE_EQUAL(arrayMove.size(), 40u);
+    BOOST_REQUIRE_EQUAL(arrayMove[39], 39);
+
+    arrayMove.clear();
+    arena.releaseTo(10);
+    BOOST_REQUIRE_EQUAL(arrayCopy.size(), 40u);
+    BOOST_REQUIRE_EQUAL(arrayCopy[39], 39);
+
+    // a cleared array is detached from the arena:
+    const unsigned long blockCount(arena.getStats().blockAllocations);
+    arrayMove.push_back(1);
+    BOOST_REQUIRE_EQUAL(arena.getStats().blockAllocations, blockCount);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
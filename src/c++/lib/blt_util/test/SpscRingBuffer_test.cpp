@@ -0,0 +1,108 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "SpscRingBuffer.hh"
+
+#include <thread>
+
+
+BOOST_AUTO_TEST_SUITE( test_SpscRingBuffer )
+
+
+BOOST_AUTO_TEST_CASE( test_SpscRingBufferSerial )
+{
+    SpscRingBuffer<int> ring(2);
+
+    BOOST_REQUIRE(ring.waitWriteSlot() != nullptr);
+    *ring.waitWriteSlot() = 1;
+    ring.commitWrite();
+    *ring.waitWriteSlot() = 2;
+    ring.commitWrite();
+    ring.closeWrite();
+
+    BOOST_REQUIRE_EQUAL(*ring.waitReadSlot(), 1);
+    ring.commitRead();
+    BOOST_REQUIRE_EQUAL(*ring.waitReadSlot(), 2);
+    ring.commitRead();
+    BOOST_REQUIRE(ring.waitReadSlot() == nullptr);
+
+    // the ring is usable again after reset:
+    ring.reset();
+    *ring.waitWriteSlot() = 3;
+    ring.commitWrite();
+    BOOST_REQUIRE_EQUAL(*ring.waitReadSlot(), 3);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_SpscRingBufferThreaded )
+{
+    // all values should arrive once and in order through a ring much smaller than the stream:
+    static const int valueCount(100000);
+    SpscRingBuffer<int> ring(8);
+
+    std::thread producer([&]()
+    {
+        for (int value(0); value < valueCount; ++value)
+        {
+            int* slot(ring.waitWriteSlot());
+            if (slot == nullptr) return;
+            *slot = value;
+            ring.commitWrite();
+        }
+        ring.closeWrite();
+    });
+
+    int expectValue(0);
+    while (const int* slot = ring.waitReadSlot())
+    {
+        if (*slot != expectValue) break;
+        ring.commitRead();
+        expectValue++;
+    }
+    producer.join();
+    BOOST_REQUIRE_EQUAL(expectValue, valueCount);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_SpscRingBufferCancel )
+{
+    // cancel should release a producer blocked on a full ring:
+    SpscRingBuffer<int> ring(1);
+    bool isProducerCancelled(false);
+
+    std::thread producer([&]()
+    {
+        while (int* slot = ring.waitWriteSlot())
+        {
+            *slot = 0;
+            ring.commitWrite();
+        }
+        isProducerCancelled = true;
+    });
+
+    BOOST_REQUIRE(ring.waitReadSlot() != nullptr);
+    ring.cancel();
+    producer.join();
+    BOOST_REQUIRE(isProducerCancelled);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,172 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/VectorMathUtil.hh"
+
+#include <random>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( test_VectorMathUtil )
+
+
+/// check the maximum relative error of vectorExp or vectorLog against the standard library over uniform
+/// samples of [minVal,maxVal]
+template <typename FloatType>
+static
+void
+checkRelativeError(
+    const bool isExp,
+    const FloatType minVal,
+    const FloatType maxVal,
+    const double maxRelativeError)
+{
+    std::mt19937 randomGenerator(20);
+    std::uniform_real_distribution<FloatType> valueDistro(minVal, maxVal);
+
+    // an odd size checks the padded final register:
+    const unsigned size(100001);
+    std::vector<FloatType> input(size);
+    for (FloatType& val : input) val = valueDistro(randomGenerator);
+
+    std::vector<FloatType> output(input);
+    if (isExp)
+    {
+        vectorExp(output.data(), size);
+    }
+    else
+    {
+        vectorLog(output.data(), size);
+    }
+
+    for (unsigned index(0); index<size; ++index)
+    {
+        const FloatType expect(isExp ? std::exp(input[index]) : std::log(input[index]));
+        if (expect == 0)
+        {
+            BOOST_REQUIRE_EQUAL(output[index], expect);
+            continue;
+        }
+        const double relativeError(std::abs((static_cast<double>(output[index])-expect)/expect));
+        BOOST_REQUIRE_MESSAGE(relativeError <= maxRelativeError,
+                              "input: " << input[index] << " output: " << output[index] << " expect: " << expect);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_vectorExpAccuracy )
+{
+    checkRelativeError<double>(true, -700., 700., 3.5e-16);
+    checkRelativeError<double>(true, -30., 0., 3.5e-16);
+    checkRelativeError<float>(true, -87.f, 88.f, 1.5e-7);
+    checkRelativeError<float>(true, -30.f, 0.f, 1.5e-7);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_vectorLogAccuracy )
+{
+    checkRelativeError<double>(false, 1e-300, 1e-295, 2.5e-16);
+    checkRelativeError<double>(false, 0.5, 2., 2.5e-16);
+    checkRelativeError<double>(false, 1., 1e6, 2.5e-16);
+    checkRelativeError<float>(false, 1e-37f, 1e-35f, 1.5e-7);
+    checkRelativeError<float>(false, 0.5f, 2.f, 1.5e-7);
+    checkRelativeError<float>(false, 1.f, 1e6f, 1.5e-7);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_vectorExpSpecialValues )
+{
+    static const double inf(std::numeric_limits<double>::infinity());
+    std::vector<double> val = { 0., -inf, inf, -1000., 1000., 2., 1. };
+    vectorExp(val.data(), val.size(), 1.);
+
+    BOOST_REQUIRE_CLOSE(val[0], std::exp(-1.), 1e-12);
+    BOOST_REQUIRE_EQUAL(val[1], 0.);
+    BOOST_REQUIRE_EQUAL(val[2], inf);
+    BOOST_REQUIRE_EQUAL(val[3], 0.);
+    BOOST_REQUIRE_EQUAL(val[4], inf);
+    BOOST_REQUIRE_CLOSE(val[5], std::exp(1.), 1e-12);
+    BOOST_REQUIRE_EQUAL(val[6], 1.);
+
+    std::vector<float> nanVal = { std::numeric_limits<float>::quiet_NaN() };
+    vectorExp(nanVal.data(), nanVal.size());
+    BOOST_REQUIRE(std::isnan(nanVal[0]));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_vectorLogSpecialValues )
+{
+    static const double inf(std::numeric_limits<double>::infinity());
+    const double subnormal(std::numeric_limits<double>::denorm_min()*1000.);
+    std::vector<double> val = { 0., -1., inf, 1., subnormal };
+    vectorLog(val.data(), val.size());
+
+    BOOST_REQUIRE_EQUAL(val[0], -inf);
+    BOOST_REQUIRE(std::isnan(val[1]));
+    BOOST_REQUIRE_EQUAL(val[2], inf);
+    BOOST_REQUIRE_EQUAL(val[3], 0.);
+    BOOST_REQUIRE_CLOSE(val[4], std::log(subnormal), 1e-12);
+
+    const float floatSubnormal(std::numeric_limits<float>::denorm_min()*1000.f);
+    std::vector<float> floatVal = { 0.f, floatSubnormal, std::numeric_limits<float>::quiet_NaN() };
+    vectorLog(floatVal.data(), floatVal.size());
+    BOOST_REQUIRE_EQUAL(floatVal[0], -std::numeric_limits<float>::infinity());
+    BOOST_REQUIRE_CLOSE(floatVal[1], std::log(floatSubnormal), 1e-4);
+    BOOST_REQUIRE(std::isnan(floatVal[2]));
+}
+
+
+
+// results must not depend on the position of a value in the array, so that callers get the same
+// result for the same value in any context:
+BOOST_AUTO_TEST_CASE( test_vectorExpPositionIndependence )
+{
+    static const double testVal(-3.7);
+    for (unsigned size(1); size<8; ++size)
+    {
+        for (unsigned index(0); index<size; ++index)
+        {
+            std::vector<double> val(size, -1.);
+            val[index] = testVal;
+            vectorExp(val.data(), size);
+
+            std::vector<double> single(1, testVal);
+            vectorExp(single.data(), 1);
+            BOOST_REQUIRE_EQUAL(val[index], single[0]);
+        }
+    }
+
+    std::vector<double> val(100);
+    for (unsigned index(0); index<val.size(); ++index) val[index] = -(index*0.1);
+    std::vector<double> rangeVal(val);
+    vectorExp(val.data(), val.size(), 2.);
+    vectorExpRange(rangeVal.begin(), rangeVal.end(), 2.);
+    for (unsigned index(0); index<val.size(); ++index)
+    {
+        BOOST_REQUIRE_EQUAL(rangeVal[index], val[index]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "WorkStealingTaskQueue.hh"
+
+#include <stdexcept>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( test_WorkStealingTaskQueue )
+
+
+BOOST_AUTO_TEST_CASE( test_WorkStealingTaskQueueSerial )
+{
+    // a single worker should get all tasks in order:
+    WorkStealingTaskQueue queue(5,1);
+    unsigned taskIndex(0);
+    for (unsigned expectIndex(0); expectIndex < 5; ++expectIndex)
+    {
+        BOOST_REQUIRE(queue.getNextTask(0,taskIndex));
+        BOOST_REQUIRE_EQUAL(taskIndex, expectIndex);
+    }
+    BOOST_REQUIRE(not queue.getNextTask(0,taskIndex));
+}
+
+
+BOOST_AUTO_TEST_CASE( test_WorkStealingTaskQueueRoundRobin )
+{
+    // tasks should be dealt out round-robin, so that each worker starts near the front of the task list:
+    WorkStealingTaskQueue queue(6,3);
+    unsigned taskIndex(0);
+    for (unsigned expectIndex(0); expectIndex < 6; ++expectIndex)
+    {
+        BOOST_REQUIRE(queue.getNextTask(expectIndex % 3,taskIndex));
+        BOOST_REQUIRE_EQUAL(taskIndex, expectIndex);
+    }
+    for (unsigned workerIndex(0); workerIndex < 3; ++workerIndex)
+    {
+        BOOST_REQUIRE(not queue.getNextTask(workerIndex,taskIndex));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_WorkStealingTaskQueueSteal )
+{
+    // worker 0 owns {0,2,4}, worker 1 owns {1,3,5}, so worker 0 should steal the lowest pending task of worker 1:
+    WorkStealingTaskQueue queue(6,2);
+    unsigned taskIndex(0);
+    BOOST_REQUIRE(queue.getNextTask(0,taskIndex));
+    BOOST_REQUIRE_EQUAL(taskIndex, 0u);
+    BOOST_REQUIRE(queue.getNextTask(0,taskIndex));
+    BOOST_REQUIRE_EQUAL(taskIndex, 2u);
+    BOOST_REQUIRE(queue.getNextTask(0,taskIndex));
+    BOOST_REQUIRE_EQUAL(taskIndex, 4u);
+    BOOST_REQUIRE(queue.getNextTask(0,taskIndex));
+    BOOST_REQUIRE_EQUAL(taskIndex, 1u);
+    BOOST_REQUIRE(queue.getNextTask(1,taskIndex));
+    BOOST_REQUIRE_EQUAL(taskIndex, 3u);
+    BOOST_REQUIRE(queue.getNextTask(0,taskIndex));
+    BOOST_REQUIRE_EQUAL(taskIndex, 5u);
+    BOOST_REQUIRE(not queue.getNextTask(0,taskIndex));
+    BOOST_REQUIRE(not queue.getNextTask(1,taskIndex));
+}
+
+
+BOOST_AUTO_TEST_CASE( test_WorkStealingWorkers )
+{
+    // every task should be handled exactly once:
+    static const unsigned taskCount(1000);
+    std::vector<unsigned> taskHits(taskCount,0);
+
+    WorkStealingTaskQueue queue(taskCount,4);
+    runWorkStealingWorkers(queue, [&](const unsigned workerIndex)
+    {
+        unsigned taskIndex(0);
+        while (queue.getNextTask(workerIndex, taskIndex))
+        {
+            taskHits[taskIndex]++;
+        }
+    });
+
+    for (const unsigned hits : taskHits)
+    {
+        BOOST_REQUIRE_EQUAL(hits, 1u);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_WorkStealingWorkersException )
+{
+    // worker exceptions should be rethrown on the calling thread:
+    WorkStealingTaskQueue queue(10,3);
+    auto throwingWorker = [&](const unsigned workerIndex)
+    {
+        unsigned taskIndex(0);
+        while (queue.getNextTask(workerIndex, taskIndex))
+        {
+            if (taskIndex == 5) throw std::runtime_error("test");
+        }
+    };
+    BOOST_CHECK_THROW(runWorkStealingWorkers(queue, throwingWorker), std::runtime_error);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -137,6 +137,30 @@ BOOST_AUTO_TEST_CASE( testGetLogSum4 )
 }
 
 
+
+// long sequences are transformed in blocks, check these against the scalar sum:
+BOOST_AUTO_TEST_CASE( testGetLogSumSequenceLong )
+{
+    static const double eps(1e-12);
+
+    std::vector<double> vec;
+    for (unsigned i(0); i<100; ++i)
+    {
+        vec.push_back(-0.37*((i*7)%100));
+
+        double largest(vec[0]);
+        for (const double val : vec) largest = std::max(largest, val);
+        double expect(0);
+        for (const double val : vec) expect += std::exp(val-largest);
+        expect = largest + std::log(expect);
+
+        BOOST_REQUIRE_CLOSE(getLogSumSequence(vec), expect, eps);
+
+        const std::vector<float> floatVec(vec.begin(), vec.end());
+        BOOST_REQUIRE_CLOSE(getLogSumSequence(floatVec), static_cast<float>(expect), 1e-4f);
+    }
+}
+
 #ifdef BENCHMARK_LOGOPS
 // This isn't a real unit test, if defined it runs benchmarks then marks a failed test to force print the output:
 BOOST_AUTO_TEST_CASE( benchmarkLogSums )
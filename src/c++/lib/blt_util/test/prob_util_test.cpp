@@ -21,6 +21,8 @@
 
 #include "prob_util.hh"
 
+#include <random>
+
 BOOST_AUTO_TEST_SUITE( prob_util )
 
 BOOST_AUTO_TEST_CASE( test_softmax )
@@ -146,5 +148,98 @@ BOOST_AUTO_TEST_CASE( test_prob_comp )
 #endif
 }
 
+/// scalar reference version of opt_normalize_ln_distro, from before the exp transform was vectorized
+static
+void
+scalarOptNormalizeLnDistro(
+    std::vector<double>& prob,
+    const std::vector<bool>& pred)
+{
+    double max(prob[0]);
+    double opt_max(0);
+    bool is_opt_max(false);
+    for (unsigned i(0); i<prob.size(); ++i)
+    {
+        if (prob[i] > max) max = prob[i];
+        if (((! is_opt_max) || (prob[i] > max)) && pred[i])
+        {
+            opt_max = prob[i];
+            is_opt_max = true;
+        }
+    }
+
+    double sum(0);
+    for (unsigned i(0); i<prob.size(); ++i)
+    {
+        const double mdiff(max-prob[i]);
+        if ((mdiff > 20) && ((! pred[i]) || ((opt_max-prob[i]) > 5)))
+        {
+            prob[i] = 0;
+            continue;
+        }
+        prob[i] = std::exp(-mdiff);
+        sum += prob[i];
+    }
+
+    for (double& val : prob) val /= sum;
+}
+
+
+BOOST_AUTO_TEST_CASE( test_normalize_ln_distro_regression )
+{
+    std::mt19937 randomGenerator(20);
+    std::uniform_real_distribution<double> logProbDistro(-60, 0);
+
+    static const double eps = 1e-11;
+    for (unsigned testIndex(0); testIndex<200; ++testIndex)
+    {
+        const unsigned size(1 + (testIndex % 450));
+        std::vector<double> logProb(size);
+        std::vector<bool> pred(size);
+        for (unsigned i(0); i<size; ++i)
+        {
+            logProb[i] = logProbDistro(randomGenerator);
+            if ((i%7) == 3) logProb[i] = -std::numeric_limits<double>::infinity();
+            pred[i] = ((i%3) == 0);
+        }
+        logProb[0] = 0;
+
+        std::vector<double> expect(logProb);
+        double sum(0);
+        for (const double val : expect) sum += std::exp(val);
+        for (double& val : expect) val = std::exp(val)/sum;
+
+        std::vector<double> prob(logProb);
+        unsigned maxIndex(0);
+        normalizeLogDistro(prob.begin(), prob.end(), maxIndex);
+        BOOST_REQUIRE_EQUAL(maxIndex, 0u);
+        for (unsigned i(0); i<size; ++i)
+        {
+            if (expect[i] == 0)
+            {
+                BOOST_REQUIRE_EQUAL(prob[i], 0.);
+                continue;
+            }
+            BOOST_REQUIRE_CLOSE(prob[i], expect[i], eps);
+        }
+
+        std::vector<double> optExpect(logProb);
+        scalarOptNormalizeLnDistro(optExpect, pred);
+
+        std::vector<double> optProb(logProb);
+        opt_normalize_ln_distro(optProb.begin(), optProb.end(), pred.begin(), maxIndex);
+        BOOST_REQUIRE_EQUAL(maxIndex, 0u);
+        for (unsigned i(0); i<size; ++i)
+        {
+            if (optExpect[i] == 0)
+            {
+                BOOST_REQUIRE_EQUAL(optProb[i], 0.);
+                continue;
+            }
+            BOOST_REQUIRE_CLOSE(optProb[i], optExpect[i], eps);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
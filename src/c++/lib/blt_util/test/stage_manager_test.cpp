@@ -130,11 +130,25 @@ struct test_pos_processor : public pos_processor_base
         {
             BOOST_CHECK(pos > (i->second));
         }
+        else
+        {
+            first_stage_pos[stage_no] = pos;
+        }
         stage_pos[stage_no] = pos;
+        stage_pos_count[stage_no]++;
+    }
+
+    /// set the skip state, as a processor does when it has no data left to process
+    void
+    setSkipProcessPos(const bool isSkip)
+    {
+        _is_skip_process_pos = isSkip;
     }
 
     typedef std::map<int,pos_t> spos_t;
     spos_t stage_pos;
+    spos_t first_stage_pos;
+    std::map<int,unsigned> stage_pos_count;
 };
 
 
@@ -165,9 +179,75 @@ BOOST_AUTO_TEST_CASE( test_stage_manager_reset )
 
     sman.reset();
 
+    // every stage should see every position in the report range:
+    for (int i(0); i<4; ++i)
+    {
+        BOOST_CHECK_EQUAL(tpp.first_stage_pos[i],0);
+        BOOST_CHECK_EQUAL(tpp.stage_pos[i],59);
+        BOOST_CHECK_EQUAL(tpp.stage_pos_count[i],60u);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_stage_manager_reset_after_data )
+{
+    const stage_data sd(get_test_stage_data());
+    const pos_range report_range(0,60);
+    test_pos_processor tpp;
+
+    stage_manager sman(sd,report_range,tpp);
+
+    sman.handle_new_pos_value(10);
+    sman.reset();
+
     for (int i(0); i<4; ++i)
     {
+        BOOST_CHECK_EQUAL(tpp.first_stage_pos[i],0);
         BOOST_CHECK_EQUAL(tpp.stage_pos[i],59);
+        BOOST_CHECK_EQUAL(tpp.stage_pos_count[i],60u);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_stage_manager_skip_process_pos )
+{
+    // test that the stage manager fast-forwards while the processor skips all positions, and
+    // resumes processing each stage in order once new data clears the skip state:
+    const stage_data sd(get_test_stage_data());
+    const pos_range report_range(0,200);
+    test_pos_processor tpp;
+
+    stage_manager sman(sd,report_range,tpp);
+
+    sman.handle_new_pos_value(40);
+    BOOST_CHECK_EQUAL(tpp.stage_pos[2],10);
+
+    tpp.setSkipProcessPos(true);
+    sman.handle_new_pos_value(100);
+    for (int i(0); i<4; ++i)
+    {
+        BOOST_CHECK_EQUAL(tpp.stage_pos_count[i],41u-sd.get_stage_id_shift(i));
+    }
+
+    tpp.setSkipProcessPos(false);
+    sman.handle_new_pos_value(150);
+
+    // each stage resumes after the skipped stretch:
+    BOOST_CHECK_EQUAL(tpp.stage_pos[0],150);
+    BOOST_CHECK_EQUAL(tpp.stage_pos[1],140);
+    BOOST_CHECK_EQUAL(tpp.stage_pos[2],120);
+    BOOST_CHECK_EQUAL(tpp.stage_pos[3],130);
+    for (int i(0); i<4; ++i)
+    {
+        BOOST_CHECK_EQUAL(tpp.stage_pos_count[i],41u-sd.get_stage_id_shift(i)+50u);
+    }
+
+    sman.reset();
+    for (int i(0); i<4; ++i)
+    {
+        BOOST_CHECK_EQUAL(tpp.first_stage_pos[i],0);
+        BOOST_CHECK_EQUAL(tpp.stage_pos[i],199);
+        BOOST_CHECK_EQUAL(tpp.stage_pos_count[i],41u-sd.get_stage_id_shift(i)+50u+49u+sd.get_stage_id_shift(i));
     }
 }
 
@@ -25,8 +25,16 @@
 #include "blt_util/parse_util.hh"
 #include "common/Exceptions.hh"
 
+#include <algorithm>
 #include <sstream>
 
+// the AVX2 batch kernel is compiled for any x86 build with a gcc-compatible compiler, and selected at runtime only
+// if the CPU supports it:
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RANDOM_FOREST_AVX2
+#include <immintrin.h>
+#endif
+
 
 
 namespace DTREE_NODE_TYPE
@@ -125,10 +133,10 @@ Deserialize(
     const rapidjson::Value& rfTreeArray(getNodeMember(root, modelLabel));
     if (! rfTreeArray.IsArray()) wrongValueTypeError(modelLabel, "array");
 
+    DecisionTree decisionTree;
     for (const auto& treeValue : rfTreeArray.GetArray())
     {
-        _forest.emplace_back();
-        DecisionTree& decisionTree(_forest.back());
+        decisionTree.data.clear();
 
         // loop through the three parameter categories (TREE, VOTE, DECISION) for each tree
         for (int i(0); i<SIZE; ++i)
@@ -157,82 +165,232 @@ Deserialize(
                     break;
                 case DECISION:
                     parseTreeNode(treeNode.value, decisionTreeNode.decision);
-                    if (decisionTreeNode.decision.left >= static_cast<int>(expectedFeatureCount))
-                    {
-                        std::ostringstream oss;
-                        oss << "ERROR: scoring model max feature index: " << decisionTreeNode.decision.left
-                            << " is inconsistent with expected feature count " << expectedFeatureCount;
-                        BOOST_THROW_EXCEPTION(illumina::common::GeneralException(oss.str()));
-                    }
                     break;
                 default:
                     assert(false && "Unknown node type when reading in Random Forrest model");
                 }
             }
         }
+
+        addTree(expectedFeatureCount, decisionTree);
     }
 }
 
 
 
-double
+void
 RandomForestModel::
-getDecisionTreeProb(
-    const featureInput_t& features,
-    const DecisionTree& dtree) const
+addTree(
+    const unsigned expectedFeatureCount,
+    const DecisionTree& dtree)
 {
-    unsigned nodeIndex(0);
+    const unsigned nodeCount(dtree.data.size());
+    const int32_t nodeOffset(_nodeLeftChild.size());
+
+    auto malformedTreeError = [&](const unsigned nodeIndex, const char* msg)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: random forest scoring model tree " << _treeRoot.size() << " node " << nodeIndex
+            << ": " << msg;
+        BOOST_THROW_EXCEPTION(illumina::common::GeneralException(oss.str()));
+    };
 
-    //traverse a single tree
-    while (true)
+    if (nodeCount == 0) malformedTreeError(0, "tree has no nodes");
+
+    for (unsigned nodeIndex(0); nodeIndex<nodeCount; ++nodeIndex)
     {
         const DecisionTreeNode& node(dtree.getNode(nodeIndex));
-        assert(node.tree.isInit);
-        // test condition signifies we've reached a leaf node
+        if (! node.tree.isInit) malformedTreeError(nodeIndex, "missing tree entry");
+
+        const int32_t forestNodeIndex(nodeOffset+nodeIndex);
+
+        // test condition signifies a leaf node
         if (node.tree.left == -1)
         {
-            assert(node.vote.isInit);
+            if (! node.vote.isInit) malformedTreeError(nodeIndex, "missing leaf node votes");
             const double total = node.vote.left + node.vote.right;
-            return (node.vote.left / total);
-        }
 
-        assert(node.decision.isInit);
-        if (features[node.decision.left] <= node.decision.right)
-        {
-            nodeIndex=node.tree.left;
+            // leaf nodes loop back to themselves on either branch, and use a valid feature index, so that
+            // traversal can continue safely past a leaf when several feature arrays are evaluated in lockstep:
+            _nodeFeatureIndex.push_back(0);
+            _nodeThreshold.push_back(0);
+            _nodeLeftChild.push_back(forestNodeIndex);
+            _nodeRightChild.push_back(forestNodeIndex);
+            _nodeLeafProb.push_back(node.vote.left / total);
         }
         else
         {
-            nodeIndex=node.tree.right;
+            if (! node.decision.isInit) malformedTreeError(nodeIndex, "missing decision");
+            if ((node.decision.left < 0) || (node.decision.left >= static_cast<int>(expectedFeatureCount)))
+            {
+                std::ostringstream oss;
+                oss << "ERROR: scoring model max feature index: " << node.decision.left
+                    << " is inconsistent with expected feature count " << expectedFeatureCount;
+                BOOST_THROW_EXCEPTION(illumina::common::GeneralException(oss.str()));
+            }
+
+            auto isValidChild = [&](const int childIndex)
+            {
+                return ((childIndex >= 0) && (childIndex < static_cast<int>(nodeCount)) &&
+                        (childIndex != static_cast<int>(nodeIndex)));
+            };
+            if (! (isValidChild(node.tree.left) && isValidChild(node.tree.right)))
+            {
+                malformedTreeError(nodeIndex, "invalid child node index");
+            }
+
+            _nodeFeatureIndex.push_back(node.decision.left);
+            _nodeThreshold.push_back(node.decision.right);
+            _nodeLeftChild.push_back(nodeOffset+node.tree.left);
+            _nodeRightChild.push_back(nodeOffset+node.tree.right);
+            _nodeLeafProb.push_back(0);
         }
     }
+
+    _treeRoot.push_back(nodeOffset);
 }
 
 
+
 double
 RandomForestModel::
 getProb(
     const featureInput_t& features) const
 {
-    double retval(0);
-    try
+    // get the probability for every tree and average them out.
+    double prob(0);
+    const unsigned treeCount(_treeRoot.size());
+    for (unsigned treeIndex(0); treeIndex<treeCount; ++treeIndex)
     {
-        // get the probability for every tree and average them out.
-        double prob(0);
-        for (const DecisionTree& dtree : _forest)
+        prob += getTreeProb(features, treeIndex);
+    }
+    return prob/treeCount;
+}
+
+
+
+#ifdef RANDOM_FOREST_AVX2
+/// \return True if the AVX2 batch kernel can be used on this CPU
+static
+bool
+isAvx2Supported()
+{
+    static const bool isSupported([]
+    {
+        __builtin_cpu_init();
+        return (__builtin_cpu_supports("avx2") != 0);
+    }());
+    return isSupported;
+}
+
+
+
+/// traverse all trees for four feature arrays at once
+///
+/// This must only be called if isAvx2Supported() is true.
+///
+/// \param[in] featureRows Pointers to the four feature arrays
+/// \param[out] probs Summed leaf probability over all trees for each of the four feature arrays
+///
+__attribute__((target("avx2")))
+static
+void
+getForestProbSumAvx2(
+    const double* const* featureRows,
+    const std::vector<int32_t>& treeRoot,
+    const int32_t* nodeFeatureIndex,
+    const double* nodeThreshold,
+    const int32_t* nodeLeftChild,
+    const int32_t* nodeRightChild,
+    const double* nodeLeafProb,
+    double* probs)
+{
+    // feature values are gathered by absolute address, so that each lane can read from a separate feature array:
+    const __m256i rowAddress(_mm256_setr_epi64x(
+                                 reinterpret_cast<int64_t>(featureRows[0]),
+                                 reinterpret_cast<int64_t>(featureRows[1]),
+                                 reinterpret_cast<int64_t>(featureRows[2]),
+                                 reinterpret_cast<int64_t>(featureRows[3])));
+
+    // selects the low 32 bits of each 64 bit comparison mask:
+    const __m256i maskCompress(_mm256_setr_epi32(0,2,4,6,0,0,0,0));
+
+    // double gathers use the masked form with all lanes enabled, so that the unused source operand is defined:
+    const __m256d allLanes(_mm256_castsi256_pd(_mm256_set1_epi64x(-1)));
+
+    __m256d probSum(_mm256_setzero_pd());
+    for (const int32_t root : treeRoot)
+    {
+        __m128i nodeIndex(_mm_set1_epi32(root));
+        while (true)
+        {
+            const __m128i leftChild(_mm_i32gather_epi32(nodeLeftChild, nodeIndex, 4));
+            const __m128i isLeaf(_mm_cmpeq_epi32(leftChild, nodeIndex));
+            if (_mm_movemask_epi8(isLeaf) == 0xFFFF) break;
+
+            const __m128i rightChild(_mm_i32gather_epi32(nodeRightChild, nodeIndex, 4));
+            const __m128i featureIndex(_mm_i32gather_epi32(nodeFeatureIndex, nodeIndex, 4));
+            const __m256d threshold(_mm256_mask_i32gather_pd(_mm256_setzero_pd(), nodeThreshold, nodeIndex,
+                                                             allLanes, 8));
+            const __m256i featureAddress(_mm256_add_epi64(rowAddress,
+                                                          _mm256_slli_epi64(_mm256_cvtepi32_epi64(featureIndex), 3)));
+            const __m256d feature(_mm256_i64gather_pd(nullptr, featureAddress, 1));
+
+            // ordered comparison, so that NaN features take the right branch as in the scalar traversal:
+            const __m256d isLeft(_mm256_cmp_pd(feature, threshold, _CMP_LE_OQ));
+            const __m128i isLeft32(_mm256_castsi256_si128(
+                                       _mm256_permutevar8x32_epi32(_mm256_castpd_si256(isLeft), maskCompress)));
+            nodeIndex = _mm_blendv_epi8(rightChild, leftChild, isLeft32);
+        }
+        probSum = _mm256_add_pd(probSum, _mm256_mask_i32gather_pd(_mm256_setzero_pd(), nodeLeafProb, nodeIndex,
+                                                                   allLanes, 8));
+    }
+    _mm256_storeu_pd(probs, probSum);
+}
+#endif
+
+
+
+void
+RandomForestModel::
+getProbBatch(
+    const featureInput_t* const* featureBatch,
+    const unsigned batchSize,
+    double* probs) const
+{
+    const unsigned treeCount(_treeRoot.size());
+    std::fill(probs, probs+batchSize, 0.);
+
+    unsigned batchIndex(0);
+#ifdef RANDOM_FOREST_AVX2
+    if (isAvx2Supported())
+    {
+        static const unsigned laneCount(4);
+        for (; (batchIndex+laneCount) <= batchSize; batchIndex += laneCount)
         {
-            prob += getDecisionTreeProb(features, dtree);
+            const double* featureRows[laneCount];
+            for (unsigned laneIndex(0); laneIndex<laneCount; ++laneIndex)
+            {
+                featureRows[laneIndex] = featureBatch[batchIndex+laneIndex]->data();
+            }
+            getForestProbSumAvx2(featureRows, _treeRoot, _nodeFeatureIndex.data(), _nodeThreshold.data(),
+                                 _nodeLeftChild.data(), _nodeRightChild.data(), _nodeLeafProb.data(),
+                                 probs+batchIndex);
         }
-        retval = prob/_forest.size();
     }
-    catch (...)
+#endif
+
+    // tree probabilities are summed in the same order as getProb(), so that results are identical:
+    for (unsigned treeIndex(0); treeIndex<treeCount; ++treeIndex)
+    {
+        for (unsigned remainderIndex(batchIndex); remainderIndex<batchSize; ++remainderIndex)
+        {
+            probs[remainderIndex] += getTreeProb(*featureBatch[remainderIndex], treeIndex);
+        }
+    }
+
+    for (unsigned probIndex(0); probIndex<batchSize; ++probIndex)
     {
-//        log_os << "Exception caught in random forest while scoring features:\n";
-//        for (const auto val : features)
-//        {
-//            log_os << "K:V " << val.first << " : " << val.second << "\n";
-//        }
-        throw;
+        probs[probIndex] /= treeCount;
     }
-    return retval;
 }
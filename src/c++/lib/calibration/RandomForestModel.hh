@@ -27,20 +27,43 @@
 #include "rapidjson/document.h"
 
 #include <cassert>
+#include <cstdint>
 
-#include <map>
 #include <vector>
 
+
+/// \brief Random forest variant scoring model
+///
+/// The forest is parsed from its json representation into a flat struct-of-arrays layout, where the nodes of all
+/// trees are stored together in contiguous feature index, threshold, child and leaf probability arrays. Leaf nodes
+/// are their own children, which allows several feature arrays to be traversed through the same tree in lockstep.
+///
 struct RandomForestModel : public VariantScoringModelBase
 {
     RandomForestModel() = default;
 
     double getProb(const featureInput_t& features) const override;
 
+    /// Trees are evaluated in the outer loop so that each tree's nodes stay in cache across the batch. On x86 CPUs
+    /// supporting AVX2, four feature arrays are traversed through each tree together. Results are identical to
+    /// getProb() in either case.
+    void
+    getProbBatch(
+        const featureInput_t* const* featureBatch,
+        const unsigned batchSize,
+        double* probs) const override;
+
     void Deserialize(
         const unsigned expectedFeatureCount,
         const rapidjson::Value& root);
 
+    /// \return Number of trees in the forest
+    unsigned
+    getTreeCount() const
+    {
+        return _treeRoot.size();
+    }
+
 private:
     template <typename L, typename R>
     struct TreeNode
@@ -52,6 +75,7 @@ private:
         R right;
     };
 
+    /// parse-time representation of a single tree node
     struct DecisionTreeNode
     {
         TreeNode<int,int> tree;
@@ -78,17 +102,52 @@ private:
         const rapidjson::Value& v,
         TreeNode<L, R>& val);
 
+    /// validate a parsed tree and append it to the flattened forest
+    void
+    addTree(
+        const unsigned expectedFeatureCount,
+        const DecisionTree& dtree);
+
+    /// \return Leaf probability of a single tree for one feature array
     double
-    getDecisionTreeProb(
+    getTreeProb(
         const featureInput_t& features,
-        const DecisionTree& dtree) const;
+        const unsigned treeIndex) const
+    {
+        int32_t nodeIndex(_treeRoot[treeIndex]);
+        while (_nodeLeftChild[nodeIndex] != nodeIndex)
+        {
+            if (features[_nodeFeatureIndex[nodeIndex]] <= _nodeThreshold[nodeIndex])
+            {
+                nodeIndex = _nodeLeftChild[nodeIndex];
+            }
+            else
+            {
+                nodeIndex = _nodeRightChild[nodeIndex];
+            }
+        }
+        return _nodeLeafProb[nodeIndex];
+    }
 
     void
     clear()
     {
-        _forest.clear();
+        _treeRoot.clear();
+        _nodeFeatureIndex.clear();
+        _nodeThreshold.clear();
+        _nodeLeftChild.clear();
+        _nodeRightChild.clear();
+        _nodeLeafProb.clear();
     }
 
 ////////data:
-    std::vector<DecisionTree> _forest;
+    /// forest node index of each tree's root node
+    std::vector<int32_t> _treeRoot;
+
+    /// per-node data for all trees, indexed by forest node index:
+    std::vector<int32_t> _nodeFeatureIndex;
+    std::vector<double> _nodeThreshold;
+    std::vector<int32_t> _nodeLeftChild;
+    std::vector<int32_t> _nodeRightChild;
+    std::vector<double> _nodeLeafProb;
 };
@@ -31,8 +31,33 @@ struct VariantScoringModelBase : public PolymorphicObject
 {
     typedef std::vector<double> featureInput_t;
 
+    /// Non-owning pointers to each feature array of a batch
+    typedef std::vector<const featureInput_t*> featureInputBatch_t;
+
     virtual
     double
     getProb(const featureInput_t& features) const = 0;
+
+    /// \brief Get the empirical variant probability for each feature array in a batch
+    ///
+    /// Each result is identical to calling getProb() on the corresponding feature array. Models can override this to
+    /// amortize evaluation over many variants.
+    ///
+    /// The batch is passed as a non-owning view, so that feature arrays do not need to be copied into the batch.
+    ///
+    /// \param[in] featureBatch Pointers to batchSize feature arrays
+    /// \param[out] probs Array of batchSize probabilities, set in the same order as featureBatch
+    virtual
+    void
+    getProbBatch(
+        const featureInput_t* const* featureBatch,
+        const unsigned batchSize,
+        double* probs) const
+    {
+        for (unsigned batchIndex(0); batchIndex < batchSize; ++batchIndex)
+        {
+            probs[batchIndex] = getProb(*featureBatch[batchIndex]);
+        }
+    }
 };
 
@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 
 /// \brief Client interface to variant scoring models specified by file at runtime
@@ -49,7 +50,26 @@ struct VariantScoringModelServer
     scoreVariant(
         const VariantScoringModelBase::featureInput_t& features) const
     {
-        return std::max(0.,std::min(1.,(_meta.probScale * std::pow(_model->getProb(features), _meta.probPow))));
+        return calibrateProb(_model->getProb(features));
+    }
+
+    /// \brief Score a batch of variants
+    ///
+    /// \param[in] featureBatch Pointers to batchSize feature arrays
+    /// \param[out] scores Array of batchSize probabilities that each variant call is false, in the same order as
+    ///                    featureBatch. Each score is identical to the scoreVariant() result for the corresponding
+    ///                    feature array.
+    void
+    scoreVariants(
+        const VariantScoringModelBase::featureInput_t* const* featureBatch,
+        const unsigned batchSize,
+        double* scores) const
+    {
+        _model->getProbBatch(featureBatch, batchSize, scores);
+        for (unsigned batchIndex(0); batchIndex < batchSize; ++batchIndex)
+        {
+            scores[batchIndex] = calibrateProb(scores[batchIndex]);
+        }
     }
 
     double scoreFilterThreshold() const
@@ -58,6 +78,12 @@ struct VariantScoringModelServer
     }
 
 private:
+    double
+    calibrateProb(const double prob) const
+    {
+        return std::max(0.,std::min(1.,(_meta.probScale * std::pow(prob, _meta.probPow))));
+    }
+
     VariantScoringModelMetadata _meta;
     std::unique_ptr<VariantScoringModelBase> _model;
 };
@@ -0,0 +1,255 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "testConfig.h"
+
+#include "RandomForestModel.hh"
+
+#include <cmath>
+
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( RandomForestModel_test )
+
+
+static
+void
+deserializeModel(
+    const std::string& modelJson,
+    const unsigned featureCount,
+    RandomForestModel& model)
+{
+    rapidjson::Document document;
+    document.Parse(modelJson.c_str());
+    BOOST_REQUIRE(! document.HasParseError());
+    model.Deserialize(featureCount, document);
+}
+
+
+/// a two tree forest:
+///
+/// tree 0: f0 <= 0.5 ? 0.75 : (f1 <= 2.0 ? 0.5 : 0.0)
+/// tree 1: 0.25
+///
+static const char* simpleModelJson = R"({"Model": [
+    {"tree": {"0": [1,2], "1": [-1,-1], "2": [3,4], "3": [-1,-1], "4": [-1,-1]},
+     "decisions": {"0": [0,0.5], "2": [1,2.0]},
+     "node_votes": {"1": [3,1], "3": [1,1], "4": [0,4]}},
+    {"tree": {"0": [-1,-1]},
+     "decisions": {},
+     "node_votes": {"0": [1,3]}}
+]})";
+
+
+BOOST_AUTO_TEST_CASE( test_RandomForestModel_getProb )
+{
+    RandomForestModel model;
+    deserializeModel(simpleModelJson, 2, model);
+    BOOST_REQUIRE_EQUAL(model.getTreeCount(), 2u);
+
+    BOOST_REQUIRE_EQUAL(model.getProb({0.2, 0.}), 0.5);
+    BOOST_REQUIRE_EQUAL(model.getProb({0.5, 0.}), 0.5);
+    BOOST_REQUIRE_EQUAL(model.getProb({1.0, 1.0}), 0.375);
+    BOOST_REQUIRE_EQUAL(model.getProb({1.0, 3.0}), 0.125);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_RandomForestModel_malformed )
+{
+    static const char* badChildJson = R"({"Model": [
+        {"tree": {"0": [1,5], "1": [-1,-1]},
+         "decisions": {"0": [0,0.5]},
+         "node_votes": {"1": [3,1]}}
+    ]})";
+
+    RandomForestModel model;
+    BOOST_REQUIRE_THROW(deserializeModel(badChildJson, 2, model), std::exception);
+
+    // feature index out of range:
+    BOOST_REQUIRE_THROW(deserializeModel(simpleModelJson, 1, model), std::exception);
+}
+
+
+/// append a random tree of up to the given depth to a json model stream
+static
+void
+writeRandomTree(
+    const unsigned featureCount,
+    const unsigned maxDepth,
+    std::mt19937& rng,
+    std::ostream& os)
+{
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    std::ostringstream treeOss, decisionOss, voteOss;
+
+    // build the tree breadth first, so that every child index is greater than its parent's:
+    std::vector<unsigned> nodeDepth = {0};
+    for (unsigned nodeIndex(0); nodeIndex<nodeDepth.size(); ++nodeIndex)
+    {
+        const char* sep((nodeIndex==0) ? "" : ",");
+        const bool isLeaf((nodeDepth[nodeIndex] == maxDepth) || (unitDist(rng) < 0.2));
+        if (isLeaf)
+        {
+            treeOss << sep << "\"" << nodeIndex << "\": [-1,-1]";
+            voteOss << (voteOss.tellp() == 0 ? "" : ",") << "\"" << nodeIndex << "\": ["
+                    << static_cast<int>(unitDist(rng)*100) << "," << (1+static_cast<int>(unitDist(rng)*100)) << "]";
+        }
+        else
+        {
+            const unsigned childIndex(nodeDepth.size());
+            nodeDepth.push_back(nodeDepth[nodeIndex]+1);
+            nodeDepth.push_back(nodeDepth[nodeIndex]+1);
+            treeOss << sep << "\"" << nodeIndex << "\": [" << childIndex << "," << (childIndex+1) << "]";
+            decisionOss << (decisionOss.tellp() == 0 ? "" : ",") << "\"" << nodeIndex << "\": ["
+                        << (rng() % featureCount) << "," << unitDist(rng) << "]";
+        }
+    }
+
+    os << "{\"tree\": {" << treeOss.str() << "}, \"decisions\": {" << decisionOss.str()
+       << "}, \"node_votes\": {" << voteOss.str() << "}}";
+}
+
+
+BOOST_AUTO_TEST_CASE( test_RandomForestModel_getProbBatch )
+{
+    static const unsigned featureCount(6);
+    static const unsigned treeCount(30);
+    static const unsigned batchSize(103);
+
+    std::mt19937 rng(42);
+    std::ostringstream modelOss;
+    modelOss << "{\"Model\": [";
+    for (unsigned treeIndex(0); treeIndex<treeCount; ++treeIndex)
+    {
+        if (treeIndex > 0) modelOss << ",";
+        writeRandomTree(featureCount, 8, rng, modelOss);
+    }
+    modelOss << "]}";
+
+    RandomForestModel model;
+    deserializeModel(modelOss.str(), featureCount, model);
+    BOOST_REQUIRE_EQUAL(model.getTreeCount(), treeCount);
+
+    std::uniform_real_distribution<double> unitDist(0.,1.);
+    std::vector<VariantScoringModelBase::featureInput_t> featureArrays(batchSize);
+    VariantScoringModelBase::featureInputBatch_t featureBatch;
+    for (auto& features : featureArrays)
+    {
+        for (unsigned featureIndex(0); featureIndex<featureCount; ++featureIndex)
+        {
+            features.push_back(unitDist(rng));
+        }
+        featureBatch.push_back(&features);
+    }
+    featureArrays[7][0] = std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<double> probs(batchSize);
+    model.getProbBatch(featureBatch.data(), batchSize, probs.data());
+    for (unsigned batchIndex(0); batchIndex<batchSize; ++batchIndex)
+    {
+        BOOST_REQUIRE_EQUAL(probs[batchIndex], model.getProb(featureArrays[batchIndex]));
+    }
+
+    // an empty batch must not write any output:
+    double prob(-1.);
+    model.getProbBatch(featureBatch.data(), 0, &prob);
+    BOOST_REQUIRE_EQUAL(prob, -1.);
+}
+
+
+/// Check that batch and single feature array probabilities are identical for a bundled scoring model, using
+/// feature values drawn at, just below and just above the model's own decision thresholds
+static
+void
+testBundledModelBatch(
+    const char* modelFilename,
+    const char* modelType)
+{
+    const std::string modelPath(std::string(TEST_MODEL_PATH) + "/" + modelFilename);
+    std::ifstream ifs(modelPath);
+    BOOST_REQUIRE(ifs);
+    std::stringstream modelJson;
+    modelJson << ifs.rdbuf();
+
+    rapidjson::Document document;
+    document.Parse(modelJson.str().c_str());
+    BOOST_REQUIRE(! document.HasParseError());
+    const rapidjson::Value& modelRoot(document["CalibrationModels"]["Somatic"][modelType]);
+    const unsigned featureCount(modelRoot["Features"].Size());
+
+    RandomForestModel model;
+    model.Deserialize(featureCount, modelRoot);
+    BOOST_REQUIRE(model.getTreeCount() > 0);
+
+    std::vector<std::vector<double>> featureThresholds(featureCount);
+    for (const auto& tree : modelRoot["Model"].GetArray())
+    {
+        for (const auto& decision : tree["decisions"].GetObject())
+        {
+            // leaf nodes may be listed with a negative feature index:
+            const int featureIndex(decision.value[0u].GetInt());
+            if (featureIndex < 0) continue;
+            featureThresholds[featureIndex].push_back(decision.value[1u].GetDouble());
+        }
+    }
+
+    static const unsigned batchSize(1001);
+    std::mt19937 rng(42);
+    std::vector<VariantScoringModelBase::featureInput_t> featureArrays(batchSize);
+    VariantScoringModelBase::featureInputBatch_t featureBatch;
+    for (auto& features : featureArrays)
+    {
+        for (unsigned featureIndex(0); featureIndex<featureCount; ++featureIndex)
+        {
+            const std::vector<double>& thresholds(featureThresholds[featureIndex]);
+            double feature(0);
+            if (not thresholds.empty())
+            {
+                feature = thresholds[rng() % thresholds.size()];
+                const double delta(std::abs(feature)*1e-3 + 1e-6);
+                feature += delta * (static_cast<int>(rng() % 3) - 1);
+            }
+            features.push_back(feature);
+        }
+        featureBatch.push_back(&features);
+    }
+
+    std::vector<double> probs(batchSize);
+    model.getProbBatch(featureBatch.data(), batchSize, probs.data());
+    for (unsigned batchIndex(0); batchIndex<batchSize; ++batchIndex)
+    {
+        BOOST_REQUIRE_EQUAL(probs[batchIndex], model.getProb(featureArrays[batchIndex]));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_RandomForestModel_getProbBatchBundledModels )
+{
+    testBundledModelBatch("somaticSNVScoringModels.json", "SNV");
+    testBundledModelBatch("somaticIndelScoringModels.json", "INDEL");
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,72 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Declarative filter applied to raw alignment records before they leave the bam_streamer
+///
+
+#include "htsapi/BamRecordFilter.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+
+bool
+BamRecordFilterSpec::
+isAnyFilterEnabled() const
+{
+    return std::any_of(isFilterEnabled.begin(), isFilterEnabled.end(), [](const bool isEnabled) { return isEnabled; });
+}
+
+
+
+void
+BamRecordFilterCounts::
+merge(const BamRecordFilterCounts& rhs)
+{
+    for (unsigned filterIndex(0); filterIndex < BAM_RECORD_FILTER::NONE; ++filterIndex)
+    {
+        count[filterIndex] += rhs.count[filterIndex];
+    }
+}
+
+
+
+uint64_t
+BamRecordFilterCounts::
+getTotal() const
+{
+    return std::accumulate(count.begin(), count.end(), uint64_t(0));
+}
+
+
+
+void
+BamRecordFilterCounts::
+report(std::ostream& os) const
+{
+    os << "BAM_RECORD_FILTER_COUNTS";
+    for (unsigned filterIndex(0); filterIndex < BAM_RECORD_FILTER::NONE; ++filterIndex)
+    {
+        os << " " << BAM_RECORD_FILTER::label(static_cast<BAM_RECORD_FILTER::index_t>(filterIndex))
+           << ": " << count[filterIndex];
+    }
+    os << "\n";
+}
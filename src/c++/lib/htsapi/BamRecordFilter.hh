@@ -0,0 +1,142 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Declarative filter applied to raw alignment records before they leave the bam_streamer
+///
+
+#pragma once
+
+#include "htsapi/bam_util.hh"
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+
+
+namespace BAM_RECORD_FILTER
+{
+/// Filters are listed in the order they are evaluated, a record filtered by more than one filter is only counted
+/// under the first of them.
+enum index_t
+{
+    QC_FAIL,
+    DUPLICATE,
+    UNMAPPED,
+    SECONDARY,
+    SUPPLEMENTARY,
+    LOW_MAPQ,
+    NONE
+};
+
+inline
+const char*
+label(const index_t id)
+{
+    switch (id)
+    {
+    case QC_FAIL:
+        return "QCFail";
+    case DUPLICATE:
+        return "Duplicate";
+    case UNMAPPED:
+        return "Unmapped";
+    case SECONDARY:
+        return "Secondary";
+    case SUPPLEMENTARY:
+        return "Supplementary";
+    case LOW_MAPQ:
+        return "LowMAPQ";
+    default:
+        return "None";
+    }
+}
+}
+
+
+/// \brief Specify which raw alignment records a bam_streamer should filter out before returning them
+///
+/// All filters are evaluated on the fixed-size core of the BAM record only (flags and MAPQ), so filtered records
+/// are skipped before any per-read work is done on them. The default specification filters nothing.
+struct BamRecordFilterSpec
+{
+    void
+    enableFilter(const BAM_RECORD_FILTER::index_t filterIndex)
+    {
+        isFilterEnabled[filterIndex] = true;
+    }
+
+    /// \brief Enable the low MAPQ filter, removing records with MAPQ less than \p minMapq
+    void
+    enableMinMapq(const uint8_t minMapq)
+    {
+        enableFilter(BAM_RECORD_FILTER::LOW_MAPQ);
+        minMappingQuality = minMapq;
+    }
+
+    /// \return True if any filter is enabled
+    bool
+    isAnyFilterEnabled() const;
+
+    /// \return The first enabled filter matching \p core, or BAM_RECORD_FILTER::NONE if the record is kept
+    BAM_RECORD_FILTER::index_t
+    getFilterIndex(const bam1_core_t& core) const
+    {
+        using namespace BAM_RECORD_FILTER;
+
+        const uint16_t flag(core.flag);
+        if (isFilterEnabled[QC_FAIL] && (flag & BAM_FLAG::FILTER)) return QC_FAIL;
+        if (isFilterEnabled[DUPLICATE] && (flag & BAM_FLAG::DUPLICATE)) return DUPLICATE;
+        if (isFilterEnabled[UNMAPPED] && (flag & BAM_FLAG::UNMAPPED)) return UNMAPPED;
+        if (isFilterEnabled[SECONDARY] && (flag & BAM_FLAG::SECONDARY)) return SECONDARY;
+        if (isFilterEnabled[SUPPLEMENTARY] && (flag & BAM_FLAG::SUPPLEMENTARY)) return SUPPLEMENTARY;
+        if (isFilterEnabled[LOW_MAPQ] && (core.qual < minMappingQuality)) return LOW_MAPQ;
+        return NONE;
+    }
+
+    std::array<bool, BAM_RECORD_FILTER::NONE> isFilterEnabled = {};
+    uint8_t minMappingQuality = 0;
+
+    /// If true, CRAM streams skip decoding of optional (aux) fields, which are then missing from all returned
+    /// records. This has no effect on BAM/SAM streams.
+    bool isSkipAuxFields = false;
+};
+
+
+/// \brief Number of records removed by each filter of a BamRecordFilterSpec
+struct BamRecordFilterCounts
+{
+    void
+    clear()
+    {
+        count.fill(0);
+    }
+
+    void
+    merge(const BamRecordFilterCounts& rhs);
+
+    /// \return Total number of filtered records
+    uint64_t
+    getTotal() const;
+
+    void
+    report(std::ostream& os) const;
+
+    std::array<uint64_t, BAM_RECORD_FILTER::NONE> count = {};
+};
@@ -0,0 +1,639 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+
+#include "htsapi/BgzfOutputStream.hh"
+
+#include "blt_util/log.hh"
+#include "common/Exceptions.hh"
+
+#include "blt_util/thirdparty_push.h"
+extern "C" {
+#include "htslib/bgzf.h"
+#include "htslib/tbx.h"
+}
+#include "blt_util/thirdparty_pop.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+
+
+namespace
+{
+
+/// A single BGZF block in the output queue
+struct BgzfBlock
+{
+    enum state_t
+    {
+        PENDING,
+        COMPRESSING,
+        COMPRESSED
+    };
+
+    std::vector<char> text;
+    std::vector<uint8_t> compressed;
+    state_t state = PENDING;
+};
+
+
+
+/// Builds a tabix index from text lines and the virtual file offset at the end of each line
+///
+/// This mirrors the indexing logic of htslib tbx_index(), which would otherwise require the compressed file to be
+/// read back in full.
+struct TabixIndexBuilder
+{
+    explicit
+    TabixIndexBuilder(const tbx_conf_t& conf)
+        : _conf(conf)
+    {}
+
+    ~TabixIndexBuilder()
+    {
+        if (_idx) hts_idx_destroy(_idx);
+    }
+
+    /// \param line Line text excluding the newline
+    /// \param endOffset Virtual file offset immediately after the line's newline
+    void
+    addLine(
+        const std::string& line,
+        const uint64_t endOffset)
+    {
+        if (line.empty()) return;
+
+        if (line[0] == _conf.meta_char)
+        {
+            _lastHeaderOffset = endOffset;
+            return;
+        }
+
+        if (_idx == nullptr)
+        {
+            static const int minShift(14);
+            static const int levelCount(5);
+            _idx = hts_idx_init(0, HTS_FMT_TBI, _lastHeaderOffset, minShift, levelCount);
+            if (_idx == nullptr) throwIndexError("Failed to initialize index");
+        }
+
+        std::string chrom;
+        int beginPos(0), endPos(0);
+        if (! parseInterval(line, chrom, beginPos, endPos))
+        {
+            throwIndexError("Can't parse record for indexing: '" + line + "'");
+        }
+
+        if (chrom != _lastChrom)
+        {
+            const auto iter(_chromIndex.find(chrom));
+            if (iter == _chromIndex.end())
+            {
+                _lastTid = _chromNames.size();
+                _chromIndex.insert(std::make_pair(chrom, _lastTid));
+                _chromNames.push_back(chrom);
+            }
+            else
+            {
+                _lastTid = iter->second;
+            }
+            _lastChrom = chrom;
+        }
+
+        if (hts_idx_push(_idx, _lastTid, beginPos, endPos, endOffset, 1) < 0)
+        {
+            throwIndexError("Failed to index record, output may be unsorted: '" + line + "'");
+        }
+    }
+
+    /// \param finalOffset Virtual file offset at the end of all text
+    void
+    save(
+        const std::string& filename,
+        const uint64_t finalOffset)
+    {
+        if (_idx == nullptr)
+        {
+            static const int minShift(14);
+            static const int levelCount(5);
+            _idx = hts_idx_init(0, HTS_FMT_TBI, _lastHeaderOffset, minShift, levelCount);
+            if (_idx == nullptr) throwIndexError("Failed to initialize index");
+        }
+        hts_idx_finish(_idx, finalOffset);
+
+        // the tabix meta block is the index configuration followed by the null-terminated sequence names:
+        std::vector<uint8_t> meta;
+        const int32_t conf[] = { _conf.preset, _conf.sc, _conf.bc, _conf.ec, _conf.meta_char, _conf.line_skip };
+        for (const int32_t val : conf) appendInt32(val, meta);
+        uint32_t namesLength(0);
+        for (const std::string& name : _chromNames) namesLength += (name.size()+1);
+        appendInt32(namesLength, meta);
+        for (const std::string& name : _chromNames) meta.insert(meta.end(), name.c_str(), name.c_str()+name.size()+1);
+
+        static const int isCopy(1);
+        if (hts_idx_set_meta(_idx, meta.size(), meta.data(), isCopy) != 0) throwIndexError("Failed to set index meta");
+        if (hts_idx_save(_idx, filename.c_str(), HTS_FMT_TBI) != 0)
+        {
+            throwIndexError("Failed to write tabix index for: '" + filename + "'");
+        }
+    }
+
+private:
+    /// get the zero-based, half-open interval of a record, following the conventions of htslib tbx_parse1()
+    ///
+    /// \return false if the record can't be parsed
+    bool
+    parseInterval(
+        const std::string& line,
+        std::string& chrom,
+        int& beginPos,
+        int& endPos) const
+    {
+        const bool isVcf((_conf.preset & 0xffff) == TBX_VCF);
+        const bool isUcsc(_conf.preset & TBX_UCSC);
+
+        bool isBeginFound(false);
+        unsigned columnNumber(1);
+        std::string::size_type columnStart(0);
+        while (columnStart <= line.size())
+        {
+            std::string::size_type columnEnd(line.find('\t', columnStart));
+            if (columnEnd == std::string::npos) columnEnd = line.size();
+            const char* column(line.c_str() + columnStart);
+            const unsigned columnSize(columnEnd - columnStart);
+
+            if (static_cast<int>(columnNumber) == _conf.sc)
+            {
+                chrom.assign(column, columnSize);
+            }
+            else if (static_cast<int>(columnNumber) == _conf.bc)
+            {
+                char* parseEnd(nullptr);
+                beginPos = endPos = std::strtol(column, &parseEnd, 10);
+                if (parseEnd == column) return false;
+                if (isUcsc)
+                {
+                    ++endPos;
+                }
+                else
+                {
+                    --beginPos;
+                }
+                if (beginPos < 0) beginPos = 0;
+                if (endPos < 1) endPos = 1;
+                isBeginFound = true;
+            }
+            else if (isVcf)
+            {
+                if (columnNumber == 4)
+                {
+                    if (columnSize > 0) endPos = beginPos + columnSize;
+                }
+                else if (columnNumber == 8)
+                {
+                    const std::string info(column, columnSize);
+                    std::string::size_type endKeyPos(std::string::npos);
+                    if (info.compare(0, 4, "END=") == 0)
+                    {
+                        endKeyPos = 4;
+                    }
+                    else
+                    {
+                        endKeyPos = info.find(";END=");
+                        if (endKeyPos != std::string::npos) endKeyPos += 5;
+                    }
+                    if (endKeyPos != std::string::npos) endPos = std::strtol(info.c_str() + endKeyPos, nullptr, 10);
+                }
+            }
+            else if (static_cast<int>(columnNumber) == _conf.ec)
+            {
+                char* parseEnd(nullptr);
+                endPos = std::strtol(column, &parseEnd, 10);
+                if (parseEnd == column) return false;
+            }
+
+            columnStart = columnEnd + 1;
+            columnNumber++;
+        }
+        return ((! chrom.empty()) && isBeginFound && (endPos >= 0));
+    }
+
+    static
+    void
+    appendInt32(
+        const uint32_t val,
+        std::vector<uint8_t>& meta)
+    {
+        for (unsigned byteIndex(0); byteIndex < 4; ++byteIndex)
+        {
+            meta.push_back(static_cast<uint8_t>((val >> (8*byteIndex)) & 0xff));
+        }
+    }
+
+    static
+    void
+    throwIndexError(const std::string& message)
+    {
+        BOOST_THROW_EXCEPTION(illumina::common::GeneralException(message));
+    }
+
+    const tbx_conf_t _conf;
+    hts_idx_t* _idx = nullptr;
+    uint64_t _lastHeaderOffset = 0;
+
+    std::map<std::string,int> _chromIndex;
+    std::vector<std::string> _chromNames;
+    std::string _lastChrom;
+    int _lastTid = -1;
+};
+
+}
+
+
+
+/// Stream buffer which cuts formatted text into BGZF blocks and manages the background compression/writer threads
+struct BgzfOutputStreamBuf : public std::streambuf
+{
+    BgzfOutputStreamBuf(
+        const std::string& filename,
+        const BGZF_INDEX_TYPE::index_t indexType,
+        const unsigned threadCount,
+        const int compressionLevel)
+        : _filename(filename),
+          _compressionLevel(compressionLevel),
+          _maxQueuedBlocks(4*threadCount),
+          _text(BGZF_BLOCK_SIZE)
+    {
+        assert(threadCount > 0);
+
+        _ofs.open(filename.c_str(), std::ios::binary);
+        if (! _ofs)
+        {
+            std::ostringstream oss;
+            oss << "Can't open output file: '" << filename << "'";
+            BOOST_THROW_EXCEPTION(illumina::common::GeneralException(oss.str()));
+        }
+
+        if (indexType == BGZF_INDEX_TYPE::VCF)
+        {
+            _indexPtr.reset(new TabixIndexBuilder(tbx_conf_vcf));
+        }
+        else if (indexType == BGZF_INDEX_TYPE::BED)
+        {
+            _indexPtr.reset(new TabixIndexBuilder(tbx_conf_bed));
+        }
+
+        setp(_text.data(), _text.data() + _text.size());
+
+        for (unsigned threadIndex(0); threadIndex < threadCount; ++threadIndex)
+        {
+            _compressThreads.emplace_back(&BgzfOutputStreamBuf::compressBlocks, this);
+        }
+        _writeThread = std::thread(&BgzfOutputStreamBuf::writeBlocks, this);
+    }
+
+    ~BgzfOutputStreamBuf()
+    {
+        stopThreads();
+    }
+
+    void
+    close()
+    {
+        if (_isClosed) return;
+        _isClosed = true;
+
+        submitBlock();
+        stopThreads();
+        rethrowError();
+
+        // the EOF marker is an empty BGZF block:
+        static const uint8_t eofMarker[28] = { 0x1f, 0x8b, 0x08, 0x04, 0, 0, 0, 0, 0, 0xff, 0x06, 0, 0x42, 0x43,
+                                               0x02, 0, 0x1b, 0, 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0
+                                             };
+        const uint64_t finalOffset(_blockAddress << 16);
+        _ofs.write(reinterpret_cast<const char*>(eofMarker), sizeof(eofMarker));
+        _ofs.close();
+        if (! _ofs)
+        {
+            std::ostringstream oss;
+            oss << "Failed to write compressed output file: '" << _filename << "'";
+            BOOST_THROW_EXCEPTION(illumina::common::GeneralException(oss.str()));
+        }
+
+        if (_indexPtr)
+        {
+            if (! _lineFragment.empty())
+            {
+                _indexPtr->addLine(_lineFragment, finalOffset);
+            }
+            _indexPtr->save(_filename, finalOffset);
+        }
+    }
+
+protected:
+    int_type
+    overflow(int_type c) override
+    {
+        if (! submitBlock()) return traits_type::eof();
+        if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+
+    int
+    sync() override
+    {
+        // the current block is intentionally not cut short here, so only check for background errors:
+        std::lock_guard<std::mutex> lock(_mutex);
+        return (_error ? -1 : 0);
+    }
+
+private:
+    /// move all buffered text into a new block on the compression queue
+    ///
+    /// \return false if the text could not be queued because of an error on a background thread
+    bool
+    submitBlock()
+    {
+        const unsigned textSize(pptr() - pbase());
+        if (textSize == 0) return true;
+
+        std::unique_ptr<BgzfBlock> blockPtr(new BgzfBlock);
+        blockPtr->text.assign(pbase(), pptr());
+        setp(_text.data(), _text.data() + _text.size());
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _producerCondition.wait(lock, [this]()
+            {
+                return (_error || (_blocks.size() < _maxQueuedBlocks));
+            });
+            if (_error) return false;
+            _blocks.push_back(std::move(blockPtr));
+        }
+        _compressCondition.notify_one();
+        return true;
+    }
+
+    /// compression thread loop
+    void
+    compressBlocks()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            BgzfBlock* blockPtr(nullptr);
+            _compressCondition.wait(lock, [&]()
+            {
+                if (_error || _isStopping) return true;
+                blockPtr = getPendingBlock();
+                return (blockPtr != nullptr);
+            });
+            if (blockPtr == nullptr)
+            {
+                blockPtr = getPendingBlock();
+                if ((blockPtr == nullptr) || _error) return;
+            }
+
+            blockPtr->state = BgzfBlock::COMPRESSING;
+            lock.unlock();
+
+            bool isCompressed(false);
+            blockPtr->compressed.resize(BGZF_MAX_BLOCK_SIZE);
+            size_t compressedSize(blockPtr->compressed.size());
+            isCompressed = (bgzf_compress(blockPtr->compressed.data(), &compressedSize, blockPtr->text.data(),
+                                          blockPtr->text.size(), _compressionLevel) == 0);
+            blockPtr->compressed.resize(compressedSize);
+
+            lock.lock();
+            if (! isCompressed)
+            {
+                setError(std::make_exception_ptr(illumina::common::GeneralException(
+                                                     "Failed to compress BGZF block for: '" + _filename + "'")));
+                return;
+            }
+            blockPtr->state = BgzfBlock::COMPRESSED;
+            _writeCondition.notify_one();
+        }
+    }
+
+    /// writer thread loop, writes compressed blocks to the file in order and updates the index
+    void
+    writeBlocks()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _writeCondition.wait(lock, [this]()
+            {
+                return (_error || (_isStopping && _blocks.empty()) ||
+                        ((! _blocks.empty()) && (_blocks.front()->state == BgzfBlock::COMPRESSED)));
+            });
+            if (_error || _blocks.empty()) return;
+
+            std::unique_ptr<BgzfBlock> blockPtr(std::move(_blocks.front()));
+            _blocks.pop_front();
+            lock.unlock();
+            _producerCondition.notify_one();
+
+            try
+            {
+                writeBlock(*blockPtr);
+            }
+            catch (...)
+            {
+                lock.lock();
+                setError(std::current_exception());
+                return;
+            }
+
+            lock.lock();
+        }
+    }
+
+    void
+    writeBlock(const BgzfBlock& block)
+    {
+        _ofs.write(reinterpret_cast<const char*>(block.compressed.data()), block.compressed.size());
+        if (! _ofs)
+        {
+            std::ostringstream oss;
+            oss << "Failed to write compressed output file: '" << _filename << "'";
+            BOOST_THROW_EXCEPTION(illumina::common::GeneralException(oss.str()));
+        }
+
+        const uint64_t blockAddress(_blockAddress);
+        _blockAddress += block.compressed.size();
+
+        if (! _indexPtr) return;
+
+        const char* text(block.text.data());
+        const unsigned textSize(block.text.size());
+        unsigned lineStart(0);
+        while (lineStart < textSize)
+        {
+            const char* lineEnd(static_cast<const char*>(std::memchr(text+lineStart, '\n', textSize-lineStart)));
+            if (lineEnd == nullptr)
+            {
+                _lineFragment.append(text+lineStart, textSize-lineStart);
+                break;
+            }
+
+            const unsigned lineEndOffset((lineEnd-text)+1);
+            _lineFragment.append(text+lineStart, (lineEndOffset-1)-lineStart);
+
+            // like bgzf_tell(), report the start of the next block for a line ending at the end of this one:
+            const uint64_t endOffset((lineEndOffset == textSize) ?
+                                     (_blockAddress << 16) : ((blockAddress << 16) | lineEndOffset));
+            _indexPtr->addLine(_lineFragment, endOffset);
+            _lineFragment.clear();
+            lineStart = lineEndOffset;
+        }
+    }
+
+    /// \return The oldest block waiting for compression, or nullptr if there is none
+    BgzfBlock*
+    getPendingBlock()
+    {
+        for (const std::unique_ptr<BgzfBlock>& blockPtr : _blocks)
+        {
+            if (blockPtr->state == BgzfBlock::PENDING) return blockPtr.get();
+        }
+        return nullptr;
+    }
+
+    /// record the first background error and wake all threads, must be called with the mutex held
+    void
+    setError(const std::exception_ptr& error)
+    {
+        if (! _error) _error = error;
+        _compressCondition.notify_all();
+        _writeCondition.notify_all();
+        _producerCondition.notify_all();
+    }
+
+    void
+    rethrowError()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_error) std::rethrow_exception(_error);
+    }
+
+    /// finish all queued blocks and join all background threads
+    void
+    stopThreads()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_isStopping) return;
+            _isStopping = true;
+        }
+        _compressCondition.notify_all();
+        _writeCondition.notify_all();
+
+        for (std::thread& compressThread : _compressThreads) compressThread.join();
+        _writeThread.join();
+    }
+
+    const std::string _filename;
+    const int _compressionLevel;
+    const unsigned _maxQueuedBlocks;
+
+    /// text of the block currently being formatted
+    std::vector<char> _text;
+
+    bool _isClosed = false;
+
+    std::mutex _mutex;
+    std::condition_variable _compressCondition;
+    std::condition_variable _writeCondition;
+    std::condition_variable _producerCondition;
+
+    /// all blocks which have not yet been written, in output order
+    std::deque<std::unique_ptr<BgzfBlock>> _blocks;
+    bool _isStopping = false;
+    std::exception_ptr _error;
+
+    std::vector<std::thread> _compressThreads;
+    std::thread _writeThread;
+
+    // the following are only accessed by the writer thread until it is joined:
+    std::ofstream _ofs;
+    uint64_t _blockAddress = 0;
+    std::unique_ptr<TabixIndexBuilder> _indexPtr;
+    std::string _lineFragment;
+};
+
+
+
+BgzfOutputStream::
+BgzfOutputStream(
+    const std::string& filename,
+    const BGZF_INDEX_TYPE::index_t indexType,
+    const unsigned threadCount,
+    const int compressionLevel)
+    : std::ostream(nullptr),
+      _streamBufPtr(new BgzfOutputStreamBuf(filename, indexType, threadCount, compressionLevel))
+{
+    rdbuf(_streamBufPtr.get());
+}
+
+
+
+BgzfOutputStream::
+~BgzfOutputStream()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::exception& e)
+    {
+        // close() must be called explicitly to handle errors on the normal path, so the destructor is only reached
+        // with an open stream during exception unwinding or after a failed close(), and can only log:
+        log_os << "ERROR: Exception caught while closing BGZF output stream: " << e.what() << "\n";
+    }
+}
+
+
+
+void
+BgzfOutputStream::
+close()
+{
+    flush();
+    _streamBufPtr->close();
+}
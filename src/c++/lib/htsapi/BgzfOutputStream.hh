@@ -0,0 +1,84 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Output stream for bgzip-compressed text with optional on-the-fly tabix indexing
+///
+
+#pragma once
+
+#include "boost/utility.hpp"
+
+#include <memory>
+#include <ostream>
+#include <string>
+
+
+/// The tabix index format which BgzfOutputStream builds for the text written to it
+namespace BGZF_INDEX_TYPE
+{
+
+enum index_t
+{
+    NONE,
+    VCF,
+    BED
+};
+}
+
+
+struct BgzfOutputStreamBuf;
+
+
+/// \brief An output stream writing bgzip-compressed (BGZF) text, with an optional tabix index built on the fly
+///
+/// Text written to the stream is cut into BGZF blocks as it is formatted. Full blocks are compressed on a pool of
+/// background threads, then written to the file in order by a separate writer thread. The writer thread knows the
+/// compressed file offset of every block, so it also parses each complete text line to build a tabix index without
+/// a second pass over the output.
+///
+/// Stream flushes do not cut short the current block, so flushing frequently does not degrade compression. The
+/// file and index are only complete after close(), which should always be called explicitly so that any error is
+/// thrown. The destructor also closes the stream, but can only log an error.
+///
+/// Indexed output must be sorted, as required by tabix.
+///
+struct BgzfOutputStream : public std::ostream, private boost::noncopyable
+{
+    /// \param filename Name of the compressed output file, any index is written to this name with a '.tbi' suffix
+    /// \param threadCount Number of background compression threads, must be at least 1
+    /// \param compressionLevel zlib compression level, or -1 for the default level
+    BgzfOutputStream(
+        const std::string& filename,
+        const BGZF_INDEX_TYPE::index_t indexType,
+        const unsigned threadCount = 1,
+        const int compressionLevel = -1);
+
+    /// Dtor closes the file if it is not already closed. Any error at this point is logged but not thrown.
+    ~BgzfOutputStream();
+
+    /// Write all remaining text, the BGZF EOF marker and the index, and close the file
+    ///
+    /// Throws if any part of the output could not be written.
+    void
+    close();
+
+private:
+    std::unique_ptr<BgzfOutputStreamBuf> _streamBufPtr;
+};
@@ -0,0 +1,148 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Process-wide htslib decoding resources shared by all alignment input streams
+///
+
+#include "htsapi/HtsDecodeThreadPool.hh"
+
+#include "blt_util/log.hh"
+#include "common/Exceptions.hh"
+
+#include "blt_util/thirdparty_push.h"
+
+#include "htslib/cram.h"
+#include "htslib/thread_pool.h"
+
+#include "blt_util/thirdparty_pop.h"
+
+#include <cassert>
+#include <cstdlib>
+
+#include <sstream>
+
+
+
+HtsDecodeThreadPool::
+HtsDecodeThreadPool(const unsigned threadCount)
+    : _threadCount(threadCount)
+{
+    using namespace illumina::common;
+
+    assert(threadCount > 0);
+
+    // a queue size of zero requests the htslib default for each attached stream:
+    _pool.qsize = 0;
+    _pool.pool = hts_tpool_init(static_cast<int>(threadCount));
+    if (nullptr == _pool.pool)
+    {
+        std::ostringstream oss;
+        oss << "Failed to create htslib decode thread pool with " << threadCount << " threads";
+        BOOST_THROW_EXCEPTION(GeneralException(oss.str()));
+    }
+}
+
+
+
+HtsDecodeThreadPool::
+~HtsDecodeThreadPool()
+{
+    if (nullptr != _cramReferenceOwner)
+    {
+        // all attached streams must be closed before the shared resources are destroyed:
+        assert(_isCramReferenceOwnerReleased);
+        if (hts_close(_cramReferenceOwner) != 0)
+        {
+            log_os << "ERROR: Failed to close CRAM file: '" << _cramReferenceFilename << "'\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    hts_tpool_destroy(_pool.pool);
+}
+
+
+
+void
+HtsDecodeThreadPool::
+attach(
+    htsFile* hfp,
+    const char* filename,
+    const char* referenceFilename)
+{
+    using namespace illumina::common;
+
+    assert(nullptr != hfp);
+
+    if (hts_set_thread_pool(hfp, &_pool) != 0)
+    {
+        std::ostringstream oss;
+        oss << "Failed to attach htslib decode thread pool to alignment file: '" << filename << "'";
+        BOOST_THROW_EXCEPTION(GeneralException(oss.str()));
+    }
+
+    if ((hfp->format.format != cram) or (nullptr == referenceFilename)) return;
+
+    std::lock_guard<std::mutex> lock(_cramReferenceMutex);
+    if (nullptr == _cramReferenceOwner)
+    {
+        _cramReferenceOwner = hfp;
+        _cramReferenceFilename = referenceFilename;
+        return;
+    }
+
+    if (_cramReferenceFilename != referenceFilename) return;
+
+    refs_t* sharedReference(cram_get_refs(_cramReferenceOwner));
+    assert(nullptr != sharedReference);
+    if (hts_set_opt(hfp, CRAM_OPT_SHARED_REF, sharedReference) != 0)
+    {
+        std::ostringstream oss;
+        oss << "Failed to share reference cache with CRAM file: '" << filename << "'";
+        BOOST_THROW_EXCEPTION(GeneralException(oss.str()));
+    }
+}
+
+
+
+int
+HtsDecodeThreadPool::
+close(htsFile* hfp)
+{
+    assert(nullptr != hfp);
+
+    if (hfp->format.format != cram) return hts_close(hfp);
+
+    std::lock_guard<std::mutex> lock(_cramReferenceMutex);
+    if (hfp == _cramReferenceOwner)
+    {
+        _isCramReferenceOwnerReleased = true;
+        return 0;
+    }
+    return hts_close(hfp);
+}
+
+
+
+std::unique_ptr<HtsDecodeThreadPool>
+createHtsDecodeThreadPool(const unsigned threadCount)
+{
+    if (threadCount == 0) return std::unique_ptr<HtsDecodeThreadPool>();
+    return std::unique_ptr<HtsDecodeThreadPool>(new HtsDecodeThreadPool(threadCount));
+}
@@ -0,0 +1,100 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Process-wide htslib decoding resources shared by all alignment input streams
+///
+
+#pragma once
+
+#include "blt_util/thirdparty_push.h"
+
+#include "htslib/hts.h"
+
+#include "blt_util/thirdparty_pop.h"
+
+#include "boost/utility.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+
+/// \brief Shared htslib thread pool and CRAM reference cache for alignment input streams
+///
+/// A single htslib thread pool is used for BGZF block decompression of every attached BAM stream and for slice
+/// decoding of every attached CRAM stream, so that the total number of decode threads stays fixed no matter how
+/// many alignment files are registered, or how many call threads register their own copy of each file.
+///
+/// The reference sequence cache of the first attached CRAM stream is shared with every later CRAM stream using the
+/// same reference, so that each reference contig is loaded once per process instead of once per stream.
+///
+/// This object must outlive all streams attached to it. All methods may be called concurrently from any thread.
+struct HtsDecodeThreadPool : private boost::noncopyable
+{
+    /// \param threadCount Number of htslib decode threads, must be at least 1
+    explicit
+    HtsDecodeThreadPool(const unsigned threadCount);
+
+    ~HtsDecodeThreadPool();
+
+    unsigned
+    getThreadCount() const
+    {
+        return _threadCount;
+    }
+
+    /// \brief Attach an open BAM/CRAM file handle to the shared thread pool and CRAM reference cache
+    ///
+    /// \param[in] filename Name of the file opened by \p hfp, used for error reporting only
+    /// \param[in] referenceFilename Reference fasta given to \p hfp, or nullptr if none was given. CRAM reference
+    ///                              sharing is skipped for handles which don't use the same reference as the
+    ///                              first attached CRAM handle.
+    void
+    attach(
+        htsFile* hfp,
+        const char* filename,
+        const char* referenceFilename);
+
+    /// \brief Close a file handle previously passed to attach()
+    ///
+    /// \return The hts_close() status of the handle
+    int
+    close(htsFile* hfp);
+
+private:
+    unsigned _threadCount;
+    htsThreadPool _pool;
+
+    /// Guards the CRAM reference cache state below, and all updates to the htslib reference count of the shared
+    /// cache, which is not thread-safe in htslib itself.
+    std::mutex _cramReferenceMutex;
+
+    /// The first attached CRAM handle, which owns the shared reference cache. Closing this handle is deferred to
+    /// the destructor so that the cache remains valid for all later CRAM streams.
+    htsFile* _cramReferenceOwner = nullptr;
+    bool _isCramReferenceOwnerReleased = false;
+    std::string _cramReferenceFilename;
+};
+
+
+
+/// \brief Create a shared decode thread pool, or return a null pointer if \p threadCount is zero
+std::unique_ptr<HtsDecodeThreadPool>
+createHtsDecodeThreadPool(const unsigned threadCount);
@@ -0,0 +1,577 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Process-wide reference sequence access for analysis region setup
+///
+
+#include "htsapi/ReferenceStore.hh"
+
+#include "blt_util/blt_exception.hh"
+#include "blt_util/log.hh"
+#include "blt_util/seq_util.hh"
+#include "common/Exceptions.hh"
+
+#include "boost/filesystem.hpp"
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+#include "boost/interprocess/sync/file_lock.hpp"
+#include "boost/interprocess/sync/scoped_lock.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace
+{
+
+/// Packed reference file layout:
+///
+/// 1. PackedReferenceHeader
+/// 2. PackedContigRecord for each contig, in fasta index order
+/// 3. Contig name characters for all contigs
+/// 4. For each contig: 2-bit packed bases, 4 bases per byte starting from the low bits, followed by the list of
+///    PackedNInterval covering all N bases of the contig. Each of these blocks starts on an 8-byte boundary.
+///
+/// All values are stored in host byte order, the file is not intended to be portable across architectures.
+///
+const char packedReferenceMagic[8] = {'S','T','R','K','P','R','E','F'};
+const uint64_t packedReferenceVersion(1);
+
+struct PackedReferenceHeader
+{
+    char magic[8];
+    uint64_t version;
+    uint64_t fileSize;
+
+    /// size and modification time of the fasta the file was created from, used to detect a stale file
+    uint64_t sourceFileSize;
+    int64_t sourceModificationTime;
+
+    uint64_t contigCount;
+};
+
+struct PackedContigRecord
+{
+    uint64_t nameOffset;
+    uint64_t nameLength;
+    uint64_t length;
+    uint64_t baseOffset;
+    uint64_t nIntervalOffset;
+    uint64_t nIntervalCount;
+};
+
+/// N-base interval in zero-indexed contig coordinates, [begin,end)
+struct PackedNInterval
+{
+    uint32_t begin;
+    uint32_t end;
+};
+
+const char packedBaseSymbol[4] = {'A','C','G','T'};
+
+
+
+uint64_t
+alignOffset(const uint64_t offset)
+{
+    static const uint64_t alignment(8);
+    return ((offset + alignment - 1) / alignment) * alignment;
+}
+
+
+
+/// \brief Summary of the fasta file used to detect a stale packed reference
+struct SourceFileInfo
+{
+    explicit
+    SourceFileInfo(const std::string& referenceFilename)
+        : fileSize(boost::filesystem::file_size(referenceFilename)),
+          modificationTime(boost::filesystem::last_write_time(referenceFilename))
+    {}
+
+    bool
+    isMatch(const PackedReferenceHeader& header) const
+    {
+        return ((header.sourceFileSize == fileSize) && (header.sourceModificationTime == modificationTime));
+    }
+
+    uint64_t fileSize;
+    int64_t modificationTime;
+};
+
+
+
+/// \return True if the header describes a complete packed reference file of the current version for this fasta
+bool
+isCurrentPackedReferenceHeader(
+    const PackedReferenceHeader& header,
+    const uint64_t fileSize,
+    const SourceFileInfo& sourceInfo)
+{
+    return ((0 == std::memcmp(header.magic, packedReferenceMagic, sizeof(packedReferenceMagic))) &&
+            (header.version == packedReferenceVersion) &&
+            (header.fileSize == fileSize) &&
+            sourceInfo.isMatch(header));
+}
+
+
+
+bool
+isCurrentPackedReferenceFile(
+    const std::string& packedFilename,
+    const SourceFileInfo& sourceInfo)
+{
+    boost::system::error_code ec;
+    const uint64_t fileSize(boost::filesystem::file_size(packedFilename, ec));
+    if (ec || (fileSize < sizeof(PackedReferenceHeader))) return false;
+
+    std::ifstream ifs(packedFilename, std::ios::binary);
+    PackedReferenceHeader header;
+    if (! ifs.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    return isCurrentPackedReferenceHeader(header, fileSize, sourceInfo);
+}
+
+
+
+template <typename T>
+void
+writeValue(
+    std::ostream& os,
+    const T& value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+
+
+void
+writePadding(
+    std::ostream& os,
+    uint64_t& offset)
+{
+    static const char zeros[8] = {};
+    const uint64_t alignedOffset(alignOffset(offset));
+    os.write(zeros, alignedOffset - offset);
+    offset = alignedOffset;
+}
+
+
+
+/// \brief Write the packed reference file for all contigs of an indexed fasta
+void
+writePackedReferenceFile(
+    const faidx_t* fai,
+    const std::string& referenceFilename,
+    const std::string& packedFilename,
+    const SourceFileInfo& sourceInfo)
+{
+    using namespace illumina::common;
+
+    const unsigned contigCount(faidx_nseq(fai));
+    std::vector<std::string> contigNames;
+    std::vector<PackedContigRecord> contigs(contigCount);
+
+    uint64_t offset(sizeof(PackedReferenceHeader) + contigCount*sizeof(PackedContigRecord));
+    for (unsigned contigIndex(0); contigIndex<contigCount; ++contigIndex)
+    {
+        contigNames.emplace_back(faidx_iseq(fai, contigIndex));
+        PackedContigRecord& contig(contigs[contigIndex]);
+        contig.nameOffset = offset;
+        contig.nameLength = contigNames.back().size();
+        offset += contig.nameLength;
+    }
+
+    std::ofstream ofs(packedFilename, std::ios::binary | std::ios::trunc);
+    if (! ofs)
+    {
+        std::ostringstream oss;
+        oss << "Can't open packed reference file for writing: '" << packedFilename << "'";
+        BOOST_THROW_EXCEPTION(GeneralException(oss.str()));
+    }
+
+    // the header and contig table are written last, once all offsets are known:
+    ofs.seekp(sizeof(PackedReferenceHeader) + contigCount*sizeof(PackedContigRecord));
+    for (const auto& contigName : contigNames)
+    {
+        ofs.write(contigName.data(), contigName.size());
+    }
+
+    std::string contigSeq;
+    std::vector<uint8_t> packedBases;
+    std::vector<PackedNInterval> nIntervals;
+    for (unsigned contigIndex(0); contigIndex<contigCount; ++contigIndex)
+    {
+        const std::string& contigName(contigNames[contigIndex]);
+        PackedContigRecord& contig(contigs[contigIndex]);
+        contig.length = faidx_seq_len(fai, contigName.c_str());
+
+        contigSeq.clear();
+        if (contig.length > 0)
+        {
+            int len; // throwaway...
+            char* seq(faidx_fetch_seq(fai, contigName.c_str(), 0, contig.length-1, &len));
+            if (nullptr == seq)
+            {
+                std::ostringstream oss;
+                oss << "Can't read sequence '" << contigName << "' from reference file: '" << referenceFilename << "'";
+                BOOST_THROW_EXCEPTION(GeneralException(oss.str()));
+            }
+            contigSeq.assign(seq);
+            free(seq);
+        }
+        standardize_ref_seq(referenceFilename.c_str(), contigName.c_str(), contigSeq, 0);
+
+        packedBases.assign((contigSeq.size()+3)/4, 0);
+        nIntervals.clear();
+        for (uint32_t pos(0); pos<contigSeq.size(); ++pos)
+        {
+            const char base(contigSeq[pos]);
+            if (base == 'N')
+            {
+                if ((! nIntervals.empty()) && (nIntervals.back().end == pos))
+                {
+                    nIntervals.back().end++;
+                }
+                else
+                {
+                    nIntervals.push_back({pos, pos+1});
+                }
+                continue;
+            }
+            packedBases[pos/4] |= (base_to_id(base) << ((pos%4)*2));
+        }
+
+        writePadding(ofs, offset);
+        contig.baseOffset = offset;
+        ofs.write(reinterpret_cast<const char*>(packedBases.data()), packedBases.size());
+        offset += packedBases.size();
+
+        writePadding(ofs, offset);
+        contig.nIntervalOffset = offset;
+        contig.nIntervalCount = nIntervals.size();
+        ofs.write(reinterpret_cast<const char*>(nIntervals.data()), nIntervals.size()*sizeof(PackedNInterval));
+        offset += nIntervals.size()*sizeof(PackedNInterval);
+    }
+
+    PackedReferenceHeader header;
+    std::memcpy(header.magic, packedReferenceMagic, sizeof(packedReferenceMagic));
+    header.version = packedReferenceVersion;
+    header.fileSize = offset;
+    header.sourceFileSize = sourceInfo.fileSize;
+    header.sourceModificationTime = sourceInfo.modificationTime;
+    header.contigCount = contigCount;
+
+    ofs.seekp(0);
+    writeValue(ofs, header);
+    for (const auto& contig : contigs)
+    {
+        writeValue(ofs, contig);
+    }
+
+    ofs.close();
+    if (! ofs)
+    {
+        std::ostringstream oss;
+        oss << "Failed to write packed reference file: '" << packedFilename << "'";
+        BOOST_THROW_EXCEPTION(GeneralException(oss.str()));
+    }
+}
+
+
+
+/// \return Lookup table from each packed byte to its 4 bases
+const std::array<std::array<char,4>,256>&
+getPackedByteToBases()
+{
+    static const std::array<std::array<char,4>,256> table = []()
+    {
+        std::array<std::array<char,4>,256> result;
+        for (unsigned byteValue(0); byteValue<256; ++byteValue)
+        {
+            for (unsigned baseIndex(0); baseIndex<4; ++baseIndex)
+            {
+                result[byteValue][baseIndex] = packedBaseSymbol[(byteValue >> (baseIndex*2)) & 0x3];
+            }
+        }
+        return result;
+    }();
+    return table;
+}
+
+}
+
+
+
+/// \brief Read-only memory mapping of a packed reference file
+struct PackedReference : private boost::noncopyable
+{
+    explicit
+    PackedReference(const std::string& packedFilename)
+        : _mapping(packedFilename.c_str(), boost::interprocess::read_only),
+          _region(_mapping, boost::interprocess::read_only)
+    {
+        const char* data(getData());
+        const auto& header(*reinterpret_cast<const PackedReferenceHeader*>(data));
+        const auto* contigs(reinterpret_cast<const PackedContigRecord*>(data + sizeof(PackedReferenceHeader)));
+        for (uint64_t contigIndex(0); contigIndex<header.contigCount; ++contigIndex)
+        {
+            const PackedContigRecord& contig(contigs[contigIndex]);
+            _contigs.emplace(std::string(data + contig.nameOffset, contig.nameLength), &contig);
+        }
+    }
+
+    uint64_t
+    getSize() const
+    {
+        return _region.get_size();
+    }
+
+    const PackedReferenceHeader&
+    getHeader() const
+    {
+        return *reinterpret_cast<const PackedReferenceHeader*>(getData());
+    }
+
+    /// \brief Decode standardized reference sequence for a region, following faidx_fetch_seq() endpoint handling
+    ///
+    /// \return False if the contig is not in the reference
+    bool
+    getRegionSeq(
+        const std::string& chrom,
+        int beginPos,
+        int endPos,
+        std::string& refSeq) const
+    {
+        const auto contigIter(_contigs.find(chrom));
+        if (contigIter == _contigs.end()) return false;
+        const PackedContigRecord& contig(*(contigIter->second));
+
+        refSeq.clear();
+        if (contig.length == 0) return true;
+
+        const int contigLength(contig.length);
+        if (endPos < beginPos) beginPos = endPos;
+        beginPos = std::min(std::max(beginPos, 0), contigLength-1);
+        endPos = std::min(std::max(endPos, 0), contigLength-1);
+
+        refSeq.resize(endPos-beginPos+1);
+        char* out(&refSeq[0]);
+        const uint8_t* packedBases(reinterpret_cast<const uint8_t*>(getData() + contig.baseOffset));
+
+        // decode single bases up to the first byte boundary, then whole bytes, then any remaining single bases:
+        int pos(beginPos);
+        for (; (pos <= endPos) && ((pos % 4) != 0); ++pos)
+        {
+            *(out++) = packedBaseSymbol[(packedBases[pos/4] >> ((pos%4)*2)) & 0x3];
+        }
+        const auto& byteToBases(getPackedByteToBases());
+        for (; (pos+3) <= endPos; pos += 4)
+        {
+            std::memcpy(out, byteToBases[packedBases[pos/4]].data(), 4);
+            out += 4;
+        }
+        for (; pos <= endPos; ++pos)
+        {
+            *(out++) = packedBaseSymbol[(packedBases[pos/4] >> ((pos%4)*2)) & 0x3];
+        }
+
+        const auto* nIntervalsBegin(reinterpret_cast<const PackedNInterval*>(getData() + contig.nIntervalOffset));
+        const auto* nIntervalsEnd(nIntervalsBegin + contig.nIntervalCount);
+        auto nIntervalIter(std::upper_bound(nIntervalsBegin, nIntervalsEnd, static_cast<uint32_t>(beginPos),
+                                            [](const uint32_t a, const PackedNInterval& b)
+        {
+            return a < b.end;
+        }));
+        for (; nIntervalIter != nIntervalsEnd; ++nIntervalIter)
+        {
+            if (static_cast<int>(nIntervalIter->begin) > endPos) break;
+            const int maskBegin(std::max(static_cast<int>(nIntervalIter->begin), beginPos));
+            const int maskEnd(std::min(static_cast<int>(nIntervalIter->end), endPos+1));
+            std::fill(refSeq.begin() + (maskBegin-beginPos), refSeq.begin() + (maskEnd-beginPos), 'N');
+        }
+        return true;
+    }
+
+private:
+    const char*
+    getData() const
+    {
+        return static_cast<const char*>(_region.get_address());
+    }
+
+    boost::interprocess::file_mapping _mapping;
+    boost::interprocess::mapped_region _region;
+    std::unordered_map<std::string, const PackedContigRecord*> _contigs;
+};
+
+
+
+/// \brief Map the packed reference file for a fasta, creating it first if it is missing or stale
+static
+std::unique_ptr<PackedReference>
+openPackedReference(
+    const faidx_t* fai,
+    const std::string& referenceFilename)
+{
+    using namespace illumina::common;
+
+    const std::string packedFilename(ReferenceStore::getPackedReferenceFilename(referenceFilename));
+    const SourceFileInfo sourceInfo(referenceFilename);
+
+    if (! isCurrentPackedReferenceFile(packedFilename, sourceInfo))
+    {
+        // all processes sharing the reference wait here while the first one to take the lock writes the file:
+        const std::string lockFilename(packedFilename + ".lock");
+        {
+            std::ofstream touch(lockFilename, std::ios::app);
+            if (! touch)
+            {
+                std::ostringstream oss;
+                oss << "Can't create packed reference lock file: '" << lockFilename << "'";
+                BOOST_THROW_EXCEPTION(GeneralException(oss.str()));
+            }
+        }
+        boost::interprocess::file_lock fileLock(lockFilename.c_str());
+        boost::interprocess::scoped_lock<boost::interprocess::file_lock> lockGuard(fileLock);
+
+        if (! isCurrentPackedReferenceFile(packedFilename, sourceInfo))
+        {
+            // write to a temporary file and rename, so that the packed file is never seen partially written:
+            const std::string tmpFilename(packedFilename + ".tmp");
+            writePackedReferenceFile(fai, referenceFilename, tmpFilename, sourceInfo);
+            boost::filesystem::rename(tmpFilename, packedFilename);
+        }
+
+        // remove the lock file while still holding the lock. This is safe because the packed file is now current,
+        // so any process taking a lock after this point skips writing it:
+        boost::system::error_code ec;
+        boost::filesystem::remove(lockFilename, ec);
+    }
+
+    std::unique_ptr<PackedReference> packedReferencePtr(new PackedReference(packedFilename));
+    if (! isCurrentPackedReferenceHeader(packedReferencePtr->getHeader(), packedReferencePtr->getSize(), sourceInfo))
+    {
+        std::ostringstream oss;
+        oss << "Packed reference file is invalid or does not match reference fasta: '" << packedFilename << "'";
+        BOOST_THROW_EXCEPTION(GeneralException(oss.str()));
+    }
+    return packedReferencePtr;
+}
+
+
+
+ReferenceStore::
+ReferenceStore(
+    const std::string& referenceFilename,
+    const bool isUsePackedReference)
+    : _referenceFilename(referenceFilename)
+{
+    using namespace illumina::common;
+
+    assert(! referenceFilename.empty());
+    _fai = fai_load(referenceFilename.c_str());
+    if (nullptr == _fai)
+    {
+        std::ostringstream oss;
+        oss << "Can't load index for reference file: '" << referenceFilename << "'";
+        BOOST_THROW_EXCEPTION(GeneralException(oss.str()));
+    }
+
+    if (isUsePackedReference)
+    {
+        try
+        {
+            _packedReferencePtr = openPackedReference(_fai, referenceFilename);
+        }
+        catch (const std::exception& e)
+        {
+            log_os << "WARNING: Can't use packed reference file for '" << referenceFilename
+                   << "', reading reference from fasta instead. Reason: " << e.what() << "\n";
+        }
+    }
+}
+
+
+
+ReferenceStore::
+~ReferenceStore()
+{
+    fai_destroy(_fai);
+}
+
+
+
+void
+ReferenceStore::
+getStandardizedRegionSeq(
+    const std::string& chrom,
+    const int beginPos,
+    const int endPos,
+    std::string& refSeq) const
+{
+    bool isFound(false);
+    if (_packedReferencePtr)
+    {
+        // the packed reference is standardized when it is written:
+        isFound = _packedReferencePtr->getRegionSeq(chrom, beginPos, endPos, refSeq);
+    }
+    else
+    {
+        int len; // throwaway...
+        char* seq(nullptr);
+        {
+            std::lock_guard<std::mutex> faiGuard(_faiMutex);
+            seq = faidx_fetch_seq(_fai, chrom.c_str(), beginPos, endPos, &len);
+        }
+        if (nullptr != seq)
+        {
+            isFound = true;
+            refSeq.assign(seq);
+            free(seq);
+            standardize_ref_seq(_referenceFilename.c_str(), chrom.c_str(), refSeq, beginPos);
+        }
+    }
+
+    if (! isFound)
+    {
+        std::ostringstream oss;
+        oss << "Can't find sequence region '" << chrom << ":" << (beginPos+1) << "-" << (endPos+1)
+            << "' in reference file: '" << _referenceFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+}
+
+
+
+std::string
+ReferenceStore::
+getPackedReferenceFilename(const std::string& referenceFilename)
+{
+    return referenceFilename + ".packed2bit";
+}
@@ -0,0 +1,106 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Process-wide reference sequence access for analysis region setup
+///
+
+#pragma once
+
+#include "blt_util/thirdparty_push.h"
+
+#include "htslib/faidx.h"
+
+#include "blt_util/thirdparty_pop.h"
+
+#include "boost/utility.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+
+struct PackedReference;
+
+
+/// \brief Reference sequence source shared by all analysis regions of a process
+///
+/// Provides standardized reference sequence for any region, with the same result as get_standardized_region_seq(),
+/// while loading the reference index once for the lifetime of the object instead of once per region.
+///
+/// If the packed reference is enabled, the reference is instead read from a sidecar file next to the reference
+/// fasta ('<fasta>.packed2bit') holding each standardized contig as 2-bit packed bases plus a list of N-base
+/// intervals. The sidecar is memory-mapped read-only, so the page cache copy of the reference is shared by every
+/// process on the node, and region sequence is decoded directly from the mapping with no file reads or fasta
+/// parsing. The sidecar is created by the first process to need it, under a file lock so that concurrent processes
+/// don't duplicate the work, and recreated if the reference fasta has changed since it was written. If the sidecar
+/// can't be created, a warning is logged and the fasta is used instead.
+///
+/// All methods may be called concurrently from any thread.
+struct ReferenceStore : private boost::noncopyable
+{
+    /// \param[in] referenceFilename Indexed reference fasta
+    /// \param[in] isUsePackedReference If true, read the reference through the memory-mapped packed sidecar file
+    ReferenceStore(
+        const std::string& referenceFilename,
+        const bool isUsePackedReference = false);
+
+    ~ReferenceStore();
+
+    const std::string&
+    getReferenceFilename() const
+    {
+        return _referenceFilename;
+    }
+
+    /// \return True if reference sequence is read from the packed sidecar file
+    bool
+    isPacked() const
+    {
+        return static_cast<bool>(_packedReferencePtr);
+    }
+
+    /// \brief Get standardized reference sequence for a region
+    ///
+    /// Region endpoints outside of the contig are handled the same way as get_standardized_region_seq().
+    ///
+    /// \param[in] beginPos Region begin position (zero-indexed, closed)
+    /// \param[in] endPos Region end position (zero-indexed, closed)
+    /// \param[out] refSeq Reference sequence of the region, the existing string capacity is reused
+    void
+    getStandardizedRegionSeq(
+        const std::string& chrom,
+        const int beginPos,
+        const int endPos,
+        std::string& refSeq) const;
+
+    /// \return Path of the packed sidecar file for a reference fasta
+    static
+    std::string
+    getPackedReferenceFilename(const std::string& referenceFilename);
+
+private:
+    std::string _referenceFilename;
+
+    /// Guards all access to the fasta index, which shares a single file handle for all fetches.
+    mutable std::mutex _faiMutex;
+    faidx_t* _fai = nullptr;
+
+    std::unique_ptr<PackedReference> _packedReferencePtr;
+};
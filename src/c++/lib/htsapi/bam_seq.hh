@@ -205,6 +205,23 @@ struct bam_seq : public bam_seq_base
         return get_bam_seq_char(get_code(i));
     }
 
+    /// decode the codes of all positions in [begin,end) to \p codes
+    ///
+    /// equivalent to get_code() for each position, but the range is only checked once
+    void
+    get_codes(
+        const pos_t begin,
+        const pos_t end,
+        uint8_t* codes) const
+    {
+        assert((begin >= 0) && (begin <= end) && (end <= static_cast<pos_t>(_size)));
+        const pos_t offsetEnd(end+static_cast<pos_t>(_offset));
+        for (pos_t i(begin+static_cast<pos_t>(_offset)); i<offsetEnd; ++i, ++codes)
+        {
+            *codes = _s[(i/2)] >> 4*(1-(i%2)) & 0xf;
+        }
+    }
+
     char
     get_complement_char(const pos_t i) const
     {
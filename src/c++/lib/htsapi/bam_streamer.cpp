@@ -24,6 +24,7 @@
 #include "blt_util/blt_exception.hh"
 #include "blt_util/log.hh"
 #include "htsapi/bam_header_util.hh"
+#include "htsapi/HtsDecodeThreadPool.hh"
 #include "htsapi/bam_streamer.hh"
 
 #include <cassert>
@@ -42,9 +43,11 @@ bam_streamer::
 bam_streamer(
     const char* filename,
     const char* referenceFilename,
-    const char* region)
+    const char* region,
+    HtsDecodeThreadPool* decodeThreadPoolPtr)
     : _is_record_set(false),
       _hfp(nullptr),
+      _decodeThreadPoolPtr(decodeThreadPoolPtr),
       _hdr(nullptr),
       _hidx(nullptr),
       _hitr(nullptr),
@@ -79,6 +82,11 @@ bam_streamer(
         }
     }
 
+    if (nullptr != _decodeThreadPoolPtr)
+    {
+        _decodeThreadPoolPtr->attach(_hfp, name(), referenceFilename);
+    }
+
     _hdr = sam_hdr_read(_hfp);
 
     if (nullptr == _hdr)
@@ -111,12 +119,21 @@ bam_streamer(
 bam_streamer::
 ~bam_streamer()
 {
+    stopReadAhead();
+    if (_readAheadRingPtr)
+    {
+        for (bam1_t* bp : _readAheadRingPtr->getSlots())
+        {
+            bam_destroy1(bp);
+        }
+    }
+
     if (nullptr != _hitr) hts_itr_destroy(_hitr);
     if (nullptr != _hidx) hts_idx_destroy(_hidx);
     if (nullptr != _hdr) bam_hdr_destroy(_hdr);
     if (nullptr != _hfp)
     {
-        const int retval = hts_close(_hfp);
+        const int retval((nullptr != _decodeThreadPoolPtr) ? _decodeThreadPoolPtr->close(_hfp) : hts_close(_hfp));
         if (retval != 0)
         {
             log_os << "ERROR: Failed to close BAM/CRAM file: '" << name() << "'\n";
@@ -214,6 +231,7 @@ resetRegion(
     int beginPos,
     int endPos)
 {
+    stopReadAhead();
     if (nullptr != _hitr) hts_itr_destroy(_hitr);
 
     _load_index();
@@ -237,21 +255,106 @@ resetRegion(
 
     _is_record_set = false;
     _record_no = 0;
+    _filterCounts.clear();
 }
 
 
 
-bool
+void
 bam_streamer::
-next()
+enableReadAhead(const unsigned recordCount)
 {
-    if (nullptr == _hfp) return false;
+    assert(recordCount > 0);
+    assert(! _readAheadRingPtr);
+    assert(! _is_record_set);
+
+    _readAheadRingPtr.reset(new SpscRingBuffer<bam1_t*>(recordCount, nullptr));
+    for (bam1_t*& bp : _readAheadRingPtr->getSlots())
+    {
+        bp = bam_init1();
+    }
+}
+
+
+
+void
+bam_streamer::
+setRecordFilter(const BamRecordFilterSpec& filterSpec)
+{
+    assert(! _is_record_set);
+    assert(! _isReadAheadStarted);
+
+    _filterSpec = filterSpec;
+    _isRecordFilter = _filterSpec.isAnyFilterEnabled();
+
+    if (_filterSpec.isSkipAuxFields && (hts_get_format(_hfp)->format == cram))
+    {
+        // all fixed fields are still decoded, so only the optional fields are missing from each record:
+        static const int requiredFields(SAM_QNAME | SAM_FLAG | SAM_RNAME | SAM_POS | SAM_MAPQ | SAM_CIGAR |
+                                        SAM_RNEXT | SAM_PNEXT | SAM_TLEN | SAM_SEQ | SAM_QUAL);
+        if (hts_set_opt(_hfp, CRAM_OPT_REQUIRED_FIELDS, requiredFields) != 0)
+        {
+            std::ostringstream oss;
+            oss << "Failed to set required fields for CRAM file: '" << name() << "'";
+            throw blt_exception(oss.str().c_str());
+        }
+    }
+}
+
+
+
+void
+bam_streamer::
+startReadAhead()
+{
+    assert(! _isReadAheadStarted);
+
+    _readAheadThread = std::thread([this]()
+    {
+        SpscRingBuffer<bam1_t*>& ring(*_readAheadRingPtr);
+        try
+        {
+            while (bam1_t** slot = ring.waitWriteSlot())
+            {
+                if (! readFilteredRecord(*slot)) break;
+                ring.commitWrite();
+            }
+        }
+        catch (...)
+        {
+            _readAheadException = std::current_exception();
+        }
+        ring.closeWrite();
+    });
+    _isReadAheadStarted = true;
+}
+
+
+
+void
+bam_streamer::
+stopReadAhead()
+{
+    if (! _isReadAheadStarted) return;
+
+    _readAheadRingPtr->cancel();
+    _readAheadThread.join();
+    _readAheadRingPtr->reset();
+    _readAheadException = nullptr;
+    _isReadAheadStarted = false;
+}
+
 
+
+bool
+bam_streamer::
+readRecord(bam1_t* bp)
+{
     int ret;
     if (nullptr == _hitr)
     {
 
-        ret = sam_read1(_hfp,_hdr, _brec._bp);
+        ret = sam_read1(_hfp,_hdr, bp);
 
         // Semi-documented sam_read1 API: -1 is expected read failure at end of stream, any other negative value
         // is an error
@@ -259,13 +362,14 @@ next()
         {
             std::ostringstream oss;
             oss << "Unexpected return value from htslib sam_read1 function '" << ret << "' while attempting to read BAM/CRAM file:\n";
-            report_state(oss);
+            if (_readAheadRingPtr) reportStreamState(oss);
+            else                   report_state(oss);
             throw blt_exception(oss.str().c_str());
         }
     }
     else
     {
-        ret = sam_itr_next(_hfp, _hitr, _brec._bp);
+        ret = sam_itr_next(_hfp, _hitr, bp);
 
         // Re sam_itr_next API: -1 is expected read failure at end of stream. As of htslib v1.5 errors also give a return
         // value of -1. If PR #575 is accepted then errors should return a value less than -1.
@@ -273,12 +377,62 @@ next()
         {
             std::ostringstream oss;
             oss << "Unexpected return value from htslib sam_itr_next function '" << ret << "' while attempting to read BAM/CRAM file:\n";
-            report_state(oss);
+            if (_readAheadRingPtr) reportStreamState(oss);
+            else                   report_state(oss);
             throw blt_exception(oss.str().c_str());
         }
     }
 
-    _is_record_set=(ret >= 0);
+    return (ret >= 0);
+}
+
+
+
+bool
+bam_streamer::
+readFilteredRecord(bam1_t* bp)
+{
+    while (readRecord(bp))
+    {
+        if (! _isRecordFilter) return true;
+
+        const BAM_RECORD_FILTER::index_t filterIndex(_filterSpec.getFilterIndex(bp->core));
+        if (filterIndex == BAM_RECORD_FILTER::NONE) return true;
+        _filterCounts.count[filterIndex]++;
+    }
+    return false;
+}
+
+
+
+bool
+bam_streamer::
+next()
+{
+    if (nullptr == _hfp) return false;
+
+    if (_readAheadRingPtr)
+    {
+        if (! _isReadAheadStarted) startReadAhead();
+
+        bam1_t** slot(_readAheadRingPtr->waitReadSlot());
+        _is_record_set = (nullptr != slot);
+        if (_is_record_set)
+        {
+            // swap the decoded record in, and the previous record buffer back to the ring for reuse:
+            std::swap(_brec._bp, *slot);
+            _readAheadRingPtr->commitRead();
+        }
+        else if (_readAheadException)
+        {
+            std::rethrow_exception(_readAheadException);
+        }
+    }
+    else
+    {
+        _is_record_set = readFilteredRecord(_brec._bp);
+    }
+
     if (_is_record_set) _record_no++;
 
     return _is_record_set;
@@ -316,11 +470,7 @@ report_state(std::ostream& os) const
 {
     const bam_record* bamp(get_record_ptr());
 
-    os << "\tbam_stream_label: '" << name() << "'\n";
-    if (_is_region && (! _region.empty()))
-    {
-        os << "\tbam_stream_selected_region: " << _region << "\n";
-    }
+    reportStreamState(os);
     if (nullptr != bamp)
     {
         os << "\tbam_stream_record_no: " << record_no() << "\n";
@@ -334,3 +484,16 @@ report_state(std::ostream& os) const
         os << "\tno bam record currently set\n";
     }
 }
+
+
+
+void
+bam_streamer::
+reportStreamState(std::ostream& os) const
+{
+    os << "\tbam_stream_label: '" << name() << "'\n";
+    if (_is_region && (! _region.empty()))
+    {
+        os << "\tbam_stream_selected_region: " << _region << "\n";
+    }
+}
@@ -23,13 +23,21 @@
 
 #pragma once
 
+#include "blt_util/SpscRingBuffer.hh"
+#include "htsapi/BamRecordFilter.hh"
 #include "htsapi/bam_record.hh"
 #include "htsapi/sam_util.hh"
 
 #include "boost/utility.hpp"
 
+#include <exception>
 #include <iosfwd>
+#include <memory>
 #include <string>
+#include <thread>
+
+
+struct HtsDecodeThreadPool;
 
 
 /// Interface for any object which provides current record and file position for error reporting purposes
@@ -61,10 +69,13 @@ struct bam_streamer : public stream_state_reporter, public boost::noncopyable
     /// \param region Restrict the stream to iterate through a specific region. The BAM/CRAM input file must be
     ///            indexed for this option to work. If 'region' is not provided, the stream is configured to
     ///            iterate through the entire alignment file.
+    /// \param decodeThreadPoolPtr Optional shared htslib thread pool used to decompress/decode this stream. If
+    ///            provided, the pool must outlive this object.
     bam_streamer(
         const char* filename,
         const char* referenceFilename,
-        const char* region = nullptr);
+        const char* region = nullptr,
+        HtsDecodeThreadPool* decodeThreadPoolPtr = nullptr);
 
     ~bam_streamer() override;
 
@@ -85,6 +96,37 @@ struct bam_streamer : public stream_state_reporter, public boost::noncopyable
         int beginPos,
         int endPos);
 
+    /// \brief Decode records on a separate read-ahead thread
+    ///
+    /// Records are decoded into a ring of \p recordCount recycled record buffers ahead of the caller, so that
+    /// decompression and decoding of upcoming records overlaps with the caller's work on the current one. Each
+    /// decoded record is swapped out of the ring into the current record, so no record data is copied.
+    ///
+    /// The read-ahead thread starts on the first call to next() after construction or resetRegion(), and is
+    /// stopped by resetRegion() and the destructor.
+    ///
+    /// \param recordCount Number of records which can be decoded ahead of the caller, must be at least 1
+    void
+    enableReadAhead(const unsigned recordCount);
+
+    /// \brief Filter out records matching \p filterSpec as they are read from the file
+    ///
+    /// Filtered records are never returned by next(), they are only tallied in the record filter counts. When
+    /// read-ahead is enabled the filter is evaluated on the read-ahead thread.
+    ///
+    /// This must be called before the first call to next().
+    void
+    setRecordFilter(const BamRecordFilterSpec& filterSpec);
+
+    /// \brief Number of records removed by the record filter since construction or the last resetRegion()
+    ///
+    /// When read-ahead is enabled, the counts are only complete after next() has returned false.
+    const BamRecordFilterCounts&
+    getRecordFilterCounts() const
+    {
+        return _filterCounts;
+    }
+
     bool next();
 
     const bam_record* get_record_ptr() const
@@ -120,8 +162,31 @@ struct bam_streamer : public stream_state_reporter, public boost::noncopyable
 private:
     void _load_index();
 
+    /// \brief Read the next record from the file into \p bp
+    ///
+    /// \return False at the end of the stream
+    bool
+    readRecord(bam1_t* bp);
+
+    /// \brief Read the next record which passes the record filter into \p bp
+    ///
+    /// \return False at the end of the stream
+    bool
+    readFilteredRecord(bam1_t* bp);
+
+    /// \brief Report stream details which don't depend on the current record
+    void
+    reportStreamState(std::ostream& os) const;
+
+    void
+    startReadAhead();
+
+    void
+    stopReadAhead();
+
     bool _is_record_set;
     htsFile* _hfp;
+    HtsDecodeThreadPool* _decodeThreadPoolPtr;
     bam_hdr_t* _hdr;
     hts_idx_t* _hidx;
     hts_itr_t* _hitr;
@@ -132,4 +197,16 @@ private:
     std::string _stream_name;
     bool _is_region;
     std::string _region;
+
+    bool _isRecordFilter = false;
+    BamRecordFilterSpec _filterSpec;
+    BamRecordFilterCounts _filterCounts;
+
+    /// Ring of decoded records shared with the read-ahead thread, null if read-ahead is not enabled
+    std::unique_ptr<SpscRingBuffer<bam1_t*>> _readAheadRingPtr;
+    std::thread _readAheadThread;
+    bool _isReadAheadStarted = false;
+
+    /// Exception thrown by the read-ahead thread, rethrown by next() once all records read before it are consumed
+    std::exception_ptr _readAheadException;
 };
@@ -0,0 +1,117 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "htsapi/BamRecordFilter.hh"
+
+#include "boost/test/unit_test.hpp"
+
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( BamRecordFilter_test_suite )
+
+
+static
+bam1_core_t
+getCore(
+    const uint16_t flag,
+    const uint8_t mapq = 60)
+{
+    bam1_core_t core = {};
+    core.flag = flag;
+    core.qual = mapq;
+    return core;
+}
+
+
+BOOST_AUTO_TEST_CASE( test_BamRecordFilterSpec_default )
+{
+    const BamRecordFilterSpec filterSpec;
+    BOOST_REQUIRE(! filterSpec.isAnyFilterEnabled());
+
+    const uint16_t allFlags(BAM_FLAG::FILTER | BAM_FLAG::DUPLICATE | BAM_FLAG::UNMAPPED | BAM_FLAG::SECONDARY |
+                            BAM_FLAG::SUPPLEMENTARY);
+    BOOST_REQUIRE_EQUAL(filterSpec.getFilterIndex(getCore(allFlags, 0)), BAM_RECORD_FILTER::NONE);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_BamRecordFilterSpec_flags )
+{
+    using namespace BAM_RECORD_FILTER;
+
+    BamRecordFilterSpec filterSpec;
+    filterSpec.enableFilter(DUPLICATE);
+    filterSpec.enableFilter(SECONDARY);
+    BOOST_REQUIRE(filterSpec.isAnyFilterEnabled());
+
+    BOOST_REQUIRE_EQUAL(filterSpec.getFilterIndex(getCore(BAM_FLAG::PAIRED)), NONE);
+    BOOST_REQUIRE_EQUAL(filterSpec.getFilterIndex(getCore(BAM_FLAG::FILTER)), NONE);
+    BOOST_REQUIRE_EQUAL(filterSpec.getFilterIndex(getCore(BAM_FLAG::DUPLICATE)), DUPLICATE);
+    BOOST_REQUIRE_EQUAL(filterSpec.getFilterIndex(getCore(BAM_FLAG::SECONDARY)), SECONDARY);
+
+    // records matching several filters are assigned to the first filter in evaluation order:
+    BOOST_REQUIRE_EQUAL(filterSpec.getFilterIndex(getCore(BAM_FLAG::SECONDARY | BAM_FLAG::DUPLICATE)), DUPLICATE);
+    filterSpec.enableFilter(QC_FAIL);
+    BOOST_REQUIRE_EQUAL(filterSpec.getFilterIndex(getCore(BAM_FLAG::FILTER | BAM_FLAG::DUPLICATE)), QC_FAIL);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_BamRecordFilterSpec_mapq )
+{
+    using namespace BAM_RECORD_FILTER;
+
+    BamRecordFilterSpec filterSpec;
+    filterSpec.enableMinMapq(20);
+
+    BOOST_REQUIRE_EQUAL(filterSpec.getFilterIndex(getCore(0, 19)), LOW_MAPQ);
+    BOOST_REQUIRE_EQUAL(filterSpec.getFilterIndex(getCore(0, 20)), NONE);
+
+    // flag filters are evaluated before MAPQ:
+    filterSpec.enableFilter(UNMAPPED);
+    BOOST_REQUIRE_EQUAL(filterSpec.getFilterIndex(getCore(BAM_FLAG::UNMAPPED, 0)), UNMAPPED);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_BamRecordFilterCounts )
+{
+    using namespace BAM_RECORD_FILTER;
+
+    BamRecordFilterCounts counts1;
+    counts1.count[DUPLICATE] = 3;
+    counts1.count[LOW_MAPQ] = 1;
+
+    BamRecordFilterCounts counts2;
+    counts2.count[DUPLICATE] = 2;
+    counts2.count[UNMAPPED] = 4;
+
+    counts1.merge(counts2);
+    BOOST_REQUIRE_EQUAL(counts1.count[DUPLICATE], 5u);
+    BOOST_REQUIRE_EQUAL(counts1.count[UNMAPPED], 4u);
+    BOOST_REQUIRE_EQUAL(counts1.getTotal(), 10u);
+
+    std::ostringstream oss;
+    counts1.report(oss);
+    BOOST_REQUIRE(oss.str().find("Duplicate: 5") != std::string::npos);
+
+    counts1.clear();
+    BOOST_REQUIRE_EQUAL(counts1.getTotal(), 0u);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
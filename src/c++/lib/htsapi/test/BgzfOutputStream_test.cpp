@@ -0,0 +1,158 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "htsapi/BgzfOutputStream.hh"
+#include "htsapi/tabix_util.hh"
+#include "common/Exceptions.hh"
+
+extern "C" {
+#include "htslib/bgzf.h"
+}
+
+#include "boost/filesystem.hpp"
+#include "boost/test/unit_test.hpp"
+
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( BgzfOutputStream_test_suite )
+
+
+/// manage a temporary output file and its index
+struct TempOutputFile
+{
+    TempOutputFile()
+        : path((boost::filesystem::temp_directory_path() /
+                boost::filesystem::unique_path("BgzfOutputStream_test.%%%%-%%%%.vcf.gz")).string())
+    {}
+
+    ~TempOutputFile()
+    {
+        boost::filesystem::remove(path);
+        boost::filesystem::remove(path + ".tbi");
+    }
+
+    const std::string path;
+};
+
+
+
+/// \return text of a sorted vcf file spanning many BGZF blocks
+static
+std::string
+getTestVcfText()
+{
+    std::ostringstream oss;
+    oss << "##fileformat=VCFv4.1\n";
+    oss << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n";
+    for (const char* chrom : { "chr1", "chr2" })
+    {
+        for (unsigned pos(1); pos <= 20000; ++pos)
+        {
+            oss << chrom << '\t' << pos << "\t.\tA\t.\t.\tPASS\tEND=" << pos << "\n";
+        }
+    }
+    return oss.str();
+}
+
+
+
+/// \return full uncompressed text of a bgzip-compressed file
+static
+std::string
+readBgzfText(const std::string& path)
+{
+    BGZF* bgzfPtr(bgzf_open(path.c_str(), "r"));
+    BOOST_REQUIRE(bgzfPtr != nullptr);
+    std::string text;
+    char buffer[4096];
+    while (true)
+    {
+        const ssize_t readSize(bgzf_read(bgzfPtr, buffer, sizeof(buffer)));
+        BOOST_REQUIRE(readSize >= 0);
+        if (readSize == 0) break;
+        text.append(buffer, readSize);
+    }
+    BOOST_REQUIRE_EQUAL(bgzf_close(bgzfPtr), 0);
+    return text;
+}
+
+
+
+/// \return number of records found by a tabix region query
+static
+unsigned
+getRegionRecordCount(
+    const std::string& path,
+    const char* region)
+{
+    htsFile* hfp(hts_open(path.c_str(), "r"));
+    BOOST_REQUIRE(hfp != nullptr);
+    tbx_t* tbx(tbx_index_load(path.c_str()));
+    BOOST_REQUIRE(tbx != nullptr);
+    hts_itr_t* itr(tbx_itr_querys(tbx, region));
+    BOOST_REQUIRE(itr != nullptr);
+
+    unsigned recordCount(0);
+    kstring_t str = {0,0,0};
+    while (tbx_itr_next(hfp, tbx, itr, &str) >= 0) recordCount++;
+
+    free(str.s);
+    tbx_itr_destroy(itr);
+    tbx_destroy(tbx);
+    hts_close(hfp);
+    return recordCount;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_BgzfOutputStream_indexed )
+{
+    const TempOutputFile outputFile;
+    const std::string text(getTestVcfText());
+    {
+        BgzfOutputStream bos(outputFile.path, BGZF_INDEX_TYPE::VCF, 3);
+        // write in uneven pieces and flush frequently to check that neither affects the output:
+        for (unsigned textOffset(0); textOffset < text.size(); textOffset += 1000)
+        {
+            bos << text.substr(textOffset, 1000) << std::flush;
+        }
+        bos.close();
+    }
+
+    BOOST_REQUIRE_EQUAL(readBgzfText(outputFile.path), text);
+
+    BOOST_REQUIRE_EQUAL(getRegionRecordCount(outputFile.path, "chr1:100-199"), 100u);
+    BOOST_REQUIRE_EQUAL(getRegionRecordCount(outputFile.path, "chr2:19990-30000"), 11u);
+    BOOST_REQUIRE_EQUAL(getRegionRecordCount(outputFile.path, "chr2"), 20000u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_BgzfOutputStream_unsorted )
+{
+    const TempOutputFile outputFile;
+    BgzfOutputStream bos(outputFile.path, BGZF_INDEX_TYPE::VCF);
+    bos << "chr1\t100\t.\tA\t.\t.\tPASS\t.\n";
+    bos << "chr1\t10\t.\tA\t.\t.\tPASS\t.\n";
+    BOOST_REQUIRE_THROW(bos.close(), illumina::common::GeneralException);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
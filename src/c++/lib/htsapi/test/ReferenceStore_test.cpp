@@ -0,0 +1,162 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "htsapi/ReferenceStore.hh"
+#include "htsapi/samtools_fasta_util.hh"
+
+#include "boost/filesystem.hpp"
+#include "boost/test/unit_test.hpp"
+
+#include <fstream>
+#include <random>
+
+
+BOOST_AUTO_TEST_SUITE( ReferenceStore_test_suite )
+
+
+/// manage a temporary directory holding a test reference fasta
+struct TempReferenceDir
+{
+    TempReferenceDir()
+        : dir(boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("ReferenceStore_test.%%%%-%%%%"))
+    {
+        boost::filesystem::create_directories(dir);
+    }
+
+    ~TempReferenceDir()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(dir, ec);
+    }
+
+    std::string
+    getReferenceFilename() const
+    {
+        return (dir / "ref.fa").string();
+    }
+
+    const boost::filesystem::path dir;
+};
+
+
+
+/// \brief Write a fasta with soft-masked, IUPAC and N-run sequence on contigs of assorted lengths and line widths
+static
+void
+writeTestFasta(const std::string& referenceFilename)
+{
+    static const char bases[] = "ACGTacgtNnRYK";
+    std::mt19937 rng(7);
+
+    std::ofstream ofs(referenceFilename);
+    const unsigned contigLengths[] = { 1, 3, 97, 1000 };
+    const unsigned lineWidths[] = { 60, 7, 10, 61 };
+    for (unsigned contigIndex(0); contigIndex<4; ++contigIndex)
+    {
+        ofs << ">chr" << contigIndex << " description\n";
+        const unsigned contigLength(contigLengths[contigIndex]);
+        for (unsigned pos(0); pos<contigLength; ++pos)
+        {
+            char base(bases[rng() % (sizeof(bases)-1)]);
+            // add long N runs:
+            if ((pos >= 100) && (pos < 150)) base = 'N';
+            ofs << base;
+            if ((((pos+1) % lineWidths[contigIndex]) == 0) || ((pos+1) == contigLength)) ofs << '\n';
+        }
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_ReferenceStore )
+{
+    const TempReferenceDir tempDir;
+    const std::string referenceFilename(tempDir.getReferenceFilename());
+    writeTestFasta(referenceFilename);
+
+    const ReferenceStore fastaStore(referenceFilename);
+    BOOST_REQUIRE(! fastaStore.isPacked());
+
+    const ReferenceStore packedStore(referenceFilename, true);
+    BOOST_REQUIRE(packedStore.isPacked());
+    BOOST_REQUIRE(boost::filesystem::exists(ReferenceStore::getPackedReferenceFilename(referenceFilename)));
+
+    // no lock or temporary file is left next to the reference:
+    BOOST_REQUIRE(! boost::filesystem::exists(ReferenceStore::getPackedReferenceFilename(referenceFilename) + ".lock"));
+    BOOST_REQUIRE(! boost::filesystem::exists(ReferenceStore::getPackedReferenceFilename(referenceFilename) + ".tmp"));
+
+    // a second store reuses the existing packed file:
+    const auto packedFileTime(boost::filesystem::last_write_time(
+                                  ReferenceStore::getPackedReferenceFilename(referenceFilename)));
+    const ReferenceStore packedStore2(referenceFilename, true);
+    BOOST_REQUIRE(packedStore2.isPacked());
+    BOOST_REQUIRE_EQUAL(packedFileTime, boost::filesystem::last_write_time(
+                            ReferenceStore::getPackedReferenceFilename(referenceFilename)));
+
+    // all regions, including those extending past either contig end, must match the original reference function:
+    std::string expected;
+    std::string fastaSeq;
+    std::string packedSeq;
+    for (const char* chrom : { "chr0", "chr1", "chr2", "chr3" })
+    {
+        for (int beginPos(-5); beginPos < 1010; beginPos += 3)
+        {
+            for (const int regionSize : { 1, 2, 5, 8, 33, 400 })
+            {
+                const int endPos(beginPos + regionSize - 1);
+                get_standardized_region_seq(referenceFilename, chrom, beginPos, endPos, expected);
+                fastaStore.getStandardizedRegionSeq(chrom, beginPos, endPos, fastaSeq);
+                packedStore.getStandardizedRegionSeq(chrom, beginPos, endPos, packedSeq);
+                BOOST_REQUIRE_EQUAL(expected, fastaSeq);
+                BOOST_REQUIRE_EQUAL(expected, packedSeq);
+            }
+        }
+    }
+
+    BOOST_REQUIRE_THROW(packedStore.getStandardizedRegionSeq("chrX", 0, 10, packedSeq), std::exception);
+    BOOST_REQUIRE_THROW(fastaStore.getStandardizedRegionSeq("chrX", 0, 10, fastaSeq), std::exception);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_ReferenceStore_stale_packed_file )
+{
+    const TempReferenceDir tempDir;
+    const std::string referenceFilename(tempDir.getReferenceFilename());
+    writeTestFasta(referenceFilename);
+    const std::string packedFilename(ReferenceStore::getPackedReferenceFilename(referenceFilename));
+
+    // a packed file which does not match the fasta is replaced:
+    {
+        std::ofstream ofs(packedFilename);
+        ofs << "not a packed reference";
+    }
+    const ReferenceStore packedStore(referenceFilename, true);
+    BOOST_REQUIRE(packedStore.isPacked());
+
+    std::string expected;
+    std::string packedSeq;
+    get_standardized_region_seq(referenceFilename, "chr3", 0, 999, expected);
+    packedStore.getStandardizedRegionSeq("chr3", 0, 999, packedSeq);
+    BOOST_REQUIRE_EQUAL(expected, packedSeq);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
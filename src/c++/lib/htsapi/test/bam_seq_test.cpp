@@ -0,0 +1,60 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "htsapi/bam_seq.hh"
+
+#include "boost/test/unit_test.hpp"
+
+#include <vector>
+
+
+
+BOOST_AUTO_TEST_SUITE( test_bam_seq )
+
+
+BOOST_AUTO_TEST_CASE( test_bam_seq_get_codes )
+{
+    // packed 4-bit codes for "ACGTNAC=G" plus padding:
+    const std::string seq("ACGTNAC=G");
+    std::vector<uint8_t> packed((seq.size()+1)/2, 0);
+    for (unsigned i(0); i<seq.size(); ++i)
+    {
+        packed[i/2] |= (get_bam_seq_code(seq[i]) << (4*(1-(i%2))));
+    }
+
+    // check all sub-ranges, starting from both even and odd offsets into the packed data:
+    for (unsigned offset(0); offset<2; ++offset)
+    {
+        const bam_seq bseq(packed.data(), seq.size()-offset, offset);
+        for (unsigned begin(0); begin<=bseq.size(); ++begin)
+        {
+            for (unsigned end(begin); end<=bseq.size(); ++end)
+            {
+                std::vector<uint8_t> codes(end-begin);
+                bseq.get_codes(begin, end, codes.data());
+                for (unsigned i(begin); i<end; ++i)
+                {
+                    BOOST_REQUIRE_EQUAL(codes[i-begin], bseq.get_code(i));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
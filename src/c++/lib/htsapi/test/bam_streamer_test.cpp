@@ -21,6 +21,7 @@
 
 #include "blt_util/blt_exception.hh"
 #include "htsapi/bam_streamer.hh"
+#include "htsapi/HtsDecodeThreadPool.hh"
 
 #include "boost/test/unit_test.hpp"
 
@@ -93,4 +94,137 @@ BOOST_AUTO_TEST_CASE( test_bam_streamer_cram_read_fail )
 }
 
 
+
+
+BOOST_AUTO_TEST_CASE( test_bam_streamer_decode_thread_pool )
+{
+    const std::string testBamPath(std::string(TEST_DATA_PATH) + "/alignment_test.bam");
+    const std::string testCramPath(std::string(TEST_DATA_PATH) + "/alignment_test.cram");
+    const std::string testRefPath(std::string(TEST_DATA_PATH) + "/alignment_test.fasta");
+
+    HtsDecodeThreadPool decodeThreadPool(2);
+
+    {
+        bam_streamer stream(testBamPath.c_str(), nullptr, nullptr, &decodeThreadPool);
+        checkStream(stream, 4u);
+        stream.resetRegion("chrA");
+        checkStream(stream, 2u);
+    }
+
+    // test multiple CRAM streams sharing one reference cache, including a stream attached after the stream owning
+    // the cache has been destroyed:
+    {
+        bam_streamer stream1(testCramPath.c_str(), testRefPath.c_str(), nullptr, &decodeThreadPool);
+        bam_streamer stream2(testCramPath.c_str(), testRefPath.c_str(), "chrA", &decodeThreadPool);
+        checkStream(stream1, 4u);
+        checkStream(stream2, 2u);
+    }
+    {
+        bam_streamer stream(testCramPath.c_str(), testRefPath.c_str(), nullptr, &decodeThreadPool);
+        checkStream(stream, 4u);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_bam_streamer_read_ahead )
+{
+    const std::string testBamPath(std::string(TEST_DATA_PATH) + "/alignment_test.bam");
+    const std::string testCramPath(std::string(TEST_DATA_PATH) + "/alignment_test.cram");
+    const std::string testRefPath(std::string(TEST_DATA_PATH) + "/alignment_test.fasta");
+
+    // use a ring smaller than the record count, so that the read-ahead thread must wait for the consumer:
+    {
+        bam_streamer stream(testBamPath.c_str(), nullptr);
+        stream.enableReadAhead(1);
+        checkStream(stream, 4u);
+        stream.resetRegion("chrA");
+        checkStream(stream, 2u);
+
+        // reset the region before the read-ahead thread reaches the end of the stream:
+        stream.resetRegion("chrA");
+        BOOST_REQUIRE(stream.next());
+        stream.resetRegion("chrA");
+        checkStream(stream, 2u);
+    }
+
+    {
+        bam_streamer stream(testCramPath.c_str(), testRefPath.c_str(), "chrA");
+        stream.enableReadAhead(4);
+        checkStream(stream, 2u);
+    }
+
+    // read errors on the read-ahead thread are rethrown on the caller's thread:
+    {
+        bam_streamer stream(testCramPath.c_str(), nullptr);
+        stream.enableReadAhead(2);
+        BOOST_REQUIRE_THROW(stream.next(), blt_exception);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_bam_streamer_record_filter )
+{
+    const std::string testBamPath(std::string(TEST_DATA_PATH) + "/alignment_test.bam");
+    const std::string testCramPath(std::string(TEST_DATA_PATH) + "/alignment_test.cram");
+    const std::string testRefPath(std::string(TEST_DATA_PATH) + "/alignment_test.fasta");
+
+    // all test records are mapped with MAPQ 60:
+    {
+        BamRecordFilterSpec filterSpec;
+        filterSpec.enableFilter(BAM_RECORD_FILTER::UNMAPPED);
+        filterSpec.enableMinMapq(60);
+
+        bam_streamer stream(testBamPath.c_str(), nullptr);
+        stream.setRecordFilter(filterSpec);
+        checkStream(stream, 4u);
+        BOOST_REQUIRE_EQUAL(stream.getRecordFilterCounts().getTotal(), 0u);
+    }
+
+    {
+        BamRecordFilterSpec filterSpec;
+        filterSpec.enableMinMapq(61);
+
+        bam_streamer stream(testBamPath.c_str(), nullptr);
+        stream.setRecordFilter(filterSpec);
+        checkStream(stream, 0u);
+        BOOST_REQUIRE_EQUAL(stream.getRecordFilterCounts().count[BAM_RECORD_FILTER::LOW_MAPQ], 4u);
+
+        // counts are reset with the region:
+        stream.resetRegion("chrA");
+        BOOST_REQUIRE_EQUAL(stream.getRecordFilterCounts().getTotal(), 0u);
+        checkStream(stream, 0u);
+        BOOST_REQUIRE_EQUAL(stream.getRecordFilterCounts().count[BAM_RECORD_FILTER::LOW_MAPQ], 2u);
+    }
+
+    // filter on the read-ahead thread, and skip CRAM optional fields:
+    {
+        BamRecordFilterSpec filterSpec;
+        filterSpec.enableMinMapq(61);
+        filterSpec.isSkipAuxFields = true;
+
+        bam_streamer stream(testCramPath.c_str(), testRefPath.c_str());
+        stream.enableReadAhead(1);
+        stream.setRecordFilter(filterSpec);
+        checkStream(stream, 0u);
+        BOOST_REQUIRE_EQUAL(stream.getRecordFilterCounts().count[BAM_RECORD_FILTER::LOW_MAPQ], 4u);
+    }
+
+    {
+        BamRecordFilterSpec filterSpec;
+        filterSpec.isSkipAuxFields = true;
+
+        bam_streamer stream(testCramPath.c_str(), testRefPath.c_str(), "chrA");
+        stream.setRecordFilter(filterSpec);
+        BOOST_REQUIRE(stream.next());
+        const bam_record& read(*(stream.get_record_ptr()));
+        BOOST_REQUIRE_EQUAL(read.read_size(), 5u);
+        BOOST_REQUIRE_EQUAL(read.get_bam_read().get_string(), "CTCTA");
+        BOOST_REQUIRE_EQUAL(read.qual()[0], 26u);
+        static const char mdtag[] = {'M','D'};
+        BOOST_REQUIRE(nullptr == read.get_string_tag(mdtag));
+    }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
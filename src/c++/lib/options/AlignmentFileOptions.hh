@@ -30,4 +30,12 @@ struct AlignmentFileOptions
     typedef std::vector<std::string> files_t;
 
     files_t alignmentFilenames;
+
+    /// Number of threads in the htslib thread pool shared by all input alignment streams for BAM decompression and
+    /// CRAM decoding. 0 disables the shared pool, so that each stream is decoded on the thread reading it.
+    unsigned decodeThreadCount = 0;
+
+    /// Number of records each input alignment stream may decode ahead of the caller on its own read-ahead thread.
+    /// 0 disables read-ahead, so that records are decoded on demand by the thread reading the stream.
+    unsigned readAheadRecordCount = 0;
 };
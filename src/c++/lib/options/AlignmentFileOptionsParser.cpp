@@ -26,13 +26,17 @@
 
 boost::program_options::options_description
 getOptionsDescription(
-    AlignmentFileOptions& /*opt*/)
+    AlignmentFileOptions& opt)
 {
     namespace po = boost::program_options;
     po::options_description desc("alignment-files");
     desc.add_options()
     ("align-file", po::value<AlignmentFileOptions::files_t>(),
      "alignment file in BAM or CRAM format (may be specified multiple times)")
+    ("decode-threads", po::value(&opt.decodeThreadCount)->default_value(opt.decodeThreadCount),
+     "number of threads shared by all input alignment files for BAM decompression and CRAM decoding (0 disables)")
+    ("read-ahead-records", po::value(&opt.readAheadRecordCount)->default_value(opt.readAheadRecordCount),
+     "number of records decoded ahead of variant calling on a separate thread for each input alignment file (0 disables)")
     ;
     return desc;
 }
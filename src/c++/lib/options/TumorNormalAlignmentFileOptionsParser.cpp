@@ -30,7 +30,7 @@
 
 boost::program_options::options_description
 getOptionsDescription(
-    TumorNormalAlignmentFileOptions& /*opt*/)
+    TumorNormalAlignmentFileOptions& opt)
 {
     namespace po = boost::program_options;
     po::options_description desc("alignment-files");
@@ -39,6 +39,10 @@ getOptionsDescription(
      "normal sample alignment file in BAM or CRAM format (exactly one file required)")
     ("tumor-align-file", po::value<AlignmentFileOptions::files_t>(),
      "tumor sample alignment file in BAM or CRAM format (exactly one file required)")
+    ("decode-threads", po::value(&opt.decodeThreadCount)->default_value(opt.decodeThreadCount),
+     "number of threads shared by all input alignment files for BAM decompression and CRAM decoding (0 disables)")
+    ("read-ahead-records", po::value(&opt.readAheadRecordCount)->default_value(opt.readAheadRecordCount),
+     "number of records decoded ahead of variant calling on a separate thread for each input alignment file (0 disables)")
     ;
     return desc;
 }
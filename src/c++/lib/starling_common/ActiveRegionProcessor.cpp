@@ -588,7 +588,11 @@ void ActiveRegionProcessor::discoverIndelsAndMismatches(
     // There are cases that the active region was not triggered at the right position.
     // E.g. ref: GTCGAT, AR: TCGAT, Hap: T[ATAT]CGAT. In this case, T->TATAT should be left-shifted.
     //
-    _aligner.align(haplotypeSeq.cbegin(),haplotypeSeq.cend(),_refSegment.cbegin(),_refSegment.cend(),result);
+    // Indels longer than _maxIndelSize are not reported below, so the alignment is banded to this size. The
+    // aligner falls back to the full alignment when the band could change the result.
+    //
+    _aligner.alignBanded(haplotypeSeq.cbegin(),haplotypeSeq.cend(),_refSegment.cbegin(),_refSegment.cend(),
+                         _maxIndelSize,result);
 
     const ALIGNPATH::path_t& alignPath = result.align.apath;
 
@@ -129,6 +129,20 @@ resetRegion(const std::string& region)
 
 
 
+BamRecordFilterCounts
+HtsMergeStreamer::
+getBamRecordFilterCounts() const
+{
+    BamRecordFilterCounts counts;
+    for (const auto& bamStreamer : _data._bam)
+    {
+        counts.merge(bamStreamer->getRecordFilterCounts());
+    }
+    return counts;
+}
+
+
+
 bool
 HtsMergeStreamer::
 next()
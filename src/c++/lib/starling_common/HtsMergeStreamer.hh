@@ -124,12 +124,25 @@ struct HtsMergeStreamer
     ///
     /// registration order will be used to order all inputs with the same position
     ///
+    /// \param[in] decodeThreadPoolPtr Optional htslib thread pool shared by all alignment streams for decompression and
+    ///                                CRAM decoding. If provided, the pool must outlive this object.
+    /// \param[in] readAheadRecordCount If non-zero, records of this stream are decoded on a separate read-ahead
+    ///                                 thread up to this many records ahead of the merged stream
+    /// \param[in] filterSpec Records of this stream matching the filter are removed before they enter the merged
+    ///                       stream
     const bam_streamer&
     registerBam(
         const std::string& bamFilename,
-        const unsigned index = 0)
+        const unsigned index = 0,
+        HtsDecodeThreadPool* decodeThreadPoolPtr = nullptr,
+        const unsigned readAheadRecordCount = 0,
+        const BamRecordFilterSpec& filterSpec = BamRecordFilterSpec())
     {
-        return registerHtsType(bamFilename, index,_data._bam);
+        std::unique_ptr<bam_streamer> bamStreamer(
+            new bam_streamer(bamFilename.c_str(), _referenceFilename.c_str(), getRegionPtr(), decodeThreadPoolPtr));
+        if (readAheadRecordCount > 0) bamStreamer->enableReadAhead(readAheadRecordCount);
+        bamStreamer->setRecordFilter(filterSpec);
+        return registerHtsStreamer(std::move(bamStreamer), index, _data._bam);
     }
 
     /// \param[in] requireNonZeroRegionLength If true, an exception is thrown for any input bed record which with region
@@ -218,6 +231,13 @@ struct HtsMergeStreamer
         return getHtsStreamer(getCurrent().order, _data._vcf);
     }
 
+    /// \brief Number of records removed by the record filters of all registered BAM/CRAM streams since the last
+    ///        call to resetRegion()
+    ///
+    /// The counts are only complete once next() has returned false.
+    BamRecordFilterCounts
+    getBamRecordFilterCounts() const;
+
 private:
 
     struct HtsData
@@ -306,12 +326,25 @@ private:
         const unsigned index,
         std::vector<std::unique_ptr<T>>& htsStreamerVec,
         const bool isHighStringencyMode = false)
+    {
+        std::unique_ptr<T> htsStreamer(
+            HTS_TYPE::htsTypeFactory<T>(htsFilename.c_str(), _referenceFilename.c_str(), getRegionPtr(), isHighStringencyMode));
+        return registerHtsStreamer(std::move(htsStreamer), index, htsStreamerVec);
+    }
+
+    /// Register an hts streamer which has already been constructed for the current region
+    template <typename T>
+    const T&
+    registerHtsStreamer(
+        std::unique_ptr<T> htsStreamer,
+        const unsigned index,
+        std::vector<std::unique_ptr<T>>& htsStreamerVec)
     {
         static const HTS_TYPE::index_t htsType(HTS_TYPE::getStreamType<T>());
         assert(! _isStreamBegin);
         const unsigned htsTypeIndex(htsStreamerVec.size());
         const unsigned orderIndex(_order.size());
-        htsStreamerVec.emplace_back(HTS_TYPE::htsTypeFactory<T>(htsFilename.c_str(), _referenceFilename.c_str(), getRegionPtr(), isHighStringencyMode));
+        htsStreamerVec.push_back(std::move(htsStreamer));
         _order.emplace_back(htsType, index, htsTypeIndex);
         queueItem(orderIndex);
         return *(htsStreamerVec.back());
@@ -27,7 +27,23 @@
 #include "calibration/IndelErrorModel.hh"
 #include "starling_common/AlleleReportInfoUtil.hh"
 
+#include "boost/make_unique.hpp"
+
+#include <algorithm>
 #include <iostream>
+#include <limits>
+
+
+
+/// order position slot entries by IndelKey
+static
+bool
+isEntryKeyLess(
+    const std::unique_ptr<IndelBuffer::indel_buffer_entry_t>& entryPtr,
+    const IndelKey& indelKey)
+{
+    return (entryPtr->first < indelKey);
+}
 
 
 
@@ -52,10 +68,8 @@ rangeIterator(
     const pos_t begin_pos,
     const pos_t end_pos)
 {
-    const IndelKey end_range_key(end_pos);
-    const iterator end(_indelBuffer.lower_bound(end_range_key));
-    const IndelKey begin_range_key(begin_pos-static_cast<pos_t>(_opt.maxIndelSize));
-    iterator begin(_indelBuffer.lower_bound(begin_range_key));
+    const iterator end(positionIterator(end_pos));
+    iterator begin(positionIterator(begin_pos-static_cast<pos_t>(_opt.maxIndelSize)));
     for (; begin!=end; ++begin)
     {
         if (begin->first.right_pos() >= begin_pos) break;
@@ -69,9 +83,8 @@ rangeIterator(
 // range [begin_pos,end_pos]. Returning indels in addition to this set is
 // acceptable.
 //
-// The indels_keys: "end_range_key" and "begin_range_key" take
-// advantage of the indel NONE type, which sorts ahead of all other
-// types at the same position.
+// Both range ends are found with positionIterator, which returns the
+// first indel at or after the given left-most position.
 //
 std::pair<IndelBuffer::const_iterator,IndelBuffer::const_iterator>
 IndelBuffer::
@@ -79,10 +92,8 @@ rangeIterator(
     const pos_t begin_pos,
     const pos_t end_pos) const
 {
-    const IndelKey end_range_key(end_pos);
-    const const_iterator end(_indelBuffer.lower_bound(end_range_key));
-    const IndelKey begin_range_key(begin_pos-static_cast<pos_t>(_opt.maxIndelSize));
-    const_iterator begin(_indelBuffer.lower_bound(begin_range_key));
+    const const_iterator end(positionIterator(end_pos));
+    const_iterator begin(positionIterator(begin_pos-static_cast<pos_t>(_opt.maxIndelSize)));
     for (; begin!=end; ++begin)
     {
         if (begin->first.right_pos() >= begin_pos) break;
@@ -102,20 +113,20 @@ addIndelObservation(
     assert(obs.key.type != INDEL::NONE);
 
     // if not previously observed
-    iterator indelIter(_indelBuffer.find(obs.key));
-    const bool isNovel(indelIter == _indelBuffer.end());
+    position_slot_t& slot(_indelSlots.getRef(obs.key.pos));
+    auto slotIter(std::lower_bound(slot.begin(), slot.end(), obs.key, isEntryKeyLess));
+    const bool isNovel((slotIter == slot.end()) || (obs.key < (*slotIter)->first));
     if (isNovel)
     {
-        const auto retval = _indelBuffer.insert(std::make_pair(obs.key,IndelData(getSampleCount(), obs.key)));
-        indelIter = retval.first;
+        slotIter = slot.insert(slotIter, boost::make_unique<indel_buffer_entry_t>(obs.key,IndelData(getSampleCount(), obs.key)));
     }
 
-    IndelData& indelData(getIndelData(indelIter));
+    IndelData& indelData((*slotIter)->second);
     if (isNovel)
     {
         indelData.initializeAuxInfo(_opt,_dopt, _ref);
 
-        const auto& indelKey(indelIter->first);
+        const auto& indelKey((*slotIter)->first);
         const bool isPrimitive = (
                                      indelKey.isMismatch() ||
                                      indelKey.isPrimitiveInsertionAllele() ||
@@ -306,13 +317,46 @@ findDataException(const IndelKey& indelKey) const
 
 
 
+IndelBuffer::indel_buffer_entry_t*
+IndelBuffer::
+findEntry(
+    const IndelKey& indelKey,
+    unsigned& entryIndex) const
+{
+    if (! _indelSlots.isKeyPresent(indelKey.pos)) return nullptr;
+    const position_slot_t& slot(_indelSlots.getConstRef(indelKey.pos));
+    const auto slotIter(std::lower_bound(slot.begin(), slot.end(), indelKey, isEntryKeyLess));
+    if ((slotIter == slot.end()) || (indelKey < (*slotIter)->first)) return nullptr;
+    entryIndex = (slotIter - slot.begin());
+    return slotIter->get();
+}
+
+
+
 void
 IndelBuffer::
 clearIndelsAtPosition(const pos_t pos)
 {
-    const iterator i_begin(positionIterator(pos));
-    const iterator i_end(positionIterator(pos + 1));
-    _indelBuffer.erase(i_begin,i_end);
+    if (! _indelSlots.isKeyPresent(pos)) return;
+
+    // release the slot's entries now rather than when the position is reused:
+    _indelSlots.getRef(pos).clear();
+    _indelSlots.erase(pos);
+}
+
+
+
+void
+IndelBuffer::
+clearIndels()
+{
+    pos_t pos(std::numeric_limits<pos_t>::lowest());
+    while (_indelSlots.getNextPresentKey(pos, pos))
+    {
+        _indelSlots.getRef(pos).clear();
+        pos++;
+    }
+    _indelSlots.clear();
 }
 
 
@@ -350,7 +394,7 @@ IndelBuffer::
 dump(std::ostream& os) const
 {
     os << "INDEL_BUFFER DUMP ON\n";
-    dump_range(_indelBuffer.begin(),_indelBuffer.end(),os);
+    dump_range(positionIterator(std::numeric_limits<pos_t>::lowest()),const_iterator(),os);
     os << "INDEL_BUFFER DUMP OFF\n";
 }
 
@@ -25,10 +25,15 @@
 
 
 #include "blt_util/depth_buffer.hh"
+#include "blt_util/RangeMap.hh"
 #include "starling_common/indel.hh"
 #include "starling_common/min_count_binom_gte_cache.hh"
 #include "starling_common/starling_base_shared.hh"
 
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 
@@ -74,9 +79,101 @@ struct IndelBuffer
     }
 
     typedef IndelData indel_buffer_value_t;
-    typedef std::map<IndelKey,indel_buffer_value_t> indel_buffer_data_t;
-    typedef indel_buffer_data_t::iterator iterator;
-    typedef indel_buffer_data_t::const_iterator const_iterator;
+    typedef std::pair<const IndelKey,indel_buffer_value_t> indel_buffer_entry_t;
+
+    /// forward iterator over buffered indels in IndelKey order
+    ///
+    /// iterators remain valid when indels are added at other positions, but adding or clearing
+    /// indels at the iterator's own position invalidates it
+    ///
+    template <typename EntryType>
+    struct iterator_base
+    {
+        typedef std::forward_iterator_tag iterator_category;
+        typedef EntryType value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef EntryType* pointer;
+        typedef EntryType& reference;
+
+        iterator_base() = default;
+
+        /// allow iterator to const_iterator conversion
+        template <typename OtherEntryType,
+                  typename = typename std::enable_if<std::is_convertible<OtherEntryType*,EntryType*>::value>::type>
+        iterator_base(
+            const iterator_base<OtherEntryType>& rhs)
+            : _buffer(rhs._buffer)
+            , _pos(rhs._pos)
+            , _entryIndex(rhs._entryIndex)
+            , _entry(rhs._entry)
+        {}
+
+        reference
+        operator*() const
+        {
+            return *_entry;
+        }
+
+        pointer
+        operator->() const
+        {
+            return _entry;
+        }
+
+        iterator_base&
+        operator++()
+        {
+            _entryIndex++;
+            _entry = _buffer->seekEntry(_pos, _entryIndex);
+            return *this;
+        }
+
+        iterator_base
+        operator++(int)
+        {
+            iterator_base tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        template <typename OtherEntryType>
+        bool
+        operator==(const iterator_base<OtherEntryType>& rhs) const
+        {
+            return (_entry == rhs._entry);
+        }
+
+        template <typename OtherEntryType>
+        bool
+        operator!=(const iterator_base<OtherEntryType>& rhs) const
+        {
+            return (_entry != rhs._entry);
+        }
+
+    private:
+        friend struct IndelBuffer;
+        template <typename> friend struct iterator_base;
+
+        iterator_base(
+            const IndelBuffer& buffer,
+            const pos_t pos,
+            const unsigned entryIndex)
+            : _buffer(&buffer)
+            , _pos(pos)
+            , _entryIndex(entryIndex)
+            , _entry(buffer.seekEntry(_pos, _entryIndex))
+        {}
+
+        const IndelBuffer* _buffer = nullptr;
+        pos_t _pos = 0;
+        unsigned _entryIndex = 0;
+
+        /// nullptr for the end iterator
+        EntryType* _entry = nullptr;
+    };
+
+    typedef iterator_base<indel_buffer_entry_t> iterator;
+    typedef iterator_base<const indel_buffer_entry_t> const_iterator;
 
     /// \returns true if this indel is novel to the buffer
     ///
@@ -89,13 +186,13 @@ struct IndelBuffer
     iterator
     positionIterator(const pos_t pos)
     {
-        return _indelBuffer.lower_bound(IndelKey(pos));
+        return iterator(*this, pos, 0);
     }
 
     const_iterator
     positionIterator(const pos_t pos) const
     {
-        return _indelBuffer.lower_bound(IndelKey(pos));
+        return const_iterator(*this, pos, 0);
     }
 
     /// position iterators which return (at least) all indels with a
@@ -120,31 +217,35 @@ struct IndelBuffer
     indel_buffer_value_t*
     getIndelDataPtr(const IndelKey& indelKey)
     {
-        const iterator i(_indelBuffer.find(indelKey));
-        return ((i==_indelBuffer.end()) ? nullptr : &(i->second) );
+        unsigned entryIndex(0);
+        indel_buffer_entry_t* entryPtr(findEntry(indelKey, entryIndex));
+        return ((nullptr == entryPtr) ? nullptr : &(entryPtr->second) );
     }
 
     const indel_buffer_value_t*
     getIndelDataPtr(const IndelKey& indelKey) const
     {
-        const const_iterator i(_indelBuffer.find(indelKey));
-        return ((i==_indelBuffer.end()) ? nullptr : &(i->second) );
+        unsigned entryIndex(0);
+        const indel_buffer_entry_t* entryPtr(findEntry(indelKey, entryIndex));
+        return ((nullptr == entryPtr) ? nullptr : &(entryPtr->second) );
     }
 
     iterator
     getIndelIter(const IndelKey& indelKey)
     {
-        const iterator iter(_indelBuffer.find(indelKey));
-        assert(iter != _indelBuffer.end());
-        return iter;
+        unsigned entryIndex(0);
+        const indel_buffer_entry_t* entryPtr(findEntry(indelKey, entryIndex));
+        assert(nullptr != entryPtr);
+        return iterator(*this, indelKey.pos, entryIndex);
     }
 
     const_iterator
     getIndelIter(const IndelKey& indelKey) const
     {
-        const const_iterator iter(_indelBuffer.find(indelKey));
-        assert(iter != _indelBuffer.end());
-        return iter;
+        unsigned entryIndex(0);
+        const indel_buffer_entry_t* entryPtr(findEntry(indelKey, entryIndex));
+        assert(nullptr != entryPtr);
+        return const_iterator(*this, indelKey.pos, entryIndex);
     }
 
     /// is an indel treated as a candidate for genotype calling and
@@ -179,15 +280,12 @@ struct IndelBuffer
 
     /// clear all indel data, but not sample info
     void
-    clearIndels()
-    {
-        _indelBuffer.clear();
-    }
+    clearIndels();
 
     bool
     empty() const
     {
-        return _indelBuffer.empty();
+        return _indelSlots.empty();
     }
 
     // debug dumpers:
@@ -207,6 +305,40 @@ struct IndelBuffer
 
 private:
 
+    /// all indels sharing the same left-most position, sorted by IndelKey
+    ///
+    /// entries are individually allocated so that their addresses are stable for client references
+    typedef std::vector<std::unique_ptr<indel_buffer_entry_t>> position_slot_t;
+
+    /// \return the first entry at or after position slot entry (pos,entryIndex), or nullptr if there is none
+    ///
+    /// pos and entryIndex are updated to the location of the returned entry
+    indel_buffer_entry_t*
+    seekEntry(
+        pos_t& pos,
+        unsigned& entryIndex) const
+    {
+        pos_t slotPos(pos);
+        while (_indelSlots.getNextPresentKey(pos, slotPos))
+        {
+            if (slotPos != pos) entryIndex = 0;
+            pos = slotPos;
+            const position_slot_t& slot(_indelSlots.getConstRef(pos));
+            if (entryIndex < slot.size()) return slot[entryIndex].get();
+            pos++;
+            entryIndex = 0;
+        }
+        return nullptr;
+    }
+
+    /// \return entry matching indelKey or nullptr if the indel is not in the buffer
+    ///
+    /// \param[out] entryIndex index of the returned entry within its position slot
+    indel_buffer_entry_t*
+    findEntry(
+        const IndelKey& indelKey,
+        unsigned& entryIndex) const;
+
     /// helper struct for IndelBuffer
     struct IndelBufferSampleData
     {
@@ -285,7 +417,10 @@ private:
     bool _isFinalized = false;
     double _maxCandidateDepth = -1.0;
     indelSampleData_t _indelSampleData;
-    indel_buffer_data_t _indelBuffer;
+
+    /// indels are bucketed by left-most position in a position-keyed ring, so that
+    /// per-position lookup and clearing avoid a tree traversal and per-node allocation
+    RangeMap<pos_t,position_slot_t,ClearT<position_slot_t>> _indelSlots;
 };
 
 
@@ -31,12 +31,14 @@
 #include "starling_common/starling_base_shared.hh"
 #include "starling_common/starling_types.hh"
 
+#include "boost/container/flat_map.hpp"
+#include "boost/container/flat_set.hpp"
+
 #include <cassert>
 
 #include <iosfwd>
 #include <map>
 #include <string>
-#include <set>
 #include <vector>
 
 
@@ -246,7 +248,10 @@ struct IndelSampleData
     // tier2 mapping criteria. All other (non-noise) observations are
     // categorized as submapped
     //
-    typedef std::set<align_id_t> evidence_t;
+    // read ids mostly arrive in increasing order, so sorted vector storage
+    // keeps insertion cheap while avoiding a node allocation per read
+    //
+    typedef boost::container::flat_set<align_id_t> evidence_t;
     evidence_t tier1_map_read_ids;
     evidence_t tier2_map_read_ids;
     evidence_t submap_read_ids;
@@ -259,7 +264,7 @@ struct IndelSampleData
     // enumerates support for the indel among all reads
     // which cross an indel breakpoint by a sufficient margin after
     // re-alignment:
-    typedef std::map<align_id_t,ReadPathScores> score_t;
+    typedef boost::container::flat_map<align_id_t,ReadPathScores> score_t;
     score_t read_path_lnp;
 
     // the reads which cross an indel breakpoint, but not by enough
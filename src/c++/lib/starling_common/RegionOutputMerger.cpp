@@ -0,0 +1,91 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+
+#include "RegionOutputMerger.hh"
+
+#include <cassert>
+
+#include <iostream>
+#include <sstream>
+
+
+
+RegionOutputMerger::
+RegionOutputMerger(
+    const std::vector<std::ostream*>& outputStreams,
+    const unsigned regionCount)
+    : _outputStreams(outputStreams),
+      _regionOutput(regionCount),
+      _isRegionComplete(regionCount, false)
+{}
+
+
+
+void
+RegionOutputMerger::
+addRegionOutput(
+    const unsigned regionIndex,
+    const std::vector<std::ostream*>& bufferStreams)
+{
+    const unsigned streamCount(_outputStreams.size());
+    assert(bufferStreams.size() == streamCount);
+
+    // extract worker buffers before taking the lock:
+    std::vector<std::string> regionOutput(streamCount);
+    for (unsigned streamIndex(0); streamIndex < streamCount; ++streamIndex)
+    {
+        if (bufferStreams[streamIndex] == nullptr) continue;
+        std::ostringstream* bufferPtr(dynamic_cast<std::ostringstream*>(bufferStreams[streamIndex]));
+        assert(bufferPtr != nullptr);
+        regionOutput[streamIndex] = bufferPtr->str();
+        bufferPtr->str("");
+    }
+
+    std::lock_guard<std::mutex> guard(_lock);
+
+    assert(regionIndex < _isRegionComplete.size());
+    assert(not _isRegionComplete[regionIndex]);
+    _regionOutput[regionIndex] = std::move(regionOutput);
+    _isRegionComplete[regionIndex] = true;
+
+    writeReadyRegions();
+}
+
+
+
+void
+RegionOutputMerger::
+writeReadyRegions()
+{
+    const unsigned regionCount(_isRegionComplete.size());
+    const unsigned streamCount(_outputStreams.size());
+    while ((_nextRegionIndex < regionCount) and _isRegionComplete[_nextRegionIndex])
+    {
+        std::vector<std::string>& regionOutput(_regionOutput[_nextRegionIndex]);
+        for (unsigned streamIndex(0); streamIndex < streamCount; ++streamIndex)
+        {
+            if (_outputStreams[streamIndex] == nullptr) continue;
+            *(_outputStreams[streamIndex]) << regionOutput[streamIndex];
+        }
+        std::vector<std::string>().swap(regionOutput);
+        _nextRegionIndex++;
+    }
+}
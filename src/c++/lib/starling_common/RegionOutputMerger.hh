@@ -0,0 +1,75 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Ordered merge of region output produced by multiple region worker threads
+///
+
+#pragma once
+
+#include "boost/utility.hpp"
+
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+/// \brief Writes buffered per-region record output to the final output streams in region order
+///
+/// Each region worker thread records output into its own set of in-memory (std::ostringstream) streams, which
+/// are matched index-for-index with the final output streams. When a region is complete the worker hands the
+/// buffered output to this object, which writes all regions that are next in order and holds any others until
+/// the preceding regions are complete.
+///
+/// All public methods are thread-safe.
+///
+struct RegionOutputMerger : private boost::noncopyable
+{
+    /// \param[in] outputStreams final output streams, null entries correspond to disabled outputs
+    /// \param[in] regionCount total number of regions expected
+    RegionOutputMerger(
+        const std::vector<std::ostream*>& outputStreams,
+        const unsigned regionCount);
+
+    /// \brief Transfer the output of one completed region out of a worker's buffer streams
+    ///
+    /// The buffer streams are cleared by this call so that they can be reused for the worker's next region.
+    ///
+    /// \param[in] bufferStreams worker output buffers, these must be std::ostringstream objects (or null)
+    ///                          in the same order as the output streams provided to the ctor
+    void
+    addRegionOutput(
+        const unsigned regionIndex,
+        const std::vector<std::ostream*>& bufferStreams);
+
+private:
+    void
+    writeReadyRegions();
+
+    std::mutex _lock;
+    std::vector<std::ostream*> _outputStreams;
+
+    /// buffered output of each region not yet written, indexed on region index and then stream index
+    std::vector<std::vector<std::string>> _regionOutput;
+    std::vector<bool> _isRegionComplete;
+
+    /// index of the next region to be written to the output streams
+    unsigned _nextRegionIndex = 0;
+};
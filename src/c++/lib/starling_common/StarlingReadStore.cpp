@@ -0,0 +1,104 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Recycling store of buffered reads, indexed by read id
+///
+
+#include "starling_common/StarlingReadStore.hh"
+
+#include <cassert>
+
+
+starling_read&
+StarlingReadStore::
+insert(
+    const bam_record& br,
+    const alignment& inputAlignment,
+    const MAPLEVEL::index_t inputAlignmentMapLevel,
+    const align_id_t readIndex)
+{
+    if (_slots.empty())
+    {
+        _beginReadIndex = readIndex;
+    }
+    else
+    {
+        assert(readIndex >= (_beginReadIndex + _slots.size()));
+    }
+
+    // skip any ids which were not inserted in this store:
+    _slots.resize(readIndex - _beginReadIndex);
+
+    if (_recycledReads.empty())
+    {
+        _slots.emplace_back(new starling_read(br, inputAlignment, inputAlignmentMapLevel, readIndex));
+    }
+    else
+    {
+        _slots.push_back(std::move(_recycledReads.back()));
+        _recycledReads.pop_back();
+        _slots.back()->reset(br, inputAlignment, inputAlignmentMapLevel, readIndex);
+    }
+    _size++;
+    return *(_slots.back());
+}
+
+
+
+void
+StarlingReadStore::
+erase(const align_id_t readIndex)
+{
+    if ((readIndex < _beginReadIndex) || (readIndex >= (_beginReadIndex + _slots.size()))) return;
+
+    read_ptr_t& slot(_slots[readIndex - _beginReadIndex]);
+    if (! slot) return;
+
+    _recycledReads.push_back(std::move(slot));
+    _size--;
+    trimFront();
+}
+
+
+
+void
+StarlingReadStore::
+clear()
+{
+    for (read_ptr_t& slot : _slots)
+    {
+        if (slot) _recycledReads.push_back(std::move(slot));
+    }
+    _slots.clear();
+    _size = 0;
+}
+
+
+
+void
+StarlingReadStore::
+trimFront()
+{
+    while ((! _slots.empty()) && (! _slots.front()))
+    {
+        _slots.pop_front();
+        _beginReadIndex++;
+    }
+}
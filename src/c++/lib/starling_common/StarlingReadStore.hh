@@ -0,0 +1,120 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Recycling store of buffered reads, indexed by read id
+///
+
+#pragma once
+
+#include "starling_common/starling_read.hh"
+
+#include "boost/utility.hpp"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+
+/// \brief Store buffered reads in a ring of slots indexed by read id
+///
+/// Read ids are assigned in increasing order as reads enter the read buffer and reads leave the buffer
+/// approximately in the same order, so all live reads are held in a contiguous window of slots starting at the
+/// lowest live read id, and the window is trimmed from the front as the buffer advances. The window may contain
+/// empty slots, for instance for reads removed out of order or ids assigned to another sample's buffer.
+///
+/// Removed read objects are retained for reuse by later reads, so that the read object, its BAM record data and
+/// its read segment alignments are allocated once and then recycled in place. The retained objects are bounded by
+/// the maximum number of reads held in the store at any one time.
+///
+struct StarlingReadStore : private boost::noncopyable
+{
+    /// \brief Insert a new read
+    ///
+    /// \param readIndex Read id of the new read, this must be greater than the id of any read previously inserted
+    ///                  since the store was last empty
+    ///
+    /// All other arguments are passed to the starling_read constructor.
+    ///
+    /// \return The new read
+    starling_read&
+    insert(
+        const bam_record& br,
+        const alignment& inputAlignment,
+        const MAPLEVEL::index_t inputAlignmentMapLevel,
+        const align_id_t readIndex);
+
+    /// \return Pointer to read, or nullptr if the read is not in the store
+    starling_read*
+    get(const align_id_t readIndex)
+    {
+        if ((readIndex < _beginReadIndex) || (readIndex >= (_beginReadIndex + _slots.size()))) return nullptr;
+        return _slots[readIndex - _beginReadIndex].get();
+    }
+
+    /// \return Pointer to read, or nullptr if the read is not in the store
+    const starling_read*
+    get(const align_id_t readIndex) const
+    {
+        return const_cast<StarlingReadStore*>(this)->get(readIndex);
+    }
+
+    /// \brief Remove a read from the store, this has no effect if the read is not in the store
+    void
+    erase(const align_id_t readIndex);
+
+    /// \brief Remove all reads from the store
+    void
+    clear();
+
+    /// \return Number of reads in the store
+    unsigned
+    size() const
+    {
+        return _size;
+    }
+
+    bool
+    empty() const
+    {
+        return (_size == 0);
+    }
+
+    /// \return Number of removed read objects retained for reuse
+    unsigned
+    getRecycledReadCount() const
+    {
+        return _recycledReads.size();
+    }
+
+private:
+    typedef std::unique_ptr<starling_read> read_ptr_t;
+
+    /// Remove empty slots from the front of the slot window
+    void
+    trimFront();
+
+    /// Slot for each read id from _beginReadIndex
+    std::deque<read_ptr_t> _slots;
+    align_id_t _beginReadIndex = 0;
+    unsigned _size = 0;
+
+    /// Removed read objects available for reuse
+    std::vector<read_ptr_t> _recycledReads;
+};
@@ -0,0 +1,110 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Deterministic cap on the number of reads retained at each alignment start position
+///
+
+#include "starling_common/StartPosReadDownsampler.hh"
+
+#include <algorithm>
+
+
+StartPosReadDownsampler::
+StartPosReadDownsampler(const unsigned maxReadsPerStartPos)
+    : _maxReadsPerStartPos(maxReadsPerStartPos)
+{
+    assert(_maxReadsPerStartPos > 0);
+}
+
+
+
+void
+StartPosReadDownsampler::
+addRead(
+    const bam_record& br,
+    const alignment& al,
+    const MAPLEVEL::index_t maplev)
+{
+    assert(empty() || (al.pos == getStartPos()));
+
+    ReadKey key;
+    key.hash = getReadNameHash(br.qname());
+    key.inputIndex = _inputReadCount++;
+
+    if (_retainedReads.size() < _maxReadsPerStartPos)
+    {
+        // slots [0,size) are always in use by the retained reads:
+        key.slotIndex = _retainedReads.size();
+        if (key.slotIndex == _slots.size()) _slots.emplace_back();
+        _retainedReads.push_back(key);
+    }
+    else
+    {
+        _droppedReadCount++;
+        if (! (key < _retainedReads.front())) return;
+
+        // replace the retained read with the highest priority value:
+        std::pop_heap(_retainedReads.begin(), _retainedReads.end());
+        key.slotIndex = _retainedReads.back().slotIndex;
+        _retainedReads.back() = key;
+    }
+    std::push_heap(_retainedReads.begin(), _retainedReads.end());
+
+    PendingRead& read(_slots[key.slotIndex]);
+    read.br = br;
+    read.al = al;
+    read.maplev = maplev;
+}
+
+
+
+uint64_t
+StartPosReadDownsampler::
+getReadNameHash(const char* readName)
+{
+    assert(nullptr != readName);
+
+    // 64-bit FNV-1a:
+    uint64_t hash(0xcbf29ce484222325ULL);
+    for (; *readName != '\0'; ++readName)
+    {
+        hash ^= static_cast<uint8_t>(*readName);
+        hash *= 0x100000001b3ULL;
+    }
+
+    // finish with the splitmix64 mixing function, so that read names differing only in their final characters
+    // are spread over the full hash range:
+    hash ^= (hash >> 30);
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= (hash >> 27);
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= (hash >> 31);
+    return hash;
+}
+
+
+
+void
+StartPosReadDownsampler::
+sortRetainedReadsByInputOrder()
+{
+    std::sort(_retainedReads.begin(), _retainedReads.end(),
+              [](const ReadKey& a, const ReadKey& b) { return (a.inputIndex < b.inputIndex); });
+}
@@ -0,0 +1,142 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \brief Deterministic cap on the number of reads retained at each alignment start position
+///
+
+#pragma once
+
+#include "blt_common/map_level.hh"
+#include "htsapi/bam_record.hh"
+#include "starling_common/alignment.hh"
+
+#include "boost/utility.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+
+/// \brief Retain at most a fixed number of reads at each alignment start position of one sample
+///
+/// Reads are added in alignment start position order and held until all reads of the current start position have
+/// been seen. When more reads than the limit start at the same position, the reads with the lowest hash value of
+/// the read name are retained, so that the selected reads do not depend on the order of reads within the input
+/// and both reads of a pair starting at the same position are retained or dropped together. The retained reads
+/// are returned in input order by flush().
+///
+/// Only the retained reads are stored, and the storage of dropped reads is reused by later reads.
+///
+struct StartPosReadDownsampler : private boost::noncopyable
+{
+    /// \param maxReadsPerStartPos Maximum number of reads retained at each start position, this must be positive
+    explicit
+    StartPosReadDownsampler(const unsigned maxReadsPerStartPos);
+
+    /// \brief Add a read starting at the current start position
+    ///
+    /// The read's start position must equal that of the other reads held in the downsampler, so any reads at a
+    /// previous start position must be flushed before adding the first read at a new start position.
+    void
+    addRead(
+        const bam_record& br,
+        const alignment& al,
+        const MAPLEVEL::index_t maplev);
+
+    /// \brief Call \p readFunc(br, al, maplev) for each retained read in input order, then remove all reads
+    template <typename ReadFunc>
+    void
+    flush(ReadFunc readFunc)
+    {
+        sortRetainedReadsByInputOrder();
+        for (const ReadKey& key : _retainedReads)
+        {
+            const PendingRead& read(_slots[key.slotIndex]);
+            readFunc(read.br, read.al, read.maplev);
+        }
+        _retainedReads.clear();
+        _inputReadCount = 0;
+    }
+
+    bool
+    empty() const
+    {
+        return _retainedReads.empty();
+    }
+
+    /// \return Alignment start position of all reads currently held in the downsampler
+    pos_t
+    getStartPos() const
+    {
+        assert(! empty());
+        return _slots[_retainedReads.front().slotIndex].al.pos;
+    }
+
+    /// \return Total number of reads dropped over the lifetime of the downsampler
+    unsigned long
+    getDroppedReadCount() const
+    {
+        return _droppedReadCount;
+    }
+
+    /// \return The hash of \p readName used to select reads, identical across runs and platforms
+    static
+    uint64_t
+    getReadNameHash(const char* readName);
+
+private:
+    struct PendingRead
+    {
+        bam_record br;
+        alignment al;
+        MAPLEVEL::index_t maplev = MAPLEVEL::UNKNOWN;
+    };
+
+    /// Selection priority of one retained read, lower values are retained first
+    struct ReadKey
+    {
+        bool
+        operator<(const ReadKey& rhs) const
+        {
+            if (hash != rhs.hash) return (hash < rhs.hash);
+            return (inputIndex < rhs.inputIndex);
+        }
+
+        uint64_t hash;
+        unsigned inputIndex;
+        unsigned slotIndex;
+    };
+
+    void
+    sortRetainedReadsByInputOrder();
+
+    const unsigned _maxReadsPerStartPos;
+
+    /// Number of reads added at the current start position
+    unsigned _inputReadCount = 0;
+
+    /// Keys of the retained reads, organized as a max-heap until the reads are flushed
+    std::vector<ReadKey> _retainedReads;
+
+    /// Read storage, indexed by ReadKey::slotIndex
+    std::vector<PendingRead> _slots;
+
+    unsigned long _droppedReadCount = 0;
+};
@@ -23,6 +23,7 @@
 
 #include "starling_common/pos_basecall_buffer.hh"
 
+#include <algorithm>
 #include <iostream>
 
 
@@ -42,9 +43,8 @@ dump(std::ostream& /*os*/) const
 
 void
 pos_basecall_buffer::
-updateGermlineScoringMetrics(
-    const char refchar,
-    const pos_t pos,
+insertGermlineScoringObservation(
+    snp_pos_info& posdata,
     const uint8_t call_id,
     const uint8_t qscore,
     const uint8_t mapq,
@@ -52,34 +52,30 @@ updateGermlineScoringMetrics(
     const unsigned distanceFromReadEdge,
     const bool is_submapped)
 {
-    const bool is_reference(refchar==id_to_base(call_id));
-
-    auto& posdata(_pdata.getRef(pos));
-    posdata.mq_ranksum.add_observation(is_reference,static_cast<unsigned>(mapq));
-    if (! is_submapped)
-    {
-        posdata.baseq_ranksum.add_observation(is_reference,static_cast<unsigned>(qscore));
-        posdata.readPositionRankSum.add_observation(is_reference,cycle);
-        if (not is_reference)
-        {
-            // maxDistance may help the mean edge distance better generalize over different read lengths:
-            static const unsigned maxDistanceFromEdge(20);
-            posdata.distanceFromReadEdge.addObservation(std::min(maxDistanceFromEdge, distanceFromReadEdge));
-        }
-    }
+    snp_pos_info::ScoringObservation obs;
+    obs.readPos = cycle;
+    obs.distanceFromReadEdge = static_cast<uint8_t>(std::min(snp_pos_info::maxDistanceFromReadEdge, distanceFromReadEdge));
+    obs.mapq = mapq;
+    obs.qscore = qscore;
+    obs.isReference = (posdata.get_ref_base()==id_to_base(call_id));
+    obs.isSubmapped = is_submapped;
+    posdata.scoringObservations.push_back(obs);
 }
 
 
 void
 pos_basecall_buffer::
-update_read_pos_ranksum(
-    char refchar,
-    const pos_t pos,
+insertSomaticScoringObservation(
+    snp_pos_info& posdata,
     const uint8_t call_id,
     const unsigned read_pos)
 {
-    const bool is_reference(refchar==id_to_base(call_id));
-
-    auto& posdata(_pdata.getRef(pos));
-    posdata.readPositionRankSum.add_observation(is_reference,read_pos);
+    snp_pos_info::ScoringObservation obs;
+    obs.readPos = read_pos;
+    obs.distanceFromReadEdge = 0;
+    obs.mapq = 0;
+    obs.qscore = 0;
+    obs.isReference = (posdata.get_ref_base()==id_to_base(call_id));
+    obs.isSubmapped = false;
+    posdata.scoringObservations.push_back(obs);
 }
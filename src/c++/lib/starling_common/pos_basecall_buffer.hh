@@ -26,10 +26,12 @@
 #include "blt_common/snp_pos_info.hh"
 #include "blt_util/blt_types.hh"
 #include "blt_util/RangeMap.hh"
+#include "blt_util/SlabArena.hh"
 
 #include <iosfwd>
 #include <cmath>
 #include <string>
+#include <type_traits>
 
 
 struct EmptyPosSet
@@ -46,6 +48,12 @@ struct EmptyPosSet
 
 
 
+/// \brief Per-position pileup data for a single sample
+///
+/// The per-position basecall and read position arrays are carved from position-keyed slab arenas owned by the
+/// buffer, so that pileup storage is recycled in bulk as the buffer window advances, instead of each position's
+/// arrays being grown from the heap.
+///
 struct pos_basecall_buffer
 {
     pos_basecall_buffer(
@@ -57,12 +65,20 @@ struct pos_basecall_buffer
     clear()
     {
         _pdata.clear();
+        _pdata.clearArenas();
     }
 
     void
     insert_pos_submap_count(const pos_t pos)
     {
-        _pdata.getRef(pos).submappedReadCount++;
+        insert_pos_submap_count(_pdata.getRef(pos));
+    }
+
+    static
+    void
+    insert_pos_submap_count(snp_pos_info& posdata)
+    {
+        posdata.submappedReadCount++;
     }
 
     void
@@ -71,35 +87,46 @@ struct pos_basecall_buffer
         _pdata.getRef(pos).spanningDeletionReadCount++;
     }
 
+    /// \return mutable pileup data at pos
+    ///
+    /// this allows all updates contributed by one read base to share a single position lookup, using the
+    /// static update functions below
+    snp_pos_info&
+    getPosRef(const pos_t pos)
+    {
+        return _pdata.getRef(pos);
+    }
+
     // update mapQ sum for RMSMappingQuality calculation
+    static
     void
     insert_mapq_count(
-        const pos_t pos,
+        snp_pos_info& posdata,
         const uint8_t mapq)
     {
-        _pdata.getRef(pos).mapqTracker.add(mapq);
+        posdata.mapqTracker.add(mapq);
     }
 
+    static
     void
     insert_alt_read_pos(
-        const pos_t pos,
+        snp_pos_info& posdata,
         const uint8_t call_id,
         const uint16_t readPos,
         const uint16_t readLength)
     {
-        snp_pos_info& posdata(_pdata.getRef(pos));
         if (posdata.get_ref_base() == id_to_base(call_id)) return;
 
         posdata.altAlleleReadPositionInfo.push_back({readPos,readLength});
     }
 
-    /// add associated basecall data to pileup at position pos which
-    /// can be used to compute variant scoring metrics
+    /// add associated basecall data to pileup position posdata which
+    /// can be used to compute germline variant scoring metrics
     ///
+    static
     void
-    updateGermlineScoringMetrics(
-        const char refpos,
-        const pos_t pos,
+    insertGermlineScoringObservation(
+        snp_pos_info& posdata,
         const uint8_t call_id,
         const uint8_t qscore,
         const uint8_t mapq,
@@ -107,25 +134,27 @@ struct pos_basecall_buffer
         const unsigned distanceFromReadEdge,
         const bool is_submapped);
 
+    /// add the read position of a basecall to pileup position posdata for the somatic read position rank-sum
+    static
     void
-    update_read_pos_ranksum(
-        char refchar,
-        const pos_t pos,
+    insertSomaticScoringObservation(
+        snp_pos_info& posdata,
         const uint8_t call_id,
         const unsigned read_pos);
 
+    static
     void
-    insert_pos_basecall(const pos_t pos,
+    insert_pos_basecall(snp_pos_info& posdata,
                         const bool is_tier1,
                         const base_call& bc)
     {
         if (is_tier1)
         {
-            _pdata.getRef(pos).calls.push_back(bc);
+            posdata.calls.push_back(bc);
         }
         else
         {
-            _pdata.getRef(pos).tier2_calls.push_back(bc);
+            posdata.tier2_calls.push_back(bc);
         }
     }
 
@@ -157,6 +186,7 @@ struct pos_basecall_buffer
     clear_to_pos(const pos_t pos)
     {
         _pdata.eraseTo(pos);
+        _pdata.releaseArenasTo(pos);
     }
 
     bool
@@ -165,27 +195,70 @@ struct pos_basecall_buffer
         return _pdata.empty();
     }
 
+    /// \return Heap allocation counters for all pileup arrays stored in this buffer
+    SlabArenaStats
+    getAllocationStats() const
+    {
+        SlabArenaStats stats(_pdata.callArena.getStats());
+        stats.merge(_pdata.readPosArena.getStats());
+        stats.merge(_pdata.scoringObservationArena.getStats());
+        return stats;
+    }
+
     void
     dump(std::ostream& os) const;
 
 private:
     typedef RangeMap<pos_t,snp_pos_info,ClearT<snp_pos_info>> pdata_t;
 
+    // erased positions may still refer to released arena storage, so these must never be copied when the
+    // RangeMap storage is expanded:
+    static_assert(std::is_nothrow_move_constructible<snp_pos_info>::value,
+                  "snp_pos_info must be nothrow move constructible");
+
     // inherit so that we can intercept the getRef calls:
     struct PosData : public pdata_t
     {
         PosData(const reference_contig_segment& ref_init) : ref(ref_init) {}
 
+        /// on the first access to each position, set the reference base and bind all pileup arrays to the
+        /// arenas under this position's key
         snp_pos_info&
         getRef(
             const pos_t& pos)
         {
             snp_pos_info& pi(pdata_t::getRef(pos));
-            if (! pi.is_ref_set()) pi.set_ref_base(ref.get_base(pos));
+            if (! pi.is_ref_set())
+            {
+                pi.set_ref_base(ref.get_base(pos));
+                pi.calls.setArena(&callArena, pos);
+                pi.tier2_calls.setArena(&callArena, pos);
+                pi.altAlleleReadPositionInfo.setArena(&readPosArena, pos);
+                pi.scoringObservations.setArena(&scoringObservationArena, pos);
+            }
             return pi;
         }
 
+        void
+        releaseArenasTo(const pos_t pos)
+        {
+            callArena.releaseTo(pos);
+            readPosArena.releaseTo(pos);
+            scoringObservationArena.releaseTo(pos);
+        }
+
+        void
+        clearArenas()
+        {
+            callArena.clear();
+            readPosArena.clear();
+            scoringObservationArena.clear();
+        }
+
         const reference_contig_segment& ref;
+        SlabArena<base_call,pos_t> callArena;
+        SlabArena<snp_pos_info::ReadPositionInfo,pos_t> readPosArena;
+        SlabArena<snp_pos_info::ScoringObservation,pos_t> scoringObservationArena;
     };
 
     const reference_contig_segment& _ref;
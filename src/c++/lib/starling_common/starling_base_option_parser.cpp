@@ -62,6 +62,8 @@ get_starling_base_option_parser(
     core_opt.add_options()
     ("ref", po::value(&opt.referenceFilename),
      "fasta reference sequence, samtools index file must be present (required)")
+    ("packed-reference", po::value(&opt.isUsePackedReference)->zero_tokens(),
+     "Read the reference from a memory-mapped 2-bit packed copy stored next to the fasta file (as '<fasta>.packed2bit'), which is created if missing or out of date. The packed copy is shared by all processes on the same host. Creating it requires write access to the fasta directory, where temporary '<fasta>.packed2bit.tmp' and '<fasta>.packed2bit.lock' files are also written while it is created. If it cannot be created, the reference is read from the fasta file instead.")
     ("region", po::value<regions_t>(),
      "samtools formatted region, eg. 'chr1:20-30'. May be supplied more than once but regions must not overlap. At least one entry required.")
     ;
@@ -118,6 +120,8 @@ get_starling_base_option_parser(
      "Maximum allowed read depth per sample (prior to realignment). Input reads which would exceed this depth are filtered out.  (default: no limit)")
     ("max-sample-read-buffer", po::value(&opt.maxBufferedReads)->default_value(opt.maxBufferedReads),
      "Maximum reads buffered for each sample")
+    ("max-reads-per-start-pos", po::value(&opt.maxReadsPerStartPos)->default_value(opt.maxReadsPerStartPos),
+     "Maximum reads retained at any one alignment start position for each sample. Reads in excess of this limit are downsampled by a hash of the read name, so that the same reads are retained in every run. Intended for ultra-deep amplicon data. (0 disables the limit)")
     ("min-qscore", po::value(&opt.minBasecallErrorPhredProb)->default_value(opt.minBasecallErrorPhredProb),
      "Don't use a basecall for SNV calling if qscore is below this value.")
     ("min-mapping-quality", po::value(&opt.minMappingErrorPhredProb)->default_value(opt.minMappingErrorPhredProb),
@@ -128,6 +132,18 @@ get_starling_base_option_parser(
     other_opt.add_options()
     ("stats-file", po::value(&opt.segmentStatsFilename),
      "Write runtime stats to file")
+    ("call-threads", po::value(&opt.callThreadCount)->default_value(opt.callThreadCount),
+     "Number of threads used to call independent analysis regions concurrently. Output is identical for any thread count above 1. Compared to single-thread output, threaded output has additional gVCF block and callable region breaks at work region boundaries, and read-backed phasing is not extended across these boundaries.")
+    ("call-thread-region-size", po::value(&opt.threadRegionSize)->default_value(opt.threadRegionSize),
+     "When more than one call thread is used, analysis regions are split into work regions of this size.")
+    ("compress-vcf-output", po::value(&opt.isCompressVcfOutput)->zero_tokens(),
+     "Write VCF and BED outputs as bgzip-compressed files with a tabix index. The suffix '.gz' is added to any output filename which does not already have it.")
+    ("compress-threads", po::value(&opt.compressThreadCount)->default_value(opt.compressThreadCount),
+     "Number of background threads used to compress each output when compress-vcf-output is set.")
+    ("compress-level", po::value(&opt.compressionLevel)->default_value(opt.compressionLevel),
+     "zlib compression level (0-9) used when compress-vcf-output is set, or -1 for the default level.")
+    ("vcf-header-cmdline", po::value(&opt.vcfHeaderCmdline),
+     "Command line recorded in the VCF header in place of the command line of this process, so that a workflow can record its own command line.")
     ("report-evs-features", po::value(&opt.isReportEVSFeatures)->zero_tokens(),
      "Report empirical variant scoring (EVS) training features in VCF output")
     ("indel-error-models-file", po::value<std::vector<std::string>>(&opt.indelErrorModelFilenames),
@@ -217,6 +233,33 @@ finalize_starling_base_options(
         pinfo.usage(oss.str().c_str());
     }
 
+    if (opt.callThreadCount < 1)
+    {
+        pinfo.usage("call-threads must be at least 1");
+    }
+
+    if (opt.compressThreadCount < 1)
+    {
+        pinfo.usage("compress-threads must be at least 1");
+    }
+
+    if ((opt.compressionLevel < -1) || (opt.compressionLevel > 9))
+    {
+        pinfo.usage("compress-level must be in the range [-1,9]");
+    }
+
+    if (opt.callThreadCount > 1)
+    {
+        if (opt.threadRegionSize < 1)
+        {
+            pinfo.usage("call-thread-region-size must be at least 1");
+        }
+        if (opt.isWriteRealignedReads())
+        {
+            pinfo.usage("Realigned read output is not supported with more than one call thread");
+        }
+    }
+
     if (vm.count("max-input-depth"))
     {
         opt.is_max_input_depth=true;
@@ -88,6 +88,9 @@ struct starling_base_options : public blt_options
 
     std::string referenceFilename;
 
+    /// If true, read the reference through a memory-mapped 2-bit packed sidecar file, see \ref ReferenceStore
+    bool isUsePackedReference = false;
+
     // list of chromosome regions to be analyzed
     regions_t regions;
 
@@ -211,6 +214,26 @@ struct starling_base_options : public blt_options
     /// Stores runtime stats
     std::string segmentStatsFilename;
 
+    /// Number of threads used to call independent analysis regions concurrently within this process
+    ///
+    /// Each thread has its own input streams and position processor, while options and models are shared.
+    unsigned callThreadCount = 1;
+
+    /// When more than one call thread is used, analysis regions are split into work regions of (at most) this size
+    unsigned threadRegionSize = 2000000;
+
+    /// If true, write VCF and BED outputs directly as bgzip-compressed files with a tabix index
+    bool isCompressVcfOutput = false;
+
+    /// Number of background compression threads used for each compressed output
+    unsigned compressThreadCount = 1;
+
+    /// zlib compression level used for compressed output, or -1 for the default level
+    int compressionLevel = -1;
+
+    /// If not empty, this is recorded in the VCF header cmdline field in place of the command line of this process
+    std::string vcfHeaderCmdline;
+
     bool
     isMaxBufferedReads() const
     {
@@ -222,6 +245,18 @@ struct starling_base_options : public blt_options
     /// set to zero to disable limit
     unsigned maxBufferedReads = 100000;
 
+    bool
+    isMaxReadsPerStartPos() const
+    {
+        return (maxReadsPerStartPos != 0);
+    }
+
+    /// maximum number of reads retained at any one alignment start position for each sample
+    ///
+    /// Reads in excess of this limit are dropped before they enter the read buffer, selecting the reads to retain
+    /// by a hash of the read name so that the result is reproducible. Set to zero to disable limit.
+    unsigned maxReadsPerStartPos = 0;
+
     bool isBasecallQualAdjustedForMapq = true;
 
     bool useTier2Evidence = false;
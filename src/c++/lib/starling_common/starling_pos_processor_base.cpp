@@ -37,6 +37,7 @@
 #include "starling_common/AlleleReportInfo.hh"
 
 #include <iomanip>
+#include <limits>
 
 
 //#define DEBUG_PPOS
@@ -340,6 +341,14 @@ update_largest_total_indel_ref_span_per_read(const unsigned is)
 starling_pos_processor_base::
 ~starling_pos_processor_base()
 {
+    for (const auto& sampleVal : _sample)
+    {
+        _statsManager.addPileupAllocationStats(sampleVal->basecallBuffer.getAllocationStats());
+        if (sampleVal->readDownsampler)
+        {
+            _statsManager.addDownsampledReads(sampleVal->readDownsampler->getDroppedReadCount());
+        }
+    }
 }
 
 
@@ -350,6 +359,7 @@ reset()
 {
     if (_stagemanPtr)
     {
+        flushDownsampledReads(std::numeric_limits<pos_t>::max());
         _stagemanPtr->reset();
     }
     _activeRegionDetector->clear();
@@ -552,6 +562,32 @@ insert_read(
         return retval;
     }
 
+    StartPosReadDownsampler* downsamplerPtr(sample(sampleIndex).readDownsampler.get());
+    if (downsamplerPtr != nullptr)
+    {
+        if ((! downsamplerPtr->empty()) && (downsamplerPtr->getStartPos() != al.pos))
+        {
+            flushDownsampledReads(downsamplerPtr->getStartPos());
+        }
+        downsamplerPtr->addRead(br, al, maplev);
+        return retval;
+    }
+
+    return insertReadAlignment(br, al, maplev, sampleIndex);
+}
+
+
+
+boost::optional<align_id_t>
+starling_pos_processor_base::
+insertReadAlignment(
+    const bam_record& br,
+    const alignment& al,
+    const MAPLEVEL::index_t maplev,
+    const unsigned sampleIndex)
+{
+    boost::optional<align_id_t> retval;
+
     starling_read_buffer& rbuff(sample(sampleIndex).readBuffer);
 
     // check whether the read buffer has reached max capacity
@@ -735,6 +771,9 @@ align_pos(const pos_t pos)
 {
     known_pos_range realign_buffer_range(get_realignment_range(pos, _stagemanPtr->get_stage_data()));
 
+    // reads starting at this position with the same alignment and sequence share candidate alignment search results:
+    CandidateAlignmentCache candAlignmentCache;
+
     const unsigned sampleCount(getSampleCount());
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
     {
@@ -750,7 +789,7 @@ align_pos(const pos_t pos)
             try
             {
                 realignAndScoreRead(_opt, _dopt, sif.sampleOptions, _ref, realign_buffer_range, sampleIndex,
-                                    rseg, getIndelBuffer());
+                                    rseg, getIndelBuffer(), &candAlignmentCache);
             }
             catch (...)
             {
@@ -779,11 +818,35 @@ starling_pos_processor_base::
 set_head_pos(const pos_t pos)
 {
     _stagemanPtr->validate_new_pos_value(pos,STAGE::READ_BUFFER);
+
+    // reads held for downsampling must be inserted before the head position moves past their start position:
+    flushDownsampledReads(pos);
     _stagemanPtr->handle_new_pos_value(pos);
 }
 
 
 
+void
+starling_pos_processor_base::
+flushDownsampledReads(const pos_t pos)
+{
+    const unsigned sampleCount(getSampleCount());
+    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+    {
+        StartPosReadDownsampler* downsamplerPtr(sample(sampleIndex).readDownsampler.get());
+        if ((downsamplerPtr == nullptr) || downsamplerPtr->empty()) continue;
+        if (downsamplerPtr->getStartPos() > pos) continue;
+
+        downsamplerPtr->flush(
+            [&](const bam_record& br, const alignment& al, const MAPLEVEL::index_t maplev)
+        {
+            insertReadAlignment(br, al, maplev, sampleIndex);
+        });
+    }
+}
+
+
+
 void
 starling_pos_processor_base::
 process_pos(const int stage_no,
@@ -961,59 +1024,6 @@ insert_pos_spandel_count(const pos_t pos,
 
 
 
-void
-starling_pos_processor_base::
-updateGermlineScoringMetrics(
-    const pos_t pos,
-    const unsigned sample_no,
-    const uint8_t call_id,
-    const uint8_t qscore,
-    const uint8_t mapq,
-    const unsigned cycle,
-    const unsigned distanceFromReadEdge,
-    const bool is_submapped)
-{
-    // assume pos is already valid:
-    auto& bcbuff(sample(sample_no).basecallBuffer);
-    bcbuff.updateGermlineScoringMetrics(_ref.get_base(pos), pos, call_id, qscore, mapq, cycle, distanceFromReadEdge, is_submapped);
-}
-
-
-void
-starling_pos_processor_base::
-updateSomaticScoringMetrics(
-    const pos_t pos,
-    const unsigned sample_no,
-    const bool is_tier1,
-    const uint8_t call_id,
-    const bool is_call_filter,
-    const uint16_t readPos,
-    const uint16_t readLength)
-{
-    // assume pos is already valid:
-    auto& bcbuff(sample(sample_no).basecallBuffer);
-    if (is_tier1 && (sample_no != 0) && (! is_call_filter))
-    {
-        bcbuff.update_read_pos_ranksum(_ref.get_base(pos),pos,call_id,readPos);
-        bcbuff.insert_alt_read_pos(pos,call_id,readPos,readLength);
-    }
-}
-
-
-void
-starling_pos_processor_base::
-insert_pos_basecall(const pos_t pos,
-                    const unsigned sample_no,
-                    const bool is_tier1,
-                    const base_call& bc)
-{
-    // assume pos is already valid:
-
-    sample(sample_no).basecallBuffer.insert_pos_basecall(pos,is_tier1,bc);
-}
-
-
-
 #if 1
 static
 pos_t
@@ -1282,109 +1292,136 @@ pileup_read_segment(
 
         if (is_segment_align_match(ps.type))
         {
-            for (unsigned j(0); j<ps.length; ++j)
+            // clip the segment to the trimmed read range and the report range:
+            const pos_t readSegmentBegin(std::max(static_cast<pos_t>(read_head_pos), static_cast<pos_t>(read_begin)));
+            const pos_t readSegmentEnd(std::min(static_cast<pos_t>(read_head_pos+ps.length), static_cast<pos_t>(read_end)));
+            const pos_t refSegmentBegin(std::max(ref_head_pos+(readSegmentBegin-static_cast<pos_t>(read_head_pos)),
+                                                 _reportRange.begin_pos()));
+            const pos_t refSegmentEnd(std::min(ref_head_pos+(readSegmentEnd-static_cast<pos_t>(read_head_pos)),
+                                               _reportRange.end_pos()));
+
+            if (refSegmentBegin < refSegmentEnd)
             {
-                const unsigned read_pos(read_head_pos+j);
-
-                if ((read_pos < read_begin) || (read_pos >= read_end)) continue; // allow for read end trimming
-                const pos_t ref_pos(ref_head_pos+static_cast<pos_t>(j));
-                // skip position outside of report range:
-                if (! is_pos_reportable(ref_pos)) continue;
-
-#ifdef DEBUG_PPOS
-                log_os << "j,ref,read: " << j << " " << ref_pos <<  " " << read_pos << "\n";
-#endif
-
-                _stagemanPtr->validate_new_pos_value(ref_pos,STAGE::get_pileup_stage_no(_opt));
-
-                const uint8_t call_code(bseq.get_code(read_pos));
-                const uint8_t call_id(bam_seq_code_to_id(call_code));
-
-                uint8_t qscore(qual[read_pos]);
+                const unsigned segmentReadBegin(read_head_pos+(refSegmentBegin-ref_head_pos));
+                const unsigned segmentSize(refSegmentEnd-refSegmentBegin);
+
+                // positions only have a lower bound in the stage manager, so the first position checks the
+                // whole segment:
+                _stagemanPtr->validate_new_pos_value(refSegmentBegin,STAGE::get_pileup_stage_no(_opt));
+
+                // decode basecalls and qualities of the segment in one pass:
+                _segmentCallCodes.resize(segmentSize);
+                _segmentQscores.resize(segmentSize);
+                bseq.get_codes(segmentReadBegin, segmentReadBegin+segmentSize, _segmentCallCodes.data());
+                std::copy(qual+segmentReadBegin, qual+segmentReadBegin+segmentSize, _segmentQscores.begin());
                 if (is_mapq_adjust)
                 {
-                    qscore = qphred_to_mapped_qphred(qscore,adjustedMapq);
+                    for (uint8_t& qscore : _segmentQscores)
+                    {
+                        qscore = qphred_to_mapped_qphred(qscore,adjustedMapq);
+                    }
                 }
 
                 const unsigned end_trimmed_read_len(read_end-read_begin);
-                unsigned align_strand_read_pos(read_pos);
-                if (! best_al.is_fwd_strand)
-                {
-                    align_strand_read_pos=read_size-(read_pos+1);
-                }
+                pos_basecall_buffer& bcbuff(sample(sampleIndex).basecallBuffer);
 
-                bool current_call_filter( true );
-                bool is_tier_specific_filter( false );
-                if (! is_submapped)
+                for (unsigned segmentIndex(0); segmentIndex<segmentSize; ++segmentIndex)
                 {
-                    bool is_call_filter((call_code == BAM_BASE::ANY) ||
-                                        (qscore < _opt.minBasecallErrorPhredProb));
+                    const unsigned read_pos(segmentReadBegin+segmentIndex);
+                    const pos_t ref_pos(refSegmentBegin+static_cast<pos_t>(segmentIndex));
+
+#ifdef DEBUG_PPOS
+                    log_os << "ref,read: " << ref_pos <<  " " << read_pos << "\n";
+#endif
 
-                    bool is_tier2_call_filter(is_call_filter);
-                    if ((! is_call_filter) && _opt.isMismatchDensityFilter())
+                    const uint8_t call_code(_segmentCallCodes[segmentIndex]);
+                    const uint8_t call_id(bam_seq_code_to_id(call_code));
+                    const uint8_t qscore(_segmentQscores[segmentIndex]);
+
+                    unsigned align_strand_read_pos(read_pos);
+                    if (! best_al.is_fwd_strand)
+                    {
+                        align_strand_read_pos=read_size-(read_pos+1);
+                    }
+
+                    bool current_call_filter( true );
+                    bool is_tier_specific_filter( false );
+                    if (! is_submapped)
                     {
-                        is_call_filter = _rmi[read_pos].mismatch_filter_map;
-                        if (_opt.useTier2Evidence)
+                        bool is_call_filter((call_code == BAM_BASE::ANY) ||
+                                            (qscore < _opt.minBasecallErrorPhredProb));
+
+                        bool is_tier2_call_filter(is_call_filter);
+                        if ((! is_call_filter) && _opt.isMismatchDensityFilter())
                         {
-                            is_tier2_call_filter = _rmi[read_pos].tier2_mismatch_filter_map;
+                            is_call_filter = _rmi[read_pos].mismatch_filter_map;
+                            if (_opt.useTier2Evidence)
+                            {
+                                is_tier2_call_filter = _rmi[read_pos].tier2_mismatch_filter_map;
+                            }
+                            else
+                            {
+                                is_tier2_call_filter = is_call_filter;
+                            }
                         }
-                        else
+                        current_call_filter = ( is_tier1 ? is_call_filter : is_tier2_call_filter );
+                        is_tier_specific_filter = ( is_tier1 && is_call_filter && (! is_tier2_call_filter) );
+
+                        if (_opt.isMismatchDensityFilter())
                         {
-                            is_tier2_call_filter = is_call_filter;
+                            is_neighbor_mismatch=(_rmi[read_pos].mismatch_count_ns>0);
                         }
                     }
-                    current_call_filter = ( is_tier1 ? is_call_filter : is_tier2_call_filter );
-                    is_tier_specific_filter = ( is_tier1 && is_call_filter && (! is_tier2_call_filter) );
 
-                    if (_opt.isMismatchDensityFilter())
-                    {
-                        is_neighbor_mismatch=(_rmi[read_pos].mismatch_count_ns>0);
-                    }
-                }
+                    // all updates below share a single lookup of the position's pileup data:
+                    snp_pos_info& posdata(bcbuff.getPosRef(ref_pos));
 
-                // always update MAPQ (even when we don't want EVS metrics)
-                sample(sampleIndex).basecallBuffer.insert_mapq_count(ref_pos,mapq);
+                    // always update MAPQ (even when we don't want EVS metrics)
+                    pos_basecall_buffer::insert_mapq_count(posdata,mapq);
 
-                // update extended feature metrics (including submapped reads):
-                if (_opt.is_compute_germline_scoring_metrics())
-                {
-                    const unsigned full_read_pos(read_pos+full_read_offset);
-                    /// zero-indexed distance from the edge of the full read
-                    const unsigned distanceFromReadEdge(std::min(full_read_pos, full_read_size-(full_read_pos+1)));
+                    // update extended feature metrics (including submapped reads):
+                    if (_opt.is_compute_germline_scoring_metrics())
+                    {
+                        const unsigned full_read_pos(read_pos+full_read_offset);
+                        /// zero-indexed distance from the edge of the full read
+                        const unsigned distanceFromReadEdge(std::min(full_read_pos, full_read_size-(full_read_pos+1)));
 
-                    updateGermlineScoringMetrics(ref_pos, sampleIndex, call_id, qscore, mapq, align_strand_read_pos,
-                                                 distanceFromReadEdge, is_submapped);
-                }
-                else if (_opt.is_compute_somatic_scoring_metrics)
-                {
-                    updateSomaticScoringMetrics(ref_pos, sampleIndex, is_tier1, call_id, current_call_filter, read_pos,
-                                                read_size);
-                }
+                        pos_basecall_buffer::insertGermlineScoringObservation(posdata, call_id, qscore, mapq, align_strand_read_pos,
+                                                                              distanceFromReadEdge, is_submapped);
+                    }
+                    else if (_opt.is_compute_somatic_scoring_metrics)
+                    {
+                        if (is_tier1 && (sampleIndex != 0) && (! current_call_filter))
+                        {
+                            pos_basecall_buffer::insertSomaticScoringObservation(posdata, call_id, read_pos);
+                            pos_basecall_buffer::insert_alt_read_pos(posdata, call_id, read_pos, read_size);
+                        }
+                    }
 
-                if (is_submapped)
-                {
-                    insert_pos_submap_count(ref_pos,sampleIndex);
-                    continue;
-                }
+                    if (is_submapped)
+                    {
+                        pos_basecall_buffer::insert_pos_submap_count(posdata);
+                        continue;
+                    }
 
-                /// include only data meeting mapping criteria after this point:
+                    /// include only data meeting mapping criteria after this point:
 
-                try
-                {
-                    const base_call bc = base_call(call_id,qscore,best_al.is_fwd_strand,
-                                                   align_strand_read_pos,end_trimmed_read_len,
-                                                   current_call_filter,is_neighbor_mismatch,is_tier_specific_filter);
+                    try
+                    {
+                        const base_call bc = base_call(call_id,qscore,best_al.is_fwd_strand,
+                                                       align_strand_read_pos,end_trimmed_read_len,
+                                                       current_call_filter,is_neighbor_mismatch,is_tier_specific_filter);
 
-                    insert_pos_basecall(ref_pos, sampleIndex, is_tier1, bc);
-                }
-                catch (...)
-                {
-                    log_os << "Exception caught in starling_pos_processor_base.insert_pos_basecall() "
-                           << "while processing read_position: " << (read_pos+1) << "\n";
-                    throw;
+                        pos_basecall_buffer::insert_pos_basecall(posdata, is_tier1, bc);
+                    }
+                    catch (...)
+                    {
+                        log_os << "Exception caught in starling_pos_processor_base.insert_pos_basecall() "
+                               << "while processing read_position: " << (read_pos+1) << "\n";
+                        throw;
+                    }
                 }
             }
-
         }
         else if (ps.type==DELETE)
         {
@@ -39,6 +39,7 @@
 #include "starling_common/read_mismatch_info.hh"
 #include "starling_common/starling_base_shared.hh"
 #include "LocalRegionStats.hh"
+#include "starling_common/StartPosReadDownsampler.hh"
 #include "starling_common/starling_read_buffer.hh"
 #include "starling_common/starling_streams_base.hh"
 #include "starling_common/ActiveRegionDetector.hh"
@@ -48,6 +49,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 struct diploid_genotype;
 
@@ -102,6 +104,19 @@ struct starling_pos_processor_base : public pos_processor_base, private boost::n
     ///
     virtual void reset();
 
+    /// \brief Finish all position reports for the current region
+    ///
+    /// Unlike reset(), this leaves the structure without any current report region, so that the reset()
+    /// included in the next resetRegion() call has nothing left to process. This is used when all output
+    /// for each region must be complete before the next region is started.
+    virtual
+    void
+    finishRegion()
+    {
+        reset();
+        _stagemanPtr.reset();
+    }
+
     /// note that indel position should be normalized before calling:
     ///
     void
@@ -135,6 +150,9 @@ struct starling_pos_processor_base : public pos_processor_base, private boost::n
     /// such as being located too far away from other alignments of the same read or having an indel that is too large.
     /// If true, the return value provides the read's id in this structure's ead buffer
     ///
+    /// When the number of reads at each start position is limited, reads are held until all reads at the same start
+    /// position have been seen, and no read id is returned.
+    ///
     boost::optional<align_id_t>
     insert_read(
         const bam_record& br,
@@ -290,7 +308,12 @@ public:
             , readBuffer(ricp)
             , sampleOptions(opt)
             , localRegionStatsCollection()
-        {}
+        {
+            if (opt.isMaxReadsPerStartPos())
+            {
+                readDownsampler.reset(new StartPosReadDownsampler(opt.maxReadsPerStartPos));
+            }
+        }
 
         void
         resetRegion()
@@ -307,6 +330,9 @@ public:
         pos_basecall_buffer basecallBuffer;
         starling_read_buffer readBuffer;
 
+        /// Reads held before insertion into readBuffer, when reads per start position are limited
+        std::unique_ptr<StartPosReadDownsampler> readDownsampler;
+
         /// An early estimate of read depth before realignment
         depth_buffer estdepth_buff;
 
@@ -408,6 +434,18 @@ private:
         assert (_activeRegionDetector);
         return *_activeRegionDetector;
     }
+    /// insert a read which has passed all checks on the read position into the read buffer
+    boost::optional<align_id_t>
+    insertReadAlignment(
+        const bam_record& br,
+        const alignment& al,
+        const MAPLEVEL::index_t maplev,
+        const unsigned sampleIndex);
+
+    /// insert all reads held for downsampling at start positions up to and including \p pos
+    void
+    flushDownsampledReads(const pos_t pos);
+
     void
     insert_pos_submap_count(const pos_t pos,
                             const unsigned sample_no);
@@ -416,38 +454,6 @@ private:
     insert_pos_spandel_count(const pos_t pos,
                              const unsigned sample_no);
 
-    /// update (basecall) data used to compute germline variant scoring
-    /// features
-    ///
-    /// \param distanceFromReadEdge distance of base call from the closest read edge
-    ///
-    void
-    updateGermlineScoringMetrics(
-        const pos_t pos,
-        const unsigned sample_no,
-        const uint8_t call_id,
-        const uint8_t qscore,
-        const uint8_t mapq,
-        const unsigned cycle,
-        const unsigned distanceFromReadEdge,
-        const bool is_submapped);
-
-    void
-    updateSomaticScoringMetrics(
-        const pos_t pos,
-        const unsigned sample_no,
-        const bool is_teir1,
-        const uint8_t call_id,
-        const bool is_call_filter,
-        const uint16_t readPos,
-        const uint16_t readLength);
-
-    void
-    insert_pos_basecall(const pos_t pos,
-                        const unsigned sample_no,
-                        const bool is_tier1,
-                        const base_call& bc);
-
     void
     process_pos(const int stage_no,
                 const pos_t pos) override;
@@ -633,6 +639,10 @@ protected:
     // read-length data structure used to compute mismatch density filter:
     read_mismatch_info _rmi;
 
+    // decoded basecalls and qualities of the read segment currently added to the pileup:
+    std::vector<uint8_t> _segmentCallCodes;
+    std::vector<uint8_t> _segmentQscores;
+
     /// Largest delete length observed for any one indel (but not greater than max_delete_size)
     unsigned _largest_indel_ref_span;
 
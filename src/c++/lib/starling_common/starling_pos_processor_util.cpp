@@ -47,7 +47,10 @@ std::vector<std::reference_wrapper<const bam_hdr_t> >
 registerAlignments(
     const std::vector<std::string>& alignmentFilename,
     const std::vector<unsigned>& registrationIndices,
-    HtsMergeStreamer& streamData)
+    HtsMergeStreamer& streamData,
+    HtsDecodeThreadPool* decodeThreadPoolPtr,
+    const unsigned readAheadRecordCount,
+    const BamRecordFilterSpec& filterSpec)
 {
     const unsigned alignmentFileCount(alignmentFilename.size());
     assert(registrationIndices.size() == alignmentFileCount);
@@ -57,7 +60,8 @@ registerAlignments(
     {
         const std::string& alignFile(alignmentFilename[alignmentFileIndex]);
         const unsigned bamIndex(registrationIndices[alignmentFileIndex]);
-        const bam_streamer& readStream(streamData.registerBam(alignFile.c_str(), bamIndex));
+        const bam_streamer& readStream(
+            streamData.registerBam(alignFile.c_str(), bamIndex, decodeThreadPoolPtr, readAheadRecordCount, filterSpec));
 
         allHeaders.push_back(readStream.get_header());
 
@@ -81,6 +85,50 @@ registerAlignments(
 
 
 
+BamRecordFilterSpec
+getInputAlignmentFilterSpec(
+    const starling_base_options& opt)
+{
+    // these filters must match starling_read_filter_shared:
+    BamRecordFilterSpec filterSpec;
+    filterSpec.enableFilter(BAM_RECORD_FILTER::QC_FAIL);
+    filterSpec.enableFilter(BAM_RECORD_FILTER::DUPLICATE);
+    filterSpec.enableFilter(BAM_RECORD_FILTER::UNMAPPED);
+    filterSpec.enableFilter(BAM_RECORD_FILTER::SECONDARY);
+    filterSpec.enableFilter(BAM_RECORD_FILTER::SUPPLEMENTARY);
+
+    // MAPQ is not filtered here, because reads below the minimum mapping quality still contribute to tier2 evidence
+    // and mapping quality statistics.
+
+    // optional fields are only needed to write realigned reads:
+    filterSpec.isSkipAuxFields = (! opt.isWriteRealignedReads());
+
+    return filterSpec;
+}
+
+
+
+void
+addInputAlignmentFilterCounts(
+    const HtsMergeStreamer& streamData,
+    starling_read_counts& readCounts,
+    RunStatsManager& statsManager)
+{
+    using namespace BAM_RECORD_FILTER;
+
+    const BamRecordFilterCounts filterCounts(streamData.getBamRecordFilterCounts());
+    readCounts.primary_filter += filterCounts.count[QC_FAIL];
+    readCounts.duplicate += filterCounts.count[DUPLICATE];
+    readCounts.unmapped += filterCounts.count[UNMAPPED];
+    readCounts.secondary += filterCounts.count[SECONDARY];
+    readCounts.supplement += filterCounts.count[SUPPLEMENTARY];
+    assert(filterCounts.count[LOW_MAPQ] == 0);
+
+    statsManager.addBamRecordFilterCounts(filterCounts);
+}
+
+
+
 void
 getSubRegionsFromBedTrack(
     const std::string& callRegionsBedFilename,
@@ -133,6 +181,77 @@ getSubRegionsFromBedTrack(
 
 
 
+void
+getStrelkaWorkRegions(
+    const starling_base_options& opt,
+    const bam_header_info& referenceHeaderInfo,
+    const std::vector<AnalysisRegionInfo>& regionInfoList,
+    const unsigned supplementalRegionBorderSize,
+    std::vector<AnalysisRegionInfo>& workRegionInfoList)
+{
+    const bool isSplitRegions(opt.callThreadCount > 1);
+
+    workRegionInfoList.clear();
+    auto addWorkRegion = [&](const std::string& chrom, const known_pos_range2& range)
+    {
+        if (not isSplitRegions)
+        {
+            AnalysisRegionInfo workRegionInfo;
+            getStrelkaAnalysisRegionInfo(chrom, range.begin_pos(), range.end_pos(),
+                                         supplementalRegionBorderSize, workRegionInfo);
+            workRegionInfoList.push_back(workRegionInfo);
+            return;
+        }
+
+        // clip the split boundaries to the chromosome size, but leave the final range end as-is so that the
+        // result matches the unsplit region:
+        const auto chromIter(referenceHeaderInfo.chrom_to_index.find(chrom));
+        assert(chromIter != referenceHeaderInfo.chrom_to_index.end());
+        const pos_t chromSize(referenceHeaderInfo.chrom_data[chromIter->second].length);
+        const pos_t splitEndPos(std::min(range.end_pos(), chromSize));
+
+        assert(opt.threadRegionSize > 0);
+        pos_t beginPos(range.begin_pos());
+        while (true)
+        {
+            const bool isLastSplit((splitEndPos - beginPos) <= static_cast<pos_t>(opt.threadRegionSize));
+            const pos_t endPos(isLastSplit ? range.end_pos() : (beginPos + opt.threadRegionSize));
+            AnalysisRegionInfo workRegionInfo;
+            getStrelkaAnalysisRegionInfo(chrom, beginPos, endPos, supplementalRegionBorderSize, workRegionInfo);
+            workRegionInfoList.push_back(workRegionInfo);
+            if (isLastSplit) break;
+            beginPos = endPos;
+        }
+    };
+
+    for (const auto& regionInfo : regionInfoList)
+    {
+        if (not opt.isUseCallRegions())
+        {
+            if (not isSplitRegions)
+            {
+                workRegionInfoList.push_back(regionInfo);
+            }
+            else
+            {
+                addWorkRegion(regionInfo.regionChrom, regionInfo.regionRange);
+            }
+        }
+        else
+        {
+            std::vector<known_pos_range2> subRegionRanges;
+            getSubRegionsFromBedTrack(opt.callRegionsBedFilename, regionInfo.regionChrom, regionInfo.regionRange, subRegionRanges);
+
+            for (const auto& subRegionRange : subRegionRanges)
+            {
+                addWorkRegion(regionInfo.regionChrom, subRegionRange);
+            }
+        }
+    }
+}
+
+
+
 /// This means 'valid' in the sense of what the code can handle right
 /// now. Specifically, '=' are not supported.
 ///
@@ -36,11 +36,38 @@
 
 
 /// \brief Register a set of alignment files to the hts streamer and verify consistency conditions.
+///
+/// \param[in] decodeThreadPoolPtr Optional htslib thread pool shared by all registered alignment streams
+/// \param[in] readAheadRecordCount Read-ahead depth of each registered alignment stream, 0 disables read-ahead
+/// \param[in] filterSpec Record filter applied by each registered alignment stream
 std::vector<std::reference_wrapper<const bam_hdr_t> >
 registerAlignments(
     const std::vector<std::string>& alignmentFilename,
     const std::vector<unsigned>& registrationIndices,
-    HtsMergeStreamer& streamData);
+    HtsMergeStreamer& streamData,
+    HtsDecodeThreadPool* decodeThreadPoolPtr = nullptr,
+    const unsigned readAheadRecordCount = 0,
+    const BamRecordFilterSpec& filterSpec = BamRecordFilterSpec());
+
+
+/// \brief Get the record filter for input alignment streams consumed by processInputReadAlignment
+///
+/// The filter removes all records which would be rejected by the always-on read filters of
+/// processInputReadAlignment, so that these records are skipped as soon as they are read from the alignment file.
+BamRecordFilterSpec
+getInputAlignmentFilterSpec(
+    const starling_base_options& opt);
+
+
+/// \brief Add the records removed by the record filters of all input alignment streams in the current region
+///        to \p readCounts and the run stats
+///
+/// This should be called once after all records of the region have been streamed.
+void
+addInputAlignmentFilterCounts(
+    const HtsMergeStreamer& streamData,
+    starling_read_counts& readCounts,
+    RunStatsManager& statsManager);
 
 
 /// re-segment each target region into 0-many target sub-regions, divided on each large gap
@@ -60,6 +87,25 @@ getSubRegionsFromBedTrack(
     std::vector<known_pos_range2>& subRegionRanges);
 
 
+/// \brief Get the list of regions submitted to the region calling loop
+///
+/// Each analysis region is first split into call sub-regions if call regions are in use. When more than one
+/// call thread is in use, the result is further split into work regions no larger than opt.threadRegionSize.
+///
+/// Each work region is finished independently in threaded mode, so the threaded output differs from single-thread
+/// output by additional gVCF block and callable region breaks at the split boundaries.
+///
+/// \param[in] regionInfoList analysis regions as returned from getStrelkaAnalysisRegions()
+/// \param[out] workRegionInfoList regions to submit to the region calling loop, in output order
+void
+getStrelkaWorkRegions(
+    const starling_base_options& opt,
+    const bam_header_info& referenceHeaderInfo,
+    const std::vector<AnalysisRegionInfo>& regionInfoList,
+    const unsigned supplementalRegionBorderSize,
+    std::vector<AnalysisRegionInfo>& workRegionInfoList);
+
+
 /// Handles input read alignments -- reads are parsed, their indels
 /// are extracted and the reads/indels are buffered to posProcessor
 ///
@@ -46,6 +46,33 @@ starling_read(
       _readIndex(readIndex),
       _read_rec(br),
       _full_read(_read_rec.read_size(), 0, *this, inputAlignment)
+{
+    initExonInfo(inputAlignment);
+}
+
+
+
+void
+starling_read::
+reset(
+    const bam_record& br,
+    const alignment& inputAlignment,
+    const MAPLEVEL::index_t inputAlignmentMapLevel,
+    const align_id_t readIndex)
+{
+    _inputAlignmentMapLevel = inputAlignmentMapLevel;
+    _readIndex = readIndex;
+    _read_rec = br;
+    _full_read.reset(_read_rec.read_size(), 0, inputAlignment);
+    _exonInfo.clear();
+    initExonInfo(inputAlignment);
+}
+
+
+
+void
+starling_read::
+initExonInfo(const alignment& inputAlignment)
 {
     const seg_id_t exonCount(apath_exon_count(inputAlignment.path));
     if (exonCount <= 1) return;
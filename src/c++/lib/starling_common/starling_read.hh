@@ -56,6 +56,17 @@ struct starling_read : private boost::noncopyable
         const MAPLEVEL::index_t inputAlignmentMapLevel,
         const align_id_t readIndex);
 
+    /// \brief Reinitialize this object to represent a new read
+    ///
+    /// This reuses the storage of the BAM record and read segments of the previous read, all arguments are the
+    /// same as the constructor.
+    void
+    reset(
+        const bam_record& br,
+        const alignment& inputAlignment,
+        const MAPLEVEL::index_t inputAlignmentMapLevel,
+        const align_id_t readIndex);
+
     // This is not const because we update the BAM record with the best
     // alignment if the read has been realigned:
     void
@@ -159,11 +170,15 @@ private:
     void
     update_full_segment();
 
+    /// Setup exon segments if the input alignment is spliced
+    void
+    initExonInfo(const alignment& inputAlignment);
+
     /// Mapping quality category for the input read
-    const MAPLEVEL::index_t _inputAlignmentMapLevel;
+    MAPLEVEL::index_t _inputAlignmentMapLevel;
 
     /// Internal alignment index created and used only within Strelka
-    const align_id_t _readIndex;
+    align_id_t _readIndex;
     bam_record _read_rec;
     read_segment _full_read;
 
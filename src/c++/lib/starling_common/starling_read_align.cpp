@@ -36,6 +36,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <deque>
 
 #include <iostream>
 #include <sstream>
@@ -192,6 +193,160 @@ typedef std::map<IndelKey,starling_align_indel_info> starling_align_indel_status
 typedef std::map<ActiveRegionId,HaplotypeStatus> HaplotypeStatusMap;
 
 
+/// A change to the indel status map made during candidate alignment search, recorded so that the change
+/// can be reverted when the search returns to a shallower level
+struct IndelStatusUndoRecord
+{
+    IndelStatusUndoRecord(
+        const IndelKey& initIndelKey,
+        const bool initIsInserted,
+        const starling_align_indel_info& initPriorInfo)
+        : indelKey(initIndelKey),
+          isInserted(initIsInserted),
+          priorInfo(initPriorInfo)
+    {}
+
+    IndelKey indelKey;
+
+    /// if true, the indel was added to the status map, so reverting the change erases it
+    bool isInserted;
+    starling_align_indel_info priorInfo;
+};
+
+typedef std::vector<IndelStatusUndoRecord> IndelStatusUndoLog;
+
+
+/// A change to the haplotype status map made during candidate alignment search
+struct HaplotypeStatusUndoRecord
+{
+    HaplotypeStatusUndoRecord(
+        const ActiveRegionId initActiveRegionId,
+        const bool initIsInserted,
+        const HaplotypeStatus& initPriorStatus)
+        : activeRegionId(initActiveRegionId),
+          isInserted(initIsInserted),
+          priorStatus(initPriorStatus)
+    {}
+
+    ActiveRegionId activeRegionId;
+
+    /// if true, the active region was added to the status map, so reverting the change erases it
+    bool isInserted;
+    HaplotypeStatus priorStatus;
+};
+
+
+/// Mutable state of the candidate alignment search
+///
+/// The state is shared by all levels of the search. Each change is recorded in an undo log so that a
+/// parent level's state can be restored when a child level completes, rather than copying the state
+/// for every child level.
+struct CandidateAlignmentSearchState
+{
+    /// marks a point in the search history which the state can be reverted to
+    struct UndoMark
+    {
+        unsigned indelStatusLogSize = 0;
+        unsigned haplotypeStatusLogSize = 0;
+        unsigned indelOrderSize = 0;
+    };
+
+    UndoMark
+    getUndoMark() const
+    {
+        UndoMark mark;
+        mark.indelStatusLogSize = indelStatusUndoLog.size();
+        mark.haplotypeStatusLogSize = haplotypeStatusUndoLog.size();
+        mark.indelOrderSize = indel_order.size();
+        return mark;
+    }
+
+    /// revert all state changes made since mark was taken
+    void
+    revertTo(const UndoMark& mark)
+    {
+        while (indelStatusUndoLog.size() > mark.indelStatusLogSize)
+        {
+            const IndelStatusUndoRecord& record(indelStatusUndoLog.back());
+            if (record.isInserted)
+            {
+                indel_status_map.erase(record.indelKey);
+            }
+            else
+            {
+                indel_status_map.find(record.indelKey)->second = record.priorInfo;
+            }
+            indelStatusUndoLog.pop_back();
+        }
+
+        while (haplotypeStatusUndoLog.size() > mark.haplotypeStatusLogSize)
+        {
+            const HaplotypeStatusUndoRecord& record(haplotypeStatusUndoLog.back());
+            if (record.isInserted)
+            {
+                haplotypeStatusMap.erase(record.activeRegionId);
+            }
+            else
+            {
+                haplotypeStatusMap.find(record.activeRegionId)->second = record.priorStatus;
+            }
+            haplotypeStatusUndoLog.pop_back();
+        }
+
+        assert(indel_order.size() >= mark.indelOrderSize);
+        indel_order.erase(indel_order.begin()+mark.indelOrderSize, indel_order.end());
+    }
+
+    bool
+    isIndelPresent(const IndelKey& indelKey) const
+    {
+        return indel_status_map.find(indelKey)->second.is_present;
+    }
+
+    void
+    setIndelPresent(
+        const IndelKey& indelKey,
+        const bool isPresent)
+    {
+        starling_align_indel_info& indelInfo(indel_status_map.find(indelKey)->second);
+        indelStatusUndoLog.emplace_back(indelKey, false, indelInfo);
+        indelInfo.is_present = isPresent;
+    }
+
+    /// add haplotype constraints for an active region if not already present
+    void
+    addHaplotypeStatus(
+        const ActiveRegionId activeRegionId,
+        const unsigned sampleCount)
+    {
+        if (haplotypeStatusMap.find(activeRegionId) != haplotypeStatusMap.end()) return;
+        haplotypeStatusMap.insert(std::make_pair(activeRegionId, HaplotypeStatus(sampleCount)));
+        haplotypeStatusUndoLog.emplace_back(activeRegionId, true, HaplotypeStatus(0));
+    }
+
+    /// update the haplotype constraints of an existing active region with the current indel state
+    ///
+    /// \return true if the updated haplotype constraints are valid
+    bool
+    updateHaplotypeStatus(
+        const ActiveRegionId activeRegionId,
+        const std::vector<int>& curIndelHaplotypeIds,
+        const bool isCurIndelOn)
+    {
+        HaplotypeStatus& haplotypeStatus(haplotypeStatusMap.at(activeRegionId));
+        haplotypeStatusUndoLog.emplace_back(activeRegionId, false, haplotypeStatus);
+        return haplotypeStatus.updateHaplotypeStatus(curIndelHaplotypeIds, isCurIndelOn);
+    }
+
+    starling_align_indel_status indel_status_map;
+    HaplotypeStatusMap haplotypeStatusMap;
+    std::vector<IndelKey> indel_order;
+
+    IndelStatusUndoLog indelStatusUndoLog;
+    std::vector<HaplotypeStatusUndoRecord> haplotypeStatusUndoLog;
+};
+
+
 static
 known_pos_range
 getReadAlignmentZone(
@@ -286,6 +441,9 @@ dump_indel_status(const starling_align_indel_status& ismap,
 /// is an indel either a candidate indel or in at least one of the
 /// discovery alignments for this read?
 ///
+/// \param[out] readIndelUsabilityPtr if non-null, record the result of any usability test which depends
+///              on the read's own indel evidence
+///
 static
 bool
 is_usable_indel(
@@ -293,21 +451,29 @@ is_usable_indel(
     const IndelKey& indelKey,
     const IndelData& indelData,
     const align_id_t read_id,
-    const unsigned sampleId)
+    const unsigned sampleId,
+    CandidateAlignmentCache::indel_usability_t* readIndelUsabilityPtr = nullptr)
 {
     if (indelBuffer.isCandidateIndel(indelKey, indelData)) return true;
 
     const IndelSampleData& indelSampleData(indelData.getSampleData(sampleId));
-    return ((indelSampleData.tier1_map_read_ids.count(read_id)>0) ||
-            (indelSampleData.tier2_map_read_ids.count(read_id)>0) ||
-            (indelSampleData.submap_read_ids.count(read_id)>0) ||
-            (indelSampleData.noise_read_ids.count(read_id)>0));
+    const bool isUsable((indelSampleData.tier1_map_read_ids.count(read_id)>0) ||
+                        (indelSampleData.tier2_map_read_ids.count(read_id)>0) ||
+                        (indelSampleData.submap_read_ids.count(read_id)>0) ||
+                        (indelSampleData.noise_read_ids.count(read_id)>0));
+
+    if (nullptr != readIndelUsabilityPtr) readIndelUsabilityPtr->emplace_back(indelKey, isUsable);
+    return isUsable;
 }
 
 
 
 /// find all indels in the indel_buffer which intersect a range (and
 /// meet candidacy/usability requirements)
+///
+/// \param[out] undoLogPtr if non-null, record all changes made to indel_status_map
+/// \param[out] readIndelUsabilityPtr if non-null, record all read-specific indel usability decisions
+///
 static
 void
 add_indels_in_range(
@@ -316,7 +482,9 @@ add_indels_in_range(
     const known_pos_range& pr,
     const unsigned sampleId,
     starling_align_indel_status& indel_status_map,
-    std::vector<IndelKey>& indel_order)
+    std::vector<IndelKey>& indel_order,
+    IndelStatusUndoLog* undoLogPtr = nullptr,
+    CandidateAlignmentCache::indel_usability_t* readIndelUsabilityPtr = nullptr)
 {
     const auto indelIterPair(indelBuffer.rangeIterator(pr.begin_pos, pr.end_pos));
 #ifdef DEBUG_ALIGN
@@ -345,21 +513,26 @@ add_indels_in_range(
 
         // if indel is already present, it may be possible to promote this indel from
         // adjacent to an intersection:
-        if (indel_status_map.count(indelKey))
+        const auto statusIter(indel_status_map.find(indelKey));
+        if (statusIter != indel_status_map.end())
         {
-            if ((! is_remove_only) && indel_status_map[indelKey].is_remove_only)
+            starling_align_indel_info& indelInfo(statusIter->second);
+            if ((! is_remove_only) && indelInfo.is_remove_only)
             {
-                indel_status_map[indelKey].is_remove_only = false;
+                if (nullptr != undoLogPtr) undoLogPtr->emplace_back(indelKey, false, indelInfo);
+                indelInfo.is_remove_only = false;
             }
         }
         else
         {
             const IndelData& indelData(getIndelData(indelIter));
-            if (is_usable_indel(indelBuffer, indelKey, indelData, read_id, sampleId))
+            if (is_usable_indel(indelBuffer, indelKey, indelData, read_id, sampleId, readIndelUsabilityPtr))
             {
-                indel_status_map[indelKey].is_present = false;
-                indel_status_map[indelKey].is_remove_only = is_remove_only;
+                starling_align_indel_info& indelInfo(indel_status_map[indelKey]);
+                indelInfo.is_present = false;
+                indelInfo.is_remove_only = is_remove_only;
                 indel_order.push_back(indelKey);
+                if (nullptr != undoLogPtr) undoLogPtr->emplace_back(indelKey, true, indelInfo);
             }
         }
     }
@@ -851,36 +1024,250 @@ getCurIndelHaplotypeIds(
     }
 }
 
-/// Recursively build potential alignment paths and push them into the
-/// candidate alignment set:
-/// \param haplotypeStatusMap map of intersecting active region and haplotyping constraints of phased variants
-static
+/// One level of the candidate alignment search stack
+///
+/// Each level corresponds to a decision on the state of one indel in the indel order. Values computed on
+/// entry to the level are retained here so that the level can resume after each child level completes.
+struct CandidateAlignmentSearchFrame
+{
+    /// the point at which this level resumes when its current child level completes
+    enum step_t
+    {
+        START,
+        AFTER_UNCHANGED_CHILD,
+        AFTER_START_PIN_CHILD,
+        AFTER_END_PIN_CHILD
+    };
+
+    CandidateAlignmentSearchFrame(
+        const CandidateAlignment& initCal,
+        const unsigned initDepth,
+        const unsigned initIndelToggleDepth,
+        const unsigned initTotalToggleDepth,
+        const known_pos_range& initReadRange,
+        const int initMaxReadIndelToggle)
+        : calPtr(&initCal),
+          depth(initDepth),
+          indelToggleDepth(initIndelToggleDepth),
+          totalToggleDepth(initTotalToggleDepth),
+          read_range(initReadRange),
+          max_read_indel_toggle(initMaxReadIndelToggle)
+    {}
+
+    /// alignment at this level, owned by the parent level or the search caller
+    const CandidateAlignment* calPtr;
+    unsigned depth;
+    unsigned indelToggleDepth;
+    unsigned totalToggleDepth;
+    known_pos_range read_range;
+    int max_read_indel_toggle;
+
+    step_t step = START;
+    CandidateAlignmentSearchState::UndoMark entryMark;
+    CandidateAlignmentSearchState::UndoMark unchangedChildMark;
+
+    bool isCurIndelOn = false;
+    bool isCurIndelConflicting = false;
+    bool containsIndelNotDiscoveredFromReads = false;
+    bool isCurIndelNotDiscoveredFromReads = false;
+    ActiveRegionId curIndelActiveRegionId = -1;
+    std::vector<int> curIndelHaplotypeIds;
+    unsigned indelToggleIncrement = 0;
+
+    /// indels present in the toggled (start and end pinned) alignments
+    indel_set_t current_indels;
+
+    /// alignment provided to the current pinned child level
+    CandidateAlignment pinCal;
+    pos_t pinRefStartPos = 0;
+    pos_t pinReadStartPos = 0;
+    pos_t pinRefEndPos = 0;
+    pos_t pinReadEndPos = 0;
+};
+
+
+
+/// Build potential alignment paths and push them into the candidate alignment set
+///
+/// The search over indel toggles is run with an explicit stack of search levels, sharing one
+/// CandidateAlignmentSearchState which is restored from its undo log as each level completes.
+///
+struct CandidateAlignmentSearch
+{
+    CandidateAlignmentSearch(
+        const starling_base_options& opt,
+        const starling_base_deriv_options& dopt,
+        const align_id_t read_id,
+        const unsigned read_length,
+        const IndelBuffer& indelBuffer,
+        const unsigned sampleId,
+        const known_pos_range& realign_buffer_range,
+        CandidateAlignmentSearchState& state,
+        std::set<CandidateAlignment>& cal_set,
+        mca_warnings& warn,
+        CandidateAlignmentCache::indel_usability_t* readIndelUsabilityPtr)
+        : _opt(opt),
+          _dopt(dopt),
+          _read_id(read_id),
+          _read_length(read_length),
+          _indelBuffer(indelBuffer),
+          _sampleId(sampleId),
+          _realign_buffer_range(realign_buffer_range),
+          _state(state),
+          _cal_set(cal_set),
+          _warn(warn),
+          _readIndelUsabilityPtr(readIndelUsabilityPtr)
+    {}
+
+    /// run the search starting from the exemplar alignment
+    ///
+    /// \param cal exemplar alignment, must remain valid for the duration of the search
+    void
+    run(
+        const CandidateAlignment& cal,
+        const known_pos_range& read_range,
+        const int max_read_indel_toggle);
+
+private:
+    typedef CandidateAlignmentSearchFrame frame_t;
+
+    /// extend the indel status for a new search level and test for termination
+    ///
+    /// \return false if the level is complete without visiting any child levels
+    bool
+    startLevel(frame_t& frame);
+
+    /// alignment 1) --> unchanged case
+    ///
+    /// \return true if a child level was pushed
+    bool
+    pushUnchangedChild(frame_t& frame);
+
+    /// toggle the current indel for the start and end pinned cases
+    ///
+    /// \return false if no toggled alignments should be searched at this level
+    bool
+    startToggledAlignments(frame_t& frame);
+
+    /// alignment 2) -- insert or delete indel and pin the start position
+    ///
+    /// \return true if a child level was pushed
+    bool
+    pushStartPinChild(frame_t& frame);
+
+    /// alignment 3) -- insert or delete indel and pin the end position
+    ///
+    /// \return true if a child level was pushed
+    bool
+    pushEndPinChild(frame_t& frame);
+
+    /// push a child level searching from the frame's pinned alignment
+    void
+    pushPinChild(const frame_t& frame)
+    {
+        _frames.emplace_back(frame.pinCal, frame.depth + 1, frame.indelToggleDepth + frame.indelToggleIncrement,
+                             frame.totalToggleDepth + 1, frame.read_range, frame.max_read_indel_toggle);
+    }
+
+    const IndelKey&
+    getCurIndel(const frame_t& frame) const
+    {
+        return _state.indel_order[frame.depth];
+    }
+
+    /// log the search context of a level which is active while an exception is handled
+    void
+    logLevelException(const frame_t& frame) const;
+
+    const starling_base_options& _opt;
+    const starling_base_deriv_options& _dopt;
+    const align_id_t _read_id;
+    const unsigned _read_length;
+    const IndelBuffer& _indelBuffer;
+    const unsigned _sampleId;
+    const known_pos_range& _realign_buffer_range;
+    CandidateAlignmentSearchState& _state;
+    std::set<CandidateAlignment>& _cal_set;
+    mca_warnings& _warn;
+    CandidateAlignmentCache::indel_usability_t* _readIndelUsabilityPtr;
+
+    /// a deque is used so that each level's pinned alignment stays at a fixed address while child levels are pushed
+    std::deque<frame_t> _frames;
+};
+
+
+
 void
-candidate_alignment_search(
-    const starling_base_options& opt,
-    const starling_base_deriv_options& dopt,
-    const align_id_t read_id,
-    const unsigned read_length,
-    const IndelBuffer& indelBuffer,
-    const unsigned sampleId,
-    const known_pos_range& realign_buffer_range,
-    std::set<CandidateAlignment>& cal_set,
-    mca_warnings& warn,
-    starling_align_indel_status indel_status_map,
-    HaplotypeStatusMap haplotypeStatusMap,
-    std::vector<IndelKey> indel_order,
-    const unsigned depth,
-    const unsigned indelToggleDepth,
-    const unsigned totalToggleDepth,
-    known_pos_range read_range,
-    int max_read_indel_toggle,
-    const CandidateAlignment& cal)
+CandidateAlignmentSearch::
+run(
+    const CandidateAlignment& cal,
+    const known_pos_range& read_range,
+    const int max_read_indel_toggle)
 {
+    static const unsigned startDepth(0);
+    static const unsigned startIndelToggleDepth(0);
+    static const unsigned startTotalToggleDepth(0);
+
+    _frames.emplace_back(cal, startDepth, startIndelToggleDepth, startTotalToggleDepth, read_range,
+                         max_read_indel_toggle);
+
+    try
+    {
+        while (! _frames.empty())
+        {
+            frame_t& frame(_frames.back());
+
+            // each case falls through to the next step of the level unless a child level is pushed:
+            switch (frame.step)
+            {
+            case frame_t::START:
+                if (! startLevel(frame)) break;
+                if (pushUnchangedChild(frame)) continue;
+            // fall through
+            case frame_t::AFTER_UNCHANGED_CHILD:
+                if (! startToggledAlignments(frame)) break;
+                if (pushStartPinChild(frame)) continue;
+            // fall through
+            case frame_t::AFTER_START_PIN_CHILD:
+                if (pushEndPinChild(frame)) continue;
+            // fall through
+            case frame_t::AFTER_END_PIN_CHILD:
+                break;
+            }
+
+            _state.revertTo(frame.entryMark);
+            _frames.pop_back();
+        }
+    }
+    catch (...)
+    {
+        // report context from the innermost to the outermost level with an active child:
+        const unsigned frameCount(_frames.size());
+        for (unsigned frameIndex(frameCount); frameIndex>1; --frameIndex)
+        {
+            logLevelException(_frames[frameIndex-2]);
+        }
+        throw;
+    }
+}
+
+
+
+bool
+CandidateAlignmentSearch::
+startLevel(frame_t& frame)
+{
+    const CandidateAlignment& cal(*frame.calPtr);
+    frame.entryMark = _state.getUndoMark();
+
 #ifdef DEBUG_ALIGN
-    std::cerr << "VARMIT starting MCA depth: " << depth << "\n";
+    std::cerr << "VARMIT starting MCA depth: " << frame.depth << "\n";
     std::cerr << "\twith cal: " << cal;
 #endif
 
+    starling_align_indel_status& indel_status_map(_state.indel_status_map);
+    std::vector<IndelKey>& indel_order(_state.indel_order);
+
     // first step is to check for new indel overlaps and extend the
     // indel_status_map as necessary:
     //
@@ -889,24 +1276,25 @@ candidate_alignment_search(
     // previous range so that we correctly overlap all potential new
     // indels.
     //
-    bool is_new_indels(indelToggleDepth==0);
+    bool is_new_indels(frame.indelToggleDepth==0);
     {
         const unsigned start_ism_size(indel_status_map.size());
         const known_pos_range pr(get_soft_clip_alignment_range(cal.al));
 
         // check to make sure we don't realign outside of the realign buffer:
-        if (! realign_buffer_range.is_superset_of(pr)) return;
+        if (! _realign_buffer_range.is_superset_of(pr)) return false;
 
+        known_pos_range& read_range(frame.read_range);
         if (pr.begin_pos < read_range.begin_pos)
         {
-            add_indels_in_range(read_id, indelBuffer, known_pos_range(pr.begin_pos, read_range.begin_pos + 1), sampleId,
-                                indel_status_map, indel_order);
+            add_indels_in_range(_read_id, _indelBuffer, known_pos_range(pr.begin_pos, read_range.begin_pos + 1), _sampleId,
+                                indel_status_map, indel_order, &_state.indelStatusUndoLog, _readIndelUsabilityPtr);
             read_range.begin_pos = pr.begin_pos;
         }
         if (pr.end_pos > read_range.end_pos)
         {
-            add_indels_in_range(read_id, indelBuffer, known_pos_range(read_range.end_pos - 1, pr.end_pos), sampleId,
-                                indel_status_map, indel_order);
+            add_indels_in_range(_read_id, _indelBuffer, known_pos_range(read_range.end_pos - 1, pr.end_pos), _sampleId,
+                                indel_status_map, indel_order, &_state.indelStatusUndoLog, _readIndelUsabilityPtr);
             read_range.end_pos = pr.end_pos;
         }
 
@@ -921,13 +1309,13 @@ candidate_alignment_search(
         }
     }
 
-    // next check for recursive termination:
-    if (depth == indel_order.size())
+    // next check for search termination:
+    if (frame.depth == indel_order.size())
     {
         CandidateAlignment calWithKeys(cal);
         addKeysToCandidateAlignment(indel_status_map, calWithKeys);
-        cal_set.insert(std::move(calWithKeys));
-        return;
+        _cal_set.insert(std::move(calWithKeys));
+        return false;
     }
 
     if (is_new_indels)
@@ -944,21 +1332,21 @@ candidate_alignment_search(
         // max indel size is ever run around the order of 10k or more this
         // might start to spuriously engage the filter.
         //
-        const double max_indels(read_length*opt.max_candidate_indel_density);
+        const double max_indels(_read_length*_opt.max_candidate_indel_density);
         if (indel_status_map.size()>max_indels)
         {
-            max_read_indel_toggle=1;
+            frame.max_read_indel_toggle=1;
         }
         else
         {
-            max_read_indel_toggle=opt.max_read_indel_toggle;
+            frame.max_read_indel_toggle=_opt.max_read_indel_toggle;
         }
 
         // a new stronger complexity limit on search based on total candidate indels crossing the read:
         //
         {
-            const int max_toggle(dopt.sal.get_max_toggle(indel_status_map.size()));
-            max_read_indel_toggle=std::min(max_read_indel_toggle,max_toggle);
+            const int max_toggle(_dopt.sal.get_max_toggle(indel_status_map.size()));
+            frame.max_read_indel_toggle=std::min(frame.max_read_indel_toggle,max_toggle);
         }
     }
 
@@ -966,13 +1354,13 @@ candidate_alignment_search(
     // number of toggles made to the exemplar alignment (this is
     // here to prevent a combinatorial blowup)
     //
-    if (static_cast<int>(indelToggleDepth)>max_read_indel_toggle)
+    if (static_cast<int>(frame.indelToggleDepth)>frame.max_read_indel_toggle)
     {
-        warn.max_toggle_depth=true;
-        return;
+        _warn.max_toggle_depth=true;
+        return false;
     }
 
-    // each recursive step invokes (up to) 3 paths:
+    // each search level invokes (up to) 3 paths:
     //  1) is the current state of the active indel
     //  2) is the alternate state of the active indel with the alignment's start position pinned
     //  3) is the alternate state of the active indel with the alignment's end position pinned
@@ -989,294 +1377,331 @@ candidate_alignment_search(
     // edge-indels can only be pinned on one side
     //
 
-    const IndelKey& curIndel(indel_order[depth]);
+    const IndelKey& curIndel(getCurIndel(frame));
 
-    bool isCurIndelConflicting(false);
-    bool containsIndelNotDiscoveredFromReads(false);
-    for (unsigned i(0); i<depth; ++i)
+    frame.isCurIndelConflicting = false;
+    frame.containsIndelNotDiscoveredFromReads = false;
+    for (unsigned i(0); i<frame.depth; ++i)
     {
         const IndelKey& indelKey(indel_order[i]);
 
-        if (!(indel_status_map[indelKey].is_present)) continue;
-        if (is_indel_conflict(indelKey, curIndel)) isCurIndelConflicting = true;
-        if ((! containsIndelNotDiscoveredFromReads) &&
-            (indelBuffer.getIndelDataPtr(indelKey)->status.notDiscoveredFromReads))
+        if (! _state.isIndelPresent(indelKey)) continue;
+        if (is_indel_conflict(indelKey, curIndel)) frame.isCurIndelConflicting = true;
+        if ((! frame.containsIndelNotDiscoveredFromReads) &&
+            (_indelBuffer.getIndelDataPtr(indelKey)->status.notDiscoveredFromReads))
         {
-            containsIndelNotDiscoveredFromReads = true;
+            frame.containsIndelNotDiscoveredFromReads = true;
         }
     }
 
-    const unsigned sampleCount(opt.getSampleCount());
+    const unsigned sampleCount(_opt.getSampleCount());
 
-    const bool isCurIndelOn(indel_status_map[curIndel].is_present);
-    const IndelData& curIndelData(*indelBuffer.getIndelDataPtr(curIndel));
+    const starling_align_indel_info& curIndelInfo(indel_status_map.find(curIndel)->second);
+    frame.isCurIndelOn = curIndelInfo.is_present;
+    const IndelData& curIndelData(*_indelBuffer.getIndelDataPtr(curIndel));
 
-    const ActiveRegionId curIndelActiveRegionId(curIndelData.activeRegionId);
-    const bool isCurIndelInActiveRegion(curIndelActiveRegionId >= 0);
+    frame.curIndelActiveRegionId = curIndelData.activeRegionId;
+    const bool isCurIndelInActiveRegion(frame.curIndelActiveRegionId >= 0);
     if (isCurIndelInActiveRegion)
     {
-        auto it = haplotypeStatusMap.find(curIndelActiveRegionId);
-        if (it == haplotypeStatusMap.end())
-        {
-            haplotypeStatusMap.insert(std::make_pair(curIndelActiveRegionId, HaplotypeStatus(sampleCount)));
-        }
+        _state.addHaplotypeStatus(frame.curIndelActiveRegionId, sampleCount);
     }
 
     // true if current indel is an external indel not discovered from reads
-    const bool isCurIndelNotDiscoveredFromReads(curIndelData.status.notDiscoveredFromReads);
+    frame.isCurIndelNotDiscoveredFromReads = curIndelData.status.notDiscoveredFromReads;
 
     // Get haplotype IDs of current indel in all samples
-    std::vector<int> curIndelHaplotypeIds(sampleCount);
+    frame.curIndelHaplotypeIds.assign(sampleCount, 0);
     getCurIndelHaplotypeIds(
-        opt.isHaplotypingEnabled,
-        sampleId,
+        _opt.isHaplotypingEnabled,
+        _sampleId,
         curIndel,
         curIndelData,
-        indel_status_map[curIndel].isInOriginalAlignment,
-        curIndelHaplotypeIds);
+        curIndelInfo.isInOriginalAlignment,
+        frame.curIndelHaplotypeIds);
 
-    // alignment 1) --> unchanged case:
-    try
-    {
-        bool isNextCandidateAlignmentValid(true);
+    return true;
+}
 
-        // 1. Check haplotype constraints
-        HaplotypeStatusMap newHaplotypeStatusMap(haplotypeStatusMap);
-        if ((! isCurIndelConflicting) && isCurIndelInActiveRegion)
-        {
-            isNextCandidateAlignmentValid = newHaplotypeStatusMap.at(curIndelActiveRegionId)
-                                            .updateHaplotypeStatus(curIndelHaplotypeIds, isCurIndelOn);
-        }
-        else
-        {
-            // current indel is conflicting or there's no haplotype info
-            isNextCandidateAlignmentValid = (! curIndel.isMismatch()) || (! isCurIndelOn);
-        }
 
-        // 2. Check whether we will be including
-        // more than one indels without enough read support
-        if (isCurIndelOn && containsIndelNotDiscoveredFromReads &&
-            isCurIndelNotDiscoveredFromReads)
-        {
-            // it's prohibited to include more than one indels without enough read support
-            isNextCandidateAlignmentValid = false;
-        }
 
-        if ((! isNextCandidateAlignmentValid) && (totalToggleDepth == 0))
-        {
-            // even if the above conditions are not met,
-            // if there was no indel toggle,
-            // allow the alignment search to proceed
-            isNextCandidateAlignmentValid = true;
-        }
+bool
+CandidateAlignmentSearch::
+pushUnchangedChild(frame_t& frame)
+{
+    frame.step = frame_t::AFTER_UNCHANGED_CHILD;
+    frame.unchangedChildMark = _state.getUndoMark();
 
-        if (isNextCandidateAlignmentValid)
-        {
-            candidate_alignment_search(opt, dopt, read_id, read_length, indelBuffer,
-                                       sampleId, realign_buffer_range,
-                                       cal_set, warn,
-                                       indel_status_map, newHaplotypeStatusMap,
-                                       indel_order, depth + 1, indelToggleDepth, totalToggleDepth,
-                                       read_range, max_read_indel_toggle, cal);
-        }
+    const IndelKey& curIndel(getCurIndel(frame));
+    const bool isCurIndelInActiveRegion(frame.curIndelActiveRegionId >= 0);
+
+    bool isNextCandidateAlignmentValid(true);
+
+    // 1. Check haplotype constraints
+    if ((! frame.isCurIndelConflicting) && isCurIndelInActiveRegion)
+    {
+        isNextCandidateAlignmentValid = _state.updateHaplotypeStatus(frame.curIndelActiveRegionId,
+                                                                     frame.curIndelHaplotypeIds, frame.isCurIndelOn);
     }
-    catch (...)
+    else
     {
-        log_os << "\nException caught while building default alignment candidate at depth: " << depth << "\n"
-               << "\tcal: " << cal
-               << "this_indel: " << curIndel;
-        throw;
+        // current indel is conflicting or there's no haplotype info
+        isNextCandidateAlignmentValid = (! curIndel.isMismatch()) || (! frame.isCurIndelOn);
+    }
+
+    // 2. Check whether we will be including
+    // more than one indels without enough read support
+    if (frame.isCurIndelOn && frame.containsIndelNotDiscoveredFromReads &&
+        frame.isCurIndelNotDiscoveredFromReads)
+    {
+        // it's prohibited to include more than one indels without enough read support
+        isNextCandidateAlignmentValid = false;
+    }
+
+    if ((! isNextCandidateAlignmentValid) && (frame.totalToggleDepth == 0))
+    {
+        // even if the above conditions are not met,
+        // if there was no indel toggle,
+        // allow the alignment search to proceed
+        isNextCandidateAlignmentValid = true;
     }
 
+    if (! isNextCandidateAlignmentValid) return false;
+
+    _frames.emplace_back(*frame.calPtr, frame.depth + 1, frame.indelToggleDepth, frame.totalToggleDepth,
+                         frame.read_range, frame.max_read_indel_toggle);
+    return true;
+}
+
+
+
+bool
+CandidateAlignmentSearch::
+startToggledAlignments(frame_t& frame)
+{
+    // remove haplotype constraints added for the unchanged case:
+    _state.revertTo(frame.unchangedChildMark);
+
+    const IndelKey& curIndel(getCurIndel(frame));
+    const bool isCurIndelInActiveRegion(frame.curIndelActiveRegionId >= 0);
+
     bool isNextCandidateAlignmentValid(true);
-    HaplotypeStatusMap newHaplotypeStatusMap(haplotypeStatusMap);
-    if (!isCurIndelConflicting && isCurIndelInActiveRegion)
+    if ((! frame.isCurIndelConflicting) && isCurIndelInActiveRegion)
     {
-        isNextCandidateAlignmentValid = newHaplotypeStatusMap.at(curIndelActiveRegionId).updateHaplotypeStatus(curIndelHaplotypeIds, !isCurIndelOn);
+        isNextCandidateAlignmentValid = _state.updateHaplotypeStatus(frame.curIndelActiveRegionId,
+                                                                     frame.curIndelHaplotypeIds, (! frame.isCurIndelOn));
     }
     else
     {
-        isNextCandidateAlignmentValid = !curIndel.isMismatch() || isCurIndelOn;
+        isNextCandidateAlignmentValid = (! curIndel.isMismatch()) || frame.isCurIndelOn;
     }
 
     // Check whether we will be including
     // more than one indels not discovered from reads
-    if (!isCurIndelOn &&
-        containsIndelNotDiscoveredFromReads &&
-        isCurIndelNotDiscoveredFromReads)
+    if ((! frame.isCurIndelOn) &&
+        frame.containsIndelNotDiscoveredFromReads &&
+        frame.isCurIndelNotDiscoveredFromReads)
     {
         // it's prohibited to include more than one indels without enough read support
         isNextCandidateAlignmentValid = false;
     }
 
-    if (! isNextCandidateAlignmentValid) return;
+    if (! isNextCandidateAlignmentValid) return false;
 
-    if (! isCurIndelOn)
+    if (! frame.isCurIndelOn)
     {
         // check whether this is a remove only indel:
-        if (indel_status_map[curIndel].is_remove_only) return;
+        if (_state.indel_status_map.find(curIndel)->second.is_remove_only) return false;
 
         // check whether this indel would interfere with an indel that's
         // already been toggled on:
         //
-        if (isCurIndelConflicting) return;
+        if (frame.isCurIndelConflicting) return false;
     }
 
     // Mismatches discovered in AR doesn't increase toggle depth,
     // because #alignments is constrained by phasing info
-    unsigned indelToggleIncrement(curIndel.isMismatch() ? 0 : 1);
+    frame.indelToggleIncrement = (curIndel.isMismatch() ? 0 : 1);
 
     // check whether toggling this indel would exceed the maximum
     // number of toggles made to the exemplar alignment (this is
     // here to prevent a combinatorial blowup)
     //
-    if (static_cast<int>(indelToggleDepth+indelToggleIncrement)>max_read_indel_toggle)
+    if (static_cast<int>(frame.indelToggleDepth+frame.indelToggleIncrement)>frame.max_read_indel_toggle)
     {
-        warn.max_toggle_depth=true;
-        return;
+        _warn.max_toggle_depth=true;
+        return false;
     }
 
     // changed cases:
-    indel_status_map[curIndel].is_present=(! isCurIndelOn);
+    _state.setIndelPresent(curIndel, (! frame.isCurIndelOn));
 
     // extract only those indels that are present in the next
     // alignment:
     //
-    indel_set_t current_indels;
-    for (const auto& is : indel_status_map)
+    frame.current_indels.clear();
+    for (const auto& is : _state.indel_status_map)
     {
-        if (is.second.is_present) current_indels.insert(is.first);
+        if (is.second.is_present) frame.current_indels.insert(is.first);
     }
 
+    return true;
+}
+
+
+
+bool
+CandidateAlignmentSearch::
+pushStartPinChild(frame_t& frame)
+{
+    frame.step = frame_t::AFTER_START_PIN_CHILD;
+
+    const CandidateAlignment& cal(*frame.calPtr);
+    const IndelKey& curIndel(getCurIndel(frame));
+
     // a pin on either end of the alignment is not possible/sensible
     // if:
     //
     // A) a deletion is being added which spans the pin site
     // B) an edge insertion/breakpoint is being removed from the pinned side
 
-    // alignment 2) -- insert or delete indel and pin the start position
-    //
     // test for conditions where the start pin is not possible:
     //
+    const pos_t ref_start_pos(cal.al.pos);
+
+    bool is_start_pin_valid(true);
+    if (! curIndel.isMismatch())
     {
-        const pos_t ref_start_pos(cal.al.pos);
+        const bool is_start_pos_delete_span(curIndel.open_pos_range().is_pos_intersect(ref_start_pos));
+        const bool is_start_pos_indel_span(frame.isCurIndelOn && (curIndel == cal.leading_indel_key));
+        is_start_pin_valid = (! (is_start_pos_delete_span || is_start_pos_indel_span));
+    }
 
-        bool is_start_pin_valid(true);
-        if (! curIndel.isMismatch())
-        {
-            const bool is_start_pos_delete_span(curIndel.open_pos_range().is_pos_intersect(ref_start_pos));
-            const bool is_start_pos_indel_span(isCurIndelOn && (curIndel == cal.leading_indel_key));
-            is_start_pin_valid = (! (is_start_pos_delete_span || is_start_pos_indel_span));
-        }
+    if (! is_start_pin_valid) return false;
 
-#ifdef DEBUG_ALIGN
-        std::cerr << "VARMIT toggling MCA depth: " << depth << "\n";
-        std::cerr << "VARMIT current indel: " << cindel;
-        std::cerr << "VARMIT current indel on?: " << is_cindel_on << "\n";
-        std::cerr << "VARMIT start-pin valid?: " << is_start_pin_valid << "\n";
-#endif
-
-        if (is_start_pin_valid)
-        {
-            const pos_t read_start_pos(unalignedPrefixSize(cal.al.path));
-            CandidateAlignment start_cal;
-            try
-            {
-                start_cal = make_start_pos_alignment(ref_start_pos,
-                                                     read_start_pos,
-                                                     cal.al.is_fwd_strand,
-                                                     read_length,
-                                                     current_indels);
-
-                candidate_alignment_search(opt, dopt, read_id, read_length, indelBuffer,
-                                           sampleId,
-                                           realign_buffer_range, cal_set,
-                                           warn, indel_status_map, newHaplotypeStatusMap,
-                                           indel_order, depth + 1, indelToggleDepth + indelToggleIncrement, totalToggleDepth + 1,
-                                           read_range, max_read_indel_toggle,
-                                           start_cal);
-            }
-            catch (...)
-            {
-                add_pin_exception_info("start",depth,cal,start_cal,ref_start_pos,read_start_pos,curIndel,current_indels);
-                throw;
-            }
-        }
+    frame.pinRefStartPos = ref_start_pos;
+    frame.pinReadStartPos = unalignedPrefixSize(cal.al.path);
+    frame.pinCal = CandidateAlignment();
+    try
+    {
+        frame.pinCal = make_start_pos_alignment(frame.pinRefStartPos,
+                                                frame.pinReadStartPos,
+                                                cal.al.is_fwd_strand,
+                                                _read_length,
+                                                frame.current_indels);
+    }
+    catch (...)
+    {
+        logLevelException(frame);
+        throw;
     }
 
+    pushPinChild(frame);
+    return true;
+}
+
+
+
+bool
+CandidateAlignmentSearch::
+pushEndPinChild(frame_t& frame)
+{
+    frame.step = frame_t::AFTER_END_PIN_CHILD;
+
+    const CandidateAlignment& cal(*frame.calPtr);
+    const IndelKey& curIndel(getCurIndel(frame));
+
     // check whether this is a mismatch or an equal-length swap,
     // in which case alignment 3 is unnecessary:
-    if (curIndel.isMismatch()) return;
-    if ((curIndel.type==INDEL::INDEL) && (curIndel.delete_length()==curIndel.insert_length())) return;
+    if (curIndel.isMismatch()) return false;
+    if ((curIndel.type==INDEL::INDEL) && (curIndel.delete_length()==curIndel.insert_length())) return false;
 
-    // alignment 3) -- insert or delete indel and pin the end position
-    //
     // test for conditions where end-pin is not possible:
     //
+    const pos_t ref_end_pos(cal.al.pos+apath_ref_length(cal.al.path));
+
+    // end pin is not possible when
+    // (1) an indel deletes through the end-pin position
+    // (2) we try to remove a trailing indel [TODO seems like same rule should be in place for adding a trailing indel]
+    const bool is_end_pos_delete_span(curIndel.open_pos_range().is_pos_intersect(ref_end_pos-1));
+    const bool is_end_pos_indel_span(frame.isCurIndelOn && (curIndel == cal.trailing_indel_key));
+    const bool is_end_pin_valid(! (is_end_pos_delete_span || is_end_pos_indel_span));
+
+    if (! is_end_pin_valid) return false;
+
+    // work backwards from end_pos to get start_pos and
+    // read_start_pos when the current indel set included,
+    // and then used the make_start_pos_alignment routine.
+    const pos_t read_end_pos(_read_length-unalignedSuffixSize(cal.al.path));
+    pos_t ref_start_pos(0);
+    pos_t read_start_pos(0);
+    get_end_pin_start_pos(frame.current_indels,_read_length,
+                          ref_end_pos,read_end_pos,
+                          ref_start_pos,read_start_pos);
+
+    // guard against low-frequency circular chromosome event:
+    if (ref_start_pos<0)
     {
-        const pos_t ref_end_pos(cal.al.pos+apath_ref_length(cal.al.path));
+        _warn.origin_skip=true;
+        return false;
+    }
 
-        // end pin is not possible when
-        // (1) an indel deletes through the end-pin position
-        // (2) we try to remove a trailing indel [TODO seems like same rule should be in place for adding a trailing indel]
-        const bool is_end_pos_delete_span(curIndel.open_pos_range().is_pos_intersect(ref_end_pos-1));
-        const bool is_end_pos_indel_span(isCurIndelOn && (curIndel == cal.trailing_indel_key));
-        const bool is_end_pin_valid(! (is_end_pos_delete_span || is_end_pos_indel_span));
+    frame.pinRefStartPos = ref_start_pos;
+    frame.pinReadStartPos = read_start_pos;
+    frame.pinRefEndPos = ref_end_pos;
+    frame.pinReadEndPos = read_end_pos;
+    frame.pinCal = CandidateAlignment();
+    try
+    {
+        frame.pinCal = make_start_pos_alignment(ref_start_pos,
+                                                read_start_pos,
+                                                cal.al.is_fwd_strand,
+                                                _read_length,
+                                                frame.current_indels);
+    }
+    catch (...)
+    {
+        logLevelException(frame);
+        throw;
+    }
 
-#ifdef DEBUG_ALIGN
-        std::cerr << "VARMIT toggling MCA depth: " << depth << "\n";
-        std::cerr << "VARMIT current indel: " << cindel;
-        std::cerr << "VARMIT current indel on?: " << is_cindel_on << "\n";
-        std::cerr << "VARMIT end-pin valid?: " << is_end_pin_valid << "\n";
-#endif
+    pushPinChild(frame);
+    return true;
+}
 
-        if (is_end_pin_valid)
-        {
-            // work backwards from end_pos to get start_pos and
-            // read_start_pos when the current indel set included,
-            // and then used the make_start_pos_alignment routine.
-            const pos_t read_end_pos(read_length-+unalignedSuffixSize(cal.al.path));
-            pos_t ref_start_pos(0);
-            pos_t read_start_pos(0);
-            get_end_pin_start_pos(current_indels,read_length,
-                                  ref_end_pos,read_end_pos,
-                                  ref_start_pos,read_start_pos);
-
-            // guard against low-frequency circular chromosome event:
-            if (ref_start_pos<0)
-            {
-                warn.origin_skip=true;
-            }
-            else
-            {
-                CandidateAlignment start_cal;
-                try
-                {
-                    start_cal = make_start_pos_alignment(ref_start_pos,
-                                                         read_start_pos,
-                                                         cal.al.is_fwd_strand,
-                                                         read_length,
-                                                         current_indels);
-
-                    candidate_alignment_search(opt, dopt, read_id, read_length, indelBuffer, sampleId,
-                                               realign_buffer_range, cal_set,
-                                               warn, indel_status_map, newHaplotypeStatusMap,
-                                               indel_order, depth + 1, indelToggleDepth + indelToggleIncrement, totalToggleDepth + 1,
-                                               read_range, max_read_indel_toggle, start_cal);
-                }
-                catch (...)
-                {
-                    add_pin_exception_info("end",depth,cal,start_cal,ref_start_pos,read_start_pos,curIndel,current_indels);
-                    log_os << "ref_end_pos: " << ref_end_pos << "\n"
-                           << "read_end_pos: " << read_end_pos << "\n";
-                    throw;
-                }
-            }
-        }
+
+
+void
+CandidateAlignmentSearch::
+logLevelException(const frame_t& frame) const
+{
+    const CandidateAlignment& cal(*frame.calPtr);
+    const IndelKey& curIndel(getCurIndel(frame));
+
+    switch (frame.step)
+    {
+    case frame_t::AFTER_UNCHANGED_CHILD:
+        log_os << "\nException caught while building default alignment candidate at depth: " << frame.depth << "\n"
+               << "\tcal: " << cal
+               << "this_indel: " << curIndel;
+        break;
+    case frame_t::AFTER_START_PIN_CHILD:
+        add_pin_exception_info("start",frame.depth,cal,frame.pinCal,frame.pinRefStartPos,frame.pinReadStartPos,
+                               curIndel,frame.current_indels);
+        break;
+    case frame_t::AFTER_END_PIN_CHILD:
+        add_pin_exception_info("end",frame.depth,cal,frame.pinCal,frame.pinRefStartPos,frame.pinReadStartPos,
+                               curIndel,frame.current_indels);
+        log_os << "ref_end_pos: " << frame.pinRefEndPos << "\n"
+               << "read_end_pos: " << frame.pinReadEndPos << "\n";
+        break;
+    default:
+        break;
     }
 }
 
 
+
 /// Summary stats of an alignment
 struct extra_path_info
 {
@@ -1531,6 +1956,9 @@ getCandidateAlignment(
 /// (3) Identify the 'representative' alignment to use for downstream SNV calling. This is chosen based on
 ///     a combination of high score and low complexity.
 ///
+/// \param[in,out] candAlignmentScores scores for each candidate alignment. If non-empty on input, these are
+///                 used in place of scoring the candidate alignments again.
+///
 static
 void
 scoreCandidateAlignments(
@@ -1561,14 +1989,24 @@ scoreCandidateAlignments(
     const std::pair<bool,bool> edge_pin(readSegment.get_segment_edge_pin());
     const bool is_pinned(edge_pin.first || edge_pin.second);
 
+    const bool isPrecomputedScores(! candAlignmentScores.empty());
+    assert((! isPrecomputedScores) || (candAlignmentScores.size() == candAlignments.size()));
+
     const auto cal_set_begin(candAlignments.cbegin()), cal_set_end(candAlignments.cend());
-    for (auto cal_iter(cal_set_begin); cal_iter!=cal_set_end; ++cal_iter)
+    unsigned scoreIndex(0);
+    for (auto cal_iter(cal_set_begin); cal_iter!=cal_set_end; ++cal_iter, ++scoreIndex)
     {
         const CandidateAlignment& ical(*cal_iter);
-        const double path_lnp(
-            scoreCandidateAlignment(opt, indelBuffer, readSegment, ical, ref));
-
-        candAlignmentScores.push_back(path_lnp);
+        double path_lnp(0);
+        if (isPrecomputedScores)
+        {
+            path_lnp = candAlignmentScores[scoreIndex];
+        }
+        else
+        {
+            path_lnp = scoreCandidateAlignment(opt, indelBuffer, readSegment, ical, ref);
+            candAlignmentScores.push_back(path_lnp);
+        }
 
 #ifdef DEBUG_ALIGN
         std::cerr << "VARMIT CANDIDATE ALIGNMENT " << ical;
@@ -1745,6 +2183,8 @@ scoreCandidateAlignments(
 /// \brief Find the most likely alignment and most likely alignment for
 /// each indel state for every indel in indel_status_map
 ///
+/// \param[in,out] candAlignmentScores see scoreCandidateAlignments
+///
 static
 void
 scoreCandidateAlignmentsAndIndels(
@@ -1755,10 +2195,11 @@ scoreCandidateAlignmentsAndIndels(
     read_segment& rseg,
     IndelBuffer& indelBuffer,
     const unsigned sampleId,
-    std::set<CandidateAlignment>& candAlignments,
+    const std::set<CandidateAlignment>& candAlignments,
     const bool is_incomplete_search,
     const bool isTestSoftClippedInputAligned,
-    const alignment& softClippedInputAlignment)
+    const alignment& softClippedInputAlignment,
+    std::vector<double>& candAlignmentScores)
 {
     assert(! candAlignments.empty());
 
@@ -1772,7 +2213,6 @@ scoreCandidateAlignmentsAndIndels(
     // (1b) possibly also find a "best" scoring path for re-alignment
     // which is not (quite) the max
     //
-    std::vector<double> candAlignmentScores;
     double maxCandAlignmentScore(0);
     const CandidateAlignment* maxCandAlignmentPtr(nullptr);
 
@@ -1813,6 +2253,8 @@ scoreCandidateAlignmentsAndIndels(
 
 
 
+/// \param[out] readIndelUsabilityPtr if non-null, record all indel usability decisions specific to this read
+///              made during the candidate alignment search
 static
 void
 getCandidateAlignments(
@@ -1825,13 +2267,14 @@ getCandidateAlignments(
     const alignment& inputAlignment,
     const known_pos_range realign_buffer_range,
     mca_warnings& warn,
-    std::set<CandidateAlignment>& cal_set)
+    std::set<CandidateAlignment>& cal_set,
+    CandidateAlignmentCache::indel_usability_t* readIndelUsabilityPtr)
 {
     const unsigned read_length(rseg.read_size());
 
-    starling_align_indel_status indel_status_map;
-    HaplotypeStatusMap haplotypeStatusMap;
-    std::vector<IndelKey> indel_order;
+    CandidateAlignmentSearchState searchState;
+    starling_align_indel_status& indel_status_map(searchState.indel_status_map);
+    std::vector<IndelKey>& indel_order(searchState.indel_order);
 
     CandidateAlignment cal;
     getCandidateAlignment(inputAlignment, rseg, cal);
@@ -1842,7 +2285,8 @@ getCandidateAlignments(
 
     // Get indel set and indel order for the input alignment:
     const known_pos_range exemplar_pr(get_soft_clip_alignment_range(cal.al));
-    add_indels_in_range(rseg.getReadIndex(), indelBuffer, exemplar_pr, sampleId, indel_status_map, indel_order);
+    add_indels_in_range(rseg.getReadIndex(), indelBuffer, exemplar_pr, sampleId, indel_status_map, indel_order,
+                        nullptr, readIndelUsabilityPtr);
 
 #ifdef DEBUG_ALIGN
     std::cerr << "VARMIT exemplar alignment range: " << exemplar_pr << "\n";
@@ -1948,16 +2392,13 @@ getCandidateAlignments(
         cal_read_length-=(sc_lead+sc_trail);
     }
 
-    // launch recursive re-alignment routine starting from the current exemplar alignment:
-    static const unsigned startDepth(0);
-    static const unsigned startIndelToggleDepth(0);
-    static const unsigned startTotalToggleDepth(0);
-
-    candidate_alignment_search(opt, dopt, rseg.getReadIndex(), cal_read_length, indelBuffer,
-                               sampleId, realign_buffer_range, cal_set,
-                               warn, indel_status_map, haplotypeStatusMap,
-                               indel_order, startDepth, startIndelToggleDepth, startTotalToggleDepth,
-                               exemplar_pr, opt.max_read_indel_toggle, cal);
+    // launch re-alignment search starting from the current exemplar alignment:
+    {
+        CandidateAlignmentSearch search(opt, dopt, rseg.getReadIndex(), cal_read_length, indelBuffer,
+                                        sampleId, realign_buffer_range, searchState, cal_set, warn,
+                                        readIndelUsabilityPtr);
+        search.run(cal, exemplar_pr, opt.max_read_indel_toggle);
+    }
 
     if (is_input_alignment_clipped)
     {
@@ -2019,6 +2460,42 @@ normalizeInputAlignmentIndels(
 
 
 
+/// \return true if a cached candidate alignment search result can be used for the read with the given id
+///
+/// All other search inputs are matched by the cache key, so the cached result is valid if every indel usability
+/// decision that depended on the original read's own indel evidence is the same for this read.
+///
+static
+bool
+isCachedCandidateAlignmentSearchValid(
+    const IndelBuffer& indelBuffer,
+    const align_id_t read_id,
+    const unsigned sampleId,
+    const CandidateAlignmentCache::Entry& cacheEntry)
+{
+    for (const auto& indelUsability : cacheEntry.readIndelUsability)
+    {
+        const IndelKey& indelKey(indelUsability.first);
+        const IndelData* indelDataPtr(indelBuffer.getIndelDataPtr(indelKey));
+        if (nullptr == indelDataPtr) return false;
+        if (is_usable_indel(indelBuffer, indelKey, *indelDataPtr, read_id, sampleId) != indelUsability.second) return false;
+    }
+    return true;
+}
+
+
+
+static
+std::string
+getReadQualityString(
+    const read_segment& rseg)
+{
+    const uint8_t* qual(rseg.qual());
+    return std::string(qual, qual+rseg.read_size());
+}
+
+
+
 void
 realignAndScoreRead(
     const starling_base_options& opt,
@@ -2028,7 +2505,8 @@ realignAndScoreRead(
     const known_pos_range& realign_buffer_range,
     const unsigned sampleId,
     read_segment& rseg,
-    IndelBuffer& indelBuffer)
+    IndelBuffer& indelBuffer,
+    CandidateAlignmentCache* candAlignmentCachePtr)
 {
     if (! rseg.is_valid())
     {
@@ -2083,11 +2561,59 @@ realignAndScoreRead(
     //
     std::set<CandidateAlignment> cal_set;
     mca_warnings warn;
+    std::vector<double> candAlignmentScores;
+
+    // the candidate alignment set (and possibly its scores) may be reused from an earlier read with
+    // the same input alignment and sequence in this realignment window:
+    const std::set<CandidateAlignment>* candAlignmentsPtr(&cal_set);
+    CandidateAlignmentCache::Entry* cacheEntryPtr(nullptr);
+    std::string readQualities;
+    if (nullptr != candAlignmentCachePtr)
+    {
+        readQualities = getReadQualityString(rseg);
 
-    getCandidateAlignments(opt, dopt, ref, rseg, indelBuffer, sampleId, normalizedInputAlignment,
-                           realign_buffer_range, warn, cal_set);
+        CandidateAlignmentCache::Key cacheKey;
+        cacheKey.sampleId = sampleId;
+        cacheKey.inputAlignment = inputAlignment;
+        cacheKey.edgePin = rseg.get_segment_edge_pin();
+        bam_seq_to_str(rseg.get_bam_read(), 0, rseg.read_size(), cacheKey.readSequence);
 
-    if ( cal_set.empty() )
+        cacheEntryPtr = candAlignmentCachePtr->getEntry(cacheKey);
+        if ((nullptr != cacheEntryPtr) &&
+            isCachedCandidateAlignmentSearchValid(indelBuffer, rseg.getReadIndex(), sampleId, *cacheEntryPtr))
+        {
+            candAlignmentsPtr = &(cacheEntryPtr->candAlignments);
+            warn.origin_skip = cacheEntryPtr->isOriginSkip;
+            warn.max_toggle_depth = cacheEntryPtr->isMaxToggleDepth;
+            if (readQualities == cacheEntryPtr->readQualities)
+            {
+                candAlignmentScores = cacheEntryPtr->candAlignmentScores;
+            }
+        }
+        else
+        {
+            CandidateAlignmentCache::indel_usability_t readIndelUsability;
+            getCandidateAlignments(opt, dopt, ref, rseg, indelBuffer, sampleId, normalizedInputAlignment,
+                                   realign_buffer_range, warn, cal_set, &readIndelUsability);
+
+            CandidateAlignmentCache::Entry& cacheEntry(candAlignmentCachePtr->getNewEntry(cacheKey));
+            cacheEntry.candAlignments = std::move(cal_set);
+            cacheEntry.isOriginSkip = warn.origin_skip;
+            cacheEntry.isMaxToggleDepth = warn.max_toggle_depth;
+            cacheEntry.readIndelUsability = std::move(readIndelUsability);
+            cacheEntryPtr = &cacheEntry;
+            candAlignmentsPtr = &(cacheEntry.candAlignments);
+        }
+    }
+    else
+    {
+        getCandidateAlignments(opt, dopt, ref, rseg, indelBuffer, sampleId, normalizedInputAlignment,
+                               realign_buffer_range, warn, cal_set, nullptr);
+    }
+
+    const std::set<CandidateAlignment>& candAlignments(*candAlignmentsPtr);
+
+    if ( candAlignments.empty() )
     {
         std::ostringstream oss;
         oss << "Empty candidate alignment set while realigning normed input alignment: " << normalizedInputAlignment << "\n";
@@ -2118,6 +2644,13 @@ realignAndScoreRead(
 
     const bool isTestSoftClippedInputAligned(opt.isRetainOptimalSoftClipping && isSoftClippedInputAlignment);
     scoreCandidateAlignmentsAndIndels(opt, dopt, sample_opt, ref,
-                                      rseg, indelBuffer, sampleId, cal_set, is_incomplete_search,
-                                      isTestSoftClippedInputAligned, softClippedInputAlignment);
+                                      rseg, indelBuffer, sampleId, candAlignments, is_incomplete_search,
+                                      isTestSoftClippedInputAligned, softClippedInputAlignment,
+                                      candAlignmentScores);
+
+    if ((nullptr != cacheEntryPtr) && cacheEntryPtr->candAlignmentScores.empty())
+    {
+        cacheEntryPtr->readQualities = readQualities;
+        cacheEntryPtr->candAlignmentScores = candAlignmentScores;
+    }
 }
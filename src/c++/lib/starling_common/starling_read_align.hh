@@ -24,11 +24,99 @@
 #pragma once
 
 
+#include "starling_common/CandidateAlignment.hh"
 #include "starling_common/IndelBuffer.hh"
 #include "starling_common/starling_read.hh"
 #include "starling_common/starling_base_shared.hh"
 #include "CandidateSnvBuffer.hh"
 
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/// \brief Candidate alignment search results shared by reads realigned in the same realignment window
+///
+/// Duplicate-rich and amplicon data often contain many reads at one locus with the same input alignment and
+/// sequence, which produce the same candidate alignment set. When base qualities also match, the candidate
+/// alignment scores are the same as well.
+///
+/// Entries are only valid for one realignment window over an unchanged indel buffer, so the cache must be
+/// cleared before realigning reads at the next position.
+///
+struct CandidateAlignmentCache
+{
+    /// indels tested for usability against the indel evidence of the specific read being realigned, paired
+    /// with the test result
+    typedef std::vector<std::pair<IndelKey,bool>> indel_usability_t;
+
+    struct Key
+    {
+        bool
+        operator<(const Key& rhs) const
+        {
+            if (sampleId < rhs.sampleId) return true;
+            if (sampleId != rhs.sampleId) return false;
+            if (inputAlignment < rhs.inputAlignment) return true;
+            if (not (inputAlignment == rhs.inputAlignment)) return false;
+            if (edgePin < rhs.edgePin) return true;
+            if (edgePin != rhs.edgePin) return false;
+            return (readSequence < rhs.readSequence);
+        }
+
+        unsigned sampleId = 0;
+        alignment inputAlignment;
+        std::pair<bool,bool> edgePin;
+        std::string readSequence;
+    };
+
+    struct Entry
+    {
+        std::set<CandidateAlignment> candAlignments;
+        bool isOriginSkip = false;
+        bool isMaxToggleDepth = false;
+        indel_usability_t readIndelUsability;
+
+        /// base qualities of the read used to compute candAlignmentScores
+        std::string readQualities;
+        std::vector<double> candAlignmentScores;
+    };
+
+    /// \return cached entry for key or nullptr if none exists
+    Entry*
+    getEntry(const Key& key)
+    {
+        const auto iter(_entries.find(key));
+        return ((iter == _entries.end()) ? nullptr : &(iter->second));
+    }
+
+    /// \return an empty entry for key, replacing any existing entry
+    Entry&
+    getNewEntry(const Key& key)
+    {
+        Entry& entry(_entries[key]);
+        entry = Entry();
+        return entry;
+    }
+
+    void
+    clear()
+    {
+        _entries.clear();
+    }
+
+    unsigned
+    size() const
+    {
+        return _entries.size();
+    }
+
+private:
+    std::map<Key,Entry> _entries;
+};
+
 
 /// \brief Search for a set of alternate alignments for each read, score them, and
 ///        select a 'best' alignment to use for SNV calling.
@@ -44,6 +132,8 @@
 ///
 /// \param realign_buffer_range The range (in reference coordinates) in which the read is allowed to realign
 ///          (due to buffering constraints)
+/// \param candAlignmentCachePtr If non-null, candidate alignment search results are shared through this cache
+///          with other reads realigned in the same window
 ///
 void
 realignAndScoreRead(
@@ -54,4 +144,5 @@ realignAndScoreRead(
     const known_pos_range& realign_buffer_range,
     const unsigned sampleId,
     read_segment& rseg,
-    IndelBuffer& indelBuffer);
+    IndelBuffer& indelBuffer,
+    CandidateAlignmentCache* candAlignmentCachePtr = nullptr);
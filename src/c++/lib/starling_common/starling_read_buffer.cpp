@@ -36,14 +36,6 @@ const starling_read_buffer::segment_group_t starling_read_buffer::_empty_segment
 
 
 
-starling_read_buffer::
-~starling_read_buffer()
-{
-    for (auto& val : _read_data) delete val.second;
-}
-
-
-
 align_id_t
 starling_read_buffer::
 add_read_alignment(
@@ -54,8 +46,7 @@ add_read_alignment(
     assert(! br.is_unmapped());
 
     const align_id_t readIndex(getNextReadIndex());
-    _read_data[readIndex] = new starling_read(br, inputAlignment, maplev, readIndex);
-    starling_read& sread(*(_read_data[readIndex]));
+    starling_read& sread(_read_data.insert(br, inputAlignment, maplev, readIndex));
 
     if (sread.isSpliced())
     {
@@ -90,10 +81,10 @@ rebuffer_read_segment(const align_id_t read_id,
                       const pos_t new_buffer_pos)
 {
     // double check that the read exists:
-    const read_data_t::iterator i(_read_data.find(read_id));
-    if (i == _read_data.end()) return;
+    starling_read* srp(_read_data.get(read_id));
+    if (nullptr == srp) return;
 
-    read_segment& rseg(i->second->get_segment(seg_id));
+    read_segment& rseg(srp->get_segment(seg_id));
 
     // remove from old pos list:
     const pos_group_t::iterator j(_pos_group.find(rseg.buffer_pos));
@@ -135,10 +126,8 @@ clear_iter(
         const align_id_t read_id(val.first);
         const seg_id_t seg_id(val.second);
 
-        const read_data_t::iterator k(_read_data.find(read_id));
-        if (k == _read_data.end()) continue;
-
-        const starling_read* srp(k->second);
+        const starling_read* srp(_read_data.get(read_id));
+        if (nullptr == srp) continue;
 
         // only remove read from data structure when we find the last
         // segment: -- note this assumes that two segments will not
@@ -146,10 +135,8 @@ clear_iter(
         //
         if (seg_id != srp->getExonCount()) continue;
 
-        // remove from simple lookup structures and delete read itself:
-        _read_data.erase(k);
-
-        delete srp;
+        // remove read from the store, which retains the read object for reuse:
+        _read_data.erase(read_id);
     }
     _pos_group.erase(i);
 }
@@ -172,10 +159,10 @@ dump_pos(const pos_t pos,
     {
         const align_id_t read_id(j->first);
         const seg_id_t seg_id(j->second);
-        const read_data_t::const_iterator k(_read_data.find(read_id));
-        if (k == _read_data.end()) continue;
+        const starling_read* srp(_read_data.get(read_id));
+        if (nullptr == srp) continue;
 
-        const starling_read& sr(*(k->second));
+        const starling_read& sr(*srp);
         os << "READ_BUFFER_POSITION: " << pos << " read_segment_no: " << ++r << " seg_id: " << seg_id << "\n";
         os << sr.get_segment(seg_id);
     }
@@ -192,7 +179,7 @@ get_ptr()
     if (_head==_end) return null_ret;
     const align_id_t read_id(_head->first);
     const seg_id_t seg_id(_head->second);
-    const starling_read_buffer::read_data_t::iterator i(_buff._read_data.find(read_id));
-    if (i==_buff._read_data.end()) return null_ret;
-    return std::make_pair(i->second,seg_id);
+    starling_read* srp(_buff._read_data.get(read_id));
+    if (nullptr == srp) return null_ret;
+    return std::make_pair(srp,seg_id);
 }
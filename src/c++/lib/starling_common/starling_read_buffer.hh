@@ -24,7 +24,7 @@
 
 #pragma once
 
-#include "starling_common/starling_read.hh"
+#include "starling_common/StarlingReadStore.hh"
 
 #include "boost/utility.hpp"
 
@@ -73,8 +73,6 @@ struct starling_read_buffer : private boost::noncopyable
     starling_read_buffer(read_id_counter* ricp = nullptr)
         : _ricp( (nullptr==ricp) ? &_ric : ricp ) {}
 
-    ~starling_read_buffer();
-
     /// insert new read into read buffer
     ///
     /// \return what is the read's internal id in the buffer?
@@ -103,18 +101,14 @@ struct starling_read_buffer : private boost::noncopyable
     starling_read*
     get_read(const align_id_t read_id)
     {
-        const read_data_t::iterator k(_read_data.find(read_id));
-        if (k == _read_data.end()) return nullptr;
-        return (k->second);
+        return _read_data.get(read_id);
     }
 
     /// \return pointer to read, or nullptr if read_id isn't in buffer
     const starling_read*
     get_read(const align_id_t read_id) const
     {
-        const read_data_t::const_iterator k(_read_data.find(read_id));
-        if (k == _read_data.end()) return nullptr;
-        return (k->second);
+        return _read_data.get(read_id);
     }
 
     /// clear contents of read buffer up to and including position pos
@@ -161,7 +155,6 @@ struct starling_read_buffer : private boost::noncopyable
     }
 
 private:
-    typedef std::map<align_id_t,starling_read*> read_data_t;
     typedef std::pair<align_id_t,seg_id_t> segment_t;
     typedef std::set<segment_t> segment_group_t;
     typedef std::map<pos_t,segment_group_t> pos_group_t;
@@ -193,8 +186,8 @@ private:
     read_id_counter _ric; // only used if a counter isn't specified on the cmdline
     read_id_counter* _ricp;
 
-    // read id to read data structure pointer map:
-    read_data_t _read_data;
+    // read id to read data structure store:
+    StarlingReadStore _read_data;
 
     // storage position to read segment id map
     //
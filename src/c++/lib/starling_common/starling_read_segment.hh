@@ -62,6 +62,25 @@ struct read_segment
         assert(! _inputAlignment.empty());
     }
 
+    /// \brief Reinitialize the segment for a new input alignment of the same parent read object
+    ///
+    /// This reuses the storage of the segment's alignments, all other arguments are the same as the constructor.
+    void
+    reset(
+        const uint16_t size,
+        const uint16_t offset,
+        const alignment& inputAlignment)
+    {
+        realignment.clear();
+        is_realigned = false;
+        is_invalid_realignment = false;
+        buffer_pos = 0;
+        _size = size;
+        _offset = offset;
+        _inputAlignment = inputAlignment;
+        assert(! _inputAlignment.empty());
+    }
+
     bool
     is_tier1_mapping() const;
 
@@ -147,7 +166,7 @@ private:
     uint16_t _offset;
     const starling_read& _sread;
     /// Read alignment as provided from the alignment input (BAM file, etc...)
-    const alignment _inputAlignment;
+    alignment _inputAlignment;
 };
 
 
@@ -24,14 +24,13 @@
 #include "starling_common/starling_ref_seq.hh"
 
 #include "common/Exceptions.hh"
-#include "htsapi/samtools_fasta_util.hh"
 #include "htsapi/bam_header_util.hh"
 
 
 
 void
 setRefSegment(
-    const starling_base_options& opt,
+    const ReferenceStore& referenceStore,
     const std::string& chrom,
     const known_pos_range2& range,
     reference_contig_segment& ref)
@@ -40,7 +39,7 @@ setRefSegment(
 
     ref.set_offset(range.begin_pos());
     // note: the ref function below takes closed-closed endpoints, so we subtract one from endPos
-    get_standardized_region_seq(opt.referenceFilename, chrom, range.begin_pos(), range.end_pos()-1, ref.seq());
+    referenceStore.getStandardizedRegionSeq(chrom, range.begin_pos(), range.end_pos()-1, ref.seq());
 }
 
 
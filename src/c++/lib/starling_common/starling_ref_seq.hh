@@ -26,13 +26,15 @@
 #include "starling_common/starling_base_shared.hh"
 #include "blt_util/known_pos_range2.hh"
 #include "htsapi/bam_header_info.hh"
+#include "htsapi/ReferenceStore.hh"
 
 #include <string>
 
 
+/// \brief Load the standardized reference sequence of \p range into \p ref
 void
 setRefSegment(
-    const starling_base_options& opt,
+    const ReferenceStore& referenceStore,
     const std::string& chrom,
     const known_pos_range2& range,
     reference_contig_segment& ref);
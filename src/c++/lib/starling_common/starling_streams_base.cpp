@@ -72,7 +72,11 @@ write_vcf_audit(
     os << "##source=" << pinfo.name() << "\n";
     os << "##source_version=" << pinfo.version() << "\n";
     os << "##startTime=" << timeBuffer << "\n";
-    os << "##cmdline=" << cmdline << "\n";
+    os << "##cmdline=" << (opt.vcfHeaderCmdline.empty() ? cmdline : opt.vcfHeaderCmdline.c_str()) << "\n";
+    if (opt.isMaxReadsPerStartPos())
+    {
+        os << "##maxReadsPerStartPos=" << opt.maxReadsPerStartPos << "\n";
+    }
     if (not opt.referenceFilename.empty())
     {
         os << "##reference=file://" << opt.referenceFilename << "\n";
@@ -111,6 +115,58 @@ open_ofstream(const prog_info& pinfo,
 
 
 
+std::unique_ptr<std::ostream>
+starling_streams_base::
+initialize_output_stream(
+    const starling_base_options& opt,
+    const prog_info& pinfo,
+    const std::string& filename,
+    const char* label,
+    const BGZF_INDEX_TYPE::index_t indexType)
+{
+    if (opt.isCompressVcfOutput)
+    {
+        static const std::string compressedSuffix(".gz");
+        std::string compressedFilename(filename);
+        if ((filename.size() < compressedSuffix.size()) ||
+            (filename.compare(filename.size()-compressedSuffix.size(), compressedSuffix.size(), compressedSuffix) != 0))
+        {
+            compressedFilename += compressedSuffix;
+        }
+        return std::unique_ptr<std::ostream>(
+                   new BgzfOutputStream(compressedFilename, indexType, opt.compressThreadCount,
+                                        opt.compressionLevel));
+    }
+
+    std::ofstream* fosPtr(new std::ofstream);
+    std::unique_ptr<std::ostream> osPtr(fosPtr);
+    open_ofstream(pinfo, filename, label, *fosPtr);
+    return osPtr;
+}
+
+
+
+void
+starling_streams_base::
+close_output_streams(const std::vector<std::ostream*>& outputStreams)
+{
+    for (std::ostream* osPtr : outputStreams)
+    {
+        if (osPtr == nullptr) continue;
+        BgzfOutputStream* compressedStreamPtr(dynamic_cast<BgzfOutputStream*>(osPtr));
+        if (compressedStreamPtr != nullptr)
+        {
+            compressedStreamPtr->close();
+        }
+        else
+        {
+            osPtr->flush();
+        }
+    }
+}
+
+
+
 std::unique_ptr<bam_dumper>
 starling_streams_base::
 initialize_realign_bam(
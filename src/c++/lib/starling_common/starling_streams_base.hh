@@ -26,6 +26,7 @@
 #include "blt_util/prog_info.hh"
 #include "htsapi/bam_util.hh"
 #include "htsapi/bam_dumper.hh"
+#include "htsapi/BgzfOutputStream.hh"
 #include "starling_common/starling_base_shared.hh"
 #include "starling_common/starling_types.hh"
 
@@ -66,6 +67,24 @@ protected:
                   const char* label,
                   std::ofstream& fos);
 
+    /// open a text output file, which is written as a bgzip-compressed file with a tabix index of type indexType
+    /// if compressed output is enabled in opt
+    static
+    std::unique_ptr<std::ostream>
+    initialize_output_stream(
+        const starling_base_options& opt,
+        const prog_info& pinfo,
+        const std::string& filename,
+        const char* label,
+        const BGZF_INDEX_TYPE::index_t indexType);
+
+    /// finish writing each non-null output stream, and close it if it is a compressed output file
+    ///
+    /// Throws if any compressed output could not be completely written.
+    static
+    void
+    close_output_streams(const std::vector<std::ostream*>& outputStreams);
+
     /// write the first few meta-data lines for a vcf file:
     ///
     static
@@ -0,0 +1,136 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "test/testIndelBuffer.hh"
+
+#include <set>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( test_IndelBuffer )
+
+
+static
+bool
+addTestIndel(
+    IndelBuffer& indelBuffer,
+    const IndelKey& indelKey,
+    const align_id_t alignId)
+{
+    IndelObservation obs;
+    obs.key = indelKey;
+    obs.data.id = alignId;
+    obs.data.iat = INDEL_ALIGN_TYPE::GENOME_TIER1_READ;
+    return indelBuffer.addIndelObservation(0, obs);
+}
+
+
+
+static
+std::vector<IndelKey>
+getBufferKeys(
+    const IndelBuffer& indelBuffer,
+    const pos_t beginPos,
+    const pos_t endPos)
+{
+    std::vector<IndelKey> keys;
+    auto iter(indelBuffer.positionIterator(beginPos));
+    const auto iterEnd(indelBuffer.positionIterator(endPos));
+    for (; iter != iterEnd; ++iter)
+    {
+        keys.push_back(iter->first);
+    }
+    return keys;
+}
+
+
+
+// check that the buffer iterates in IndelKey order across sparse, out-of-order insertions
+BOOST_AUTO_TEST_CASE( test_IndelBufferOrder )
+{
+    reference_contig_segment ref;
+    ref.seq() = std::string(5000,'A');
+    TestIndelBuffer testBuffer(ref);
+    IndelBuffer& indelBuffer(testBuffer.getIndelBuffer());
+
+    const std::vector<IndelKey> inputKeys =
+    {
+        IndelKey(2000, INDEL::INDEL, 2),
+        IndelKey(2000, INDEL::INDEL, 0, "AG"),
+        IndelKey(10, INDEL::INDEL, 1),
+        IndelKey(4500, INDEL::INDEL, 0, "T"),
+        IndelKey(2000, INDEL::INDEL, 1, "C"),
+        IndelKey(11, INDEL::INDEL, 3),
+        IndelKey(10, INDEL::INDEL, 0, "C"),
+    };
+
+    std::set<IndelKey> expectKeys;
+    align_id_t alignId(0);
+    for (const auto& indelKey : inputKeys)
+    {
+        BOOST_REQUIRE(addTestIndel(indelBuffer, indelKey, alignId++));
+        expectKeys.insert(indelKey);
+    }
+
+    // repeat observations are not novel and add read evidence to the existing entry:
+    BOOST_REQUIRE(! addTestIndel(indelBuffer, inputKeys[0], alignId++));
+    BOOST_REQUIRE_EQUAL(indelBuffer.getIndelDataPtr(inputKeys[0])->getSampleData(0).tier1_map_read_ids.size(), 2u);
+    BOOST_REQUIRE(nullptr == indelBuffer.getIndelDataPtr(IndelKey(2000, INDEL::INDEL, 3)));
+    BOOST_REQUIRE(nullptr == indelBuffer.getIndelDataPtr(IndelKey(3000, INDEL::INDEL, 3)));
+
+    const std::vector<IndelKey> allKeys(getBufferKeys(indelBuffer, 0, 5000));
+    BOOST_REQUIRE(allKeys == std::vector<IndelKey>(expectKeys.begin(), expectKeys.end()));
+
+    const std::vector<IndelKey> posKeys(getBufferKeys(indelBuffer, 11, 2001));
+    BOOST_REQUIRE_EQUAL(posKeys.size(), 4u);
+    BOOST_REQUIRE_EQUAL(posKeys.front(), IndelKey(11, INDEL::INDEL, 3));
+
+    // iteration can start from the indel returned by a lookup:
+    for (const auto& indelKey : inputKeys)
+    {
+        auto indelIter(indelBuffer.getIndelIter(indelKey));
+        BOOST_REQUIRE_EQUAL(indelIter->first, indelKey);
+        ++indelIter;
+        auto expectIter(expectKeys.find(indelKey));
+        ++expectIter;
+        if (expectIter == expectKeys.end())
+        {
+            BOOST_REQUIRE(indelIter == IndelBuffer::const_iterator());
+        }
+        else
+        {
+            BOOST_REQUIRE_EQUAL(indelIter->first, *expectIter);
+        }
+    }
+
+    indelBuffer.clearIndelsAtPosition(2000);
+    BOOST_REQUIRE_EQUAL(getBufferKeys(indelBuffer, 0, 5000).size(), 4u);
+    BOOST_REQUIRE(nullptr == indelBuffer.getIndelDataPtr(inputKeys[0]));
+
+    indelBuffer.clearIndelsAtPosition(10);
+    indelBuffer.clearIndelsAtPosition(11);
+    BOOST_REQUIRE(! indelBuffer.empty());
+    indelBuffer.clearIndels();
+    BOOST_REQUIRE(indelBuffer.empty());
+    BOOST_REQUIRE(indelBuffer.positionIterator(0) == IndelBuffer::const_iterator());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
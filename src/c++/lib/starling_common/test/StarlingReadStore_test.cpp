@@ -0,0 +1,129 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "htsapi/align_path_bam_util.hh"
+#include "starling_common/StarlingReadStore.hh"
+
+
+BOOST_AUTO_TEST_SUITE( StarlingReadStore_test_suite )
+
+
+/// mock up a mapped read with a simple match alignment
+struct TestRead
+{
+    TestRead(
+        const char* qname,
+        const char* read,
+        const pos_t pos)
+    {
+        bamRead.set_qname(qname);
+        const std::vector<uint8_t> qual(strlen(read), 40);
+        bamRead.set_readqual(read, qual.data());
+
+        al.pos = pos;
+        al.path.emplace_back(ALIGNPATH::MATCH, strlen(read));
+
+        bam1_t& br(*(bamRead.get_data()));
+        br.core.pos = al.pos;
+        edit_bam_cigar(al.path, br);
+    }
+
+    bam_record bamRead;
+    alignment al;
+};
+
+
+
+BOOST_AUTO_TEST_CASE( test_StarlingReadStore_window )
+{
+    const TestRead testRead("FOOREAD", "GTACGG", 2);
+
+    StarlingReadStore store;
+    BOOST_REQUIRE(store.empty());
+
+    // ids may be sparse:
+    store.insert(testRead.bamRead, testRead.al, MAPLEVEL::TIER1_MAPPED, 3);
+    store.insert(testRead.bamRead, testRead.al, MAPLEVEL::TIER1_MAPPED, 4);
+    store.insert(testRead.bamRead, testRead.al, MAPLEVEL::TIER1_MAPPED, 7);
+    BOOST_REQUIRE_EQUAL(store.size(), 3u);
+
+    BOOST_REQUIRE(nullptr == store.get(0));
+    BOOST_REQUIRE(nullptr == store.get(5));
+    BOOST_REQUIRE(nullptr == store.get(8));
+    BOOST_REQUIRE(nullptr != store.get(7));
+    BOOST_REQUIRE_EQUAL(store.get(7)->getReadIndex(), 7u);
+
+    // erase out of order:
+    store.erase(4);
+    BOOST_REQUIRE(nullptr == store.get(4));
+    BOOST_REQUIRE(nullptr != store.get(3));
+    store.erase(4);
+    BOOST_REQUIRE_EQUAL(store.size(), 2u);
+
+    store.erase(3);
+    BOOST_REQUIRE_EQUAL(store.size(), 1u);
+    BOOST_REQUIRE_EQUAL(store.get(7)->getReadIndex(), 7u);
+
+    store.insert(testRead.bamRead, testRead.al, MAPLEVEL::TIER1_MAPPED, 8);
+    BOOST_REQUIRE_EQUAL(store.size(), 2u);
+
+    store.clear();
+    BOOST_REQUIRE(store.empty());
+    BOOST_REQUIRE(nullptr == store.get(7));
+    BOOST_REQUIRE_EQUAL(store.getRecycledReadCount(), 3u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_StarlingReadStore_recycle )
+{
+    const TestRead testRead1("FOOREAD", "GTACGG", 2);
+    const TestRead testRead2("BARREAD2", "ACGTACGTAC", 10);
+
+    StarlingReadStore store;
+    {
+        starling_read& sread(store.insert(testRead1.bamRead, testRead1.al, MAPLEVEL::TIER1_MAPPED, 0));
+        read_segment& rseg(sread.get_full_segment());
+        rseg.buffer_pos = 5;
+        rseg.is_realigned = true;
+        rseg.realignment = testRead1.al;
+    }
+    store.erase(0);
+    BOOST_REQUIRE_EQUAL(store.getRecycledReadCount(), 1u);
+
+    // the recycled read object must not retain any state from the previous read:
+    const starling_read& sread(store.insert(testRead2.bamRead, testRead2.al, MAPLEVEL::TIER2_MAPPED, 1));
+    BOOST_REQUIRE_EQUAL(store.getRecycledReadCount(), 0u);
+    BOOST_REQUIRE_EQUAL(sread.getReadIndex(), 1u);
+    BOOST_REQUIRE_EQUAL(sread.getInputAlignmentMapLevel(), MAPLEVEL::TIER2_MAPPED);
+    BOOST_REQUIRE_EQUAL(std::string(sread.key().qname()), "BARREAD2");
+
+    const read_segment& rseg(sread.get_full_segment());
+    BOOST_REQUIRE_EQUAL(rseg.read_size(), 10u);
+    BOOST_REQUIRE_EQUAL(rseg.get_bam_read().get_string(), "ACGTACGTAC");
+    BOOST_REQUIRE_EQUAL(rseg.buffer_pos, 0);
+    BOOST_REQUIRE(! rseg.is_realigned);
+    BOOST_REQUIRE(rseg.realignment.empty());
+    BOOST_REQUIRE(rseg.getInputAlignment() == testRead2.al);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
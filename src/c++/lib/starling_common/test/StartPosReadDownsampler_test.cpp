@@ -0,0 +1,180 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "htsapi/align_path_bam_util.hh"
+#include "starling_common/StartPosReadDownsampler.hh"
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( StartPosReadDownsampler_test_suite )
+
+
+/// mock up a mapped read with a simple match alignment
+static
+void
+setTestRead(
+    const std::string& qname,
+    const pos_t pos,
+    bam_record& bamRead,
+    alignment& al)
+{
+    static const char read[] = "GTACGG";
+    bamRead.set_qname(qname.c_str());
+    const std::vector<uint8_t> qual(strlen(read), 40);
+    bamRead.set_readqual(read, qual.data());
+
+    al.clear();
+    al.pos = pos;
+    al.path.emplace_back(ALIGNPATH::MATCH, strlen(read));
+
+    bam1_t& br(*(bamRead.get_data()));
+    br.core.pos = al.pos;
+    edit_bam_cigar(al.path, br);
+}
+
+
+
+/// add reads with the given names at one start position, and return the names of the retained reads
+static
+std::vector<std::string>
+downsampleReads(
+    const std::vector<std::string>& readNames,
+    StartPosReadDownsampler& downsampler)
+{
+    static const pos_t pos(100);
+    bam_record bamRead;
+    alignment al;
+    for (const std::string& readName : readNames)
+    {
+        setTestRead(readName, pos, bamRead, al);
+        downsampler.addRead(bamRead, al, MAPLEVEL::TIER1_MAPPED);
+    }
+
+    std::vector<std::string> retainedNames;
+    if (! downsampler.empty())
+    {
+        BOOST_REQUIRE_EQUAL(downsampler.getStartPos(), pos);
+    }
+    downsampler.flush(
+        [&](const bam_record& br, const alignment& readAlignment, const MAPLEVEL::index_t maplev)
+    {
+        BOOST_REQUIRE_EQUAL(readAlignment.pos, pos);
+        BOOST_REQUIRE_EQUAL(maplev, MAPLEVEL::TIER1_MAPPED);
+        retainedNames.emplace_back(br.qname());
+    });
+    BOOST_REQUIRE(downsampler.empty());
+    return retainedNames;
+}
+
+
+
+static
+std::vector<std::string>
+getTestReadNames(const unsigned readCount)
+{
+    std::vector<std::string> readNames;
+    for (unsigned readIndex(0); readIndex < readCount; ++readIndex)
+    {
+        readNames.push_back("AMPLICON:1:FC:" + std::to_string(readIndex));
+    }
+    return readNames;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_StartPosReadDownsamplerBelowLimit )
+{
+    StartPosReadDownsampler downsampler(10);
+    const std::vector<std::string> readNames(getTestReadNames(10));
+
+    // all reads are returned in input order:
+    BOOST_REQUIRE(downsampleReads(readNames, downsampler) == readNames);
+    BOOST_REQUIRE_EQUAL(downsampler.getDroppedReadCount(), 0u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_StartPosReadDownsamplerLimit )
+{
+    static const unsigned maxReads(20);
+    StartPosReadDownsampler downsampler(maxReads);
+    const std::vector<std::string> readNames(getTestReadNames(500));
+
+    const std::vector<std::string> retainedNames(downsampleReads(readNames, downsampler));
+    BOOST_REQUIRE_EQUAL(retainedNames.size(), maxReads);
+    BOOST_REQUIRE_EQUAL(downsampler.getDroppedReadCount(), 480u);
+
+    // retained reads are the lowest read name hash values, returned in input order:
+    std::vector<std::string> expectedNames(readNames);
+    std::sort(expectedNames.begin(), expectedNames.end(),
+              [](const std::string& a, const std::string& b)
+    {
+        return (StartPosReadDownsampler::getReadNameHash(a.c_str()) <
+                StartPosReadDownsampler::getReadNameHash(b.c_str()));
+    });
+    expectedNames.resize(maxReads);
+    std::sort(expectedNames.begin(), expectedNames.end(),
+              [&](const std::string& a, const std::string& b)
+    {
+        return (std::find(readNames.begin(), readNames.end(), a) <
+                std::find(readNames.begin(), readNames.end(), b));
+    });
+    BOOST_REQUIRE(retainedNames == expectedNames);
+
+    // the downsampler is reusable at the next start position:
+    BOOST_REQUIRE(downsampleReads(getTestReadNames(5), downsampler) == getTestReadNames(5));
+    BOOST_REQUIRE_EQUAL(downsampler.getDroppedReadCount(), 480u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_StartPosReadDownsamplerInputOrder )
+{
+    // the set of retained reads does not depend on the input order of reads at the same position:
+    std::vector<std::string> readNames(getTestReadNames(300));
+    StartPosReadDownsampler downsampler1(25);
+    const std::vector<std::string> retainedNames1(downsampleReads(readNames, downsampler1));
+
+    std::reverse(readNames.begin(), readNames.end());
+    StartPosReadDownsampler downsampler2(25);
+    const std::vector<std::string> retainedNames2(downsampleReads(readNames, downsampler2));
+
+    const std::set<std::string> retainedSet1(retainedNames1.begin(), retainedNames1.end());
+    const std::set<std::string> retainedSet2(retainedNames2.begin(), retainedNames2.end());
+    BOOST_REQUIRE_EQUAL(retainedSet1.size(), 25u);
+    BOOST_REQUIRE(retainedSet1 == retainedSet2);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_StartPosReadDownsamplerReadNameHash )
+{
+    // the hash value is fixed so that read selection is identical across runs and builds:
+    BOOST_REQUIRE_EQUAL(StartPosReadDownsampler::getReadNameHash("READ1"), 0xcfa2766dd62fab34ULL);
+    BOOST_REQUIRE(StartPosReadDownsampler::getReadNameHash("READ1") !=
+                  StartPosReadDownsampler::getReadNameHash("READ2"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
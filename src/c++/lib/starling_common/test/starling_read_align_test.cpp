@@ -404,4 +404,257 @@ BOOST_AUTO_TEST_CASE( test_realign_and_score_read )
     }
 }
 
+
+BOOST_AUTO_TEST_CASE( test_realign_and_score_read_cached )
+{
+    // reads with the same input alignment and sequence should share one candidate alignment search
+    // through the cache, and produce the same realignment as an uncached search
+    starling_base_options_test opt;
+    starling_base_deriv_options dopt(opt);
+    starling_sample_options sample_opt(opt);
+    reference_contig_segment ref;
+    ref.seq() = "ACGTACGTACGTACGTACGT";
+
+    known_pos_range realign_buffer_range(0, 20);
+
+    const unsigned sampleIndex(0);
+
+    IndelBuffer indelBuffer(opt, dopt, ref);
+    depth_buffer db;
+    depth_buffer db2;
+    indelBuffer.registerSample(db, db2, false);
+    indelBuffer.finalizeSamples();
+    {
+        IndelObservation obs;
+        obs.key = IndelKey(4, INDEL::INDEL, 1);
+        obs.data.is_external_candidate = true;
+
+        indelBuffer.addIndelObservation(sampleIndex, obs);
+    }
+
+    bam_record bamRead;
+    bamRead.set_qname("FOOREAD");
+    const char read[] = "GTACGG";
+    const uint8_t qual[] = {40, 40, 40, 40, 40, 40};
+    bamRead.set_readqual(read, qual);
+
+    alignment al;
+    al.pos = 2;
+    ALIGNPATH::cigar_to_apath("5M1S", al.path);
+
+    bam1_t& br(*(bamRead.get_data()));
+    br.core.pos = al.pos;
+    edit_bam_cigar(al.path, br);
+
+    starling_read uncachedRead(bamRead, al, MAPLEVEL::UNKNOWN, 0);
+    read_segment& uncachedSegment(uncachedRead.get_full_segment());
+    realignAndScoreRead(opt, dopt, sample_opt, ref, realign_buffer_range, sampleIndex, uncachedSegment,
+                        indelBuffer);
+
+    CandidateAlignmentCache cache;
+    for (align_id_t readIndex(1); readIndex<4; ++readIndex)
+    {
+        starling_read sread(bamRead, al, MAPLEVEL::UNKNOWN, readIndex);
+        read_segment& rseg(sread.get_full_segment());
+        realignAndScoreRead(opt, dopt, sample_opt, ref, realign_buffer_range, sampleIndex, rseg,
+                            indelBuffer, &cache);
+
+        BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+        BOOST_REQUIRE_EQUAL(rseg.is_realigned, uncachedSegment.is_realigned);
+        if (rseg.is_realigned)
+        {
+            BOOST_REQUIRE_EQUAL(rseg.realignment, uncachedSegment.realignment);
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_realign_and_score_read_cached_qualities )
+{
+    // a read with the same input alignment and sequence as a cached read, but different base qualities, should
+    // reuse the cached candidate alignment set and recompute the candidate alignment scores
+    starling_base_options_test opt;
+    starling_base_deriv_options dopt(opt);
+    starling_sample_options sample_opt(opt);
+    reference_contig_segment ref;
+    ref.seq() = "ACGTACGTACGTACGTACGTACGTACGTACGT";
+
+    known_pos_range realign_buffer_range(0, 32);
+
+    const unsigned sampleIndex(0);
+
+    IndelBuffer indelBuffer(opt, dopt, ref);
+    depth_buffer db;
+    depth_buffer db2;
+    indelBuffer.registerSample(db, db2, false);
+    indelBuffer.finalizeSamples();
+    const IndelKey candidateIndelKey(12, INDEL::INDEL, 1);
+    {
+        IndelObservation obs;
+        obs.key = candidateIndelKey;
+        obs.data.is_external_candidate = true;
+
+        indelBuffer.addIndelObservation(sampleIndex, obs);
+    }
+
+    // the read must be long enough to meet the minimum breakpoint flank size on both sides of the indel:
+    const char read[] = "GTACGTACGTACGTACGTAC";
+    const std::vector<uint8_t> highQual(20, 40);
+    const std::vector<uint8_t> lowQual(20, 10);
+
+    alignment al;
+    al.pos = 2;
+    ALIGNPATH::cigar_to_apath("20M", al.path);
+
+    auto realignRead = [&](
+                           const std::vector<uint8_t>& qual,
+                           const align_id_t readIndex,
+                           CandidateAlignmentCache* cachePtr)
+    {
+        bam_record bamRead;
+        bamRead.set_qname("FOOREAD");
+        bamRead.set_readqual(read, qual.data());
+        bam1_t& br(*(bamRead.get_data()));
+        br.core.pos = al.pos;
+        edit_bam_cigar(al.path, br);
+
+        // indels are only scored for tier1 or tier2 mapped reads:
+        starling_read sread(bamRead, al, MAPLEVEL::TIER1_MAPPED, readIndex);
+        realignAndScoreRead(opt, dopt, sample_opt, ref, realign_buffer_range, sampleIndex,
+                            sread.get_full_segment(), indelBuffer, cachePtr);
+    };
+
+    const align_id_t uncachedReadIndex(0);
+    const align_id_t highQualReadIndex(1);
+    const align_id_t lowQualReadIndex(2);
+
+    realignRead(lowQual, uncachedReadIndex, nullptr);
+
+    CandidateAlignmentCache cache;
+    realignRead(highQual, highQualReadIndex, &cache);
+    realignRead(lowQual, lowQualReadIndex, &cache);
+    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+
+    // the low quality read scores should match those of an uncached search, and not the cached high quality scores:
+    const IndelData* indelDataPtr(indelBuffer.getIndelDataPtr(candidateIndelKey));
+    BOOST_REQUIRE(indelDataPtr != nullptr);
+    const auto& readPathScores(indelDataPtr->getSampleData(sampleIndex).read_path_lnp);
+    BOOST_REQUIRE_EQUAL(readPathScores.count(uncachedReadIndex), 1u);
+    BOOST_REQUIRE_EQUAL(readPathScores.count(highQualReadIndex), 1u);
+    BOOST_REQUIRE_EQUAL(readPathScores.count(lowQualReadIndex), 1u);
+
+    const ReadPathScores& uncachedScores(readPathScores.at(uncachedReadIndex));
+    const ReadPathScores& highQualScores(readPathScores.at(highQualReadIndex));
+    const ReadPathScores& lowQualScores(readPathScores.at(lowQualReadIndex));
+    BOOST_REQUIRE_EQUAL(lowQualScores.ref, uncachedScores.ref);
+    BOOST_REQUIRE_EQUAL(lowQualScores.indel, uncachedScores.indel);
+    BOOST_REQUIRE_NE(lowQualScores.ref, highQualScores.ref);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_realign_and_score_read_cached_read_evidence )
+{
+    // a cached candidate alignment search which depended on the read's own evidence for a non-candidate indel
+    // should not be reused for a read with different evidence for that indel, so the search should be repeated
+    starling_base_options_test opt;
+    starling_base_deriv_options dopt(opt);
+    starling_sample_options sample_opt(opt);
+    reference_contig_segment ref;
+    ref.seq() = "ACGTACGTACGTACGTACGT";
+
+    known_pos_range realign_buffer_range(0, 20);
+
+    const unsigned sampleIndex(0);
+
+    IndelBuffer indelBuffer(opt, dopt, ref);
+    depth_buffer db;
+    depth_buffer db2;
+    indelBuffer.registerSample(db, db2, false);
+    indelBuffer.finalizeSamples();
+    {
+        IndelObservation obs;
+        obs.key = IndelKey(4, INDEL::INDEL, 1);
+        obs.data.is_external_candidate = true;
+
+        indelBuffer.addIndelObservation(sampleIndex, obs);
+    }
+
+    // a single noise observation from the first read is not enough to make this indel a candidate, so it is
+    // only usable in the alignment search of that read:
+    const align_id_t evidenceReadIndex(1);
+    const align_id_t otherReadIndex(2);
+    const IndelKey noiseIndelKey(6, INDEL::INDEL, 1);
+    {
+        IndelObservation obs;
+        obs.key = noiseIndelKey;
+        obs.data.is_noise = true;
+        obs.data.id = evidenceReadIndex;
+
+        indelBuffer.addIndelObservation(sampleIndex, obs);
+    }
+    BOOST_REQUIRE(not indelBuffer.isCandidateIndel(noiseIndelKey));
+
+    bam_record bamRead;
+    bamRead.set_qname("FOOREAD");
+    const char read[] = "GTACGG";
+    const uint8_t qual[] = {40, 40, 40, 40, 40, 40};
+    bamRead.set_readqual(read, qual);
+
+    alignment al;
+    al.pos = 2;
+    ALIGNPATH::cigar_to_apath("5M1S", al.path);
+
+    bam1_t& br(*(bamRead.get_data()));
+    br.core.pos = al.pos;
+    edit_bam_cigar(al.path, br);
+
+    starling_read uncachedRead(bamRead, al, MAPLEVEL::UNKNOWN, otherReadIndex);
+    read_segment& uncachedSegment(uncachedRead.get_full_segment());
+    realignAndScoreRead(opt, dopt, sample_opt, ref, realign_buffer_range, sampleIndex, uncachedSegment,
+                        indelBuffer);
+
+    CandidateAlignmentCache cache;
+    CandidateAlignmentCache::Key cacheKey;
+    cacheKey.sampleId = sampleIndex;
+    cacheKey.inputAlignment = uncachedSegment.getInputAlignment();
+    cacheKey.edgePin = uncachedSegment.get_segment_edge_pin();
+    cacheKey.readSequence = read;
+
+    auto getNoiseIndelUsability = [&]()
+    {
+        const CandidateAlignmentCache::Entry* entryPtr(cache.getEntry(cacheKey));
+        BOOST_REQUIRE(entryPtr != nullptr);
+        const CandidateAlignmentCache::indel_usability_t& readIndelUsability(entryPtr->readIndelUsability);
+        const auto iter(std::find_if(readIndelUsability.begin(), readIndelUsability.end(),
+                                     [&](const std::pair<IndelKey,bool>& val)
+        {
+            return (val.first == noiseIndelKey);
+        }));
+        BOOST_REQUIRE(iter != readIndelUsability.end());
+        return iter->second;
+    };
+
+    starling_read evidenceRead(bamRead, al, MAPLEVEL::UNKNOWN, evidenceReadIndex);
+    realignAndScoreRead(opt, dopt, sample_opt, ref, realign_buffer_range, sampleIndex,
+                        evidenceRead.get_full_segment(), indelBuffer, &cache);
+    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE(getNoiseIndelUsability());
+
+    // the cached entry is rejected for the other read, so the search is repeated and the entry is replaced:
+    starling_read otherRead(bamRead, al, MAPLEVEL::UNKNOWN, otherReadIndex);
+    read_segment& otherSegment(otherRead.get_full_segment());
+    BOOST_REQUIRE(not isCachedCandidateAlignmentSearchValid(indelBuffer, otherReadIndex, sampleIndex,
+                                                            *cache.getEntry(cacheKey)));
+    realignAndScoreRead(opt, dopt, sample_opt, ref, realign_buffer_range, sampleIndex, otherSegment,
+                        indelBuffer, &cache);
+    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE(not getNoiseIndelUsability());
+
+    BOOST_REQUIRE_EQUAL(otherSegment.is_realigned, uncachedSegment.is_realigned);
+    if (otherSegment.is_realigned)
+    {
+        BOOST_REQUIRE_EQUAL(otherSegment.realignment, uncachedSegment.realignment);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
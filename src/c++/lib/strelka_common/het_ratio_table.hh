@@ -0,0 +1,112 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2018 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include "blt_util/blt_types.hh"
+
+#include <cassert>
+
+#include <array>
+#include <vector>
+
+
+/// A simple static sized array with deep copy semantics:
+///
+template <unsigned NVAL>
+struct cache_val
+{
+    std::array<blt_float_t,NVAL> val;
+};
+
+
+/// an immutable lookup table for lhood computation intermediates
+///
+/// Effectively func(qscore,hetratio) -> array[NVAL] is precomputed for every basecall qscore and each het ratio in
+/// a fixed list. All values are computed in the ctor, so that the table can be shared between threads without any
+/// synchronization once constructed. Clients are expected to hold the table as a static const object.
+///
+/// Both the qscore and het ratio index are bound to ranges on [0,small int] so values are stored in a single vector,
+/// with all qscores for one het ratio stored contiguously. This allows the per-basecall lookup in the likelihood
+/// kernels to be reduced to a single indexed read from one table row.
+///
+template <unsigned NVAL>
+struct het_ratio_table
+{
+    typedef cache_val<NVAL> value_type;
+
+    /// \param[in] hetRatios het ratio associated with each ratio index
+    /// \param[in] fillFunc function of (qscore, hetRatio, value_type&) used to compute each table entry
+    template <typename FillFunc>
+    het_ratio_table(
+        const std::vector<blt_float_t>& hetRatios,
+        FillFunc fillFunc)
+        : _hetRatios(hetRatios),
+          _table(MAX_QSCORE * hetRatios.size())
+    {
+        const unsigned ratioCount(hetRatios.size());
+        for (unsigned ratioIndex(0); ratioIndex < ratioCount; ++ratioIndex)
+        {
+            for (unsigned qscore(0); qscore < MAX_QSCORE; ++qscore)
+            {
+                fillFunc(qscore, hetRatios[ratioIndex], _table[qscore + ratioIndex * MAX_QSCORE]);
+            }
+        }
+    }
+
+    unsigned
+    getRatioCount() const
+    {
+        return _hetRatios.size();
+    }
+
+    blt_float_t
+    getHetRatio(const unsigned ratioIndex) const
+    {
+        assert(ratioIndex < getRatioCount());
+        return _hetRatios[ratioIndex];
+    }
+
+    /// \return A pointer to the values of all qscores for the given het ratio, indexed on qscore
+    const value_type*
+    getRatioRow(const unsigned ratioIndex) const
+    {
+        assert(ratioIndex < getRatioCount());
+        return _table.data() + ratioIndex * MAX_QSCORE;
+    }
+
+    const value_type&
+    getVal(
+        const unsigned qscore,
+        const unsigned ratioIndex) const
+    {
+        assert(qscore < MAX_QSCORE);
+        return getRatioRow(ratioIndex)[qscore];
+    }
+
+    /// all basecall qscores are stored in 6 bits (see base_call in snp_pos_info.hh)
+    enum constants { MAX_QSCORE = 64 };
+
+private:
+    std::vector<blt_float_t> _hetRatios;
+    std::vector<value_type> _table;
+};
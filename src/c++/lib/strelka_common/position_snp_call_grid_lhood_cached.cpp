@@ -25,6 +25,7 @@
 #include "blt_util/digt.hh"
 #include "blt_util/logSumUtil.hh"
 
+#include <cassert>
 #include <cmath>
 
 
@@ -35,53 +36,91 @@ static const blt_float_t ln_one_half(std::log(one_half));
 
 
 
+/// fill lhood table values for expect values of 0.0, 0.5 & 1.0
+static
+void
+fillDiploidLhoodValues(
+    const unsigned qscore,
+    const blt_float_t /*het_ratio*/,
+    cache_val<3>& cv)
+{
+    const blt_float_t eprob(qphred_to_error_prob(qscore));
+    const blt_float_t ceprob(1-eprob);
+    const blt_float_t lne(qphred_to_ln_error_prob(qscore));
+    const blt_float_t lnce(qphred_to_ln_comp_error_prob(qscore));
+
+    cv.val[0] = lne+ln_one_third;
+    cv.val[1] = std::log((ceprob)+((eprob)*one_third))+ln_one_half;
+    cv.val[2] = lnce;
+}
+
+
+
+/// fill lhood table values for expect values of 0.0, het_ratio & chet_ratio
+static
+void
+fillHetRatioLhoodValues(
+    const unsigned qscore,
+    const blt_float_t het_ratio,
+    cache_val<3>& cv)
+{
+    const blt_float_t chet_ratio(1.-het_ratio);
+    const blt_float_t eprob(qphred_to_error_prob(qscore));
+    const blt_float_t ceprob(1-eprob);
+
+    cv.val[0] = qphred_to_ln_error_prob(qscore)+ln_one_third;
+    cv.val[1] = std::log((ceprob)*het_ratio+((eprob)*one_third)*chet_ratio);
+    cv.val[2] = std::log((ceprob)*chet_ratio+((eprob)*one_third)*het_ratio);
+}
+
+
+
+static const het_ratio_table<3> diploidLhoodTable({one_half}, fillDiploidLhoodValues);
+
+
+
+/// build het ratio lhood table for ratios on an evenly spaced grid: ratioOffset+(i+1)*ratioIncrement
+static
+het_ratio_table<3>
+getHetRatioGridLhoodTable(
+    const unsigned ratioCount,
+    const blt_float_t ratioOffset,
+    const blt_float_t ratioIncrement)
+{
+    std::vector<blt_float_t> hetRatios;
+    for (unsigned ratioIndex(0); ratioIndex<ratioCount; ++ratioIndex)
+    {
+        hetRatios.push_back(ratioOffset+(ratioIndex+1)*ratioIncrement);
+    }
+    return het_ratio_table<3>(hetRatios, fillHetRatioLhoodValues);
+}
+
+
+
 // accelerated version with no hyrax q-val mods:
 //
-// the ratio key can be used as a proxy for the het ratio to look up cached results:
+// the ratio table row holds precomputed values for one het ratio over all qscores:
 //
 static
 void
 get_high_low_het_ratio_lhood_cached(
-    const snp_pos_info& pi,
-    const blt_float_t het_ratio,
-    const unsigned het_ratio_index,
-    het_ratio_cache<3>& hrcache,
+    const BasecallHistogram& histogram,
+    const cache_val<3>* const ratioRow,
     blt_float_t* lhood_high,
     blt_float_t* lhood_low)
 {
-    const blt_float_t chet_ratio(1.-het_ratio);
-
-    const unsigned n_calls(pi.calls.size());
-
-    //    cache_val cv;
     static const uint8_t remap[3] = {0,2,1};
 
-    for (unsigned i(0); i<n_calls; ++i)
+    for (const BasecallHistogram::Bin& bin : histogram)
     {
-        const base_call& bc(pi.calls[i]);
-
-        std::pair<bool,cache_val<3>*> ret(hrcache.get_val(bc.get_qscore(),het_ratio_index));
-        cache_val<3>& cv(*ret.second);
-        if (! ret.first)
-        {
-            const blt_float_t eprob(bc.error_prob());
-            const blt_float_t ceprob(1-eprob);
-            //const blt_float_t lne(bc.ln_error_prob());
-            //const blt_float_t lnce(bc.ln_comp_error_prob());
-
-            // precalculate the result for expect values of 0.0, het_ratio, chet_ratio, 1.0
-            cv.val[0] = bc.ln_error_prob()+ln_one_third;
-            cv.val[1] = std::log((ceprob)*het_ratio+((eprob)*one_third)*chet_ratio);
-            cv.val[2] = std::log((ceprob)*chet_ratio+((eprob)*one_third)*het_ratio);
-        }
-
-        const uint8_t obs_id(bc.base_id);
+        const cache_val<3>& cv(ratioRow[bin.qscore]);
+        const blt_float_t count(bin.count);
 
         for (unsigned gt(N_BASE); gt<DIGT::SIZE; ++gt)
         {
-            const unsigned key(DIGT::expect2_bias(obs_id,gt));
-            lhood_high[gt] += cv.val[key];
-            lhood_low[gt] += cv.val[remap[key]];
+            const unsigned key(DIGT::expect2_bias(bin.baseId,gt));
+            lhood_high[gt] += count*cv.val[key];
+            lhood_low[gt] += count*cv.val[remap[key]];
         }
     }
 }
@@ -93,10 +132,8 @@ get_high_low_het_ratio_lhood_cached(
 static
 void
 increment_het_ratio_lhood_cached(
-    const snp_pos_info& pi,
-    const blt_float_t het_ratio,
-    const unsigned het_ratio_index,
-    het_ratio_cache<3>& hrcache,
+    const BasecallHistogram& histogram,
+    const cache_val<3>* const ratioRow,
     blt_float_t* all_het_lhood)
 {
     // multiply probs of alternate ratios into local likelihoods, then
@@ -114,7 +151,7 @@ increment_het_ratio_lhood_cached(
         lhood_high[gt] = 0.;
         lhood_low[gt] = 0.;
     }
-    get_high_low_het_ratio_lhood_cached(pi,het_ratio,het_ratio_index,hrcache,lhood_high,lhood_low);
+    get_high_low_het_ratio_lhood_cached(histogram,ratioRow,lhood_high,lhood_low);
 
     for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
     {
@@ -128,38 +165,22 @@ increment_het_ratio_lhood_cached(
 void
 get_diploid_gt_lhood_cached(
     const blt_options& opt,
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const bool useHetVariantFrequencyExtension,
     const blt_float_t hetVariantFrequencyExtension,
     blt_float_t* const lhood)
 {
-    // ! not thread-safe !
-    static het_ratio_cache<3> hrcache;
-
     // get likelihood of each genotype
     for (unsigned gt(0); gt<DIGT::SIZE; ++gt) lhood[gt] = 0.;
 
-    for (const base_call& bc : pi.calls)
+    const cache_val<3>* const diploidRow(diploidLhoodTable.getRatioRow(0));
+    for (const BasecallHistogram::Bin& bin : histogram)
     {
-        std::pair<bool,cache_val<3>*> ret(hrcache.get_val(bc.get_qscore(),0));
-        cache_val<3>& cv(*ret.second);
-        if (! ret.first)
-        {
-            const blt_float_t eprob(bc.error_prob());
-            const blt_float_t ceprob(1-eprob);
-            const blt_float_t lne(bc.ln_error_prob());
-            const blt_float_t lnce(bc.ln_comp_error_prob());
-
-            // precalculate the result for expect values of 0.0, 0.5 & 1.0
-            cv.val[0] = lne+ln_one_third;
-            cv.val[1] = std::log((ceprob)+((eprob)*one_third))+ln_one_half;
-            cv.val[2] = lnce;
-        }
-
-        const uint8_t obs_id(bc.base_id);
+        const cache_val<3>& cv(diploidRow[bin.qscore]);
+        const blt_float_t count(bin.count);
         for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
         {
-            lhood[gt] += cv.val[DIGT::expect2(obs_id,gt)];
+            lhood[gt] += count*cv.val[DIGT::expect2(bin.baseId,gt)];
         }
     }
 
@@ -170,16 +191,17 @@ get_diploid_gt_lhood_cached(
     //
     if (useHetVariantFrequencyExtension)
     {
-        // ! not thread-safe !
-        static het_ratio_cache<3> hrcache_bias;
-
         // loop is currently setup to assume a uniform het ratio subgenotype prior
         const unsigned n_bias_steps(1+static_cast<unsigned>(hetVariantFrequencyExtension/opt.maxHetVariantFrequencyIncrement));
         const blt_float_t ratio_increment(hetVariantFrequencyExtension/static_cast<blt_float_t>(n_bias_steps));
+
+        // the table is built on first use, so the het ratio grid must be constant for all calls:
+        static const het_ratio_table<3> biasTable(getHetRatioGridLhoodTable(n_bias_steps, 0.5, ratio_increment));
+        assert(biasTable.getRatioCount() == n_bias_steps);
+
         for (unsigned i(0); i<n_bias_steps; ++i)
         {
-            const blt_float_t het_ratio(0.5+(i+1)*ratio_increment);
-            increment_het_ratio_lhood_cached(pi,het_ratio,i,hrcache_bias,lhood);
+            increment_het_ratio_lhood_cached(histogram,biasTable.getRatioRow(i),lhood);
         }
 
         const unsigned n_het_subgt(1+2*n_bias_steps);
@@ -200,13 +222,10 @@ get_diploid_gt_lhood_cached(
 //
 void
 get_diploid_het_grid_lhood_cached(
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const unsigned hetResolution,
     blt_float_t* const lhood)
 {
-    // ! not thread-safe !
-    static het_ratio_cache<3> hrcache;
-
     // get likelihood of each genotype
     const unsigned totalHetRatios(hetResolution*2);
     for (unsigned gt(0); gt<(totalHetRatios*DIGT::HET_SIZE); ++gt) lhood[gt] = 0.;
@@ -214,10 +233,14 @@ get_diploid_het_grid_lhood_cached(
     blt_float_t* lhood_off=lhood-N_BASE;
 
     const blt_float_t ratio_increment(0.5/static_cast<blt_float_t>(hetResolution+1));
+
+    // the table is built on first use, so the het ratio grid must be constant for all calls:
+    static const het_ratio_table<3> gridTable(getHetRatioGridLhoodTable(hetResolution, 0, ratio_increment));
+    assert(gridTable.getRatioCount() == hetResolution);
+
     for (unsigned hetIndex(0); hetIndex<hetResolution; ++hetIndex)
     {
-        const blt_float_t het_ratio((hetIndex+1)*ratio_increment);
-        get_high_low_het_ratio_lhood_cached(pi,het_ratio,hetIndex,hrcache,
+        get_high_low_het_ratio_lhood_cached(histogram,gridTable.getRatioRow(hetIndex),
                                             lhood_off+(hetIndex*DIGT::HET_SIZE),
                                             lhood_off+((totalHetRatios-(hetIndex+1))*DIGT::HET_SIZE));
     }
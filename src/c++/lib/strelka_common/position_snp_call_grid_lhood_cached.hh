@@ -22,10 +22,10 @@
 
 #pragma once
 
-#include "het_ratio_cache.hh"
+#include "het_ratio_table.hh"
 
+#include "blt_common/BasecallHistogram.hh"
 #include "blt_common/blt_shared.hh"
-#include "blt_common/snp_pos_info.hh"
 
 
 /// get standard diploid snp lhood's
@@ -40,7 +40,7 @@
 void
 get_diploid_gt_lhood_cached(
     const blt_options& opt,
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const bool useHetVariantFrequencyExtension,
     const blt_float_t hetVariantFrequencyExtension,
     blt_float_t* const lhood);
@@ -51,10 +51,10 @@ inline
 void
 get_diploid_gt_lhood_cached(
     const blt_options& opt,
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     blt_float_t* const lhood)
 {
-    get_diploid_gt_lhood_cached(opt, pi, false, 0, lhood);
+    get_diploid_gt_lhood_cached(opt, histogram, false, 0, lhood);
 }
 
 
@@ -65,6 +65,6 @@ get_diploid_gt_lhood_cached(
 /// \param hetresolution how many intermediates between 0-0.5 should we sample per half-axis?
 void
 get_diploid_het_grid_lhood_cached(
-    const snp_pos_info& pi,
+    const BasecallHistogram& histogram,
     const unsigned hetResolution,
     blt_float_t* const lhood);
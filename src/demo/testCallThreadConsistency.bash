@@ -0,0 +1,123 @@
+#!/usr/bin/env bash
+#
+# Strelka - Small Variant Caller
+# Copyright (c) 2009-2018 Illumina, Inc.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+#
+
+#
+# Verify that threaded germline and somatic caller output does not depend on the call thread count, by calling
+# the demo data with different numbers of call threads and comparing the results. Note that single-thread output
+# is not expected to match, because threaded calling finishes each work region independently.
+#
+# usage: testCallThreadConsistency.bash starling2 strelka2 demoDataDir outputDir
+#
+
+set -o nounset
+set -o pipefail
+
+if [ $# -ne 4 ]; then
+    echo "usage: $0 starling2 strelka2 demoDataDir outputDir" 1>&2
+    exit 2
+fi
+
+starlingBin=$1
+strelkaBin=$2
+dataDir=$3
+outputDir=$4
+
+referenceThreadCount=2
+threadCounts="$referenceThreadCount 4"
+
+# use a small work region size so that the demo contig is split into several work regions:
+threadOpts="--call-thread-region-size 1000"
+
+rm -rf $outputDir
+mkdir -p $outputDir
+
+for threads in $threadCounts; do
+    prefix=$outputDir/threads$threads
+
+    $starlingBin \
+        --ref $dataDir/demo20.fa \
+        --region demo20:1-5000 \
+        --align-file $dataDir/NA12891_demo20.bam \
+        --align-file $dataDir/NA12892_demo20.bam \
+        --max-indel-size 50 \
+        --min-mapping-quality 20 \
+        --gvcf-min-gqx 15 \
+        --enable-read-backed-phasing \
+        --gvcf-output-prefix $prefix.germline. \
+        --stats-file $prefix.germline.stats.xml \
+        --call-threads $threads $threadOpts
+
+    if [ $? -ne 0 ]; then
+        echo "ERROR: germline calling failed with $threads call threads" 1>&2
+        exit 1
+    fi
+
+    $strelkaBin \
+        --ref $dataDir/demo20.fa \
+        --region demo20:1-5000 \
+        --tumor-align-file $dataDir/NA12891_demo20.bam \
+        --normal-align-file $dataDir/NA12892_demo20.bam \
+        --max-indel-size 50 \
+        --somatic-snv-file $prefix.somatic.snvs.vcf \
+        --somatic-indel-file $prefix.somatic.indels.vcf \
+        --somatic-callable-regions-file $prefix.somatic.callable.bed \
+        --stats-file $prefix.somatic.stats.xml \
+        --call-threads $threads $threadOpts
+
+    if [ $? -ne 0 ]; then
+        echo "ERROR: somatic calling failed with $threads call threads" 1>&2
+        exit 1
+    fi
+done
+
+# the header records the command line, which differs between runs:
+filterVariableMetadata() {
+    awk '!/^##(fileDate|source_version|startTime|reference|cmdline)/' $1
+}
+
+expectedPrefix=$outputDir/threads$referenceThreadCount
+fileCount=0
+for efile in $expectedPrefix.*.vcf $expectedPrefix.*.bed; do
+    suffix=${efile#$expectedPrefix}
+    for threads in $threadCounts; do
+        if [ $threads -eq $referenceThreadCount ]; then continue; fi
+        rfile=$outputDir/threads$threads$suffix
+        diff <(filterVariableMetadata $efile) <(filterVariableMetadata $rfile)
+
+        if [ $? -ne 0 ]; then
+            cat<<END 1>&2
+
+ERROR: Found difference between call thread counts in file '$suffix'.
+       $referenceThreadCount thread results file: $efile
+       $threads thread results file: $rfile
+
+END
+            exit 1
+        fi
+    done
+    fileCount=$((fileCount+1))
+done
+
+if [ $fileCount -eq 0 ]; then
+    echo "ERROR: No output files found in '$outputDir'" 1>&2
+    exit 1
+fi
+
+echo "**** No differences found between call thread counts in $fileCount files." 1>&2
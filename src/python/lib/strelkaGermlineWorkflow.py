@@ -117,10 +117,16 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     for bamPath in self.params.bamList :
         segCmd.extend(["--align-file",bamPath])
 
+    # compress segment output in the caller, using the same compression level as the bgzip9 utility:
+    segCmd.extend(["--compress-vcf-output", "--compress-level", "9"])
+
     if not isFirstSegment :
         segCmd.append("--gvcf-skip-header")
-    elif len(self.params.callContinuousVf) > 0 :
-        segCmd.extend(["--gvcf-include-header", "VF"])
+    else :
+        # record the workflow configuration command line in the vcf header instead of the segment command line:
+        segCmd.extend(["--vcf-header-cmdline", " ".join(self.params.configCommandLine)])
+        if len(self.params.callContinuousVf) > 0 :
+            segCmd.extend(["--gvcf-include-header", "VF"])
 
     if self.params.isHighDepthFilter :
         segCmd.extend(["--chrom-depth-file", self.paths.getChromDepth()])
@@ -149,40 +155,15 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     segTaskLabel=preJoin(taskPrefix,"callGenomeSegment_"+genomeSegmentLabel)
     self.addTask(segTaskLabel,segCmd,dependencies=dependencies,memMb=self.params.callMemMb)
 
-    # clean up and compress genome segment files:
+    # the segment vcf files are written directly as bgzip-compressed files by the caller:
     nextStepWait = set()
+    nextStepWait.add(segTaskLabel)
 
-    def compressRawVcf(rawVcfFilename, label) :
-        """
-        Process each raw vcf file with header modifications and bgzip compression
-        """
-
-        compressedVariantsPath = rawVcfFilename +".gz"
-        compressCmd = "cat "+quote(rawVcfFilename)
-
-        if isFirstSegment :
-            def getHeaderFixCmd() :
-                cmd  = "\"%s\" -E \"%s\"" % (sys.executable, self.params.vcfCmdlineSwapper)
-                cmd += ' "' + " ".join(self.params.configCommandLine) + '"'
-                return cmd
-            compressCmd += " | " + getHeaderFixCmd()
-
-        compressCmd += " | \"%s\" -c >| \"%s\"" % (self.params.bgzip9Bin, compressedVariantsPath)
-
-        compressTaskLabel=preJoin(taskPrefix,"compressGenomeSegment_"+genomeSegmentLabel+"_"+label)
-        self.addTask(compressTaskLabel, compressCmd, dependencies=segTaskLabel, memMb=self.params.callMemMb)
-        nextStepWait.add(compressTaskLabel)
-        return compressedVariantsPath
-
-    rawVariantsPath = self.paths.getTmpSegmentVariantsPath(genomeSegmentLabel)
-    compressedVariantsPath = compressRawVcf(rawVariantsPath, "variants")
-    segFiles.variants.append(compressedVariantsPath)
+    segFiles.variants.append(self.paths.getTmpSegmentVariantsPath(genomeSegmentLabel) + ".gz")
 
     sampleCount = len(self.params.bamList)
     for sampleIndex in range(sampleCount) :
-        rawVariantsPath = self.paths.getTmpSegmentGvcfPath(genomeSegmentLabel, sampleIndex)
-        compressedVariantsPath = compressRawVcf(rawVariantsPath, gvcfSampleLabel(sampleIndex))
-        segFiles.sample[sampleIndex].gvcf.append(compressedVariantsPath)
+        segFiles.sample[sampleIndex].gvcf.append(self.paths.getTmpSegmentGvcfPath(genomeSegmentLabel, sampleIndex) + ".gz")
 
 
     if self.params.isWriteRealignedBam :
@@ -136,8 +136,14 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     segFiles.stats.append(self.paths.getTmpRunStatsPath(genomeSegmentLabel))
     segCmd.extend(["--stats-file", segFiles.stats[-1]])
 
+    # compress segment output in the caller:
+    segCmd.append("--compress-vcf-output")
+
     if not isFirstSegment :
         segCmd.append("--strelka-skip-header")
+    else :
+        # record the workflow configuration command line in the vcf header instead of the segment command line:
+        segCmd.extend(["--vcf-header-cmdline", " ".join(self.params.configCommandLine)])
 
     if self.params.isHighDepthFilter :
         segCmd.extend(["--strelka-chrom-depth-file", self.paths.getChromDepth()])
@@ -149,32 +155,8 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     callTask=preJoin(taskPrefix,"callGenomeSegment_"+genomeSegmentLabel)
     self.addTask(callTask,segCmd,dependencies=dependencies,memMb=self.params.callMemMb)
 
-    # fix vcf header to use parent pyflow cmdline instead of random segment command:
-    compressWaitFor=callTask
-    if isFirstSegment :
-        headerFixTask=preJoin(taskPrefix,"fixVcfHeader_"+genomeSegmentLabel)
-        def getHeaderFixCmd(fileName) :
-            tmpName=fileName+".reheader.tmp"
-            cmd  = "\"%s\" -E \"%s\"" % (sys.executable, self.params.vcfCmdlineSwapper)
-            cmd += ' "' + " ".join(self.params.configCommandLine) + '"'
-            cmd += " < \"%s\" > \"%s\" && mv \"%s\" \"%s\"" % (fileName,tmpName,
-                                                               tmpName, fileName)
-            return cmd
-
-        headerFixCmd  = getHeaderFixCmd(tmpSnvPath)
-        headerFixCmd += " && "
-        headerFixCmd += getHeaderFixCmd(tmpIndelPath)
-
-        self.addTask(headerFixTask, headerFixCmd, dependencies=callTask, isForceLocal=True)
-        compressWaitFor=headerFixTask
-
-    compressTask=preJoin(taskPrefix,"compressSegmentOutput_"+genomeSegmentLabel)
-    compressCmd="\"%s\" \"%s\" && \"%s\" \"%s\"" % (self.params.bgzipBin, tmpSnvPath, self.params.bgzipBin, tmpIndelPath)
-    if self.params.isOutputCallableRegions :
-        compressCmd += " && \"%s\" \"%s\"" % (self.params.bgzipBin, self.paths.getTmpSegmentRegionPath(genomeSegmentLabel))
-
-    self.addTask(compressTask, compressCmd, dependencies=compressWaitFor, isForceLocal=True)
-    nextStepWait.add(compressTask)
+    # the segment vcf and bed files are written directly as bgzip-compressed files by the caller:
+    nextStepWait.add(callTask)
 
     if self.params.isWriteRealignedBam :
         def sortRealignBam(label, sortList) :